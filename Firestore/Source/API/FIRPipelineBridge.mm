@@ -1627,11 +1627,11 @@ core::ListenOptions ToListenOptions(__FIRPipelineListenOptionsBridge *_Nullable
   for (FIRStageBridge *stage in _stages) {
     auto evaluable_stage = std::dynamic_pointer_cast<api::EvaluableStage>(
         [stage cppStageWithReader:firestore.dataReader]);
-    if (evaluable_stage) {
-      cpp_stages.push_back(evaluable_stage);
-    } else {
+    if (!evaluable_stage) {
       HARD_FAIL("Failed to convert cpp stage to EvaluableStage for RealtimePipeline");
     }
+    // Stages that can't be listened to are reported to `listener` as an error.
+    cpp_stages.push_back(evaluable_stage);
   }
 
   cpp_pipeline = std::make_shared<RealtimePipeline>(
@@ -63,8 +63,8 @@ size_t CollectionReference::Hash() const {
   return util::Hash(firestore().get(), query());
 }
 
-const std::string& CollectionReference::collection_id() const {
-  return query().path().last_segment();
+std::string CollectionReference::collection_id() const {
+  return std::string(query().path().last_segment());
 }
 
 absl::optional<DocumentReference> CollectionReference::parent() const {
@@ -74,8 +74,8 @@ size_t DocumentReference::Hash() const {
   return util::Hash(firestore_.get(), key_);
 }
 
-const std::string& DocumentReference::document_id() const {
-  return key_.path().last_segment();
+std::string DocumentReference::document_id() const {
+  return std::string(key_.path().last_segment());
 }
 
 CollectionReference DocumentReference::Parent() const {
@@ -54,7 +54,7 @@ class DocumentReference {
     return key_;
   }
 
-  const std::string& document_id() const;
+  std::string document_id() const;
 
   CollectionReference Parent() const;
 
@@ -75,8 +75,8 @@ DocumentReference DocumentSnapshot::CreateReference() const {
   return DocumentReference{internal_key_, firestore_};
 }
 
-const std::string& DocumentSnapshot::document_id() const {
-  return internal_key_.path().last_segment();
+std::string DocumentSnapshot::document_id() const {
+  return std::string(internal_key_.path().last_segment());
 }
 
 absl::optional<google_firestore_v1_Value> DocumentSnapshot::GetValue(
@@ -31,12 +31,31 @@ constexpr bool Settings::DefaultSslEnabled;
 constexpr bool Settings::DefaultPersistenceEnabled;
 constexpr int64_t Settings::DefaultCacheSizeBytes;
 constexpr int64_t Settings::MinimumCacheSizeBytes;
+constexpr bool Settings::DefaultParallelViewComputationEnabled;
+constexpr int64_t Settings::DefaultMaxCoalescedWriteBytes;
+constexpr Settings::MessageCompression Settings::DefaultMessageCompression;
+constexpr int64_t Settings::DefaultMessageCompressionThresholdBytes;
+constexpr int64_t Settings::DefaultDecodedDocumentCacheSizeBytes;
+constexpr bool Settings::DefaultConcurrentCacheReadsEnabled;
+constexpr bool Settings::DefaultStagedStartupEnabled;
+constexpr bool Settings::DefaultShardedExecutionEnabled;
 
 Settings::Settings(const Settings& other)
     : host_(other.host_),
       ssl_enabled_(other.ssl_enabled_),
       persistence_enabled_(other.persistence_enabled_),
-      cache_size_bytes_(other.cache_size_bytes_) {
+      cache_size_bytes_(other.cache_size_bytes_),
+      parallel_view_computation_enabled_(
+          other.parallel_view_computation_enabled_),
+      max_coalesced_write_bytes_(other.max_coalesced_write_bytes_),
+      message_compression_(other.message_compression_),
+      message_compression_threshold_bytes_(
+          other.message_compression_threshold_bytes_),
+      decoded_document_cache_size_bytes_(
+          other.decoded_document_cache_size_bytes_),
+      concurrent_cache_reads_enabled_(other.concurrent_cache_reads_enabled_),
+      staged_startup_enabled_(other.staged_startup_enabled_),
+      sharded_execution_enabled_(other.sharded_execution_enabled_) {
   if (other.cache_settings_ != nullptr) {
     cache_settings_ = CopyCacheSettings(*other.cache_settings_);
   }
@@ -51,6 +70,15 @@ Settings& Settings::operator=(const Settings& other) {
   ssl_enabled_ = other.ssl_enabled_;
   persistence_enabled_ = other.persistence_enabled_;
   cache_size_bytes_ = other.cache_size_bytes_;
+  parallel_view_computation_enabled_ = other.parallel_view_computation_enabled_;
+  max_coalesced_write_bytes_ = other.max_coalesced_write_bytes_;
+  message_compression_ = other.message_compression_;
+  message_compression_threshold_bytes_ =
+      other.message_compression_threshold_bytes_;
+  decoded_document_cache_size_bytes_ = other.decoded_document_cache_size_bytes_;
+  concurrent_cache_reads_enabled_ = other.concurrent_cache_reads_enabled_;
+  staged_startup_enabled_ = other.staged_startup_enabled_;
+  sharded_execution_enabled_ = other.sharded_execution_enabled_;
   if (other.cache_settings_ != nullptr) {
     cache_settings_ = CopyCacheSettings(*other.cache_settings_);
   }
@@ -115,13 +143,33 @@ MemoryCacheSettings MemoryCacheSettings::WithMemoryGarbageCollectorSettings(
 
 size_t Settings::Hash() const {
   return util::Hash(host_, ssl_enabled_, persistence_enabled_,
-                    cache_size_bytes_, cache_settings_);
+                    cache_size_bytes_, cache_settings_,
+                    parallel_view_computation_enabled_,
+                    max_coalesced_write_bytes_,
+                    message_compression_,
+                    message_compression_threshold_bytes_,
+                    decoded_document_cache_size_bytes_,
+                    concurrent_cache_reads_enabled_,
+                    staged_startup_enabled_,
+                    sharded_execution_enabled_);
 }
 
 bool operator==(const Settings& lhs, const Settings& rhs) {
   bool eq = lhs.host_ == rhs.host_ && lhs.ssl_enabled_ == rhs.ssl_enabled_ &&
             lhs.persistence_enabled_ == rhs.persistence_enabled_ &&
-            lhs.cache_size_bytes_ == rhs.cache_size_bytes_;
+            lhs.cache_size_bytes_ == rhs.cache_size_bytes_ &&
+            lhs.parallel_view_computation_enabled_ ==
+                rhs.parallel_view_computation_enabled_ &&
+            lhs.max_coalesced_write_bytes_ == rhs.max_coalesced_write_bytes_ &&
+            lhs.message_compression_ == rhs.message_compression_ &&
+            lhs.message_compression_threshold_bytes_ ==
+                rhs.message_compression_threshold_bytes_ &&
+            lhs.decoded_document_cache_size_bytes_ ==
+                rhs.decoded_document_cache_size_bytes_ &&
+            lhs.concurrent_cache_reads_enabled_ ==
+                rhs.concurrent_cache_reads_enabled_ &&
+            lhs.staged_startup_enabled_ == rhs.staged_startup_enabled_ &&
+            lhs.sharded_execution_enabled_ == rhs.sharded_execution_enabled_;
   if (!eq) {
     return eq;
   }
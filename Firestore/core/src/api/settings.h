@@ -38,6 +38,9 @@ class LocalCacheSettings;
  */
 class Settings {
  public:
+  /** The algorithm used to compress messages sent to the backend. */
+  enum class MessageCompression { kNone, kGzip, kDeflate };
+
   // Note: a constexpr array of char (`char[]`) doesn't work with Visual Studio
   // 2015.
   static constexpr const char* DefaultHost = "firestore.googleapis.com";
@@ -46,6 +49,15 @@ class Settings {
   static constexpr int64_t DefaultCacheSizeBytes = 100 * 1024 * 1024;
   static constexpr int64_t MinimumCacheSizeBytes = 1 * 1024 * 1024;
   static constexpr int64_t CacheSizeUnlimited = -1;
+  static constexpr bool DefaultParallelViewComputationEnabled = false;
+  static constexpr int64_t DefaultMaxCoalescedWriteBytes = 0;
+  static constexpr MessageCompression DefaultMessageCompression =
+      MessageCompression::kNone;
+  static constexpr int64_t DefaultMessageCompressionThresholdBytes = 1024;
+  static constexpr int64_t DefaultDecodedDocumentCacheSizeBytes = 0;
+  static constexpr bool DefaultConcurrentCacheReadsEnabled = false;
+  static constexpr bool DefaultStagedStartupEnabled = false;
+  static constexpr bool DefaultShardedExecutionEnabled = false;
 
   Settings() = default;
   Settings(const Settings& other);
@@ -78,6 +90,99 @@ class Settings {
   const LocalCacheSettings* local_cache_settings() const;
   void set_local_cache_settings(const LocalCacheSettings& settings);
 
+  /**
+   * Whether views of different queries are recomputed in parallel on a pool
+   * of worker threads when a change affects many active listeners.
+   */
+  void set_parallel_view_computation_enabled(bool value) {
+    parallel_view_computation_enabled_ = value;
+  }
+  bool parallel_view_computation_enabled() const {
+    return parallel_view_computation_enabled_;
+  }
+
+  /**
+   * The maximum size of a write request into which consecutive pending writes
+   * may be packed. Zero, the default, sends each write in its own request, and
+   * so do negative values.
+   */
+  void set_max_coalesced_write_bytes(int64_t value) {
+    max_coalesced_write_bytes_ = value;
+  }
+  int64_t max_coalesced_write_bytes() const {
+    return max_coalesced_write_bytes_;
+  }
+
+  /**
+   * The algorithm with which messages sent on gRPC calls and streams are
+   * compressed. The backend is free to compress its responses either way.
+   */
+  void set_message_compression(MessageCompression value) {
+    message_compression_ = value;
+  }
+  MessageCompression message_compression() const {
+    return message_compression_;
+  }
+
+  /**
+   * Messages smaller than this many bytes are sent uncompressed even when
+   * message compression is enabled, since they would gain little from it.
+   * Negative values are treated as zero.
+   */
+  void set_message_compression_threshold_bytes(int64_t value) {
+    message_compression_threshold_bytes_ = value;
+  }
+  int64_t message_compression_threshold_bytes() const {
+    return message_compression_threshold_bytes_;
+  }
+
+  /**
+   * The size, in encoded bytes, of the in-memory cache of recently read
+   * documents kept in front of the persistent cache. Zero, the default,
+   * disables it.
+   */
+  void set_decoded_document_cache_size_bytes(int64_t value) {
+    decoded_document_cache_size_bytes_ = value;
+  }
+  int64_t decoded_document_cache_size_bytes() const {
+    return decoded_document_cache_size_bytes_;
+  }
+
+  /**
+   * Whether reads from the cache only run on a pool of reader threads against
+   * a snapshot of the cache, rather than one at a time on the worker queue.
+   */
+  void set_concurrent_cache_reads_enabled(bool value) {
+    concurrent_cache_reads_enabled_ = value;
+  }
+  bool concurrent_cache_reads_enabled() const {
+    return concurrent_cache_reads_enabled_;
+  }
+
+  /**
+   * Whether starting the client defers loading field indexes and migrating
+   * overlays until they are first needed, so that the first reads from the
+   * cache don't wait for them.
+   */
+  void set_staged_startup_enabled(bool value) {
+    staged_startup_enabled_ = value;
+  }
+  bool staged_startup_enabled() const {
+    return staged_startup_enabled_;
+  }
+
+  /**
+   * Whether the client decodes watch responses and delivers snapshot events on
+   * queues of their own, rather than doing all of its work on the worker
+   * queue.
+   */
+  void set_sharded_execution_enabled(bool value) {
+    sharded_execution_enabled_ = value;
+  }
+  bool sharded_execution_enabled() const {
+    return sharded_execution_enabled_;
+  }
+
   friend bool operator==(const Settings& lhs, const Settings& rhs);
 
   size_t Hash() const;
@@ -91,6 +196,17 @@ class Settings {
   bool persistence_enabled_ = DefaultPersistenceEnabled;
   int64_t cache_size_bytes_ = DefaultCacheSizeBytes;
   std::unique_ptr<LocalCacheSettings> cache_settings_ = nullptr;
+  bool parallel_view_computation_enabled_ =
+      DefaultParallelViewComputationEnabled;
+  int64_t max_coalesced_write_bytes_ = DefaultMaxCoalescedWriteBytes;
+  MessageCompression message_compression_ = DefaultMessageCompression;
+  int64_t message_compression_threshold_bytes_ =
+      DefaultMessageCompressionThresholdBytes;
+  int64_t decoded_document_cache_size_bytes_ =
+      DefaultDecodedDocumentCacheSizeBytes;
+  bool concurrent_cache_reads_enabled_ = DefaultConcurrentCacheReadsEnabled;
+  bool staged_startup_enabled_ = DefaultStagedStartupEnabled;
+  bool sharded_execution_enabled_ = DefaultShardedExecutionEnabled;
 };
 
 class LocalCacheSettings {
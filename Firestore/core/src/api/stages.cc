@@ -18,7 +18,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -30,6 +32,7 @@
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/object_value.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -43,6 +46,63 @@ namespace api {
 
 using model::DeepClone;
 
+namespace {
+
+using EvaluableFields = std::vector<
+    std::pair<model::FieldPath, std::unique_ptr<core::EvaluableExpr>>>;
+
+/** Prepares `fields`, keyed by the field that each one produces. */
+EvaluableFields ToEvaluableFields(
+    const std::unordered_map<std::string, std::shared_ptr<Expr>>& fields) {
+  EvaluableFields result;
+  result.reserve(fields.size());
+  for (const auto& field : fields) {
+    result.emplace_back(model::FieldPath{field.first},
+                        field.second->ToEvaluable());
+  }
+  return result;
+}
+
+/**
+ * Evaluates `fields` against `input`. Fields that evaluate to unset are left
+ * out, and fields that fail to evaluate are null.
+ */
+model::TransformMap EvaluateFields(const EvaluateContext& context,
+                                   const EvaluableFields& fields,
+                                   const model::PipelineInputOutput& input) {
+  model::TransformMap result;
+  for (const auto& field : fields) {
+    core::EvaluateResult value = field.second->Evaluate(context, input);
+    if (value.type() == core::EvaluateResult::ResultType::kUnset) {
+      continue;
+    }
+    result.emplace(field.first, value.type() ==
+                                        core::EvaluateResult::ResultType::kError
+                                    ? nanopb::MakeMessage(model::NullValue())
+                                    : value.ReleaseValue());
+  }
+  return result;
+}
+
+/**
+ * Returns a document with the key, version and mutation state of `input`,
+ * that holds `data` instead of the contents of `input`.
+ */
+model::PipelineInputOutput WithData(const model::PipelineInputOutput& input,
+                                    model::ObjectValue data) {
+  model::MutableDocument result = model::MutableDocument::FoundDocument(
+      input.key(), input.version(), std::move(data));
+  result.WithReadTime(input.read_time());
+  if (input.has_local_mutations()) {
+    result.SetHasLocalMutations();
+  } else if (input.has_committed_mutations()) {
+    result.SetHasCommittedMutations();
+  }
+  return result;
+}
+
+}  // namespace
+
 CollectionSource::CollectionSource(std::string path)
     : path_(model::ResourcePath::FromStringView(path)) {
 }
@@ -742,6 +802,194 @@ model::PipelineInputOutputVector SortStage::Evaluate(
   return input_copy;
 }
 
+model::PipelineInputOutputVector OffsetStage::Evaluate(
+    const EvaluateContext& /*context*/,
+    const model::PipelineInputOutputVector& inputs) const {
+  if (offset_ <= 0) {
+    return inputs;
+  }
+
+  auto count = static_cast<size_t>(offset_);
+  if (count >= inputs.size()) {
+    return {};
+  }
+  return model::PipelineInputOutputVector(inputs.begin() + count, inputs.end());
+}
+
+model::PipelineInputOutputVector SelectStage::Evaluate(
+    const EvaluateContext& context,
+    const model::PipelineInputOutputVector& inputs) const {
+  const EvaluableFields fields = ToEvaluableFields(fields_);
+
+  model::PipelineInputOutputVector results;
+  results.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    // Only the selected fields are read, so documents that are still encoded
+    // never decode the others, and nothing else is copied.
+    model::ObjectValue data;
+    data.SetAll(EvaluateFields(context, fields, input));
+    results.push_back(WithData(input, std::move(data)));
+  }
+  return results;
+}
+
+model::PipelineInputOutputVector AddFields::Evaluate(
+    const EvaluateContext& context,
+    const model::PipelineInputOutputVector& inputs) const {
+  const EvaluableFields fields = ToEvaluableFields(fields_);
+
+  model::PipelineInputOutputVector results;
+  results.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    // Evaluated against the input, before any of the fields are added.
+    model::TransformMap added = EvaluateFields(context, fields, input);
+    model::ObjectValue data{input.data()};
+    data.SetAll(std::move(added));
+    results.push_back(WithData(input, std::move(data)));
+  }
+  return results;
+}
+
+model::PipelineInputOutputVector RemoveFieldsStage::Evaluate(
+    const EvaluateContext& /*context*/,
+    const model::PipelineInputOutputVector& inputs) const {
+  // Removed top-level fields are skipped while copying the rest of the
+  // document. Nested fields can only be deleted from the copy.
+  std::set<std::string> removed_top_level;
+  std::vector<model::FieldPath> removed_nested;
+  for (const Field& field : fields_) {
+    if (field.field_path().size() == 1) {
+      removed_top_level.emplace(field.field_path().first_segment());
+    } else {
+      removed_nested.push_back(field.field_path());
+    }
+  }
+
+  model::PipelineInputOutputVector results;
+  results.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    google_firestore_v1_Value value = input.value();
+    const google_firestore_v1_MapValue& fields = value.map_value;
+
+    nanopb::Message<google_firestore_v1_MapValue> kept;
+    kept->fields = nanopb::MakeArray<google_firestore_v1_MapValue_FieldsEntry>(
+        fields.fields_count);
+    for (pb_size_t i = 0; i < fields.fields_count; ++i) {
+      const google_firestore_v1_MapValue_FieldsEntry& entry = fields.fields[i];
+      if (removed_top_level.count(nanopb::MakeString(entry.key)) > 0) {
+        continue;
+      }
+      google_firestore_v1_MapValue_FieldsEntry& copy =
+          kept->fields[kept->fields_count++];
+      copy.key = nanopb::CopyBytesArray(entry.key);
+      copy.value = *DeepClone(entry.value).release();
+    }
+
+    model::ObjectValue data = model::ObjectValue::FromMapValue(std::move(kept));
+    for (const model::FieldPath& path : removed_nested) {
+      data.Delete(path);
+    }
+    results.push_back(WithData(input, std::move(data)));
+  }
+  return results;
+}
+
+model::PipelineInputOutputVector DistinctStage::Evaluate(
+    const EvaluateContext& context,
+    const model::PipelineInputOutputVector& inputs) const {
+  const EvaluableFields groups = ToEvaluableFields(groups_);
+
+  // Each distinct combination of group values becomes one result, keyed and
+  // versioned like the first input that produced it. Results are found by the
+  // fingerprint of their group values, and only compared with inputs whose
+  // fingerprint matches.
+  model::PipelineInputOutputVector results;
+  std::unordered_multimap<uint64_t, size_t> results_by_fingerprint;
+
+  for (const auto& input : inputs) {
+    std::vector<nanopb::Message<google_firestore_v1_Value>> values;
+    values.reserve(groups.size());
+    uint64_t fingerprint = 0;
+    for (const auto& group : groups) {
+      core::EvaluateResult value = group.second->Evaluate(context, input);
+      values.push_back(value.IsErrorOrUnset()
+                           ? nanopb::MakeMessage(model::NullValue())
+                           : value.ReleaseValue());
+      fingerprint = fingerprint * 31 + model::Fingerprint(*values.back());
+    }
+
+    auto candidates = results_by_fingerprint.equal_range(fingerprint);
+    bool seen = std::any_of(
+        candidates.first, candidates.second,
+        [&](const std::pair<const uint64_t, size_t>& candidate) {
+          const model::PipelineInputOutput& result = results[candidate.second];
+          for (size_t i = 0; i < groups.size(); ++i) {
+            absl::optional<google_firestore_v1_Value> group_value =
+                result.field(groups[i].first);
+            if (!group_value || !model::Equals(*group_value, *values[i])) {
+              return false;
+            }
+          }
+          return true;
+        });
+    if (seen) {
+      continue;
+    }
+
+    model::TransformMap fields;
+    for (size_t i = 0; i < groups.size(); ++i) {
+      fields.emplace(groups[i].first, std::move(values[i]));
+    }
+    model::ObjectValue data;
+    data.SetAll(std::move(fields));
+
+    results_by_fingerprint.emplace(fingerprint, results.size());
+    results.push_back(WithData(input, std::move(data)));
+  }
+  return results;
+}
+
+model::PipelineInputOutputVector Unnest::Evaluate(
+    const EvaluateContext& context,
+    const model::PipelineInputOutputVector& inputs) const {
+  const auto* alias = dynamic_cast<const Field*>(alias_.get());
+  HARD_ASSERT(alias != nullptr, "Unnest alias must be a field");
+  const Field* index_field = nullptr;
+  if (index_field_) {
+    index_field = dynamic_cast<const Field*>(index_field_->get());
+    HARD_ASSERT(index_field != nullptr, "Unnest index field must be a field");
+  }
+  const auto evaluable_field = field_->ToEvaluable();
+
+  // Every input produces one result per element of its array, and no results
+  // if the field is not an array. Results are added as each array is walked,
+  // without collecting the elements first.
+  model::PipelineInputOutputVector results;
+  for (const auto& input : inputs) {
+    core::EvaluateResult array = evaluable_field->Evaluate(context, input);
+    if (array.type() != core::EvaluateResult::ResultType::kArray) {
+      continue;
+    }
+
+    const google_firestore_v1_ArrayValue& elements = array.value()->array_value;
+    for (pb_size_t i = 0; i < elements.values_count; ++i) {
+      model::TransformMap fields;
+      fields.emplace(alias->field_path(), DeepClone(elements.values[i]));
+      if (index_field) {
+        google_firestore_v1_Value index{};
+        index.which_value_type = google_firestore_v1_Value_integer_value_tag;
+        index.integer_value = i;
+        fields.emplace(index_field->field_path(), nanopb::MakeMessage(index));
+      }
+
+      model::ObjectValue data{input.data()};
+      data.SetAll(std::move(fields));
+      results.push_back(WithData(input, std::move(data)));
+    }
+  }
+  return results;
+}
+
 }  // namespace api
 }  // namespace firestore
 }  // namespace firebase
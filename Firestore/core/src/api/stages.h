@@ -209,7 +209,7 @@ class DocumentsSource : public EvaluableStage {
   std::set<std::string> documents_;
 };
 
-class AddFields : public Stage {
+class AddFields : public EvaluableStage {
  public:
   explicit AddFields(
       std::unordered_map<std::string, std::shared_ptr<Expr>> fields)
@@ -224,6 +224,14 @@ class AddFields : public Stage {
     return kName;
   }
 
+  const std::unordered_map<std::string, std::shared_ptr<Expr>>& fields() const {
+    return fields_;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   std::unordered_map<std::string, std::shared_ptr<Expr>> fields_;
 };
@@ -388,7 +396,7 @@ class LimitStage : public EvaluableStage {
   int32_t limit_;
 };
 
-class OffsetStage : public Stage {
+class OffsetStage : public EvaluableStage {
  public:
   explicit OffsetStage(int64_t offset) : offset_(offset) {
   }
@@ -401,11 +409,19 @@ class OffsetStage : public Stage {
     return kName;
   }
 
+  int64_t offset() const {
+    return offset_;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   int64_t offset_;
 };
 
-class SelectStage : public Stage {
+class SelectStage : public EvaluableStage {
  public:
   explicit SelectStage(
       std::unordered_map<std::string, std::shared_ptr<Expr>> fields)
@@ -420,6 +436,14 @@ class SelectStage : public Stage {
     return kName;
   }
 
+  const std::unordered_map<std::string, std::shared_ptr<Expr>>& fields() const {
+    return fields_;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   std::unordered_map<std::string, std::shared_ptr<Expr>> fields_;
 };
@@ -450,7 +474,7 @@ class SortStage : public EvaluableStage {
   std::vector<Ordering> orders_;
 };
 
-class DistinctStage : public Stage {
+class DistinctStage : public EvaluableStage {
  public:
   explicit DistinctStage(
       std::unordered_map<std::string, std::shared_ptr<Expr>> groups)
@@ -465,11 +489,19 @@ class DistinctStage : public Stage {
     return kName;
   }
 
+  const std::unordered_map<std::string, std::shared_ptr<Expr>>& groups() const {
+    return groups_;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   std::unordered_map<std::string, std::shared_ptr<Expr>> groups_;
 };
 
-class RemoveFieldsStage : public Stage {
+class RemoveFieldsStage : public EvaluableStage {
  public:
   explicit RemoveFieldsStage(std::vector<Field> fields)
       : fields_(std::move(fields)) {
@@ -483,6 +515,14 @@ class RemoveFieldsStage : public Stage {
     return kName;
   }
 
+  const std::vector<Field>& fields() const {
+    return fields_;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   std::vector<Field> fields_;
 };
@@ -570,7 +610,7 @@ class Union : public Stage {
   std::shared_ptr<Pipeline> other_;
 };
 
-class Unnest : public Stage {
+class Unnest : public EvaluableStage {
  public:
   Unnest(std::shared_ptr<Expr> field,
          std::shared_ptr<Expr> alias,
@@ -583,6 +623,22 @@ class Unnest : public Stage {
     return kName;
   }
 
+  const Expr* field() const {
+    return field_.get();
+  }
+
+  const Expr* alias() const {
+    return alias_.get();
+  }
+
+  const Expr* index_field() const {
+    return index_field_ ? index_field_->get() : nullptr;
+  }
+
+  model::PipelineInputOutputVector Evaluate(
+      const EvaluateContext& context,
+      const model::PipelineInputOutputVector& inputs) const override;
+
  private:
   std::shared_ptr<Expr> field_;
   std::shared_ptr<Expr> alias_;
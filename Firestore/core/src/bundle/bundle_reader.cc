@@ -17,7 +17,10 @@
 #include "Firestore/core/src/bundle/bundle_reader.h"
 
 #include <algorithm>
+#include <limits>
 
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
@@ -26,6 +29,8 @@ namespace firebase {
 namespace firestore {
 namespace bundle {
 
+using nanopb::Message;
+using nanopb::StringReader;
 using nlohmann::json;
 using util::ByteStream;
 using util::StreamReadResult;
@@ -68,38 +73,103 @@ std::unique_ptr<BundleElement> BundleReader::GetNextElement() {
 }
 
 std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
-  auto length_prefix = ReadLengthPrefix();
-  if (!length_prefix.has_value()) {
-    return nullptr;
+  if (format_ == Format::Unknown) {
+    DetectFormat();
+    if (!reader_status_.ok()) {
+      return nullptr;
+    }
   }
 
+  size_t prefix_size = 0;
   size_t prefix_value = 0;
-  auto ok = absl::SimpleAtoi<size_t>(length_prefix.value(), &prefix_value);
-  if (!ok) {
-    Fail("Prefix string is not a valid number");
-    return nullptr;
+  if (format_ == Format::Binary) {
+    auto length_prefix = ReadVarintLengthPrefix(&prefix_size);
+    if (!length_prefix.has_value()) {
+      return nullptr;
+    }
+    if (length_prefix.value() > std::numeric_limits<size_t>::max()) {
+      Fail("Prefix value is too large");
+      return nullptr;
+    }
+    prefix_value = static_cast<size_t>(length_prefix.value());
+  } else {
+    auto length_prefix = ReadLengthPrefix();
+    if (!length_prefix.has_value()) {
+      return nullptr;
+    }
+
+    auto ok = absl::SimpleAtoi<size_t>(length_prefix.value(), &prefix_value);
+    if (!ok) {
+      Fail("Prefix string is not a valid number");
+      return nullptr;
+    }
+    prefix_size = length_prefix.value().size();
   }
 
   buffer_.clear();
-  ReadJsonToBuffer(prefix_value);
+  ReadToBuffer(prefix_value);
   if (!reader_status_.ok()) {
     return nullptr;
   }
 
   // metadata's size does not count in `bytes_read_`.
   if (metadata_loaded_) {
-    bytes_read_ += length_prefix.value().size() + buffer_.size();
+    bytes_read_ += prefix_size + buffer_.size();
+  }
+
+  if (format_ == Format::Binary) {
+    return DecodeBinaryBundleElementFromBuffer();
   }
+
   auto result = DecodeBundleElementFromBuffer();
   reader_status_.Update(json_reader_.status());
 
   return result;
 }
 
+void BundleReader::DetectFormat() {
+  StreamReadResult result = input_->Read(1);
+  if (!result.ok()) {
+    reader_status_.Update(result.status());
+    return;
+  }
+
+  std::string head = std::move(result).ValueOrDie();
+  if (head.empty() || head[0] != kBinaryBundleMagic[0]) {
+    format_ = Format::Json;
+    pending_prefix_ = std::move(head);
+    return;
+  }
+
+  while (head.size() < kBinaryBundleMagicSize) {
+    StreamReadResult rest = input_->Read(kBinaryBundleMagicSize - head.size());
+    if (!rest.ok()) {
+      reader_status_.Update(rest.status());
+      return;
+    }
+    bool eof = rest.eof();
+    head.append(std::move(rest).ValueOrDie());
+    if (eof) {
+      break;
+    }
+  }
+
+  if (head != absl::string_view(kBinaryBundleMagic, kBinaryBundleMagicSize)) {
+    Fail("Invalid binary bundle header");
+    return;
+  }
+  format_ = Format::Binary;
+}
+
 absl::optional<std::string> BundleReader::ReadLengthPrefix() {
+  // Whatever was consumed while detecting the bundle format is the start of
+  // the first length prefix.
+  std::string prefix = std::move(pending_prefix_);
+  pending_prefix_.clear();
+
   // length string of size 16 indicates an element about 1PB, which is
   // impossible for valid bundles.
-  StreamReadResult result = input_->ReadUntil('{', 16);
+  StreamReadResult result = input_->ReadUntil('{', 16 - prefix.size());
   if (!result.ok()) {
     reader_status_.Update(result.status());
     return absl::nullopt;
@@ -107,14 +177,50 @@ absl::optional<std::string> BundleReader::ReadLengthPrefix() {
 
   // Underlying stream is closed, and there happens to be no more data to
   // process.
-  if (result.eof() && result.ValueOrDie().empty()) {
+  if (result.eof() && result.ValueOrDie().empty() && prefix.empty()) {
     return absl::nullopt;
   }
 
-  return absl::make_optional(std::move(result).ValueOrDie());
+  prefix.append(std::move(result).ValueOrDie());
+  return absl::make_optional(std::move(prefix));
 }
 
-void BundleReader::ReadJsonToBuffer(size_t required_size) {
+absl::optional<uint64_t> BundleReader::ReadVarintLengthPrefix(
+    size_t* prefix_size) {
+  *prefix_size = 0;
+  uint64_t value = 0;
+
+  // A varint encodes 7 bits per byte, and takes at most 10 bytes for 64 bits.
+  for (int shift = 0; shift < 64; shift += 7) {
+    StreamReadResult result = input_->Read(1);
+    if (!result.ok()) {
+      reader_status_.Update(result.status());
+      return absl::nullopt;
+    }
+
+    const std::string& byte_string = result.ValueOrDie();
+    if (byte_string.empty()) {
+      // Underlying stream is closed, this is only expected in between
+      // elements.
+      if (*prefix_size != 0) {
+        Fail("Reached the end of stream within a length prefix");
+      }
+      return absl::nullopt;
+    }
+
+    ++*prefix_size;
+    auto byte = static_cast<uint8_t>(byte_string[0]);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+
+  Fail("Prefix is not a valid varint");
+  return absl::nullopt;
+}
+
+void BundleReader::ReadToBuffer(size_t required_size) {
   if (!reader_status_.ok()) {
     return;
   }
@@ -166,6 +272,46 @@ std::unique_ptr<BundleElement> BundleReader::DecodeBundleElementFromBuffer() {
   }
 }
 
+std::unique_ptr<BundleElement>
+BundleReader::DecodeBinaryBundleElementFromBuffer() {
+  StringReader reader(buffer_);
+  auto element = Message<firestore_BundleElement>::TryParse(&reader);
+  if (!reader.ok()) {
+    reader_status_.Update(reader.status());
+    return nullptr;
+  }
+
+  std::unique_ptr<BundleElement> result;
+  switch (element->which_element_type) {
+    case firestore_BundleElement_metadata_tag:
+      result = absl::make_unique<BundleMetadata>(
+          serializer_.DecodeBundleMetadata(&reader, element->metadata));
+      break;
+    case firestore_BundleElement_named_query_tag:
+      result = absl::make_unique<NamedQuery>(
+          serializer_.DecodeNamedQuery(&reader, element->named_query));
+      break;
+    case firestore_BundleElement_document_metadata_tag:
+      result = absl::make_unique<BundledDocumentMetadata>(
+          serializer_.DecodeDocumentMetadata(&reader,
+                                             element->document_metadata));
+      break;
+    case firestore_BundleElement_document_tag:
+      result = absl::make_unique<BundleDocument>(
+          serializer_.DecodeDocument(&reader, element->document));
+      break;
+    default:
+      reader.Fail("Unrecognized BundleElement");
+      break;
+  }
+
+  reader_status_.Update(reader.status());
+  if (!reader_status_.ok()) {
+    return nullptr;
+  }
+  return result;
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
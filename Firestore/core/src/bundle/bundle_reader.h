@@ -32,13 +32,31 @@ namespace firestore {
 namespace bundle {
 
 /**
- * Reads the length-prefixed JSON stream for Bundles.
+ * The header that starts every binary encoded bundle.
+ *
+ * JSON bundles always start with the decimal length prefix of their first
+ * element, so a leading non-digit byte is enough to tell the formats apart.
+ */
+constexpr char kBinaryBundleMagic[] = "\xFF" "FSB1";
+constexpr size_t kBinaryBundleMagicSize = sizeof(kBinaryBundleMagic) - 1;
+
+/**
+ * Reads the length-prefixed stream for Bundles.
+ *
+ * Two encodings are supported, and detected from the start of the stream:
+ *
+ *   - JSON: each element is a JSON string prefixed by its length in bytes,
+ *     written as a decimal number.
+ *   - Binary: `kBinaryBundleMagic`, followed by serialized `BundleElement`
+ *     protos, each prefixed by its length in bytes as a varint.
  *
  * The class takes a bundle stream and presents abstractions to read bundled
  * elements out of the underlying content.
  */
 class BundleReader {
  public:
+  enum class Format { Unknown, Json, Binary };
+
   BundleReader(BundleSerializer serializer,
                std::unique_ptr<util::ByteStream> input);
 
@@ -75,11 +93,27 @@ class BundleReader {
     return bytes_read_;
   }
 
+  /**
+   * The encoding of the bundle, `Format::Unknown` until the first element has
+   * been read.
+   */
+  Format format() const {
+    return format_;
+  }
+
  private:
+  /**
+   * Determines the encoding of the bundle from the first bytes of the stream.
+   *
+   * For JSON bundles, the byte consumed to make the decision is kept in
+   * `pending_prefix_` to be read as part of the first length prefix.
+   */
+  void DetectFormat();
+
   /**
    * Reads from the head of internal buffer, pulls more data from underlying
    * stream until a complete element is found (including the prefixed length and
-   * the JSON string).
+   * the JSON string or serialized proto).
    *
    * Once a complete element is read, it is dropped from internal buffer.
    *
@@ -98,10 +132,17 @@ class BundleReader {
    */
   absl::optional<std::string> ReadLengthPrefix();
 
+  /**
+   * Reads the varint length prefix of a binary bundle element, and stores the
+   * number of bytes it took in `prefix_size`. Returns `nullopt` when at the end
+   * of stream.
+   */
+  absl::optional<uint64_t> ReadVarintLengthPrefix(size_t* prefix_size);
+
   /**
    * Reads `required_size` number of chars from stream into internal `buffer_`.
    */
-  void ReadJsonToBuffer(size_t required_size);
+  void ReadToBuffer(size_t required_size);
 
   /**
    * Decodes internal `buffer_` into a `BundleElement`, returned as a unique_ptr
@@ -111,6 +152,12 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> DecodeBundleElementFromBuffer();
 
+  /**
+   * Decodes internal `buffer_`, holding a serialized `BundleElement` proto,
+   * into a `BundleElement`. Returns nullptr if fails.
+   */
+  std::unique_ptr<BundleElement> DecodeBinaryBundleElementFromBuffer();
+
   BundleSerializer serializer_;
   util::JsonReader json_reader_;
 
@@ -121,6 +168,9 @@ class BundleReader {
   BundleMetadata metadata_;
   bool metadata_loaded_ = false;
 
+  Format format_ = Format::Unknown;
+  std::string pending_prefix_;
+
   // Internal buffer, cleared every time a complete element is parsed from this.
   std::string buffer_;
 
@@ -705,6 +705,127 @@ BundleDocument BundleSerializer::DecodeDocument(JsonReader& reader,
       ObjectValue::FromMapValue(std::move(map_value))));
 }
 
+BundleMetadata BundleSerializer::DecodeBundleMetadata(
+    nanopb::Reader* reader, const firestore_BundleMetadata& metadata) const {
+  return BundleMetadata(
+      rpc_serializer_.DecodeString(metadata.id), metadata.version,
+      rpc_serializer_.DecodeVersion(reader->context(), metadata.create_time),
+      metadata.total_documents, metadata.total_bytes);
+}
+
+NamedQuery BundleSerializer::DecodeNamedQuery(
+    nanopb::Reader* reader, firestore_NamedQuery& named_query) const {
+  return NamedQuery(
+      rpc_serializer_.DecodeString(named_query.name),
+      DecodeBundledQuery(reader, named_query.bundled_query),
+      rpc_serializer_.DecodeVersion(reader->context(), named_query.read_time));
+}
+
+BundledQuery BundleSerializer::DecodeBundledQuery(
+    nanopb::Reader* reader, firestore_BundledQuery& query) const {
+  if (query.which_query_type != firestore_BundledQuery_structured_query_tag) {
+    reader->Fail(
+        StringFormat("Unknown bundled query_type: %s", query.which_query_type));
+    return {};
+  }
+
+  // Apply the same restrictions as `VerifyStructuredQuery` does for JSON.
+  const google_firestore_v1_StructuredQuery& structured_query =
+      query.structured_query;
+  if (structured_query.select.fields_count > 0) {
+    reader->Fail(
+        "Queries with 'select' statements are not supported in bundles");
+    return {};
+  }
+  if (structured_query.from_count == 0) {
+    reader->Fail("Query does not have a 'from' collection");
+    return {};
+  }
+  if (structured_query.offset != 0) {
+    reader->Fail("Queries with 'offset' are not supported in bundles");
+    return {};
+  }
+
+  ResourcePath parent =
+      ResourcePath::FromString(rpc_serializer_.DecodeString(query.parent));
+  if (!rpc_serializer_.IsLocalResourceName(parent)) {
+    reader->Fail("Resource name is not valid for current instance: " +
+                 parent.CanonicalString());
+    return {};
+  }
+
+  // Bundled queries are what the backend sees, so the limit type is carried
+  // separately and applied when the query is read back, like for JSON.
+  Target target = rpc_serializer_.DecodeStructuredQuery(
+      reader->context(), query.parent, query.structured_query);
+  LimitType limit_type =
+      query.limit_type == firestore_BundledQuery_LimitType_LAST
+          ? LimitType::Last
+          : LimitType::First;
+
+  if (!reader->ok()) {
+    return {};
+  }
+  return BundledQuery(std::move(target), limit_type);
+}
+
+DocumentKey BundleSerializer::DecodeDocumentKey(
+    nanopb::Reader* reader, const pb_bytes_array_t* name) const {
+  if (!reader->ok()) {
+    return {};
+  }
+  std::string name_string = rpc_serializer_.DecodeString(name);
+  if (!rpc_serializer_.IsLocalDocumentKey(name_string)) {
+    reader->Fail("Resource name is not a valid document key for current "
+                 "instance: " +
+                 name_string);
+    return {};
+  }
+  return rpc_serializer_.DecodeKey(reader->context(), name);
+}
+
+BundledDocumentMetadata BundleSerializer::DecodeDocumentMetadata(
+    nanopb::Reader* reader,
+    const firestore_BundledDocumentMetadata& document_metadata) const {
+  DocumentKey key = DecodeDocumentKey(reader, document_metadata.name);
+  // Return early if !ok(), `DocumentKey` aborts with invalid inputs.
+  if (!reader->ok()) {
+    return {};
+  }
+
+  SnapshotVersion read_time = rpc_serializer_.DecodeVersion(
+      reader->context(), document_metadata.read_time);
+
+  std::vector<std::string> queries;
+  queries.reserve(document_metadata.queries_count);
+  for (pb_size_t i = 0; i < document_metadata.queries_count; ++i) {
+    queries.push_back(
+        rpc_serializer_.DecodeString(document_metadata.queries[i]));
+  }
+
+  return BundledDocumentMetadata(std::move(key), read_time,
+                                 document_metadata.exists, std::move(queries));
+}
+
+BundleDocument BundleSerializer::DecodeDocument(
+    nanopb::Reader* reader, google_firestore_v1_Document& document) const {
+  DocumentKey key = DecodeDocumentKey(reader, document.name);
+  // Return early if !ok(), `DocumentKey` aborts with invalid inputs.
+  if (!reader->ok()) {
+    return {};
+  }
+
+  SnapshotVersion update_time =
+      rpc_serializer_.DecodeVersion(reader->context(), document.update_time);
+
+  // Takes ownership of the document fields, no copy of the values is made.
+  ObjectValue value =
+      ObjectValue::FromFieldsEntry(document.fields, document.fields_count);
+
+  return BundleDocument(MutableDocument::FoundDocument(
+      std::move(key), update_time, std::move(value)));
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
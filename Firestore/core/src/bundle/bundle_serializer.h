@@ -27,6 +27,7 @@
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/core_fwd.h"
 #include "Firestore/core/src/core/filter.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -40,7 +41,12 @@ namespace firestore {
 
 namespace bundle {
 
-/** A JSON serializer to deserialize Firestore Bundles. */
+/**
+ * A serializer to deserialize Firestore Bundles.
+ *
+ * Bundle elements can be decoded either from their JSON representation, or
+ * from the nanopb `BundleElement` protos used by binary encoded bundles.
+ */
 class BundleSerializer {
  public:
   explicit BundleSerializer(remote::Serializer serializer)
@@ -58,6 +64,23 @@ class BundleSerializer {
   BundleDocument DecodeDocument(util::JsonReader& reader,
                                 const nlohmann::json& document) const;
 
+  // Binary (nanopb) decoding. These mirror the JSON overloads above, and
+  // report errors through the given `reader`. Like `remote::Serializer`, they
+  // may take ownership of parts of the given protos.
+
+  BundleMetadata DecodeBundleMetadata(
+      nanopb::Reader* reader, const firestore_BundleMetadata& metadata) const;
+
+  NamedQuery DecodeNamedQuery(nanopb::Reader* reader,
+                              firestore_NamedQuery& named_query) const;
+
+  BundledDocumentMetadata DecodeDocumentMetadata(
+      nanopb::Reader* reader,
+      const firestore_BundledDocumentMetadata& document_metadata) const;
+
+  BundleDocument DecodeDocument(nanopb::Reader* reader,
+                                google_firestore_v1_Document& document) const;
+
  private:
   BundledQuery DecodeBundledQuery(util::JsonReader& reader,
                                   const nlohmann::json& query) const;
@@ -91,6 +114,11 @@ class BundleSerializer {
   pb_bytes_array_t* DecodeReferenceValue(util::JsonReader& reader,
                                          const std::string& ref_string) const;
 
+  BundledQuery DecodeBundledQuery(nanopb::Reader* reader,
+                                  firestore_BundledQuery& query) const;
+  model::DocumentKey DecodeDocumentKey(nanopb::Reader* reader,
+                                       const pb_bytes_array_t* name) const;
+
   remote::Serializer rpc_serializer_;
 };
 
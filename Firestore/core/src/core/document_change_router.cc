@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/document_change_router.h"
+
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/core/query.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using model::DocumentKey;
+using model::DocumentMap;
+using model::ResourcePath;
+
+DocumentChangeRouter::DocumentChangeRouter(const DocumentMap& changes)
+    : changes_(changes) {
+}
+
+const DocumentMap& DocumentChangeRouter::ChangesFor(
+    const QueryOrPipeline& query) {
+  if (!query.IsPipeline()) {
+    const Query& q = query.query();
+    if (q.IsDocumentQuery()) {
+      return ChangesInCollection(q.path().PopLast());
+    } else if (q.IsCollectionGroupQuery()) {
+      return ChangesInCollectionGroup(*q.collection_group());
+    }
+    return ChangesInCollection(q.path());
+  }
+
+  const api::RealtimePipeline& pipeline = query.pipeline();
+  switch (GetPipelineSourceType(pipeline)) {
+    case PipelineSourceType::kCollection:
+      return ChangesInCollection(
+          ResourcePath::FromString(*GetPipelineCollection(pipeline)));
+    case PipelineSourceType::kCollectionGroup:
+      return ChangesInCollectionGroup(*GetPipelineCollectionGroup(pipeline));
+    case PipelineSourceType::kDatabase:
+    case PipelineSourceType::kDocuments:
+    case PipelineSourceType::kUnknown:
+      break;
+  }
+  return changes_;
+}
+
+const DocumentMap& DocumentChangeRouter::ChangesInCollection(
+    const ResourcePath& collection_path) {
+  if (!collections_indexed_) {
+    for (const auto& kv : changes_) {
+      const DocumentKey& key = kv.first;
+      DocumentMap& bucket = by_collection_[key.path().PopLast()];
+      bucket = bucket.insert(key, kv.second);
+    }
+    collections_indexed_ = true;
+  }
+
+  auto it = by_collection_.find(collection_path);
+  return it != by_collection_.end() ? it->second : empty_;
+}
+
+const DocumentMap& DocumentChangeRouter::ChangesInCollectionGroup(
+    const std::string& collection_group) {
+  if (!collection_groups_indexed_) {
+    for (const auto& kv : changes_) {
+      const DocumentKey& key = kv.first;
+      DocumentMap& bucket = by_collection_group_[*key.GetCollectionGroup()];
+      bucket = bucket.insert(key, kv.second);
+    }
+    collection_groups_indexed_ = true;
+  }
+
+  auto it = by_collection_group_.find(collection_group);
+  return it != by_collection_group_.end() ? it->second : empty_;
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
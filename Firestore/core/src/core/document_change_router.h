@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_DOCUMENT_CHANGE_ROUTER_H_
+#define FIRESTORE_CORE_SRC_CORE_DOCUMENT_CHANGE_ROUTER_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "Firestore/core/src/immutable/sorted_map.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/resource_path.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+class QueryOrPipeline;
+
+/**
+ * Routes a set of changed documents to the views that could be affected by
+ * them.
+ *
+ * Every query (and most realtime pipelines) is restricted to a single
+ * collection path or collection group, so a document can only enter, leave,
+ * or change within a view if it lives in that collection. The router buckets
+ * the changes by parent collection and by collection group on first use, so
+ * that fanning an event out to many views costs one pass over the changes
+ * instead of one `Matches` call per view per document.
+ *
+ * The router holds a reference to the changes, which must outlive it.
+ */
+class DocumentChangeRouter {
+ public:
+  explicit DocumentChangeRouter(const model::DocumentMap& changes);
+
+  /**
+   * Returns the subset of the changes that could affect the results of
+   * `query`. Queries whose source cannot be narrowed down (database-wide or
+   * document-list pipelines) receive all changes.
+   */
+  const model::DocumentMap& ChangesFor(const QueryOrPipeline& query);
+
+ private:
+  const model::DocumentMap& ChangesInCollection(
+      const model::ResourcePath& collection_path);
+  const model::DocumentMap& ChangesInCollectionGroup(
+      const std::string& collection_group);
+
+  const model::DocumentMap& changes_;
+  const model::DocumentMap empty_;
+
+  bool collections_indexed_ = false;
+  std::map<model::ResourcePath, model::DocumentMap> by_collection_;
+
+  bool collection_groups_indexed_ = false;
+  std::unordered_map<std::string, model::DocumentMap> by_collection_group_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_DOCUMENT_CHANGE_ROUTER_H_
@@ -16,28 +16,75 @@
 
 #include "Firestore/core/src/core/event_manager.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "Firestore/core/src/core/pipeline_util.h"
 #include "Firestore/core/src/core/query_listener.h"
 #include "Firestore/core/src/core/sync_engine.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/string_format.h"
 #include "absl/algorithm/container.h"
 
 namespace firebase {
 namespace firestore {
 namespace core {
 
+using util::AsyncQueue;
 using util::Empty;
+using util::Status;
+using util::StringFormat;
+
+namespace {
+
+/** A snapshot and the listeners it is raised to. */
+struct ViewSnapshotEvent {
+  std::vector<std::shared_ptr<QueryListener>> listeners;
+  ViewSnapshot snapshot;
+};
+
+}  // namespace
 
 EventManager::EventManager(QueryEventSource* query_event_source)
     : query_event_source_(query_event_source) {
   query_event_source->SetCallback(this);
 }
 
+void EventManager::NotifyListenersOn(std::shared_ptr<AsyncQueue> event_queue) {
+  event_queue_ = std::move(event_queue);
+}
+
+void EventManager::Notify(std::function<void()> notification) {
+  if (event_queue_) {
+    event_queue_->Enqueue(notification);
+  } else {
+    notification();
+  }
+}
+
+void EventManager::RunAfterEvents(std::function<void()> callback) {
+  Notify(std::move(callback));
+}
+
 model::TargetId EventManager::AddQueryListener(
     std::shared_ptr<core::QueryListener> listener) {
   const QueryOrPipeline& query_or_pipeline = listener->query();
 
+  if (query_or_pipeline.IsPipeline()) {
+    for (const auto& stage : query_or_pipeline.pipeline().stages()) {
+      if (!IsListenableStage(*stage)) {
+        Status error(Error::kErrorInvalidArgument,
+                     StringFormat("Stage %s is not supported in realtime "
+                                  "pipelines",
+                                  stage->name()));
+        Notify([listener, error] { listener->OnError(error); });
+        return 0;
+      }
+    }
+  }
+
   ListenerSetupAction listener_action =
       ListenerSetupAction::NoSetupActionRequired;
 
@@ -61,17 +108,20 @@ model::TargetId EventManager::AddQueryListener(
 
   query_info.listeners.push_back(listener);
 
-  bool raised_event = listener->OnOnlineStateChanged(online_state_);
-  HARD_ASSERT(!raised_event,
-              "OnOnlineStateChanged() shouldn't raise an event "
-              "for brand-new listeners.");
+  Notify([this, listener, online_state = online_state_,
+          snapshot = query_info.view_snapshot()] {
+    bool raised_event = listener->OnOnlineStateChanged(online_state);
+    HARD_ASSERT(!raised_event,
+                "OnOnlineStateChanged() shouldn't raise an event "
+                "for brand-new listeners.");
 
-  if (query_info.view_snapshot().has_value()) {
-    raised_event = listener->OnViewSnapshot(query_info.view_snapshot().value());
-    if (raised_event) {
-      RaiseSnapshotsInSyncEvent();
+    if (snapshot.has_value()) {
+      raised_event = listener->OnViewSnapshot(snapshot.value());
+      if (raised_event) {
+        RaiseSnapshotsInSyncEvent();
+      }
     }
-  }
+  });
 
   switch (listener_action) {
     case ListenerSetupAction::InitializeLocalListenAndRequireWatchConnection:
@@ -135,30 +185,38 @@ void EventManager::RemoveQueryListener(
 
 void EventManager::AddSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& listener) {
-  snapshots_in_sync_listeners_.insert(listener);
-  listener->OnEvent(Empty());
+  Notify([this, listener] {
+    snapshots_in_sync_listeners_.insert(listener);
+    listener->OnEvent(Empty());
+  });
 }
 
 void EventManager::RemoveSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& listener) {
-  snapshots_in_sync_listeners_.erase(listener);
+  Notify([this, listener] { snapshots_in_sync_listeners_.erase(listener); });
 }
 
 void EventManager::HandleOnlineStateChange(model::OnlineState online_state) {
-  bool raised_event = false;
   online_state_ = online_state;
 
+  std::vector<std::shared_ptr<QueryListener>> listeners;
   for (auto&& kv : queries_) {
     QueryListenersInfo& info = kv.second;
-    for (auto&& listener : info.listeners) {
-      if (listener->OnOnlineStateChanged(online_state_)) {
+    listeners.insert(listeners.end(), info.listeners.begin(),
+                     info.listeners.end());
+  }
+
+  Notify([this, listeners, online_state] {
+    bool raised_event = false;
+    for (auto&& listener : listeners) {
+      if (listener->OnOnlineStateChanged(online_state)) {
         raised_event = true;
       }
     }
-  }
-  if (raised_event) {
-    RaiseSnapshotsInSyncEvent();
-  }
+    if (raised_event) {
+      RaiseSnapshotsInSyncEvent();
+    }
+  });
 }
 
 void EventManager::RaiseSnapshotsInSyncEvent() {
@@ -170,23 +228,32 @@ void EventManager::RaiseSnapshotsInSyncEvent() {
 
 void EventManager::OnViewSnapshots(
     std::vector<core::ViewSnapshot>&& snapshots) {
-  bool raised_event = false;
+  // Shared rather than copied into the notification, since queuing it copies
+  // it.
+  auto events = std::make_shared<std::vector<ViewSnapshotEvent>>();
   for (ViewSnapshot& snapshot : snapshots) {
     const QueryOrPipeline& query = snapshot.query_or_pipeline();
     auto found_iter = queries_.find(query);
     if (found_iter != queries_.end()) {
       QueryListenersInfo& query_info = found_iter->second;
-      for (const auto& listener : query_info.listeners) {
-        if (listener->OnViewSnapshot(snapshot)) {
+      query_info.set_view_snapshot(snapshot);
+      events->push_back({query_info.listeners, std::move(snapshot)});
+    }
+  }
+
+  Notify([this, events] {
+    bool raised_event = false;
+    for (const ViewSnapshotEvent& event : *events) {
+      for (const auto& listener : event.listeners) {
+        if (listener->OnViewSnapshot(event.snapshot)) {
           raised_event = true;
         }
       }
-      query_info.set_view_snapshot(std::move(snapshot));
     }
-  }
-  if (raised_event) {
-    RaiseSnapshotsInSyncEvent();
-  }
+    if (raised_event) {
+      RaiseSnapshotsInSyncEvent();
+    }
+  });
 }
 
 void EventManager::OnError(const core::QueryOrPipeline& query,
@@ -196,14 +263,18 @@ void EventManager::OnError(const core::QueryOrPipeline& query,
     return;
   }
 
-  QueryListenersInfo& query_info = found_iter->second;
-  for (const auto& listener : query_info.listeners) {
-    listener->OnError(error);
-  }
+  std::vector<std::shared_ptr<QueryListener>> listeners =
+      std::move(found_iter->second.listeners);
 
   // Remove all listeners. NOTE: We don't need to call
   // `SyncEngine::StopListening()` after an error.
   queries_.erase(found_iter);
+
+  Notify([listeners, error] {
+    for (const auto& listener : listeners) {
+      listener->OnError(error);
+    }
+  });
 }
 
 bool EventManager::QueryListenersInfo::Erase(
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_CORE_EVENT_MANAGER_H_
 #define FIRESTORE_CORE_SRC_CORE_EVENT_MANAGER_H_
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -27,6 +28,7 @@
 #include "Firestore/core/src/core/sync_engine_callback.h"
 #include "Firestore/core/src/core/view_snapshot.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/empty.h"
 #include "Firestore/core/src/util/status_fwd.h"
 #include "absl/types/optional.h"
@@ -46,13 +48,26 @@ class EventManager : public SyncEngineCallback {
  public:
   explicit EventManager(QueryEventSource* query_event_source_);
 
+  /**
+   * Makes the event manager call listeners on `event_queue` rather than on the
+   * worker queue. Listeners are called in the same order as they would be on
+   * the worker queue, with the listeners registered for the query at the time
+   * each event was raised.
+   *
+   * `event_queue` must have run or dropped all of its operations before the
+   * event manager is destroyed.
+   */
+  void NotifyListenersOn(std::shared_ptr<util::AsyncQueue> event_queue);
+
   /**
    * Adds a query listener that will be called with new snapshots for the query.
    * The EventManager is responsible for multiplexing many listeners to a single
    * listen in the SyncEngine and will perform a listen if it's the first
    * QueryListener added for a query.
    *
-   * Returns the TargetId of the listen call in the SyncEngine.
+   * Returns the TargetId of the listen call in the SyncEngine. A pipeline with
+   * stages that can't be listened to (see `IsListenableStage`) is rejected
+   * instead: the listener gets an invalid-argument error and 0 is returned.
    */
   model::TargetId AddQueryListener(
       std::shared_ptr<core::QueryListener> listener);
@@ -63,6 +78,14 @@ class EventManager : public SyncEngineCallback {
    */
   void RemoveQueryListener(std::shared_ptr<core::QueryListener> listener);
 
+  /**
+   * Runs `callback` once the listeners have been called with the events raised
+   * so far: on the event queue if there is one, or right away otherwise. Use
+   * this for results that must not overtake snapshots, such as write
+   * acknowledgements.
+   */
+  void RunAfterEvents(std::function<void()> callback);
+
   void AddSnapshotsInSyncListener(
       const std::shared_ptr<EventListener<util::Empty>>& listener);
   void RemoveSnapshotsInSyncListener(
@@ -80,6 +103,12 @@ class EventManager : public SyncEngineCallback {
    */
   void RaiseSnapshotsInSyncEvent();
 
+  /**
+   * Runs `notification`, which calls listeners, on the event queue if there is
+   * one, or right away otherwise.
+   */
+  void Notify(std::function<void()> notification);
+
   /**
    * Holds the listeners and the last received ViewSnapshot for a query being
    * tracked by EventManager.
@@ -130,6 +159,10 @@ class EventManager : public SyncEngineCallback {
   QueryEventSource* query_event_source_ = nullptr;
   model::OnlineState online_state_ = model::OnlineState::Unknown;
   std::unordered_map<core::QueryOrPipeline, QueryListenersInfo> queries_;
+
+  std::shared_ptr<util::AsyncQueue> event_queue_;
+
+  // Only used by notifications.
   std::unordered_set<std::shared_ptr<EventListener<util::Empty>>>
       snapshots_in_sync_listeners_;
 };
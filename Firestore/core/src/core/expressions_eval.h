@@ -81,6 +81,11 @@ class EvaluateResult {
     return value_.get();
   }
 
+  /** Moves the value out of this result, so that it isn't copied again. */
+  nanopb::Message<google_firestore_v1_Value> ReleaseValue() {
+    return std::move(value_);
+  }
+
   bool IsErrorOrUnset() const {
     return type_ == ResultType::kError || type_ == ResultType::kUnset;
   }
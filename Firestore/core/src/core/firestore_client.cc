@@ -16,10 +16,14 @@
 
 #include "Firestore/core/src/core/firestore_client.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <future>
+#include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "Firestore/core/src/api/document_reference.h"
@@ -39,11 +43,13 @@
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_store_snapshot.h"
 #include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/proto_sizer.h"
 #include "Firestore/core/src/local/query_engine.h"
 #include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/startup_timings.h"
 #include "Firestore/core/src/model/aggregate_field.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/document.h"
@@ -56,6 +62,7 @@
 #include "Firestore/core/src/remote/remote_store.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/background_queue.h"
 #include "Firestore/core/src/util/delayed_constructor.h"
 #include "Firestore/core/src/util/exception.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -81,10 +88,12 @@ using credentials::User;
 using firestore::Error;
 using local::LevelDbOpener;
 using local::LocalStore;
+using local::LocalStoreSnapshot;
 using local::LruParams;
 using local::MemoryPersistence;
 using local::QueryEngine;
 using local::QueryResult;
+using local::StartupTimings;
 using model::AggregateField;
 using model::Document;
 using model::DocumentKeySet;
@@ -99,6 +108,7 @@ using remote::FirebaseMetadataProvider;
 using remote::RemoteStore;
 using remote::Serializer;
 using util::AsyncQueue;
+using util::BackgroundQueue;
 using util::Empty;
 using util::Executor;
 using util::Status;
@@ -120,6 +130,38 @@ static const auto kInitialBackfillDelay = std::chrono::seconds(15);
 /** Minimum amount of time between backfill checks, after the first one. */
 static const auto kRegularBackfillDelay = std::chrono::minutes(1);
 
+StatusOr<DocumentSnapshot> DocumentSnapshotFromCache(
+    const DocumentReference& doc, const Document& document) {
+  if (document->is_found_document()) {
+    return DocumentSnapshot::FromDocument(
+        doc.firestore(), document,
+        SnapshotMetadata{document->has_local_mutations(),
+                         /*from_cache=*/true});
+  } else if (document->is_no_document()) {
+    return DocumentSnapshot::FromNoDocument(
+        doc.firestore(), doc.key(),
+        SnapshotMetadata{/*pending_writes=*/false,
+                         /*from_cache=*/true});
+  } else {
+    return Status{
+        Error::kErrorUnavailable,
+        "Failed to get document from cache. (However, this document "
+        "may exist on the server. Run again without setting source to "
+        "FirestoreSourceCache to attempt to retrieve the document "};
+  }
+}
+
+QuerySnapshot QuerySnapshotFromCache(const api::Query& query,
+                                     const DocumentMap& documents) {
+  ViewSnapshot snapshot =
+      View::ComputeInitialSnapshot(query.query(), documents);
+  SnapshotMetadata metadata(snapshot.has_pending_writes(),
+                            snapshot.from_cache());
+
+  return QuerySnapshot(query.firestore(), query.query(), std::move(snapshot),
+                       std::move(metadata));
+}
+
 }  // namespace
 
 std::shared_ptr<FirestoreClient> FirestoreClient::Create(
@@ -203,7 +245,9 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
 
   // Note: The initialization work must all be synchronous (we can't dispatch
   // more work) since external write/listen operations could get queued to run
-  // before that subsequent work completes.
+  // before that subsequent work completes. Work that staged startup defers is
+  // instead done by whichever operation first needs it.
+  auto open_start = std::chrono::steady_clock::now();
   if (settings.persistence_enabled()) {
     LevelDbOpener opener(database_info_);
 
@@ -218,6 +262,10 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
 
     auto ldb = std::move(created).ValueOrDie();
     lru_delegate_ = ldb->reference_delegate();
+    if (settings.decoded_document_cache_size_bytes() > 0) {
+      ldb->remote_document_cache()->EnableDocumentCache(
+          static_cast<size_t>(settings.decoded_document_cache_size_bytes()));
+    }
 
     persistence_ = std::move(ldb);
     if (settings.gc_enabled()) {
@@ -240,27 +288,80 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   } else {
     persistence_ = MemoryPersistence::WithEagerGarbageCollector();
   }
+  auto opened = std::chrono::steady_clock::now();
 
   query_engine_ = absl::make_unique<QueryEngine>();
   local_store_ = absl::make_unique<LocalStore>(persistence_.get(),
                                                query_engine_.get(), user);
+  local_store_->startup_timings()->Record(
+      StartupTimings::Phase::kOpenPersistence,
+      std::chrono::duration_cast<StartupTimings::Duration>(opened -
+                                                           open_start));
+  if (settings.staged_startup_enabled()) {
+    local_store_->EnableStagedStartup();
+  }
+  if (settings.sharded_execution_enabled()) {
+    decode_queue_ = AsyncQueue::Create(
+        Executor::CreateSerial("com.google.firebase.firestore.decode"));
+    event_queue_ = AsyncQueue::Create(
+        Executor::CreateSerial("com.google.firebase.firestore.events"));
+  }
+
   connectivity_monitor_ = ConnectivityMonitor::Create(worker_queue_);
   auto datastore = std::make_shared<Datastore>(
       database_info_, worker_queue_, auth_credentials_provider_,
       app_check_credentials_provider_, connectivity_monitor_.get(),
       firebase_metadata_provider_.get());
+  if (settings.message_compression() != Settings::MessageCompression::kNone) {
+    // A negative threshold would wrap around to a huge size_t and disable
+    // compression altogether; treat it as zero instead.
+    int64_t threshold_bytes =
+        std::max<int64_t>(0, settings.message_compression_threshold_bytes());
+    datastore->EnableMessageCompression(settings.message_compression(),
+                                        static_cast<size_t>(threshold_bytes));
+  }
+  if (decode_queue_) {
+    datastore->DecodeWatchResponsesOn(decode_queue_);
+  }
 
   remote_store_ = absl::make_unique<RemoteStore>(
       local_store_.get(), std::move(datastore), worker_queue_,
       connectivity_monitor_.get(), [this](OnlineState online_state) {
         sync_engine_->HandleOnlineStateChange(online_state);
       });
+  if (settings.max_coalesced_write_bytes() > 0) {
+    // Budgets too large for `size_t` can't be reached anyway.
+    uint64_t max_request_bytes =
+        std::min<uint64_t>(settings.max_coalesced_write_bytes(),
+                           std::numeric_limits<size_t>::max());
+    remote_store_->EnableWriteBatchCoalescing(
+        static_cast<size_t>(max_request_bytes));
+  }
 
   sync_engine_ =
       absl::make_unique<SyncEngine>(local_store_.get(), remote_store_.get(),
                                     user, kMaxConcurrentLimboResolutions);
+  if (settings.parallel_view_computation_enabled()) {
+    sync_engine_->EnableParallelViewComputation();
+  }
+
+  if (settings.concurrent_cache_reads_enabled()) {
+    auto hw_concurrency = std::thread::hardware_concurrency();
+    if (hw_concurrency == 0) {
+      // If the standard library doesn't know, guess something reasonable.
+      hw_concurrency = 4;
+    }
+    cache_reader_executor_ = Executor::CreateConcurrent(
+        "com.google.firebase.firestore.cache_reads",
+        static_cast<int>(hw_concurrency));
+    cache_reads_ =
+        absl::make_unique<BackgroundQueue>(cache_reader_executor_.get());
+  }
 
   event_manager_ = absl::make_unique<EventManager>(sync_engine_.get());
+  if (event_queue_) {
+    event_manager_->NotifyListenersOn(event_queue_);
+  }
 
   // Setup wiring for remote store.
   remote_store_->set_sync_engine(sync_engine_.get());
@@ -268,7 +369,10 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   // NOTE: RemoteStore depends on LocalStore (for persisting stream tokens,
   // refilling mutation queue, etc.) so must be started after LocalStore.
   local_store_->Start();
-  remote_store_->Start();
+  StartupTimings* timings = local_store_->startup_timings();
+  timings->Measure(StartupTimings::Phase::kStartRemoteStore,
+                   [&] { remote_store_->Start(); });
+  LOG_DEBUG("Started. Startup timings: %s", timings->ToString());
 
   ScheduleIndexBackfiller();
 }
@@ -305,6 +409,9 @@ void FirestoreClient::Dispose() {
   }
 
   worker_queue_->Dispose();
+  if (event_queue_) {
+    event_queue_->Dispose();
+  }
   user_executor_->Dispose();
 }
 
@@ -314,7 +421,14 @@ void FirestoreClient::TerminateAsync(StatusCallback callback) {
     TerminateInternal();
 
     if (callback) {
-      user_executor_->Execute([=] { callback(Status::OK()); });
+      // Report termination after the events raised before it.
+      auto user_executor = user_executor_;
+      auto notify = [user_executor, callback] {
+        user_executor->Execute([=] { callback(Status::OK()); });
+      };
+      if (!event_queue_ || !event_queue_->Enqueue(notify)) {
+        notify();
+      }
     }
   });
 }
@@ -333,9 +447,37 @@ void FirestoreClient::TerminateInternal() {
 
   backfiller_callback_.Cancel();
 
+  // Every read that was accepted before termination still calls its listener,
+  // and the snapshots they hold must be released before the database closes.
+  // Reads never wait on the worker queue, so this can't deadlock.
+  if (cache_reads_) {
+    cache_reads_->AwaitAll();
+    cache_reads_.reset();
+  }
+  if (cache_reader_executor_) {
+    cache_reader_executor_->Dispose();
+    cache_reader_executor_.reset();
+  }
+
+  // Responses still being decoded are for streams that are about to be shut
+  // down, so drop them.
+  if (decode_queue_) {
+    decode_queue_->Dispose();
+    decode_queue_.reset();
+  }
+
   remote_store_->Shutdown();
   persistence_->Shutdown();
 
+  // Events that have already been raised are still delivered: the event
+  // manager that raised them is handed to the event queue, which destroys it
+  // once they have been delivered. The event queue itself lives as long as
+  // this client.
+  if (event_queue_) {
+    std::shared_ptr<EventManager> event_manager = std::move(event_manager_);
+    event_queue_->Enqueue([event_manager] {});
+  }
+
   local_store_.reset();
   query_engine_.reset();
   event_manager_.reset();
@@ -352,6 +494,25 @@ void FirestoreClient::TerminateInternal() {
   connectivity_monitor_.reset();
 }
 
+void FirestoreClient::DeliverAfterEvents(std::function<void()> callback) {
+  auto user_executor = user_executor_;
+  auto deliver = [user_executor, callback] {
+    user_executor->Execute([callback] { callback(); });
+  };
+  if (event_manager_) {
+    event_manager_->RunAfterEvents(std::move(deliver));
+  } else {
+    deliver();
+  }
+}
+
+std::shared_ptr<LocalStoreSnapshot> FirestoreClient::TakeCacheSnapshot() {
+  if (!cache_reader_executor_) {
+    return nullptr;
+  }
+  return local_store_->TakeSnapshot();
+}
+
 void FirestoreClient::ScheduleLruGarbageCollection() {
   std::chrono::milliseconds delay =
       gc_has_run_ ? kRegularGCDelay : kInitialGCDelay;
@@ -404,7 +565,7 @@ void FirestoreClient::WaitForPendingWrites(StatusCallback callback) {
   // Dispatch the result back onto the user dispatch queue.
   auto async_callback = [this, callback](util::Status status) {
     if (callback) {
-      user_executor_->Execute([=] { callback(std::move(status)); });
+      DeliverAfterEvents([=] { callback(std::move(status)); });
     }
   };
 
@@ -462,31 +623,24 @@ void FirestoreClient::GetDocumentFromLocalCache(
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
   worker_queue_->Enqueue([this, doc, shared_callback] {
-    Document document = local_store_->ReadDocument(doc.key());
-    StatusOr<DocumentSnapshot> maybe_snapshot;
-
-    if (document->is_found_document()) {
-      maybe_snapshot = DocumentSnapshot::FromDocument(
-          doc.firestore(), document,
-          SnapshotMetadata{document->has_local_mutations(),
-                           /*from_cache=*/true});
-    } else if (document->is_no_document()) {
-      maybe_snapshot = DocumentSnapshot::FromNoDocument(
-          doc.firestore(), doc.key(),
-          SnapshotMetadata{/*pending_writes=*/false,
-                           /*from_cache=*/true});
-    } else {
-      maybe_snapshot =
-          Status{Error::kErrorUnavailable,
-                 "Failed to get document from cache. (However, this document "
-                 "may exist on the server. Run again without setting source to "
-                 "FirestoreSourceCache to attempt to retrieve the document "};
-    }
+    auto deliver = [this, shared_callback](
+                       StatusOr<DocumentSnapshot> maybe_snapshot) {
+      if (shared_callback) {
+        user_executor_->Execute(
+            [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
+      }
+    };
 
-    if (shared_callback) {
-      user_executor_->Execute(
-          [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
+    std::shared_ptr<LocalStoreSnapshot> cache = TakeCacheSnapshot();
+    if (cache) {
+      cache_reads_->Execute([doc, cache, deliver] {
+        deliver(DocumentSnapshotFromCache(doc, cache->ReadDocument(doc.key())));
+      });
+      return;
     }
+
+    deliver(
+        DocumentSnapshotFromCache(doc, local_store_->ReadDocument(doc.key())));
   });
 }
 
@@ -497,30 +651,31 @@ void FirestoreClient::GetDocumentsFromLocalCache(
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
   worker_queue_->Enqueue([this, query, shared_callback] {
-    QueryResult query_result = local_store_->ExecuteQuery(
-        QueryOrPipeline(query.query()), /* use_previous_results= */ true);
-
-    View view(QueryOrPipeline(query.query()), query_result.remote_keys());
-    ViewDocumentChanges view_doc_changes =
-        view.ComputeDocumentChanges(query_result.documents());
-    ViewChange view_change = view.ApplyChanges(view_doc_changes);
-    HARD_ASSERT(
-        view_change.limbo_changes().empty(),
-        "View returned limbo documents during local-only query execution.");
-
-    HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
-
-    ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
-    SnapshotMetadata metadata(snapshot.has_pending_writes(),
-                              snapshot.from_cache());
-
-    QuerySnapshot result(query.firestore(), query.query(), std::move(snapshot),
-                         std::move(metadata));
+    auto deliver = [this, shared_callback](QuerySnapshot result) {
+      if (shared_callback) {
+        user_executor_->Execute(
+            [=] { shared_callback->OnEvent(std::move(result)); });
+      }
+    };
 
-    if (shared_callback) {
-      user_executor_->Execute(
-          [=] { shared_callback->OnEvent(std::move(result)); });
+    // Snapshots can't look up the collections of a collection group.
+    std::shared_ptr<LocalStoreSnapshot> cache;
+    if (!query.query().IsCollectionGroupQuery()) {
+      cache = TakeCacheSnapshot();
+    }
+    if (cache) {
+      // Without target data, the documents are matched by a full scan of the
+      // query's collection, which is what the query engine falls back to.
+      cache_reads_->Execute([query, cache, deliver] {
+        deliver(
+            QuerySnapshotFromCache(query, cache->ExecuteQuery(query.query())));
+      });
+      return;
     }
+
+    QueryResult query_result = local_store_->ExecuteQuery(
+        QueryOrPipeline(query.query()), /* use_previous_results= */ true);
+    deliver(QuerySnapshotFromCache(query, query_result.documents()));
   });
 }
 
@@ -532,14 +687,15 @@ void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
   worker_queue_->Enqueue([this, mutations, callback]() mutable {
     if (mutations.empty()) {
       if (callback) {
-        user_executor_->Execute([=] { callback(Status::OK()); });
+        DeliverAfterEvents([=] { callback(Status::OK()); });
       }
     } else {
       sync_engine_->WriteMutations(
           std::move(mutations), [this, callback](Status error) {
-            // Dispatch the result back onto the user dispatch queue.
+            // Dispatch the result back onto the user dispatch queue, after
+            // the latency-compensated snapshots for the write.
             if (callback) {
-              user_executor_->Execute([=] { callback(std::move(error)); });
+              DeliverAfterEvents([=] { callback(std::move(error)); });
             }
           });
     }
@@ -554,7 +710,7 @@ void FirestoreClient::Transaction(int max_attempts,
   // Dispatch the result back onto the user dispatch queue.
   auto async_callback = [this, result_callback](Status status) {
     if (result_callback) {
-      user_executor_->Execute([=] { result_callback(std::move(status)); });
+      DeliverAfterEvents([=] { result_callback(std::move(status)); });
     }
   };
 
@@ -31,6 +31,7 @@
 #include "Firestore/core/src/credentials/credentials_fwd.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/background_queue.h"
 #include "Firestore/core/src/util/byte_stream.h"
 #include "Firestore/core/src/util/delayed_constructor.h"
 #include "Firestore/core/src/util/empty.h"
@@ -43,6 +44,7 @@ namespace firestore {
 
 namespace local {
 class LocalStore;
+class LocalStoreSnapshot;
 class LruDelegate;
 class Persistence;
 class QueryEngine;
@@ -224,6 +226,12 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void TerminateInternal();
 
+  /**
+   * Runs `callback` on the user executor, after the snapshots raised so far
+   * have been handed to it.
+   */
+  void DeliverAfterEvents(std::function<void()> callback);
+
   /**
    * Schedules a callback to try running LRU garbage collection. Reschedules
    * itself after the GC has run.
@@ -236,6 +244,13 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
    */
   void ScheduleIndexBackfiller();
 
+  /**
+   * Returns a snapshot of the local store for a cache-only read to run on the
+   * cache reader executor, or null if the read should run on the worker queue
+   * instead.
+   */
+  std::shared_ptr<local::LocalStoreSnapshot> TakeCacheSnapshot();
+
   DatabaseInfo database_info_;
   std::shared_ptr<credentials::AppCheckCredentialsProvider>
       app_check_credentials_provider_;
@@ -251,6 +266,31 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   std::shared_ptr<util::AsyncQueue> worker_queue_;
   std::shared_ptr<util::Executor> user_executor_;
 
+  /**
+   * With sharded execution, the worker queue hands work off to two more
+   * queues, and everything else stays on the worker queue:
+   *
+   *   - Watch stream responses are decoded on `decode_queue_`, and handed back
+   *     to the worker queue in the order they arrived (see
+   *     `Stream::DecodeResponsesOn`).
+   *   - Listeners are called on `event_queue_`, in the order the worker queue
+   *     raised their events (see `EventManager::NotifyListenersOn`).
+   *
+   * Writes, and the local store they go through, never leave the worker
+   * queue, so they keep their order. Both queues are null unless enabled.
+   */
+  std::shared_ptr<util::AsyncQueue> decode_queue_;
+  std::shared_ptr<util::AsyncQueue> event_queue_;
+
+  /**
+   * Runs cache-only reads against snapshots of the local store, so that they
+   * neither wait for nor hold up the worker queue. Reads are submitted through
+   * `cache_reads_`, which lets termination wait for them. Both are null unless
+   * enabled.
+   */
+  std::unique_ptr<util::Executor> cache_reader_executor_;
+  std::unique_ptr<util::BackgroundQueue> cache_reads_;
+
   std::unique_ptr<remote::FirebaseMetadataProvider> firebase_metadata_provider_;
 
   std::unique_ptr<local::Persistence> persistence_;
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,14 +29,15 @@
 #include "Firestore/core/src/api/stages.h"
 #include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/expressions_eval.h"
+#include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/filter.h"
 #include "Firestore/core/src/core/order_by.h"
-#include "Firestore/core/src/core/pipeline_run.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/comparison.h"
@@ -109,8 +111,8 @@ std::vector<std::shared_ptr<api::EvaluableStage>> RewriteStages(
         copy.push_back(NewKeyOrdering());
         new_stages.push_back(std::make_shared<api::SortStage>(std::move(copy)));
       }
-    } else if (stage->name() ==
-               "limit") {  // For stages whose semantics depend on ordering
+    } else if (stage->name() == "limit" || stage->name() == "offset") {
+      // For stages whose semantics depend on ordering
       if (!has_order) {
         new_stages.push_back(std::make_shared<api::SortStage>(
             std::vector<api::Ordering>{NewKeyOrdering()}));
@@ -172,6 +174,17 @@ std::string CanonifySortOrderings(const std::vector<api::Ordering>& orders) {
   return absl::StrJoin(entries, ",");
 }
 
+// Canonicalizes named expressions, such as the fields of a select stage, in
+// the order of their names.
+std::string CanonifyNamedExprs(
+    const std::unordered_map<std::string, std::shared_ptr<api::Expr>>& exprs) {
+  std::map<std::string, std::string> entries;
+  for (const auto& entry : exprs) {
+    entries.emplace(entry.first, CanonifyExpr(entry.second.get()));
+  }
+  return absl::StrJoin(entries, ",", absl::PairFormatter("="));
+}
+
 std::string CanonifyStage(const std::shared_ptr<api::EvaluableStage>& stage) {
   HARD_ASSERT(stage != nullptr, "Canonify a null stage");
 
@@ -202,6 +215,38 @@ std::string CanonifyStage(const std::shared_ptr<api::EvaluableStage>& stage) {
   } else if (auto limit_stage =
                  std::dynamic_pointer_cast<api::LimitStage>(stage)) {
     return absl::StrFormat("%s(%d)", limit_stage->name(), limit_stage->limit());
+  } else if (auto offset_stage =
+                 std::dynamic_pointer_cast<api::OffsetStage>(stage)) {
+    return absl::StrFormat("%s(%d)", offset_stage->name(),
+                           offset_stage->offset());
+  } else if (auto select_stage =
+                 std::dynamic_pointer_cast<api::SelectStage>(stage)) {
+    return absl::StrFormat("%s(%s)", select_stage->name(),
+                           CanonifyNamedExprs(select_stage->fields()));
+  } else if (auto add_fields =
+                 std::dynamic_pointer_cast<api::AddFields>(stage)) {
+    return absl::StrFormat("%s(%s)", add_fields->name(),
+                           CanonifyNamedExprs(add_fields->fields()));
+  } else if (auto remove_fields =
+                 std::dynamic_pointer_cast<api::RemoveFieldsStage>(stage)) {
+    std::vector<std::string> fields;
+    for (const auto& field : remove_fields->fields()) {
+      fields.push_back(CanonifyExpr(&field));
+    }
+    return absl::StrFormat("%s(%s)", remove_fields->name(),
+                           absl::StrJoin(fields, ","));
+  } else if (auto distinct_stage =
+                 std::dynamic_pointer_cast<api::DistinctStage>(stage)) {
+    return absl::StrFormat("%s(%s)", distinct_stage->name(),
+                           CanonifyNamedExprs(distinct_stage->groups()));
+  } else if (auto unnest = std::dynamic_pointer_cast<api::Unnest>(stage)) {
+    std::vector<std::string> params = {CanonifyExpr(unnest->field()),
+                                       CanonifyExpr(unnest->alias())};
+    if (unnest->index_field() != nullptr) {
+      params.push_back(CanonifyExpr(unnest->index_field()));
+    }
+    return absl::StrFormat("%s(%s)", unnest->name(),
+                           absl::StrJoin(params, ","));
   }
 
   HARD_FAIL(absl::StrFormat("Trying to canonify an unrecognized stage type %s",
@@ -274,8 +319,9 @@ TargetOrPipeline QueryOrPipeline::ToTargetOrPipeline() const {
 bool QueryOrPipeline::MatchesAllDocuments() const {
   if (IsPipeline()) {
     for (const auto& stage : pipeline().rewritten_stages()) {
-      // Check for LimitStage
-      if (stage->name() == "limit") {
+      // Check for stages that drop or combine documents
+      if (stage->name() == "limit" || stage->name() == "offset" ||
+          stage->name() == "distinct" || stage->name() == "unnest") {
         return false;
       }
 
@@ -297,8 +343,8 @@ bool QueryOrPipeline::MatchesAllDocuments() const {
         }
         return false;  // Any other Where stage means it filters documents
       }
-      // TODO(pipeline) : Add checks for other filtering stages like Aggregate,
-      // Distinct, FindNearest once they are implemented in C++.
+      // TODO(pipeline) : Add checks for other filtering stages like Aggregate
+      // and FindNearest once they are implemented in C++.
     }
     return true;  // No filtering stages found (besides allowed ones)
   }
@@ -325,9 +371,17 @@ bool QueryOrPipeline::has_limit() const {
 
 bool QueryOrPipeline::Matches(const model::Document& doc) const {
   if (IsPipeline()) {
-    const auto result = RunPipeline(
-        const_cast<api::RealtimePipeline&>(this->pipeline()), {doc.get()});
-    return result.size() > 0;
+    const api::EvaluateContext context = pipeline().evaluate_context();
+    model::PipelineInputOutputVector result{doc.get()};
+    for (const auto& stage : pipeline().rewritten_stages()) {
+      // An offset skips documents by their position among all results, which
+      // says nothing about whether a single document matches.
+      if (stage->name() == "offset") {
+        continue;
+      }
+      result = stage->Evaluate(context, result);
+    }
+    return !result.empty();
   }
 
   return query().Matches(doc);
@@ -429,6 +483,12 @@ PipelineFlavor GetPipelineFlavor(const api::RealtimePipeline&) {
   return PipelineFlavor::kExact;
 }
 
+bool IsListenableStage(const api::EvaluableStage& stage) {
+  const std::string& name = stage.name();
+  return name != "distinct" && name != "unnest" && name != "select" &&
+         name != "add_fields" && name != "remove_fields" && name != "offset";
+}
+
 PipelineSourceType GetPipelineSourceType(
     const api::RealtimePipeline& pipeline) {
   HARD_ASSERT(!pipeline.stages().empty(),
@@ -540,6 +600,162 @@ absl::optional<int64_t> GetLastEffectiveLimit(
   return absl::nullopt;
 }
 
+// --- ToIndexTarget and helpers ---
+
+namespace {  // Anonymous namespace for ToIndexTarget helpers
+
+// The operator of the FieldFilter that keeps the same documents as the named
+// comparison of a field with a constant. Comparisons that can keep documents
+// without the field, such as `not_equal`, have none: no FieldFilter keeps
+// those.
+absl::optional<FieldFilter::Operator> ToFilterOperator(
+    const std::string& function_name) {
+  using Operator = FieldFilter::Operator;
+  static const auto* operators =
+      new std::unordered_map<std::string, Operator>{
+          {"equal", Operator::Equal},
+          {"less_than", Operator::LessThan},
+          {"less_than_or_equal", Operator::LessThanOrEqual},
+          {"greater_than", Operator::GreaterThan},
+          {"greater_than_or_equal", Operator::GreaterThanOrEqual},
+          {"array_contains", Operator::ArrayContains},
+          {"equal_any", Operator::In},
+          {"array_contains_any", Operator::ArrayContainsAny},
+      };
+  auto found = operators->find(function_name);
+  if (found == operators->end()) {
+    return absl::nullopt;
+  }
+  return found->second;
+}
+
+// The operator to use when the constant comes before the field, as in
+// `1 < a`, or nullopt if the operands can't be swapped.
+absl::optional<FieldFilter::Operator> SwapOperands(FieldFilter::Operator op) {
+  using Operator = FieldFilter::Operator;
+  switch (op) {
+    case Operator::Equal:
+      return Operator::Equal;
+    case Operator::LessThan:
+      return Operator::GreaterThan;
+    case Operator::LessThanOrEqual:
+      return Operator::GreaterThanOrEqual;
+    case Operator::GreaterThan:
+      return Operator::LessThan;
+    case Operator::GreaterThanOrEqual:
+      return Operator::LessThanOrEqual;
+    default:
+      return absl::nullopt;
+  }
+}
+
+// Pipelines never match null or NaN through a comparison, while FieldFilters
+// give both special meanings, so constants holding them aren't translated.
+bool IsIndexableConstant(FieldFilter::Operator op,
+                         const google_firestore_v1_Value& value) {
+  if (op == FieldFilter::Operator::In ||
+      op == FieldFilter::Operator::ArrayContainsAny) {
+    if (!model::IsArray(value) || value.array_value.values_count == 0) {
+      return false;
+    }
+    for (pb_size_t i = 0; i < value.array_value.values_count; ++i) {
+      const google_firestore_v1_Value& element = value.array_value.values[i];
+      if (model::IsNullValue(element) || model::IsNaNValue(element)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return !model::IsNullValue(value) && !model::IsNaNValue(value);
+}
+
+absl::optional<FieldFilter> ToIndexFilter(const api::Expr* expr) {
+  const auto* function = dynamic_cast<const api::FunctionExpr*>(expr);
+  if (function == nullptr || function->params().size() != 2) {
+    return absl::nullopt;
+  }
+  absl::optional<FieldFilter::Operator> op =
+      ToFilterOperator(function->name());
+  if (!op) {
+    return absl::nullopt;
+  }
+
+  const api::Expr* lhs = function->params()[0].get();
+  const api::Expr* rhs = function->params()[1].get();
+  const auto* field = dynamic_cast<const api::Field*>(lhs);
+  const auto* constant = dynamic_cast<const api::Constant*>(rhs);
+  if (field == nullptr || constant == nullptr) {
+    field = dynamic_cast<const api::Field*>(rhs);
+    constant = dynamic_cast<const api::Constant*>(lhs);
+    op = SwapOperands(*op);
+    if (field == nullptr || constant == nullptr || !op) {
+      return absl::nullopt;
+    }
+  }
+
+  if (field->field_path().IsKeyFieldPath() ||
+      !IsIndexableConstant(*op, constant->value())) {
+    return absl::nullopt;
+  }
+  return FieldFilter::Create(field->field_path(), *op,
+                             model::DeepClone(constant->value()));
+}
+
+// Adds a filter for every conjunct of `expr` that has one. Leaving the others
+// out only widens the set of documents the filters keep.
+void AddIndexFilters(const api::Expr* expr, std::vector<FieldFilter>* filters) {
+  const auto* function = dynamic_cast<const api::FunctionExpr*>(expr);
+  if (function != nullptr && function->name() == "and") {
+    for (const auto& param : function->params()) {
+      AddIndexFilters(param.get(), filters);
+    }
+    return;
+  }
+
+  absl::optional<FieldFilter> filter = ToIndexFilter(expr);
+  if (filter) {
+    filters->push_back(*std::move(filter));
+  }
+}
+
+}  // anonymous namespace
+
+absl::optional<Target> ToIndexTarget(const api::RealtimePipeline& pipeline) {
+  Query query;
+  switch (GetPipelineSourceType(pipeline)) {
+    case PipelineSourceType::kCollection:
+      query = Query(
+          model::ResourcePath::FromString(*GetPipelineCollection(pipeline)));
+      break;
+    case PipelineSourceType::kCollectionGroup:
+      query = Query(model::ResourcePath::Empty(),
+                    *GetPipelineCollectionGroup(pipeline));
+      break;
+    default:
+      return absl::nullopt;
+  }
+
+  std::vector<FieldFilter> filters;
+  const auto& stages = pipeline.rewritten_stages();
+  for (size_t i = 1; i < stages.size(); ++i) {
+    if (auto where = std::dynamic_pointer_cast<api::Where>(stages[i])) {
+      AddIndexFilters(where->expr(), &filters);
+    } else if (stages[i]->name() != "sort") {
+      // Past a limit, conditions only apply to the documents the limit kept,
+      // and past a projection they may not refer to stored fields at all.
+      break;
+    }
+  }
+
+  if (filters.empty()) {
+    return absl::nullopt;
+  }
+  for (FieldFilter& filter : filters) {
+    query = query.AddingFilter(std::move(filter));
+  }
+  return query.ToTarget();
+}
+
 // --- ToPipelineStages and helpers ---
 
 namespace {  // Anonymous namespace for ToPipelineStages helpers
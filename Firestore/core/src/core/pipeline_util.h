@@ -160,6 +160,12 @@ enum class PipelineSourceType {
 // Determines the flavor of the given pipeline based on its stages.
 PipelineFlavor GetPipelineFlavor(const api::RealtimePipeline& pipeline);
 
+// Whether the given stage can be part of a pipeline that is listened to.
+// Views key their results by source document and only know how to window them
+// with a limit, so stages that reshape, merge or skip results can be evaluated
+// locally but not listened to.
+bool IsListenableStage(const api::EvaluableStage& stage);
+
 // Determines the source type of the given pipeline based on its first stage.
 PipelineSourceType GetPipelineSourceType(const api::RealtimePipeline& pipeline);
 
@@ -184,6 +190,20 @@ api::RealtimePipeline AsCollectionPipelineAtPath(
 absl::optional<int64_t> GetLastEffectiveLimit(
     const api::RealtimePipeline& pipeline);
 
+/**
+ * Translates the filters at the start of the pipeline into a Target that can
+ * be served from the local indexes.
+ *
+ * Every document the pipeline keeps matches the returned target, but not the
+ * other way around: conditions without a FieldFilter equivalent are left out,
+ * and so are sorts and limits. Documents looked up through the target must
+ * still be run through the pipeline.
+ *
+ * @return The target, or nullopt if the pipeline doesn't read a collection or
+ *     collection group, or if none of its filters can be translated.
+ */
+absl::optional<Target> ToIndexTarget(const api::RealtimePipeline& pipeline);
+
 /**
  * Converts a core::Query into a sequence of pipeline stages.
  *
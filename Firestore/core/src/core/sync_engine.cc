@@ -16,9 +16,12 @@
 
 #include "Firestore/core/src/core/sync_engine.h"
 
+#include <thread>
+
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
 #include "Firestore/core/src/bundle/bundle_element.h"
 #include "Firestore/core/src/bundle/bundle_loader.h"
+#include "Firestore/core/src/core/document_change_router.h"
 #include "Firestore/core/src/core/pipeline_util.h"
 #include "Firestore/core/src/core/sync_engine_callback.h"
 #include "Firestore/core/src/core/transaction.h"
@@ -72,6 +75,7 @@ using model::TargetId;
 using remote::RemoteEvent;
 using remote::TargetChange;
 using util::AsyncQueue;
+using util::Executor;
 using util::Status;
 using util::StatusCallback;
 
@@ -516,20 +520,45 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
   std::vector<ViewSnapshot> new_snapshots;
   std::vector<LocalViewChanges> document_changes_in_all_views;
 
+  // Only hand each view the changes from the collection it listens to, rather
+  // than having every view evaluate every changed document.
+  DocumentChangeRouter router(changes);
+
+  // Views are independent of each other, so each phase below that only touches
+  // a single view may run in parallel. Everything that touches the LocalStore
+  // or SyncEngine state runs on the worker queue, in view iteration order.
+  std::vector<QueryView*> query_views;
+  std::vector<const DocumentMap*> view_changes_input;
+  query_views.reserve(query_views_by_query_.size());
+  view_changes_input.reserve(query_views_by_query_.size());
   for (const auto& entry : query_views_by_query_) {
-    const auto& query_view = entry.second;
-    View& view = query_view->view();
-    ViewDocumentChanges view_doc_changes = view.ComputeDocumentChanges(changes);
-    if (view_doc_changes.needs_refill()) {
+    QueryView* query_view = entry.second.get();
+    query_views.push_back(query_view);
+    view_changes_input.push_back(&router.ChangesFor(query_view->query()));
+  }
+
+  std::vector<absl::optional<ViewDocumentChanges>> view_doc_changes(
+      query_views.size());
+  ForEachView(query_views.size(), [&](size_t i) {
+    view_doc_changes[i] =
+        query_views[i]->view().ComputeDocumentChanges(*view_changes_input[i]);
+  });
+
+  for (size_t i = 0; i < query_views.size(); ++i) {
+    if (view_doc_changes[i]->needs_refill()) {
       // The query has a limit and some docs were removed/updated, so we need to
       // re-run the query against the local store to make sure we didn't lose
       // any good docs that had been past the limit.
       QueryResult query_result = local_store_->ExecuteQuery(
-          query_view->query(), /* use_previous_results= */ false);
-      view_doc_changes = view.ComputeDocumentChanges(query_result.documents(),
-                                                     view_doc_changes);
+          query_views[i]->query(), /* use_previous_results= */ false);
+      view_doc_changes[i] = query_views[i]->view().ComputeDocumentChanges(
+          query_result.documents(), view_doc_changes[i]);
     }
+  }
 
+  std::vector<absl::optional<ViewChange>> view_changes(query_views.size());
+  ForEachView(query_views.size(), [&](size_t i) {
+    QueryView* query_view = query_views[i];
     absl::optional<TargetChange> target_changes;
     bool targetIsPendingReset = false;
     if (maybe_remote_event.has_value()) {
@@ -547,16 +576,19 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
       }
     }
 
-    ViewChange view_change = view.ApplyChanges(view_doc_changes, target_changes,
-                                               targetIsPendingReset);
+    view_changes[i] = query_view->view().ApplyChanges(
+        *view_doc_changes[i], target_changes, targetIsPendingReset);
+  });
 
+  for (size_t i = 0; i < query_views.size(); ++i) {
+    const ViewChange& view_change = *view_changes[i];
     UpdateTrackedLimboDocuments(view_change.limbo_changes(),
-                                query_view->target_id());
+                                query_views[i]->target_id());
 
     if (view_change.snapshot().has_value()) {
       new_snapshots.push_back(*view_change.snapshot());
       LocalViewChanges doc_changes = LocalViewChanges::FromViewSnapshot(
-          *view_change.snapshot(), query_view->target_id());
+          *view_change.snapshot(), query_views[i]->target_id());
       document_changes_in_all_views.push_back(std::move(doc_changes));
     }
   }
@@ -565,6 +597,32 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
   local_store_->NotifyLocalViewChanges(document_changes_in_all_views);
 }
 
+void SyncEngine::EnableParallelViewComputation() {
+  if (view_executor_) {
+    return;
+  }
+
+  auto hw_concurrency = std::thread::hardware_concurrency();
+  if (hw_concurrency == 0) {
+    // If the standard library doesn't know, guess something reasonable.
+    hw_concurrency = 4;
+  }
+  view_executor_ = Executor::CreateConcurrent(
+      "com.google.firebase.firestore.views", static_cast<int>(hw_concurrency));
+}
+
+void SyncEngine::ForEachView(size_t count,
+                             const std::function<void(size_t)>& task) {
+  if (!view_executor_ || count < 2) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  view_executor_->ExecuteAll(count, task);
+}
+
 void SyncEngine::UpdateTrackedLimboDocuments(
     const std::vector<LimboDocumentChange>& limbo_changes, TargetId target_id) {
   for (const LimboDocumentChange& limbo_change : limbo_changes) {
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -35,6 +36,7 @@
 #include "Firestore/core/src/local/reference_set.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/random_access_queue.h"
 #include "Firestore/core/src/util/status.h"
 #include "absl/strings/string_view.h"
@@ -186,6 +188,13 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   void LoadBundle(std::shared_ptr<bundle::BundleReader> reader,
                   std::shared_ptr<api::LoadBundleTask> result_task);
 
+  /**
+   * Recomputes independent views in parallel on a pool of worker threads when
+   * a change affects more than one active query. Snapshots are still delivered
+   * to the callback in the same order as when views are recomputed serially.
+   */
+  void EnableParallelViewComputation();
+
   // For tests only
   std::map<model::DocumentKey, model::TargetId>
   GetActiveLimboDocumentResolutions() const {
@@ -276,6 +285,12 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
       const model::DocumentMap& changes,
       const absl::optional<remote::RemoteEvent>& maybe_remote_event);
 
+  /**
+   * Invokes `task` with every index in [0, count), on the view executor if
+   * parallel view computation is enabled, and returns once all have finished.
+   */
+  void ForEachView(size_t count, const std::function<void(size_t)>& task);
+
   /** Updates the limbo document state for the given target_id. */
   void UpdateTrackedLimboDocuments(
       const std::vector<LimboDocumentChange>& limbo_changes,
@@ -369,6 +384,12 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   /** Used to track any documents that are currently in limbo. */
   local::ReferenceSet limbo_document_refs_;
+
+  /**
+   * Worker pool used to recompute views in parallel, or null if views are
+   * recomputed serially on the worker queue.
+   */
+  std::unique_ptr<util::Executor> view_executor_;
 };
 
 }  // namespace core
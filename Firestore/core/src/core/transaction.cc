@@ -17,6 +17,7 @@
 #include "Firestore/core/src/core/transaction.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <unordered_set>
 #include <utility>
@@ -98,26 +99,33 @@ void Transaction::Lookup(const std::vector<DocumentKey>& keys,
     return;
   }
 
+  // Each document is recorded as soon as it has been decoded, so that the
+  // responses of a large read are never buffered in full. Results are handed
+  // to the callback sorted by key.
+  auto documents = std::make_shared<std::map<DocumentKey, Document>>();
+
   datastore->LookupDocuments(
       keys,
-      [this, callback](const StatusOr<std::vector<Document>>& maybe_documents) {
-        if (!maybe_documents.ok()) {
-          callback(maybe_documents.status());
+      [this, documents](Document doc) {
+        Status record_error = RecordVersion(doc);
+        if (record_error.ok()) {
+          DocumentKey key = doc->key();
+          (*documents)[std::move(key)] = std::move(doc);
+        }
+        return record_error;
+      },
+      [documents, callback](const Status& status) {
+        if (!status.ok()) {
+          callback(status);
           return;
         }
 
-        const auto& documents = maybe_documents.ValueOrDie();
-        for (const Document& doc : documents) {
-          Status record_error = RecordVersion(doc);
-          if (!record_error.ok()) {
-            callback(record_error);
-            return;
-          }
+        std::vector<Document> result;
+        result.reserve(documents->size());
+        for (auto& kv : *documents) {
+          result.push_back(std::move(kv.second));
         }
-
-        // TODO(varconst): see if `maybe_documents` can be moved into the
-        // callback.
-        callback(maybe_documents);
+        callback(StatusOr<std::vector<Document>>{std::move(result)});
       });
 }
 
@@ -177,7 +177,7 @@ void ParseContext::ValidatePath() const {
   if (!path_) {
     return;
   }
-  for (const std::string& segment : *path_) {
+  for (absl::string_view segment : *path_) {
     ValidatePathSegment(segment);
   }
 }
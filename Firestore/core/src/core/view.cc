@@ -19,6 +19,7 @@
 #include <algorithm>  // For std::sort
 #include <utility>
 #include <valarray>
+#include <vector>
 
 #include "Firestore/core/src/core/pipeline_run.h"
 #include "Firestore/core/src/core/target.h"
@@ -152,6 +153,13 @@ View::View(QueryOrPipeline query, DocumentKeySet remote_documents)
       document_set_(query_.Comparator()),  // QueryOrPipeline must provide a
                                            // valid comparator
       synced_documents_(std::move(remote_documents)) {
+  if (query_.IsPipeline()) {
+    for (const auto& stage : query_.pipeline().stages()) {
+      HARD_ASSERT(IsListenableStage(*stage),
+                  "Stage %s is not supported in realtime pipelines",
+                  stage->name());
+    }
+  }
 }
 
 ComparisonResult View::Compare(const Document& lhs, const Document& rhs) const {
@@ -199,7 +207,9 @@ ViewDocumentChanges View::ComputeDocumentChanges(
     bool change_applied = false;
     // Calculate change
     if (old_doc && new_doc) {
-      bool docs_equal = (*old_doc)->value() == (*new_doc)->value();
+      // Compares the cached content fingerprints before falling back to a
+      // deep comparison of the document contents.
+      bool docs_equal = (*old_doc)->data() == (*new_doc)->data();
       if (!docs_equal) {
         if (!ShouldWaitForSyncedDocument(*new_doc, *old_doc)) {
           change_set.AddChange(
@@ -312,6 +322,55 @@ ViewDocumentChanges View::ComputeDocumentChanges(
                              new_mutated_keys, needs_refill);
 }
 
+ViewSnapshot View::ComputeInitialSnapshot(const Query& query,
+                                          const DocumentMap& docs) {
+  std::vector<Document> results;
+  for (const auto& kv : docs) {
+    if (query.Matches(kv.second)) {
+      results.push_back(kv.second);
+    }
+  }
+
+  model::DocumentComparator comparator = query.Comparator();
+  auto ascending = [&comparator](const Document& lhs, const Document& rhs) {
+    return util::Ascending(comparator.Compare(lhs, rhs));
+  };
+  if (query.has_limit() &&
+      static_cast<size_t>(query.limit()) < results.size()) {
+    // Only the documents within the limit need to be sorted.
+    auto limit = static_cast<size_t>(query.limit());
+    if (query.has_limit_to_first()) {
+      std::partial_sort(results.begin(), results.begin() + limit,
+                        results.end(), ascending);
+      results.resize(limit);
+    } else {
+      std::partial_sort(
+          results.begin(), results.begin() + limit, results.end(),
+          [&](const Document& lhs, const Document& rhs) {
+            return ascending(rhs, lhs);
+          });
+      results.resize(limit);
+      std::reverse(results.begin(), results.end());
+    }
+  } else {
+    std::sort(results.begin(), results.end(), ascending);
+  }
+
+  DocumentKeySet mutated_keys;
+  for (const Document& doc : results) {
+    if (doc->has_local_mutations()) {
+      mutated_keys = mutated_keys.insert(doc->key());
+    }
+  }
+
+  DocumentSet documents =
+      DocumentSet::FromDocuments(std::move(comparator), std::move(results));
+  return ViewSnapshot::FromInitialDocuments(
+      QueryOrPipeline(query), std::move(documents), std::move(mutated_keys),
+      /*from_cache=*/true, /*excludes_metadata_changes=*/false,
+      /*has_cached_results=*/false);
+}
+
 bool View::ShouldWaitForSyncedDocument(const Document& new_doc,
                                        const Document& old_doc) const {
   // We suppress the initial change event for documents that were modified as
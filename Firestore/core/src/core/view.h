@@ -179,6 +179,15 @@ class View {
       const absl::optional<remote::TargetChange>& target_change = absl::nullopt,
       bool targetIsPendingReset = false);
 
+  /**
+   * Returns the snapshot of a one-shot read of `docs` by `query`: the same
+   * snapshot as applying `docs` to a new view of the query, without the diff
+   * against an empty view. The matching documents are sorted in bulk, and the
+   * snapshot's document changes are only created if asked for.
+   */
+  static ViewSnapshot ComputeInitialSnapshot(const Query& query,
+                                             const model::DocumentMap& docs);
+
   /**
    * Applies an OnlineState change to the view, potentially generating an
    * ViewChange if the view's sync_state_ changes as a result.
@@ -148,12 +148,13 @@ ViewSnapshot::ViewSnapshot(QueryOrPipeline query,
     : query_{std::move(query)},
       documents_{std::move(documents)},
       old_documents_{std::move(old_documents)},
-      document_changes_{std::move(document_changes)},
+      document_changes_{std::make_shared<DocumentChanges>()},
       mutated_keys_{std::move(mutated_keys)},
       from_cache_{from_cache},
       sync_state_changed_{sync_state_changed},
       excludes_metadata_changes_{excludes_metadata_changes},
       has_cached_results_{has_cached_results} {
+  document_changes_->changes = std::move(document_changes);
 }
 
 ViewSnapshot ViewSnapshot::FromInitialDocuments(QueryOrPipeline query,
@@ -162,21 +163,31 @@ ViewSnapshot ViewSnapshot::FromInitialDocuments(QueryOrPipeline query,
                                                 bool from_cache,
                                                 bool excludes_metadata_changes,
                                                 bool has_cached_results) {
-  std::vector<DocumentViewChange> view_changes;
-  for (const Document& doc : documents) {
-    view_changes.emplace_back(doc, DocumentViewChange::Type::Added);
-  }
-
   DocumentSet old_documents(query.Comparator());
-  return ViewSnapshot{std::move(query),
-                      documents,
-                      old_documents,
-                      std::move(view_changes),
-                      std::move(mutated_keys),
-                      from_cache,
-                      /*sync_state_changed=*/true,
-                      excludes_metadata_changes,
-                      has_cached_results};
+  ViewSnapshot snapshot{std::move(query),
+                        std::move(documents),
+                        std::move(old_documents),
+                        /*document_changes=*/{},
+                        std::move(mutated_keys),
+                        from_cache,
+                        /*sync_state_changed=*/true,
+                        excludes_metadata_changes,
+                        has_cached_results};
+  snapshot.all_documents_added_ = true;
+  return snapshot;
+}
+
+const std::vector<DocumentViewChange>& ViewSnapshot::document_changes() const {
+  if (all_documents_added_) {
+    std::call_once(document_changes_->created, [this] {
+      std::vector<DocumentViewChange>& changes = document_changes_->changes;
+      changes.reserve(documents_.size());
+      for (const Document& doc : documents_) {
+        changes.emplace_back(doc, DocumentViewChange::Type::Added);
+      }
+    });
+  }
+  return document_changes_->changes;
 }
 
 const QueryOrPipeline& ViewSnapshot::query_or_pipeline() const {
@@ -20,6 +20,7 @@
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -110,7 +111,7 @@ class ViewSnapshot {
 
   /**
    * Returns a view snapshot as if all documents in the snapshot were
-   * added.
+   * added. The corresponding document changes are only created if asked for.
    */
   static ViewSnapshot FromInitialDocuments(QueryOrPipeline query,
                                            model::DocumentSet documents,
@@ -133,9 +134,7 @@ class ViewSnapshot {
   }
 
   /** The set of changes that have been applied to the documents. */
-  const std::vector<DocumentViewChange>& document_changes() const {
-    return document_changes_;
-  }
+  const std::vector<DocumentViewChange>& document_changes() const;
 
   /** Whether any document in the snapshot was served from the local cache. */
   bool from_cache() const {
@@ -176,7 +175,17 @@ class ViewSnapshot {
 
   model::DocumentSet documents_;
   model::DocumentSet old_documents_;
-  std::vector<DocumentViewChange> document_changes_;
+
+  // Snapshots of initial documents create their changes on first use, so that
+  // one-shot reads that never look at them don't pay for them. Copies of the
+  // snapshot share them.
+  struct DocumentChanges {
+    std::once_flag created;
+    std::vector<DocumentViewChange> changes;
+  };
+  std::shared_ptr<DocumentChanges> document_changes_;
+  bool all_documents_added_ = false;
+
   model::DocumentKeySet mutated_keys_;
 
   bool from_cache_ = false;
@@ -152,6 +152,18 @@ class ArraySortedMap : public SortedMapBase {
       : array_{SortedArray(entries, comparator)}, comparator_{comparator} {
   }
 
+  /**
+   * Creates an ArraySortedMap from the entries in [begin, end), which must
+   * already be sorted by `comparator` and have distinct keys.
+   */
+  template <typename Iterator>
+  static ArraySortedMap FromSortedEntries(Iterator begin,
+                                          Iterator end,
+                                          const C& comparator = {}) {
+    return ArraySortedMap{std::make_shared<const array_type>(begin, end),
+                          comparator};
+  }
+
   /** Returns true if the map contains no elements. */
   bool empty() const {
     return size() == 0;
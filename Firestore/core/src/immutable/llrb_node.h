@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_IMMUTABLE_LLRB_NODE_H_
 #define FIRESTORE_CORE_SRC_IMMUTABLE_LLRB_NODE_H_
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 
@@ -101,6 +102,14 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode erase(const K& key, const Comparator& comparator) const;
 
+  /**
+   * Returns a tree of the entries in [begin, end), which must be sorted and
+   * have distinct keys. The tree is built bottom-up in linear time, without
+   * the rebalancing (and copying) of inserting the entries one at a time.
+   */
+  template <typename Iterator>
+  static LlrbNode FromSortedEntries(Iterator begin, Iterator end);
+
   const LlrbNode& min() const {
     const LlrbNode* node = this;
     while (!node->left().empty()) {
@@ -221,6 +230,9 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode InnerErase(const K& key, const Comparator& comparator) const;
 
+  template <typename Iterator>
+  static LlrbNode BuildFromSorted(Iterator begin, size_type size, int height);
+
   void FixUp();
   void FixRootColor();
 
@@ -336,6 +348,68 @@ LlrbNode<K, V> LlrbNode<K, V>::InnerErase(const K& key,
   return n;
 }
 
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::FromSortedEntries(Iterator begin,
+                                                 Iterator end) {
+  // A left-leaning red-black tree is a 2-3 tree in which each 3-node is a
+  // black node with a red left child. A 2-3 tree whose leaves are all `height`
+  // levels deep holds between 2^height - 1 and 3^height - 1 entries, so build
+  // the shortest one that fits: this keeps the tree as shallow as possible.
+  auto size = static_cast<size_type>(end - begin);
+  int height = 0;
+  while ((uint64_t{2} << height) - 1 <= size) {
+    ++height;
+  }
+  return BuildFromSorted(begin, size, height);
+}
+
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::BuildFromSorted(Iterator begin,
+                                               size_type size,
+                                               int height) {
+  if (height == 0) {
+    return LlrbNode{};
+  }
+
+  // The largest subtree one level shorter than this one.
+  uint64_t max_child_size = 1;
+  for (int i = 1; i < height; ++i) {
+    max_child_size *= 3;
+  }
+  max_child_size -= 1;
+
+  if (size - 1 <= 2 * max_child_size) {
+    // A 2-node: a black entry between two subtrees.
+    size_type left_size = (size - 1) / 2;
+    Iterator middle = begin + left_size;
+    LlrbNode left = BuildFromSorted(begin, left_size, height - 1);
+    LlrbNode right =
+        BuildFromSorted(middle + 1, size - 1 - left_size, height - 1);
+    return LlrbNode{
+        Rep{value_type{*middle}, Color::Black, std::move(left),
+            std::move(right)}};
+  }
+
+  // A 3-node: a black entry with a red entry to its left, between three
+  // subtrees.
+  size_type rest = size - 2;
+  size_type first_size = rest / 3;
+  size_type second_size = (rest - first_size) / 2;
+  size_type third_size = rest - first_size - second_size;
+  Iterator red_entry = begin + first_size;
+  Iterator black_entry = red_entry + 1 + second_size;
+  LlrbNode first = BuildFromSorted(begin, first_size, height - 1);
+  LlrbNode second = BuildFromSorted(red_entry + 1, second_size, height - 1);
+  LlrbNode third = BuildFromSorted(black_entry + 1, third_size, height - 1);
+  LlrbNode red{
+      Rep{value_type{*red_entry}, Color::Red, std::move(first),
+          std::move(second)}};
+  return LlrbNode{Rep{value_type{*black_entry}, Color::Black, std::move(red),
+                      std::move(third)}};
+}
+
 template <typename K, typename V>
 void LlrbNode<K, V>::FixUp() {
   set_size(left().size() + 1 + right().size());
@@ -73,6 +73,21 @@ class SortedMap : public SortedMapBase {
     }
   }
 
+  /**
+   * Creates a SortedMap from the entries in [begin, end), which must already
+   * be sorted by `comparator` and have distinct keys. This takes linear time,
+   * rather than the O(n log n) of inserting the entries one at a time.
+   */
+  template <typename Iterator>
+  static SortedMap FromSortedEntries(Iterator begin,
+                                     Iterator end,
+                                     const C& comparator = {}) {
+    if (static_cast<size_type>(end - begin) <= kFixedSize) {
+      return SortedMap{array_type::FromSortedEntries(begin, end, comparator)};
+    }
+    return SortedMap{tree_type::FromSortedEntries(begin, end, comparator)};
+  }
+
   SortedMap(const SortedMap& other) : tag_{other.tag_} {
     switch (tag_) {
       case Tag::Array:
@@ -74,6 +74,17 @@ class TreeSortedMap : public SortedMapBase, private util::CompressedMember<C> {
     return TreeSortedMap{std::move(node), comparator};
   }
 
+  /**
+   * Creates a TreeSortedMap from the entries in [begin, end), which must
+   * already be sorted by `comparator` and have distinct keys.
+   */
+  template <typename Iterator>
+  static TreeSortedMap FromSortedEntries(Iterator begin,
+                                         Iterator end,
+                                         const C& comparator = {}) {
+    return TreeSortedMap{node_type::FromSortedEntries(begin, end), comparator};
+  }
+
   /** Returns true if the map contains no elements. */
   bool empty() const {
     return root_.empty();
@@ -64,7 +64,7 @@ void WriteUnlabeledIndexString(pb_bytes_array_t* string_index,
   encoder->WriteString(nanopb::MakeStringView(string_index));
 }
 
-void WriteUnlabeledIndexString(const std::string& string_index,
+void WriteUnlabeledIndexString(absl::string_view string_index,
                                DirectionalIndexByteEncoder* encoder) {
   encoder->WriteString(string_index);
 }
@@ -90,7 +90,7 @@ void WriteIndexEntityRef(pb_bytes_array_t* reference_value,
       nanopb::MakeStringView(reference_value));
   auto num_segments = path.size();
   for (size_t index = DocumentNameOffset; index < num_segments; ++index) {
-    const std::string& segment = path[index];
+    absl::string_view segment = path[index];
     WriteValueTypeLabel(encoder, IndexType::kReferenceSegment);
     WriteUnlabeledIndexString(segment, encoder);
   }
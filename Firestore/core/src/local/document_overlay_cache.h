@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_DOCUMENT_OVERLAY_CACHE_H_
 
 #include <cstdlib>
+#include <memory>
 #include <set>
 #include <unordered_map>
 
@@ -106,6 +107,18 @@ class DocumentOverlayCache {
       int since_batch_id,
       std::size_t count) const = 0;
 
+  /**
+   * Returns a read-only copy of the overlays as of now, which can be read from
+   * any thread and outside of a transaction, or null if this cache doesn't
+   * support snapshots. The copy may be shared with other callers, so it must
+   * not be modified.
+   *
+   * Must be called in a transaction.
+   */
+  virtual std::shared_ptr<DocumentOverlayCache> CreateSnapshot() const {
+    return nullptr;
+  }
+
  private:
   friend class DocumentOverlayCacheTestHelper;
 
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/local/leveldb_document_overlay_cache.h"
 
+#include <memory>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -23,6 +25,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/memory_document_overlay_cache.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -40,7 +43,6 @@ using model::Mutation;
 using model::MutationByDocumentKeyMap;
 using model::Overlay;
 using model::OverlayByDocumentKeyMap;
-using model::OverlayHash;
 using model::ResourcePath;
 using nanopb::Message;
 using nanopb::StringReader;
@@ -54,46 +56,55 @@ LevelDbDocumentOverlayCache::LevelDbDocumentOverlayCache(
 
 absl::optional<Overlay> LevelDbDocumentOverlayCache::GetOverlay(
     const DocumentKey& document_key) const {
-  const std::string key_prefix =
-      LevelDbDocumentOverlayKey::KeyPrefix(user_id_, document_key);
-
-  auto it = db_->current_transaction()->NewIterator();
-  it->Seek(key_prefix);
-
-  if (!it->Valid() || !absl::StartsWith(it->key(), key_prefix)) {
+  EnsureIndexLoaded();
+  auto it = overlays_.find(document_key);
+  if (it == overlays_.end()) {
     return absl::nullopt;
   }
-
-  LevelDbDocumentOverlayKey key;
-  HARD_ASSERT(key.Decode(it->key()));
-  if (key.document_key() != document_key) {
-    return absl::nullopt;
-  }
-
-  return ParseOverlay(key, it->value());
+  return it->second;
 }
 
 void LevelDbDocumentOverlayCache::SaveOverlays(
     int largest_batch_id, const MutationByDocumentKeyMap& overlays) {
+  EnsureIndexLoaded();
+  index_changed_in_transaction_ = true;
   for (const auto& overlays_entry : overlays) {
     SaveOverlay(largest_batch_id, overlays_entry.first, overlays_entry.second);
   }
 }
 
 void LevelDbDocumentOverlayCache::RemoveOverlaysForBatchId(int batch_id) {
-  ForEachKeyWithLargestBatchId(
-      batch_id, [&](LevelDbDocumentOverlayKey&& key) { DeleteOverlay(key); });
+  EnsureIndexLoaded();
+  index_changed_in_transaction_ = true;
+  auto batch_it = keys_by_largest_batch_id_.find(batch_id);
+  if (batch_it == keys_by_largest_batch_id_.end()) {
+    return;
+  }
+
+  // Copy the keys, since unindexing the overlays erases the set.
+  const std::set<DocumentKey> document_keys = batch_it->second;
+  for (const DocumentKey& document_key : document_keys) {
+    DeleteOverlay(LevelDbDocumentOverlayKey(user_id_, document_key, batch_id));
+    UnindexOverlay(document_key);
+  }
 }
 
 OverlayByDocumentKeyMap LevelDbDocumentOverlayCache::GetOverlays(
     const ResourcePath& collection, int since_batch_id) const {
+  EnsureIndexLoaded();
   OverlayByDocumentKeyMap result;
-  ForEachKeyInCollection(
-      collection, since_batch_id, [&](LevelDbDocumentOverlayKey&& key) {
-        absl::optional<Overlay> overlay = GetOverlay(key);
-        HARD_ASSERT(overlay.has_value());
-        result[std::move(key).document_key()] = std::move(overlay).value();
-      });
+  auto collection_it = keys_by_collection_.find(collection);
+  if (collection_it == keys_by_collection_.end()) {
+    return result;
+  }
+
+  const KeysByBatchId& keys_by_batch_id = collection_it->second;
+  for (auto it = keys_by_batch_id.upper_bound(since_batch_id);
+       it != keys_by_batch_id.end(); ++it) {
+    for (const DocumentKey& document_key : it->second) {
+      result[document_key] = overlays_.at(document_key);
+    }
+  }
   return result;
 }
 
@@ -101,28 +112,67 @@ OverlayByDocumentKeyMap LevelDbDocumentOverlayCache::GetOverlays(
     absl::string_view collection_group,
     int since_batch_id,
     std::size_t count) const {
-  absl::optional<int> current_batch_id;
+  EnsureIndexLoaded();
   OverlayByDocumentKeyMap result;
-  ForEachKeyInCollectionGroup(
-      collection_group, since_batch_id,
-      [&](LevelDbDocumentOverlayKey&& key) -> ForEachKeyAction {
-        if (!current_batch_id.has_value()) {
-          current_batch_id = key.largest_batch_id();
-        } else if (current_batch_id.value() != key.largest_batch_id()) {
-          if (result.size() >= count) {
-            return ForEachKeyAction::kStop;
-          }
-          current_batch_id = key.largest_batch_id();
-        }
-
-        absl::optional<Overlay> overlay = GetOverlay(key);
-        HARD_ASSERT(overlay.has_value());
-        result[std::move(key).document_key()] = std::move(overlay).value();
-        return ForEachKeyAction::kKeepGoing;
-      });
+  auto group_it = keys_by_collection_group_.find(std::string(collection_group));
+  if (group_it == keys_by_collection_group_.end()) {
+    return result;
+  }
+
+  // Overlays from the same batch are never split across calls, so `count` is
+  // only checked between batches.
+  const KeysByBatchId& keys_by_batch_id = group_it->second;
+  const auto begin = keys_by_batch_id.upper_bound(since_batch_id);
+  for (auto it = begin; it != keys_by_batch_id.end(); ++it) {
+    if (it != begin && result.size() >= count) {
+      break;
+    }
+    for (const DocumentKey& document_key : it->second) {
+      result[document_key] = overlays_.at(document_key);
+    }
+  }
   return result;
 }
 
+std::shared_ptr<DocumentOverlayCache>
+LevelDbDocumentOverlayCache::CreateSnapshot() const {
+  EnsureIndexLoaded();
+  if (snapshot_) {
+    return snapshot_;
+  }
+
+  // The in-memory index holds every overlay, so copy it rather than reading
+  // LevelDB. Reads between writes share the copy.
+  auto snapshot = std::make_shared<MemoryDocumentOverlayCache>();
+  for (const auto& batch_keys : keys_by_largest_batch_id_) {
+    MutationByDocumentKeyMap mutations;
+    for (const DocumentKey& key : batch_keys.second) {
+      mutations.emplace(key, overlays_.at(key).mutation());
+    }
+    snapshot->SaveOverlays(batch_keys.first, mutations);
+  }
+  snapshot_ = std::move(snapshot);
+  return snapshot_;
+}
+
+void LevelDbDocumentOverlayCache::OnTransactionStarted() {
+  if (!index_changed_in_transaction_) {
+    return;
+  }
+
+  index_loaded_ = false;
+  snapshot_.reset();
+  overlays_.clear();
+  keys_by_largest_batch_id_.clear();
+  keys_by_collection_.clear();
+  keys_by_collection_group_.clear();
+  index_changed_in_transaction_ = false;
+}
+
+void LevelDbDocumentOverlayCache::OnTransactionCommitted() {
+  index_changed_in_transaction_ = false;
+}
+
 int LevelDbDocumentOverlayCache::GetOverlayCount() const {
   return CountEntriesWithKeyPrefix(
       LevelDbDocumentOverlayKey::KeyPrefix(user_id_));
@@ -185,24 +235,20 @@ void LevelDbDocumentOverlayCache::SaveOverlay(int largest_batch_id,
   if (collection_group_index_key.has_value()) {
     transaction->Put(std::move(collection_group_index_key).value(), "");
   }
+
+  IndexOverlay(document_key, Overlay(largest_batch_id, mutation));
 }
 
 void LevelDbDocumentOverlayCache::DeleteOverlay(
     const model::DocumentKey& document_key) {
-  const std::string key_prefix =
-      LevelDbDocumentOverlayKey::KeyPrefix(user_id_, document_key);
-  auto it = db_->current_transaction()->NewIterator();
-  it->Seek(key_prefix);
-
-  if (!it->Valid() || !absl::StartsWith(it->key(), key_prefix)) {
+  auto it = overlays_.find(document_key);
+  if (it == overlays_.end()) {
     return;
   }
 
-  LevelDbDocumentOverlayKey key;
-  HARD_ASSERT(key.Decode(it->key()));
-  if (key.document_key() == document_key) {
-    DeleteOverlay(key);
-  }
+  DeleteOverlay(LevelDbDocumentOverlayKey(user_id_, document_key,
+                                          it->second.largest_batch_id()));
+  UnindexOverlay(document_key);
 }
 
 void LevelDbDocumentOverlayCache::DeleteOverlay(
@@ -219,83 +265,77 @@ void LevelDbDocumentOverlayCache::DeleteOverlay(
   }
 }
 
-void LevelDbDocumentOverlayCache::ForEachKeyWithLargestBatchId(
-    int largest_batch_id,
-    std::function<void(LevelDbDocumentOverlayKey&& key)> callback) const {
-  const std::string key_prefix =
-      LevelDbDocumentOverlayLargestBatchIdIndexKey::KeyPrefix(user_id_,
-                                                              largest_batch_id);
+void LevelDbDocumentOverlayCache::EnsureIndexLoaded() const {
+  if (index_loaded_) {
+    return;
+  }
+
+  const std::string key_prefix = LevelDbDocumentOverlayKey::KeyPrefix(user_id_);
   auto it = db_->current_transaction()->NewIterator();
   for (it->Seek(key_prefix);
        it->Valid() && absl::StartsWith(it->key(), key_prefix); it->Next()) {
-    LevelDbDocumentOverlayLargestBatchIdIndexKey key;
+    LevelDbDocumentOverlayKey key;
     HARD_ASSERT(key.Decode(it->key()));
-    callback(std::move(key).ToLevelDbDocumentOverlayKey());
+    IndexOverlay(key.document_key(), ParseOverlay(key, it->value()));
   }
+  index_loaded_ = true;
 }
 
-void LevelDbDocumentOverlayCache::ForEachKeyInCollection(
-    const ResourcePath& collection,
-    int since_batch_id,
-    std::function<void(LevelDbDocumentOverlayKey&&)> callback) const {
-  const std::string index_start_key =
-      LevelDbDocumentOverlayCollectionIndexKey::KeyPrefix(user_id_, collection,
-                                                          since_batch_id + 1);
-  const std::string index_key_prefix =
-      LevelDbDocumentOverlayCollectionIndexKey::KeyPrefix(user_id_, collection);
-
-  auto it = db_->current_transaction()->NewIterator();
-  for (it->Seek(index_start_key);
-       it->Valid() && absl::StartsWith(it->key(), index_key_prefix);
-       it->Next()) {
-    LevelDbDocumentOverlayCollectionIndexKey key;
-    HARD_ASSERT(key.Decode(it->key()));
-    if (key.collection() != collection) {
-      break;
-    }
-    callback(std::move(key).ToLevelDbDocumentOverlayKey());
+void LevelDbDocumentOverlayCache::IndexOverlay(const DocumentKey& document_key,
+                                               Overlay overlay) const {
+  snapshot_.reset();
+
+  const int largest_batch_id = overlay.largest_batch_id();
+  keys_by_largest_batch_id_[largest_batch_id].insert(document_key);
+  keys_by_collection_[document_key.path().PopLast()][largest_batch_id].insert(
+      document_key);
+
+  absl::optional<std::string> collection_group =
+      document_key.GetCollectionGroup();
+  if (collection_group.has_value()) {
+    keys_by_collection_group_[std::move(collection_group).value()]
+                             [largest_batch_id]
+                                 .insert(document_key);
   }
+
+  overlays_[document_key] = std::move(overlay);
 }
 
-void LevelDbDocumentOverlayCache::ForEachKeyInCollectionGroup(
-    absl::string_view collection_group,
-    int since_batch_id,
-    std::function<ForEachKeyAction(LevelDbDocumentOverlayKey&&)> callback)
-    const {
-  const std::string index_start_key =
-      LevelDbDocumentOverlayCollectionGroupIndexKey::KeyPrefix(
-          user_id_, collection_group, since_batch_id + 1);
-  const std::string index_key_prefix =
-      LevelDbDocumentOverlayCollectionGroupIndexKey::KeyPrefix(
-          user_id_, collection_group);
+void LevelDbDocumentOverlayCache::UnindexOverlay(
+    const DocumentKey& document_key) {
+  auto it = overlays_.find(document_key);
+  if (it == overlays_.end()) {
+    return;
+  }
 
-  auto it = db_->current_transaction()->NewIterator();
-  for (it->Seek(index_start_key);
-       it->Valid() && absl::StartsWith(it->key(), index_key_prefix);
-       it->Next()) {
-    LevelDbDocumentOverlayCollectionGroupIndexKey key;
-    HARD_ASSERT(key.Decode(it->key()));
-    if (key.collection_group() != collection_group) {
-      break;
-    }
-    const ForEachKeyAction action =
-        callback(std::move(key).ToLevelDbDocumentOverlayKey());
-    if (action == ForEachKeyAction::kStop) {
-      break;
+  snapshot_.reset();
+
+  const int largest_batch_id = it->second.largest_batch_id();
+  auto erase_key = [&](KeysByBatchId& keys_by_batch_id) {
+    auto batch_it = keys_by_batch_id.find(largest_batch_id);
+    HARD_ASSERT(batch_it != keys_by_batch_id.end());
+    batch_it->second.erase(document_key);
+    if (batch_it->second.empty()) {
+      keys_by_batch_id.erase(batch_it);
     }
-    HARD_ASSERT(action == ForEachKeyAction::kKeepGoing);
+    return keys_by_batch_id.empty();
+  };
+
+  erase_key(keys_by_largest_batch_id_);
+
+  const ResourcePath collection = document_key.path().PopLast();
+  if (erase_key(keys_by_collection_[collection])) {
+    keys_by_collection_.erase(collection);
   }
-}
 
-absl::optional<Overlay> LevelDbDocumentOverlayCache::GetOverlay(
-    const LevelDbDocumentOverlayKey& key) const {
-  auto it = db_->current_transaction()->NewIterator();
-  const std::string encoded_key = key.Encode();
-  it->Seek(encoded_key);
-  if (!it->Valid() || it->key() != encoded_key) {
-    return absl::nullopt;
+  absl::optional<std::string> collection_group =
+      document_key.GetCollectionGroup();
+  if (collection_group.has_value() &&
+      erase_key(keys_by_collection_group_[collection_group.value()])) {
+    keys_by_collection_group_.erase(collection_group.value());
   }
-  return ParseOverlay(key, it->value());
+
+  overlays_.erase(it);
 }
 
 }  // namespace local
@@ -19,9 +19,16 @@
 
 #include <cstdlib>
 #include <functional>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 #include "Firestore/core/src/local/document_overlay_cache.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/overlay.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "absl/strings/string_view.h"
 
 namespace firebase {
@@ -38,6 +45,15 @@ class LevelDbDocumentOverlayKey;
 class LevelDbPersistence;
 class LocalSerializer;
 
+/**
+ * A DocumentOverlayCache backed by LevelDB.
+ *
+ * Overlays are persisted in LevelDB along with index rows by largest batch ID,
+ * collection, and collection group. Because the number of overlays is bounded
+ * by the number of pending writes, all of the current user's overlays are also
+ * kept in a write-through in-memory index. The index is loaded from LevelDB
+ * on first use and updated by every write, so that reads never touch LevelDB.
+ */
 class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
  public:
   LevelDbDocumentOverlayCache(const credentials::User& user,
@@ -67,6 +83,25 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
                                              int since_batch_id,
                                              std::size_t count) const override;
 
+  /**
+   * Returns an in-memory copy of the current user's overlays, which is
+   * independent of this cache and of LevelDB. The same copy is returned until
+   * the overlays change.
+   */
+  std::shared_ptr<DocumentOverlayCache> CreateSnapshot() const override;
+
+  /**
+   * Called by LevelDbPersistence when a transaction starts. If a previous
+   * transaction changed overlays but never committed, the in-memory index
+   * holds its changes, so it is dropped and reloaded from LevelDB on next use.
+   */
+  void OnTransactionStarted();
+
+  /**
+   * Called by LevelDbPersistence once the current transaction has committed.
+   */
+  void OnTransactionCommitted();
+
  private:
   friend class LevelDbDocumentOverlayCacheTestHelper;
 
@@ -79,11 +114,6 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
   int GetOverlayCount() const override;
   int CountEntriesWithKeyPrefix(const std::string& key_prefix) const;
 
-  enum class ForEachKeyAction {
-    kKeepGoing,
-    kStop,
-  };
-
   model::Overlay ParseOverlay(const LevelDbDocumentOverlayKey& key,
                               absl::string_view encoded_mutation) const;
 
@@ -95,22 +125,17 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
 
   void DeleteOverlay(const LevelDbDocumentOverlayKey&);
 
-  void ForEachKeyWithLargestBatchId(
-      int largest_batch_id,
-      std::function<void(LevelDbDocumentOverlayKey&&)>) const;
-
-  void ForEachKeyInCollection(
-      const model::ResourcePath& collection,
-      int since_batch_id,
-      std::function<void(LevelDbDocumentOverlayKey&&)>) const;
+  /**
+   * Populates the in-memory index from LevelDB, if not already done. Loading
+   * happens lazily (rather than in the constructor) because the cache may be
+   * created outside of a transaction.
+   */
+  void EnsureIndexLoaded() const;
 
-  void ForEachKeyInCollectionGroup(
-      absl::string_view collection_group,
-      int since_batch_id,
-      std::function<ForEachKeyAction(LevelDbDocumentOverlayKey&&)>) const;
+  void IndexOverlay(const model::DocumentKey& document_key,
+                    model::Overlay overlay) const;
 
-  absl::optional<model::Overlay> GetOverlay(
-      const LevelDbDocumentOverlayKey& decoded_key) const;
+  void UnindexOverlay(const model::DocumentKey& document_key);
 
   // The LevelDbDocumentOverlayCache instance is owned by LevelDbPersistence.
   LevelDbPersistence* db_;
@@ -123,6 +148,23 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
    * LevelDB keys.
    */
   std::string user_id_;
+
+  using KeysByBatchId = std::map<int, std::set<model::DocumentKey>>;
+
+  // The in-memory index of all overlays for `user_id_`. Keys within each
+  // collection and collection group are ordered by largest batch ID, mirroring
+  // the LevelDB index rows.
+  mutable bool index_loaded_ = false;
+  bool index_changed_in_transaction_ = false;
+  mutable model::OverlayByDocumentKeyMap overlays_;
+  mutable KeysByBatchId keys_by_largest_batch_id_;
+  mutable std::map<model::ResourcePath, KeysByBatchId> keys_by_collection_;
+  mutable std::unordered_map<std::string, KeysByBatchId>
+      keys_by_collection_group_;
+
+  // The copy of the index last returned by `CreateSnapshot()`, dropped
+  // whenever the index changes.
+  mutable std::shared_ptr<DocumentOverlayCache> snapshot_;
 };
 
 }  // namespace local
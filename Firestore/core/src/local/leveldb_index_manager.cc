@@ -46,7 +46,6 @@
 #include "Firestore/core/src/util/logic_utils.h"
 #include "Firestore/core/src/util/set_util.h"
 #include "Firestore/core/src/util/string_util.h"
-#include "Firestore/third_party/nlohmann_json/json.hpp"
 #include "absl/strings/match.h"
 #include "leveldb/iterator.h"
 
@@ -66,48 +65,11 @@ using model::DocumentMap;
 using model::FieldIndex;
 using model::IndexState;
 using model::ResourcePath;
-using model::SnapshotVersion;
 using model::TargetIndexMatcher;
-using nlohmann::json;
 using util::LogicUtils;
 
 namespace {
 
-struct DbIndexState {
-  int64_t seconds;
-  int32_t nanos;
-  std::string key;
-  model::ListenSequenceNumber sequence_number;
-  model::BatchId largest_batch_id;
-};
-
-void from_json(const json& j, DbIndexState& s) {
-  j.at("seconds").get_to(s.seconds);
-  j.at("nanos").get_to(s.nanos);
-  j.at("key").get_to(s.key);
-  j.at("seq_num").get_to(s.sequence_number);
-  j.at("largest_batch").get_to(s.largest_batch_id);
-}
-
-IndexState DecodeIndexState(const std::string& encoded) {
-  auto j = json::parse(encoded.begin(), encoded.end(), /*callback=*/nullptr,
-                       /*allow_exceptions=*/false);
-  auto db_state = j.get<DbIndexState>();
-  return {db_state.sequence_number,
-          SnapshotVersion(Timestamp(db_state.seconds, db_state.nanos)),
-          DocumentKey::FromPathString(db_state.key), db_state.largest_batch_id};
-}
-
-std::string EncodeIndexState(const IndexState& state) {
-  return json{
-      {"seconds", state.index_offset().read_time().timestamp().seconds()},
-      {"nanos", state.index_offset().read_time().timestamp().nanoseconds()},
-      {"key", state.index_offset().document_key().ToString()},
-      {"seq_num", state.sequence_number()},
-      {"largest_batch", state.index_offset().largest_batch_id()}}
-      .dump();
-}
-
 bool IsInFilter(const Target& target, const model::FieldPath& field_path) {
   for (const auto& filter : target.filters()) {
     if (filter.IsAFieldFilter()) {
@@ -179,6 +141,24 @@ IndexEntry GenerateUpperBound(int32_t index_id,
   return inclusive ? entry.Successor() : entry;
 }
 
+/** Deletes the states of all users for the index with the given id. */
+template <typename StateKey>
+void DeleteIndexStates(LevelDbTransaction* transaction, int32_t index_id) {
+  auto state_prefix = StateKey::KeyPrefix();
+  auto iter = transaction->NewIterator();
+  StateKey state_key;
+  for (iter->Seek(state_prefix); iter->Valid(); iter->Next()) {
+    if (!absl::StartsWith(iter->key(), state_prefix) ||
+        !state_key.Decode(iter->key())) {
+      break;
+    }
+
+    if (state_key.index_id() == index_id) {
+      transaction->Delete(iter->key());
+    }
+  }
+}
+
 }  // namespace
 
 LevelDbIndexManager::LevelDbIndexManager(const User& user,
@@ -211,7 +191,7 @@ void LevelDbIndexManager::AddToCollectionParentIndex(
   HARD_ASSERT(collection_path.size() % 2 == 1, "Expected a collection path.");
 
   if (collection_parents_cache_.Add(collection_path)) {
-    std::string collection_id = collection_path.last_segment();
+    std::string collection_id(collection_path.last_segment());
     ResourcePath parent_path = collection_path.PopLast();
 
     std::string key =
@@ -249,8 +229,8 @@ void LevelDbIndexManager::Start() {
   // contain per user information on how up to date the index is.
   {
     auto state_iter = db_->current_transaction()->NewIterator();
-    auto state_key_prefix = LevelDbIndexStateKey::KeyPrefix(uid_);
-    LevelDbIndexStateKey state_key;
+    auto state_key_prefix = LevelDbBinaryIndexStateKey::KeyPrefix(uid_);
+    LevelDbBinaryIndexStateKey state_key;
     for (state_iter->Seek(state_key_prefix); state_iter->Valid();
          state_iter->Next()) {
       if (!absl::StartsWith(state_iter->key(), state_key_prefix) ||
@@ -258,8 +238,17 @@ void LevelDbIndexManager::Start() {
         break;
       }
 
-      index_states.insert(
-          {state_key.index_id(), DecodeIndexState(state_iter->value())});
+      nanopb::StringReader reader{state_iter->value()};
+      IndexState state =
+          serializer_->DecodeIndexState(&reader, state_iter->value());
+      if (!reader.ok()) {
+        // Like migration 10, treat a state that can't be read as missing, so
+        // that its index backfills again from the start.
+        LOG_WARN("Ignoring unreadable state of index %s: %s",
+                 state_key.index_id(), reader.status().ToString());
+        continue;
+      }
+      index_states.insert({state_key.index_id(), std::move(state)});
     }
   }
 
@@ -373,22 +362,12 @@ void LevelDbIndexManager::DeleteFieldIndex(const FieldIndex& index) {
   db_->current_transaction()->Delete(LevelDbIndexConfigurationKey::Key(
       index.index_id(), index.collection_group()));
 
-  // Delete states from all users for this index id.
-  {
-    auto state_prefix = LevelDbIndexStateKey::KeyPrefix();
-    auto iter = db_->current_transaction()->NewIterator();
-    LevelDbIndexStateKey state_key;
-    for (iter->Seek(state_prefix); iter->Valid(); iter->Next()) {
-      if (!absl::StartsWith(iter->key(), state_prefix) ||
-          !state_key.Decode(iter->key())) {
-        break;
-      }
-
-      if (state_key.index_id() == index.index_id()) {
-        db_->current_transaction()->Delete(iter->key());
-      }
-    }
-  }
+  // Delete states from all users for this index id, including the JSON states
+  // kept for earlier versions of the SDK.
+  DeleteIndexStates<LevelDbBinaryIndexStateKey>(db_->current_transaction(),
+                                                index.index_id());
+  DeleteIndexStates<LevelDbIndexStateKey>(db_->current_transaction(),
+                                          index.index_id());
 
   // Delete entries from all users for this index id.
   {
@@ -444,9 +423,10 @@ absl::optional<model::FieldIndex> LevelDbIndexManager::GetFieldIndex(
   HARD_ASSERT(started_, "IndexManager not started");
 
   TargetIndexMatcher target_index_matcher(target);
-  std::string collection_group = target.collection_group() != nullptr
-                                     ? (*target.collection_group())
-                                     : target.path().last_segment();
+  std::string collection_group =
+      target.collection_group() != nullptr
+          ? (*target.collection_group())
+          : std::string(target.path().last_segment());
 
   std::vector<FieldIndex> collection_indexes =
       GetFieldIndexes(collection_group);
@@ -771,9 +751,10 @@ void LevelDbIndexManager::UpdateCollectionGroup(
   for (const auto& field_index : GetFieldIndexes(collection_group)) {
     IndexState updated_state{memoized_max_sequence_number_, offset};
 
-    auto state_key = LevelDbIndexStateKey::Key(uid_, field_index.index_id());
-    db_->current_transaction()->Put(std::move(state_key),
-                                    EncodeIndexState(updated_state));
+    auto state_key =
+        LevelDbBinaryIndexStateKey::Key(uid_, field_index.index_id());
+    db_->current_transaction()->Put(
+        std::move(state_key), serializer_->EncodeIndexState(updated_state));
 
     MemoizeIndex(FieldIndex{field_index.index_id(),
                             field_index.collection_group(),
@@ -16,12 +16,14 @@
 
 #include "Firestore/core/src/local/leveldb_key.h"
 
+#include <array>
 #include <utility>
 #include <vector>
 
 #include "Firestore/core/src/local/leveldb_util.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/md5.h"
 #include "Firestore/core/src/util/ordered_code.h"
 #include "absl/base/attributes.h"
 #include "absl/strings/escaping.h"
@@ -55,6 +57,7 @@ const char* kBundlesTable = "bundles";
 const char* kNamedQueriesTable = "named_queries";
 const char* kIndexConfigurationTable = "index_configuration";
 const char* kIndexStateTable = "index_state";
+const char* kBinaryIndexStateTable = "binary_index_state";
 const char* kIndexEntriesTable = "index_entries";
 const char* kIndexEntriesDocumentKeyIndexTable =
     "index_entries_document_key_index";
@@ -1006,6 +1009,15 @@ bool LevelDbTargetKey::Decode(leveldb::Slice key) {
   return reader.ok();
 }
 
+std::string LevelDbQueryTargetKey::CanonicalIdHash(
+    absl::string_view canonical_id) {
+  // The first 64 bits of the MD5 digest, hex encoded so that keys remain
+  // readable in DescribeKey output.
+  std::array<uint8_t, 16> digest = util::CalculateMd5Digest(canonical_id);
+  return absl::BytesToHexString(
+      absl::string_view(reinterpret_cast<const char*>(digest.data()), 8));
+}
+
 std::string LevelDbQueryTargetKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kQueryTargetsTable);
@@ -1343,6 +1355,38 @@ bool LevelDbIndexStateKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbBinaryIndexStateKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kBinaryIndexStateTable);
+  return writer.result();
+}
+
+std::string LevelDbBinaryIndexStateKey::KeyPrefix(absl::string_view user_id) {
+  Writer writer;
+  writer.WriteTableName(kBinaryIndexStateTable);
+  writer.WriteUserId(user_id);
+  return writer.result();
+}
+
+std::string LevelDbBinaryIndexStateKey::Key(absl::string_view user_id,
+                                            int32_t index_id) {
+  Writer writer;
+  writer.WriteTableName(kBinaryIndexStateTable);
+  writer.WriteUserId(user_id);
+  writer.WriteIndexId(index_id);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbBinaryIndexStateKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kBinaryIndexStateTable);
+  user_id_ = reader.ReadUserId();
+  index_id_ = reader.ReadIndexId();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbIndexEntryKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kIndexEntriesTable);
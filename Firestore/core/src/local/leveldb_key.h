@@ -373,9 +373,21 @@ class LevelDbTargetKey {
  * A key in the query targets table, an index of canonical_ids to the targets
  * they may match. This is not a unique mapping because canonical_id does not
  * promise a unique name for all possible queries.
+ *
+ * As of schema version 9 lookups use rows whose canonical_id component holds
+ * `CanonicalIdHash(canonical_id)`, since the full canonical ID can be
+ * kilobytes long for large queries and pipelines. Each target also keeps a row
+ * keyed by its full canonical ID for earlier versions of the SDK.
  */
 class LevelDbQueryTargetKey {
  public:
+  /**
+   * Returns the fixed-width digest of the given canonical ID that is stored in
+   * query target keys. Different canonical IDs may share a digest, so callers
+   * must still compare the targets themselves.
+   */
+  static std::string CanonicalIdHash(absl::string_view canonical_id);
+
   /**
    * Creates a key that contains just the query targets table prefix and points
    * just before the first key.
@@ -403,7 +415,9 @@ class LevelDbQueryTargetKey {
   ABSL_MUST_USE_RESULT
   bool Decode(absl::string_view key);
 
-  /** The canonical_id derived from the query. */
+  /**
+   * The canonical_id component of the key; see `CanonicalIdHash()`.
+   */
   const std::string& canonical_id() const {
     return canonical_id_;
   }
@@ -893,6 +907,57 @@ class LevelDbIndexStateKey {
   std::string user_id_;
 };
 
+/**
+ * A key in the binary_index_state table. Like the index_state table, it stores
+ * the per index per user backfilling state, but in the binary encoding of
+ * `LocalSerializer::EncodeIndexState`. Schema version 10 moved the states
+ * here, and leaves the JSON states in index_state for earlier versions of the
+ * SDK to read after a downgrade.
+ */
+class LevelDbBinaryIndexStateKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a key prefix that points just before the first key for a given user
+   * id.
+   */
+  static std::string KeyPrefix(absl::string_view user_id);
+
+  /**
+   * Creates a key that points to the key for the given user id and index id.
+   */
+  static std::string Key(absl::string_view user_id, int32_t index_id);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The user id for this entry. */
+  const std::string& user_id() const {
+    return user_id_;
+  }
+
+  /** The index id for this entry. */
+  int32_t index_id() const {
+    return index_id_;
+  }
+
+ private:
+  int32_t index_id_;
+  std::string user_id_;
+};
+
 /**
  * A key in the index_entries_document_key_index table, storing the encoded
  * entries for an given index, user id and document key.
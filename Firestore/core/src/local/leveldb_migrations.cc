@@ -21,17 +21,22 @@
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
 #include "Firestore/Protos/nanopb/firestore/local/target.nanopb.h"
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/memory_index_manager.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/statusor.h"
+#include "Firestore/third_party/nlohmann_json/json.hpp"
 #include "absl/strings/match.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -40,9 +45,13 @@ namespace {
 
 using leveldb::Status;
 using model::DocumentKey;
+using model::IndexState;
 using model::ResourcePath;
+using model::SnapshotVersion;
+using model::TargetId;
 using nanopb::Message;
 using nanopb::StringReader;
+using nlohmann::json;
 
 /**
  * Save the given version number as the current version of the schema of the
@@ -227,7 +236,7 @@ void EnsureCollectionParentRow(LevelDbTransaction* transaction,
                                const DocumentKey& key) {
   const ResourcePath& collection_path = key.path().PopLast();
   if (cache->Add(collection_path)) {
-    std::string collection_id = collection_path.last_segment();
+    std::string collection_id(collection_path.last_segment());
     ResourcePath parent_path = collection_path.PopLast();
 
     std::string key =
@@ -290,7 +299,7 @@ util::StatusOr<TargetData> ReadTargetData(
   auto target_it = transaction.NewIterator();
   const auto& target_key = LevelDbTargetKey::Key(query_target_key.target_id());
   target_it->Seek(target_key);
-  if (!target_it->Valid()) {
+  if (!target_it->Valid() || target_it->key() != target_key) {
     return util::Status(
         kErrorNotFound,
         util::StringFormat(
@@ -370,6 +379,126 @@ void EnsureOverlayDataMigrationIsRequired(leveldb::DB* db) {
   transaction.Commit();
 }
 
+/**
+ * Migration 9.
+ *
+ * Adds a query_targets row keyed by a fixed-width hash of each target's
+ * canonical ID. The rows keyed by the full canonical ID stay, and are kept up
+ * to date by `LevelDbTargetCache`, so that earlier versions of the SDK can
+ * still find their targets after a downgrade.
+ */
+void HashQueryTargetCanonicalIds(leveldb::DB* db,
+                                 const LocalSerializer& serializer) {
+  LevelDbTransaction transaction(db, "Hash Query Target Canonical Ids");
+
+  std::string query_targets_prefix = LevelDbQueryTargetKey::KeyPrefix();
+  auto it = transaction.NewIterator();
+  it->Seek(query_targets_prefix);
+  LevelDbQueryTargetKey query_target_key;
+  for (; it->Valid() && absl::StartsWith(it->key(), query_targets_prefix);
+       it->Next()) {
+    HARD_ASSERT(query_target_key.Decode(it->key()),
+                "Failed to decode query_targets key");
+
+    // Rows of both forms are visited when this migration reruns after a
+    // downgrade. A downgraded SDK only removes the full form of the targets
+    // it drops, which leaves the hashed form dangling.
+    util::StatusOr<TargetData> target_data =
+        ReadTargetData(query_target_key, serializer, transaction);
+    if (!target_data.ok()) {
+      LOG_WARN("Reading target data failed: %s",
+               target_data.status().error_message());
+      if (target_data.status().code() == kErrorNotFound) {
+        transaction.Delete(it->key());
+      }
+      continue;
+    }
+
+    const std::string& canonical_id =
+        target_data.ValueOrDie().target_or_pipeline().CanonicalId();
+    const TargetId target_id = target_data.ValueOrDie().target_id();
+    for (const std::string& key :
+         {LevelDbQueryTargetKey::Key(
+              LevelDbQueryTargetKey::CanonicalIdHash(canonical_id), target_id),
+          LevelDbQueryTargetKey::Key(canonical_id, target_id)}) {
+      if (key != it->key()) {
+        std::string empty_buffer;
+        transaction.Put(key, empty_buffer);
+      }
+    }
+  }
+
+  SaveVersion(9, &transaction);
+  transaction.Commit();
+}
+
+/**
+ * Decodes an index state in the JSON encoding used before migration 10, or
+ * returns nullopt if `encoded` isn't one.
+ */
+absl::optional<IndexState> DecodeJsonIndexState(const std::string& encoded) {
+  json j = json::parse(encoded.begin(), encoded.end(), /*callback=*/nullptr,
+                       /*allow_exceptions=*/false);
+  if (!j.is_object()) {
+    return absl::nullopt;
+  }
+  for (const char* field : {"seconds", "nanos", "seq_num", "largest_batch"}) {
+    auto value = j.find(field);
+    if (value == j.end() || !value->is_number_integer()) {
+      return absl::nullopt;
+    }
+  }
+  auto key = j.find("key");
+  if (key == j.end() || !key->is_string()) {
+    return absl::nullopt;
+  }
+  ResourcePath path = ResourcePath::FromString(key->get<std::string>());
+  if (!DocumentKey::IsDocumentKey(path)) {
+    return absl::nullopt;
+  }
+
+  return IndexState{
+      j.at("seq_num").get<model::ListenSequenceNumber>(),
+      SnapshotVersion(Timestamp(j.at("seconds").get<int64_t>(),
+                                j.at("nanos").get<int32_t>())),
+      DocumentKey(std::move(path)),
+      j.at("largest_batch").get<model::BatchId>()};
+}
+
+/**
+ * Migration 10.
+ *
+ * Copies the per-user index states from JSON into the binary encoding of
+ * `LocalSerializer::EncodeIndexState`, stored under their own table. The JSON
+ * states are left in place so that earlier versions of the SDK can still read
+ * them after a downgrade. States that can't be read are not copied, which makes
+ * their indexes backfill again from the start.
+ */
+void EncodeIndexStatesInBinary(leveldb::DB* db,
+                               const LocalSerializer& serializer) {
+  LevelDbTransaction transaction(db, "Encode index states in binary");
+
+  std::string index_state_prefix = LevelDbIndexStateKey::KeyPrefix();
+  LevelDbIndexStateKey state_key;
+  auto it = transaction.NewIterator();
+  for (it->Seek(index_state_prefix);
+       it->Valid() && absl::StartsWith(it->key(), index_state_prefix);
+       it->Next()) {
+    absl::optional<IndexState> state = DecodeJsonIndexState(it->value());
+    if (!state || !state_key.Decode(it->key())) {
+      LOG_WARN("Skipping unreadable index state");
+      continue;
+    }
+
+    transaction.Put(LevelDbBinaryIndexStateKey::Key(state_key.user_id(),
+                                                    state_key.index_id()),
+                    serializer.EncodeIndexState(*state));
+  }
+
+  SaveVersion(10, &transaction);
+  transaction.Commit();
+}
+
 }  // namespace
 
 LevelDbMigrations::SchemaVersion LevelDbMigrations::ReadSchemaVersion(
@@ -433,6 +562,14 @@ void LevelDbMigrations::RunMigrations(leveldb::DB* db,
   if (from_version < 8 && to_version >= 8) {
     EnsureOverlayDataMigrationIsRequired(db);
   }
+
+  if (from_version < 9 && to_version >= 9) {
+    HashQueryTargetCanonicalIds(db, serializer);
+  }
+
+  if (from_version < 10 && to_version >= 10) {
+    EncodeIndexStatesInBinary(db, serializer);
+  }
 }
 
 }  // namespace local
@@ -73,8 +73,11 @@ class LevelDbMigrations {
  *   * Migration 6 populates the collection_parents index.
  *   * Migration 7 rewrites query_targets canonical ids in new format.
  *   * Migration 8 kicks off overlay data migration.
+ *   * Migration 9 rewrites query_targets keys to use a hash of the canonical
+ *     id.
+ *   * Migration 10 rewrites index states from JSON to a binary encoding.
  */
-const LevelDbMigrations::SchemaVersion kSchemaVersion = 8;
+const LevelDbMigrations::SchemaVersion kSchemaVersion = 10;
 
 }  // namespace local
 }  // namespace firestore
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_mutation_queue.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -55,6 +56,14 @@ using nanopb::ByteString;
 using nanopb::Message;
 using nanopb::StringReader;
 
+/** Returns the given batch IDs in sorted order without duplicates. */
+std::vector<BatchId> SortAndDeduplicate(std::vector<BatchId> batch_ids) {
+  std::sort(batch_ids.begin(), batch_ids.end());
+  batch_ids.erase(std::unique(batch_ids.begin(), batch_ids.end()),
+                  batch_ids.end());
+  return batch_ids;
+}
+
 BatchId LoadNextBatchIdFromDb(DB* db) {
   // TODO(gsoltis): implement Prev() and SeekToLast() on
   // LevelDbTransaction::Iterator, then port this to a transaction.
@@ -228,7 +237,7 @@ LevelDbMutationQueue::AllMutationBatchesAffectingDocumentKeys(
   // Take a pass through the document keys and collect the set of unique
   // mutation batch_ids that affect them all. Some batches can affect more than
   // one key.
-  std::set<BatchId> batch_ids;
+  std::vector<BatchId> batch_ids;
 
   auto index_iterator = db_->current_transaction()->NewIterator();
   LevelDbDocumentMutationKey row_key;
@@ -254,11 +263,11 @@ LevelDbMutationQueue::AllMutationBatchesAffectingDocumentKeys(
         break;
       }
 
-      batch_ids.insert(row_key.batch_id());
+      batch_ids.push_back(row_key.batch_id());
     }
   }
 
-  return AllMutationBatchesWithIds(batch_ids);
+  return AllMutationBatchesWithIds(SortAndDeduplicate(std::move(batch_ids)));
 }
 
 std::vector<MutationBatch>
@@ -278,39 +287,40 @@ LevelDbMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
   const ResourcePath& query_path = query.path();
   size_t immediate_children_path_length = query_path.size() + 1;
 
-  // TODO(mcg): Actually implement a single-collection query
-  //
-  // This is actually executing an ancestor query, traversing the whole subtree
-  // below the collection which can be horrifically inefficient for some
-  // structures. The right way to solve this is to implement the full value
-  // index, but that's not in the cards in the near future so this is the best
-  // we can do for the moment.
-  //
   // Since we don't yet index the actual properties in the mutations, our
   // current approach is to just return all mutation batches that affect
   // documents in the collection being queried.
   //
+  // Index rows have this form (with markers in brackets):
+  //
+  // <User>user <Path>coll <Path>doc1 <BatchId>2 <Terminator>
+  // <User>user <Path>coll <Path>doc1 <Path>sub <Path>doc <BatchId>3
+  // <Terminator>
+  // <User>user <Path>coll <Path>doc2 <BatchId>3 <Terminator>
+  //
+  // Path markers sort after BatchId markers, so the rows for each immediate
+  // child of the collection come before the rows for that child's
+  // subcollections. Once the scan reaches a row in a subcollection, it seeks
+  // past the rest of that child's subtree instead of stepping through it.
+  //
   // Unlike AllMutationBatchesAffectingDocumentKey, this iteration will scan the
   // document-mutation index for more than a single document so the associated
-  // batch_ids will be neither necessarily unique nor in order. This means an
-  // efficient simultaneous scan isn't possible.
+  // batch_ids will be neither necessarily unique nor in order. They are
+  // accumulated in a vector and then sorted and deduplicated so they can be
+  // traversed in order in a scan of the main table.
+  //
+  // This method is faster than performing lookups of the keys with _db->Get and
+  // keeping a hash of batch_ids that have already been looked up. The
+  // performance difference is minor for small numbers of keys but > 30% faster
+  // for larger numbers of keys.
   std::string index_prefix =
       LevelDbDocumentMutationKey::KeyPrefix(user_id_, query_path);
   auto index_iterator = db_->current_transaction()->NewIterator();
   index_iterator->Seek(index_prefix);
 
   LevelDbDocumentMutationKey row_key;
-
-  // Collect up unique batch_ids encountered during a scan of the index. Use a
-  // set<BatchId> to accumulate the IDs so they can be traversed in order in a
-  // scan of the main table.
-  //
-  // This method is faster than performing lookups of the keys with _db->Get and
-  // keeping a hash of batch_ids that have already been looked up. The
-  // performance difference is minor for small numbers of keys but > 30% faster
-  // for larger numbers of keys.
-  std::set<BatchId> unique_batch_ids;
-  for (; index_iterator->Valid(); index_iterator->Next()) {
+  std::vector<BatchId> batch_ids;
+  while (index_iterator->Valid()) {
     if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
         !row_key.Decode(index_iterator->key())) {
       break;
@@ -319,17 +329,20 @@ LevelDbMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
     // Rows with document keys more than one segment longer than the query path
     // can't be matches. For example, a query on 'rooms' can't match the
     // document /rooms/abc/messages/xyx.
-    // TODO(mcg): we'll need a different scanner when we implement ancestor
-    // queries.
-    if (row_key.document_key().path().size() !=
-        immediate_children_path_length) {
+    const ResourcePath& row_path = row_key.document_key().path();
+    if (row_path.size() != immediate_children_path_length) {
+      ResourcePath child_path(
+          row_path.begin(), row_path.begin() + immediate_children_path_length);
+      index_iterator->Seek(util::PrefixSuccessor(
+          LevelDbDocumentMutationKey::KeyPrefix(user_id_, child_path)));
       continue;
     }
 
-    unique_batch_ids.insert(row_key.batch_id());
+    batch_ids.push_back(row_key.batch_id());
+    index_iterator->Next();
   }
 
-  return AllMutationBatchesWithIds(unique_batch_ids);
+  return AllMutationBatchesWithIds(SortAndDeduplicate(std::move(batch_ids)));
 }
 
 absl::optional<MutationBatch> LevelDbMutationQueue::LookupMutationBatch(
@@ -432,8 +445,9 @@ void LevelDbMutationQueue::SetLastStreamToken(ByteString stream_token) {
 }
 
 std::vector<MutationBatch> LevelDbMutationQueue::AllMutationBatchesWithIds(
-    const std::set<BatchId>& batch_ids) {
+    const std::vector<BatchId>& batch_ids) {
   std::vector<MutationBatch> result;
+  result.reserve(batch_ids.size());
 
   // Given an ordered set of unique batch_ids perform a skipping scan over the
   // main table to find the mutation batches.
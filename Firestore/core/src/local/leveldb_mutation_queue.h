@@ -17,7 +17,6 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_MUTATION_QUEUE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_MUTATION_QUEUE_H_
 
-#include <set>
 #include <string>
 #include <vector>
 
@@ -100,9 +99,11 @@ class LevelDbMutationQueue : public MutationQueue {
   /**
    * Constructs a vector of matching batches, sorted by batch_id to ensure that
    * multiple mutations affecting the same document key are applied in order.
+   *
+   * @param batch_ids The batch IDs to look up, sorted and without duplicates.
    */
   std::vector<model::MutationBatch> AllMutationBatchesWithIds(
-      const std::set<model::BatchId>& batch_ids);
+      const std::vector<model::BatchId>& batch_ids);
 
   std::string mutation_queue_key() const;
 
@@ -30,6 +30,7 @@
 #include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/sizer.h"
+#include "Firestore/core/src/util/defer.h"
 #include "Firestore/core/src/util/filesystem.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
@@ -318,6 +319,8 @@ void LevelDbPersistence::DeleteAllFieldIndexes() {
 
   DeleteEverythingWithPrefix("Delete All Index States",
                              LevelDbIndexStateKey::KeyPrefix());
+  DeleteEverythingWithPrefix("Delete All Binary Index States",
+                             LevelDbBinaryIndexStateKey::KeyPrefix());
 
   DeleteEverythingWithPrefix("Delete All Index Entries",
                              LevelDbIndexEntryKey::KeyPrefix());
@@ -330,12 +333,26 @@ void LevelDbPersistence::RunInternal(absl::string_view label,
 
   transaction_ = absl::make_unique<LevelDbTransaction>(db_.get(), label);
   reference_delegate_->OnTransactionStarted(label);
+  document_cache_->OnTransactionStarted();
+  target_cache_->OnTransactionStarted();
+  for (const auto& entry : document_overlay_caches_) {
+    entry.second->OnTransactionStarted();
+  }
+
+  // If `block` throws, drop the transaction without committing it. The caches
+  // forget what it wrote when the next transaction starts.
+  util::Defer drop_uncommitted([&] { transaction_.reset(); });
 
   block();
 
   reference_delegate_->OnTransactionCommitted();
   transaction_->Commit();
   transaction_.reset();
+  document_cache_->OnTransactionCommitted();
+  target_cache_->OnTransactionCommitted();
+  for (const auto& entry : document_overlay_caches_) {
+    entry.second->OnTransactionCommitted();
+  }
 }
 
 leveldb::ReadOptions StandardReadOptions() {
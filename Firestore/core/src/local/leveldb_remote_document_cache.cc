@@ -16,28 +16,32 @@
 
 #include "Firestore/core/src/local/leveldb_remote_document_cache.h"
 
+#include <set>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
-#include "Firestore/Protos/nanopb/firestore/local/maybe_document.nanopb.h"
 #include "Firestore/core/src/core/pipeline_util.h"  // Added
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/filter.h"
+#include "Firestore/core/src/core/order_by.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_transaction.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/overlay.h"
-#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
-#include "Firestore/core/src/util/background_queue.h"
 #include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/string_util.h"
+#include "absl/memory/memory.h"
 #include "leveldb/db.h"
 
 namespace firebase {
@@ -50,46 +54,38 @@ using leveldb::Status;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentVersionMap;
+using model::FieldPath;
 using model::MutableDocument;
 using model::MutableDocumentMap;
 using model::ResourcePath;
 using model::SnapshotVersion;
-using nanopb::Message;
 using nanopb::StringReader;
-using util::BackgroundQueue;
 using util::Executor;
 
 /**
- * An accumulator for results produced asynchronously. This accumulates
- * values in a vector to avoid contention caused by accumulating into more
- * complex structures like immutable::SortedMap.
+ * Returns the top-level fields that `query` reads to decide whether a document
+ * matches: the fields of its filters and of its order-bys. Returns no fields
+ * for pipelines.
  */
-template <typename T>
-class AsyncResults {
- public:
-  void Insert(T&& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    values_.push_back(std::move(value));
-  }
+std::set<std::string> MatchedFields(const core::QueryOrPipeline& query) {
+  std::set<std::string> fields;
+  if (query.IsPipeline()) return fields;
 
-  void Insert(const T& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    values_.push_back(value);
+  auto add_field = [&](const FieldPath& path) {
+    if (!path.IsKeyFieldPath()) {
+      fields.emplace(path.first_segment());
+    }
+  };
+  for (const core::Filter& filter : query.query().filters()) {
+    for (const core::FieldFilter& field_filter : filter.GetFlattenedFilters()) {
+      add_field(field_filter.field());
+    }
   }
-
-  /**
-   * Returns the accumulated result, moving it out of AsyncResults. The
-   * AsyncResults object should not be reused.
-   */
-  std::vector<T> Result() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::move(values_);
+  for (const core::OrderBy& order_by : query.query().normalized_order_bys()) {
+    add_field(order_by.field());
   }
-
- private:
-  std::vector<T> values_;
-  std::mutex mutex_;
-};
+  return fields;
+}
 
 }  // namespace
 
@@ -105,39 +101,82 @@ LevelDbRemoteDocumentCache::LevelDbRemoteDocumentCache(
                                          static_cast<int>(hw_concurrency));
 }
 
-// Out of line because of unique_ptrs to incomplete types.
-LevelDbRemoteDocumentCache::~LevelDbRemoteDocumentCache() = default;
+LevelDbRemoteDocumentCache::LevelDbRemoteDocumentCache(
+    const LevelDbRemoteDocumentCache& live, const leveldb::Snapshot* snapshot)
+    : db_(live.db_),
+      index_manager_(live.index_manager_),
+      serializer_(live.serializer_),
+      executor_(live.executor_),
+      snapshot_(NOT_NULL(snapshot)) {
+  leveldb::ReadOptions read_options = LevelDbTransaction::DefaultReadOptions();
+  read_options.snapshot = snapshot_;
+  snapshot_transaction_ = absl::make_unique<LevelDbTransaction>(
+      db_->ptr(), "Remote document cache snapshot", read_options);
+}
+
+LevelDbRemoteDocumentCache::~LevelDbRemoteDocumentCache() {
+  if (snapshot_) {
+    // The transaction reads from the snapshot, so release it last.
+    snapshot_transaction_.reset();
+    db_->ptr()->ReleaseSnapshot(snapshot_);
+  }
+}
+
+std::unique_ptr<RemoteDocumentCache>
+LevelDbRemoteDocumentCache::CreateSnapshot() const {
+  // `new` rather than `make_unique` because the constructor is private.
+  return std::unique_ptr<RemoteDocumentCache>(
+      new LevelDbRemoteDocumentCache(*this, db_->ptr()->GetSnapshot()));
+}
+
+LevelDbTransaction* LevelDbRemoteDocumentCache::transaction() const {
+  return snapshot_ ? snapshot_transaction_.get() : db_->current_transaction();
+}
 
 void LevelDbRemoteDocumentCache::Add(const MutableDocument& document,
                                      const SnapshotVersion& read_time) {
+  HARD_ASSERT(!snapshot_, "Cannot write to a remote document cache snapshot");
   const DocumentKey& key = document.key();
   const ResourcePath& path = key.path();
 
   std::string ldb_document_key = LevelDbRemoteDocumentKey::Key(key);
-  db_->current_transaction()->Put(ldb_document_key,
-                                  serializer_->EncodeMaybeDocument(document));
+  transaction()->Put(ldb_document_key,
+                     serializer_->EncodeMaybeDocument(document));
 
   std::string ldb_read_time_key = LevelDbRemoteDocumentReadTimeKey::Key(
       path.PopLast(), read_time, path.last_segment());
-  db_->current_transaction()->Put(ldb_read_time_key, "");
+  transaction()->Put(ldb_read_time_key, "");
 
   NOT_NULL(index_manager_);
   index_manager_->AddToCollectionParentIndex(document.key().path().PopLast());
+
+  InvalidateDocument(key);
 }
 
 void LevelDbRemoteDocumentCache::Remove(const DocumentKey& key) {
+  HARD_ASSERT(!snapshot_, "Cannot write to a remote document cache snapshot");
   std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
-  db_->current_transaction()->Delete(ldb_key);
+  transaction()->Delete(ldb_key);
+
+  InvalidateDocument(key);
 }
 
 MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) const {
+  absl::optional<MutableDocument> cached = GetCachedDocument(key);
+  if (cached) {
+    return std::move(*cached);
+  }
+
   std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
   std::string value;
-  Status status = db_->current_transaction()->Get(ldb_key, &value);
+  Status status = transaction()->Get(ldb_key, &value);
   if (status.IsNotFound()) {
     return MutableDocument::InvalidDocument(key);
   } else if (status.ok()) {
-    return DecodeMaybeDocument(value, key);
+    size_t encoded_size = value.size();
+    MutableDocument document = DecodeMaybeDocument(std::move(value), key);
+    CacheDocument(document, encoded_size);
+    return document;
   } else {
     HARD_FAIL("Fetch document for key (%s) failed with status: %s",
               key.ToString(), status.ToString());
@@ -146,31 +185,42 @@ MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) const {
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
     const DocumentKeySet& keys) const {
-  BackgroundQueue tasks(executor_.get());
-  AsyncResults<std::pair<DocumentKey, MutableDocument>> results;
+  MutableDocumentMap map;
+
+  // Read the documents that aren't cached, then decode them all in parallel.
+  std::vector<const DocumentKey*> encoded_keys;
+  std::vector<std::string> encoded_contents;
 
   LevelDbRemoteDocumentKey current_key;
-  auto it = db_->current_transaction()->NewIterator();
+  auto it = transaction()->NewIterator();
 
   for (const DocumentKey& key : keys) {
+    absl::optional<MutableDocument> cached = GetCachedDocument(key);
+    if (cached) {
+      map = map.insert(key, std::move(*cached));
+      continue;
+    }
+
     it->Seek(LevelDbRemoteDocumentKey::Key(key));
     if (!it->Valid() || !current_key.Decode(it->key()) ||
         current_key.document_key() != key) {
-      results.Insert(
-          std::make_pair(key, MutableDocument::InvalidDocument(key)));
+      map = map.insert(key, MutableDocument::InvalidDocument(key));
     } else {
-      const std::string& contents = it->value();
-      tasks.Execute([this, &results, &key, contents] {
-        results.Insert(std::make_pair(key, DecodeMaybeDocument(contents, key)));
-      });
+      encoded_keys.push_back(&key);
+      encoded_contents.push_back(it->value());
     }
   }
 
-  tasks.AwaitAll();
+  std::vector<MutableDocument> documents(encoded_keys.size());
+  executor_->ExecuteAll(encoded_keys.size(), [&](size_t i) {
+    size_t encoded_size = encoded_contents[i].size();
+    documents[i] =
+        DecodeMaybeDocument(std::move(encoded_contents[i]), *encoded_keys[i]);
+    CacheDocument(documents[i], encoded_size);
+  });
 
-  MutableDocumentMap map;
-  for (const auto& entry : results.Result()) {
-    map = map.insert(entry.first, entry.second);
+  for (size_t i = 0; i < documents.size(); ++i) {
+    map = map.insert(*encoded_keys[i], std::move(documents[i]));
   }
   return map;
 }
@@ -179,24 +229,38 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
     DocumentVersionMap&& remote_map,
     const core::QueryOrPipeline& query,
     const model::OverlayByDocumentKeyMap& mutated_docs) const {
-  BackgroundQueue tasks(executor_.get());
-  AsyncResults<std::pair<DocumentKey, MutableDocument>> results;
+  // Documents are decoded lazily. Decode the fields that the query reads in a
+  // single pass over each document, and leave the rest of the document encoded
+  // unless it matches.
+  std::set<std::string> matched_fields = MatchedFields(query);
+
+  std::vector<const DocumentVersionMap::value_type*> key_versions;
+  key_versions.reserve(remote_map.size());
   for (const auto& key_version : remote_map) {
-    tasks.Execute([this, &results, &key_version, query, &mutated_docs] {
-      auto document = Get(key_version.first).WithReadTime(key_version.second);
-      if (document.is_found_document() &&
-          // Either the document matches the given query, or it is mutated.
-          (query.Matches(document) ||
-           mutated_docs.find(key_version.first) != mutated_docs.end())) {
-        results.Insert(std::make_pair(key_version.first, std::move(document)));
-      }
-    });
+    key_versions.push_back(&key_version);
   }
-  tasks.AwaitAll();
+
+  // Documents that don't match are left invalid.
+  std::vector<MutableDocument> documents(key_versions.size());
+  executor_->ExecuteAll(key_versions.size(), [&](size_t i) {
+    const DocumentKey& key = key_versions[i]->first;
+    auto document = Get(key).WithReadTime(key_versions[i]->second);
+    if (document.is_found_document() && !matched_fields.empty()) {
+      document.data().PrefetchFields(matched_fields);
+    }
+    if (document.is_found_document() &&
+        // Either the document matches the given query, or it is mutated.
+        (query.Matches(document) ||
+         mutated_docs.find(key) != mutated_docs.end())) {
+      documents[i] = std::move(document);
+    }
+  });
 
   MutableDocumentMap map;
-  for (const auto& entry : results.Result()) {
-    map = map.insert(entry.first, entry.second);
+  for (size_t i = 0; i < documents.size(); ++i) {
+    if (documents[i].is_valid_document()) {
+      map = map.insert(key_versions[i]->first, std::move(documents[i]));
+    }
   }
   return map;
 }
@@ -263,7 +327,7 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetDocumentsMatchingQuery(
   // set.
   std::string start_key =
       LevelDbRemoteDocumentReadTimeKey::KeyPrefix(path, offset.read_time());
-  auto it = db_->current_transaction()->NewIterator();
+  auto it = transaction()->NewIterator();
   it->Seek(util::ImmediateSuccessor(start_key));
 
   DocumentVersionMap remote_map;
@@ -299,12 +363,10 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetDocumentsMatchingQuery(
 }
 
 MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
-    absl::string_view encoded, const DocumentKey& key) const {
-  StringReader reader{encoded};
-
-  auto message = Message<firestore_client_MaybeDocument>::TryParse(&reader);
-  MutableDocument maybe_document =
-      serializer_->DecodeMaybeDocument(&reader, *message);
+    std::string encoded, const DocumentKey& key) const {
+  StringReader reader;
+  MutableDocument maybe_document = serializer_->DecodeMaybeDocument(
+      &reader, std::make_shared<const std::string>(std::move(encoded)));
 
   if (!reader.ok()) {
     HARD_FAIL("MaybeDocument proto failed to parse: %s",
@@ -321,6 +383,72 @@ void LevelDbRemoteDocumentCache::SetIndexManager(IndexManager* manager) {
   index_manager_ = NOT_NULL(manager);
 }
 
+void LevelDbRemoteDocumentCache::EnableDocumentCache(size_t max_size_bytes) {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  document_cache_ = absl::make_unique<DocumentCache>(max_size_bytes);
+}
+
+int64_t LevelDbRemoteDocumentCache::document_cache_hits() const {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  return document_cache_hits_;
+}
+
+int64_t LevelDbRemoteDocumentCache::document_cache_misses() const {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  return document_cache_misses_;
+}
+
+void LevelDbRemoteDocumentCache::OnTransactionStarted() {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  keys_written_in_transaction_.clear();
+}
+
+void LevelDbRemoteDocumentCache::OnTransactionCommitted() {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  keys_written_in_transaction_.clear();
+}
+
+absl::optional<MutableDocument> LevelDbRemoteDocumentCache::GetCachedDocument(
+    const DocumentKey& key) const {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  if (!document_cache_ || keys_written_in_transaction_.count(key) > 0) {
+    return absl::nullopt;
+  }
+
+  MutableDocument* cached = document_cache_->get(key);
+  if (!cached) {
+    ++document_cache_misses_;
+    return absl::nullopt;
+  }
+
+  ++document_cache_hits_;
+  // Callers are free to modify the documents they get, so hand out copies.
+  // Copies of a document that has not been decoded yet share its encoded
+  // bytes.
+  return cached->Clone();
+}
+
+void LevelDbRemoteDocumentCache::CacheDocument(const MutableDocument& document,
+                                               size_t encoded_size) const {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  if (!document_cache_ ||
+      keys_written_in_transaction_.count(document.key()) > 0) {
+    return;
+  }
+
+  document_cache_->put(document.key(), document.Clone(), encoded_size);
+}
+
+void LevelDbRemoteDocumentCache::InvalidateDocument(const DocumentKey& key) {
+  std::lock_guard<std::mutex> lock(document_cache_mutex_);
+  if (!document_cache_) {
+    return;
+  }
+
+  document_cache_->remove(key);
+  keys_written_in_transaction_.insert(key);
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
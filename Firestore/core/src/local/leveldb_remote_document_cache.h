@@ -17,21 +17,30 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "Firestore/core/src/core/pipeline_util.h"  // Added
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/leveldb_index_manager.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/overlay.h"
 #include "Firestore/core/src/model/types.h"
-#include "absl/strings/string_view.h"
+#include "Firestore/core/src/util/lru_cache.h"
 #include "absl/types/optional.h"
 
+namespace leveldb {
+class Snapshot;
+}  // namespace leveldb
+
 namespace firebase {
 namespace firestore {
 
@@ -40,13 +49,13 @@ class Executor;
 }  // namespace util
 
 namespace model {
-class MutableDocument;
 class SnapshotVersion;
 }  // namespace model
 
 namespace local {
 
 class LevelDbPersistence;
+class LevelDbTransaction;
 class LocalSerializer;
 
 /** Cached Remote Documents backed by leveldb. */
@@ -80,7 +89,49 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
 
   void SetIndexManager(IndexManager* manager) override;
 
+  /**
+   * Returns a read-only cache that reads a LevelDB snapshot of the documents
+   * committed so far. It can be read from any thread without a transaction,
+   * and doesn't see later writes.
+   */
+  std::unique_ptr<RemoteDocumentCache> CreateSnapshot() const override;
+
+  /**
+   * Keeps recently read documents in memory, up to `max_size_bytes` of their
+   * encoded size, so that reading them again skips LevelDB and decoding.
+   */
+  void EnableDocumentCache(size_t max_size_bytes);
+
+  /** The number of reads served from the document cache. */
+  int64_t document_cache_hits() const;
+
+  /** The number of reads that missed the document cache while enabled. */
+  int64_t document_cache_misses() const;
+
+  /**
+   * Called by LevelDbPersistence when a transaction starts. Writes of a
+   * previous transaction that never committed are forgotten: they were never
+   * added to the document cache.
+   */
+  void OnTransactionStarted();
+
+  /**
+   * Called by LevelDbPersistence once the current transaction has committed,
+   * after which documents it wrote can be cached again.
+   */
+  void OnTransactionCommitted();
+
  private:
+  /** Creates a read-only cache over `snapshot`; see `CreateSnapshot()`. */
+  LevelDbRemoteDocumentCache(const LevelDbRemoteDocumentCache& live,
+                             const leveldb::Snapshot* snapshot);
+
+  /**
+   * The transaction to read from: the snapshot transaction of a snapshot, or
+   * the current transaction otherwise.
+   */
+  LevelDbTransaction* transaction() const;
+
   /**
    * Looks up a set of entries in the cache, returning only existing entries of
    * Type::Document together with its SnapshotVersion.
@@ -90,8 +141,28 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
       const core::QueryOrPipeline& query,
       const model::OverlayByDocumentKeyMap& mutated_docs = {}) const;
 
+  /**
+   * Decodes a document read from the cache. The fields of a found document are
+   * only decoded from `encoded` once they are accessed, so documents that are
+   * filtered out, or only needed for their key and version, are never fully
+   * decoded.
+   */
   model::MutableDocument DecodeMaybeDocument(
-      absl::string_view encoded, const model::DocumentKey& key) const;
+      std::string encoded, const model::DocumentKey& key) const;
+
+  /** Returns a copy of the cached document for `key`, if any. */
+  absl::optional<model::MutableDocument> GetCachedDocument(
+      const model::DocumentKey& key) const;
+
+  /** Caches a copy of `document`, read from `encoded_size` bytes. */
+  void CacheDocument(const model::MutableDocument& document,
+                     size_t encoded_size) const;
+
+  /**
+   * Evicts `key` from the document cache and keeps it out until the current
+   * transaction commits, so that uncommitted writes are never cached.
+   */
+  void InvalidateDocument(const model::DocumentKey& key);
 
   // The LevelDbRemoteDocumentCache instance is owned by LevelDbPersistence.
   LevelDbPersistence* db_;
@@ -100,7 +171,26 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
   // Owned by LevelDbPersistence.
   LocalSerializer* serializer_ = nullptr;
 
-  std::unique_ptr<util::Executor> executor_;
+  // Shared with snapshots of this cache.
+  std::shared_ptr<util::Executor> executor_;
+
+  // Set only for snapshots, which own their snapshot and read from it in a
+  // transaction of their own.
+  const leveldb::Snapshot* snapshot_ = nullptr;
+  std::unique_ptr<LevelDbTransaction> snapshot_transaction_;
+
+  using DocumentCache = util::LruCache<model::DocumentKey,
+                                       model::MutableDocument,
+                                       model::DocumentKeyHash>;
+
+  // Guards the document cache, which is read from the query executor's
+  // threads. Null unless enabled.
+  mutable std::mutex document_cache_mutex_;
+  std::unique_ptr<DocumentCache> document_cache_;
+  std::unordered_set<model::DocumentKey, model::DocumentKeyHash>
+      keys_written_in_transaction_;
+  mutable int64_t document_cache_hits_ = 0;
+  mutable int64_t document_cache_misses_ = 0;
 };
 
 }  // namespace local
@@ -19,6 +19,7 @@
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
@@ -48,6 +49,25 @@ using model::TargetId;
 using nanopb::Message;
 using nanopb::StringReader;
 
+namespace {
+
+/** The maximum number of targets kept in the in-memory canonical ID cache. */
+const size_t kTargetCacheCapacity = 100;
+
+/**
+ * Returns the query_targets keys of a target: the one keyed by the hash of its
+ * canonical ID, which lookups use, and the one keyed by the full canonical ID,
+ * which earlier versions of the SDK use (see migration 9).
+ */
+std::vector<std::string> QueryTargetKeys(const std::string& canonical_id,
+                                         TargetId target_id) {
+  return {LevelDbQueryTargetKey::Key(
+              LevelDbQueryTargetKey::CanonicalIdHash(canonical_id), target_id),
+          LevelDbQueryTargetKey::Key(canonical_id, target_id)};
+}
+
+}  // namespace
+
 absl::optional<Message<firestore_client_TargetGlobal>>
 LevelDbTargetCache::TryReadMetadata(leveldb::DB* db) {
   std::string key = LevelDbTargetGlobalKey::Key();
@@ -83,7 +103,9 @@ Message<firestore_client_TargetGlobal> LevelDbTargetCache::ReadMetadata(
 
 LevelDbTargetCache::LevelDbTargetCache(LevelDbPersistence* db,
                                        LocalSerializer* serializer)
-    : db_(NOT_NULL(db)), serializer_(NOT_NULL(serializer)) {
+    : db_(NOT_NULL(db)),
+      serializer_(NOT_NULL(serializer)),
+      targets_by_canonical_id_(kTargetCacheCapacity) {
 }
 
 void LevelDbTargetCache::Start() {
@@ -104,10 +126,12 @@ void LevelDbTargetCache::AddTarget(const TargetData& target_data) {
 
   const std::string& canonical_id =
       target_data.target_or_pipeline().CanonicalId();
-  std::string index_key =
-      LevelDbQueryTargetKey::Key(canonical_id, target_data.target_id());
-  std::string empty_buffer;
-  db_->current_transaction()->Put(index_key, empty_buffer);
+  for (const std::string& index_key :
+       QueryTargetKeys(canonical_id, target_data.target_id())) {
+    std::string empty_buffer;
+    db_->current_transaction()->Put(index_key, empty_buffer);
+  }
+  CacheOnCommit(canonical_id, target_data);
 
   metadata_->target_count++;
   UpdateMetadata(target_data);
@@ -117,6 +141,17 @@ void LevelDbTargetCache::AddTarget(const TargetData& target_data) {
 void LevelDbTargetCache::UpdateTarget(const TargetData& target_data) {
   Save(target_data);
 
+  const std::string& canonical_id =
+      target_data.target_or_pipeline().CanonicalId();
+  auto written = targets_written_in_transaction_.find(canonical_id);
+  const TargetData* cached =
+      written != targets_written_in_transaction_.end()
+          ? (written->second ? &*written->second : nullptr)
+          : targets_by_canonical_id_.get(canonical_id);
+  if (cached && cached->target_id() == target_data.target_id()) {
+    CacheOnCommit(canonical_id, target_data);
+  }
+
   if (UpdateMetadata(target_data)) {
     SaveMetadata();
   }
@@ -130,22 +165,61 @@ void LevelDbTargetCache::RemoveTarget(const TargetData& target_data) {
   std::string key = LevelDbTargetKey::Key(target_id);
   db_->current_transaction()->Delete(key);
 
-  std::string index_key = LevelDbQueryTargetKey::Key(
-      target_data.target_or_pipeline().CanonicalId(), target_id);
-  db_->current_transaction()->Delete(index_key);
+  const std::string& canonical_id =
+      target_data.target_or_pipeline().CanonicalId();
+  for (const std::string& index_key :
+       QueryTargetKeys(canonical_id, target_id)) {
+    db_->current_transaction()->Delete(index_key);
+  }
+  CacheOnCommit(canonical_id, absl::nullopt);
 
   metadata_->target_count--;
   SaveMetadata();
 }
 
+void LevelDbTargetCache::OnTransactionStarted() {
+  targets_written_in_transaction_.clear();
+}
+
+void LevelDbTargetCache::OnTransactionCommitted() {
+  for (auto& written : targets_written_in_transaction_) {
+    if (written.second) {
+      targets_by_canonical_id_.put(written.first,
+                                   std::move(written.second).value());
+    }
+  }
+  targets_written_in_transaction_.clear();
+}
+
+void LevelDbTargetCache::CacheOnCommit(const std::string& canonical_id,
+                                       absl::optional<TargetData> target_data) {
+  // Dropping the cached target right away keeps lookups in this transaction
+  // from seeing it, and is harmless if the transaction never commits.
+  targets_by_canonical_id_.remove(canonical_id);
+  targets_written_in_transaction_[canonical_id] = std::move(target_data);
+}
+
 absl::optional<TargetData> LevelDbTargetCache::GetTarget(
     const core::TargetOrPipeline& target_or_pipeline) {
-  // Scan the query-target index starting with a prefix starting with the given
-  // target's or pipeline's canonical_id. Note that this is a scan rather than
-  // a get because canonical_ids are not required to be unique per target.
   const std::string& canonical_id = target_or_pipeline.CanonicalId();
+  const bool written_in_transaction =
+      targets_written_in_transaction_.count(canonical_id) > 0;
+  if (!written_in_transaction) {
+    TargetData* cached = targets_by_canonical_id_.get(canonical_id);
+    if (cached && cached->target_or_pipeline() == target_or_pipeline) {
+      return *cached;
+    }
+  }
+
+  // Scan the query-target index starting with a prefix starting with the hash
+  // of the given target's or pipeline's canonical_id. Note that this is a scan
+  // rather than a get because neither canonical_ids nor their hashes are
+  // unique per target.
+  const std::string canonical_id_hash =
+      LevelDbQueryTargetKey::CanonicalIdHash(canonical_id);
   auto index_iterator = db_->current_transaction()->NewIterator();
-  std::string index_prefix = LevelDbQueryTargetKey::KeyPrefix(canonical_id);
+  std::string index_prefix =
+      LevelDbQueryTargetKey::KeyPrefix(canonical_id_hash);
   index_iterator->Seek(index_prefix);
 
   // Simultaneously scan the targets table. This works because each
@@ -157,14 +231,11 @@ absl::optional<TargetData> LevelDbTargetCache::GetTarget(
 
   LevelDbQueryTargetKey row_key;
   for (; index_iterator->Valid(); index_iterator->Next()) {
-    // Only consider rows matching exactly the specific canonical_id of
+    // Only consider rows matching exactly the specific canonical_id hash of
     // interest.
-    auto kk = index_iterator->key();
-    (void)kk;
-
     if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
         !row_key.Decode(index_iterator->key()) ||
-        canonical_id != row_key.canonical_id()) {
+        canonical_id_hash != row_key.canonical_id()) {
       // End of this canonical_id's possible targets.
       break;
     }
@@ -186,6 +257,10 @@ absl::optional<TargetData> LevelDbTargetCache::GetTarget(
     // pipeline is actually equal to the requested one.
     TargetData target_data = DecodeTarget(target_iterator->value());
     if (target_data.target_or_pipeline() == target_or_pipeline) {
+      // Targets the transaction hasn't written are as committed.
+      if (!written_in_transaction) {
+        targets_by_canonical_id_.put(canonical_id, target_data);
+      }
       return target_data;
     }
   }
@@ -239,6 +314,19 @@ size_t LevelDbTargetCache::RemoveTargets(
 
   // Remove the CanonicalId to TargetId mapping
   RemoveQueryTargetKeyForTargets(removed_targets);
+  auto is_removed = [&](const TargetData& target_data) {
+    return removed_targets.find(target_data.target_id()) !=
+           removed_targets.end();
+  };
+  targets_by_canonical_id_.remove_if(
+      [&](const std::string&, const TargetData& target_data) {
+        return is_removed(target_data);
+      });
+  for (auto& written : targets_written_in_transaction_) {
+    if (written.second && is_removed(*written.second)) {
+      written.second = absl::nullopt;
+    }
+  }
 
   metadata_->target_count -= removed_targets.size();
   SaveMetadata();
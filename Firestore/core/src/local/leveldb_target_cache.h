@@ -17,14 +17,17 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "Firestore/Protos/nanopb/firestore/local/target.nanopb.h"
 #include "Firestore/core/src/local/target_cache.h"
+#include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/util/lru_cache.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "leveldb/db.h"
@@ -35,7 +38,6 @@ namespace local {
 
 class LevelDbPersistence;
 class LocalSerializer;
-class TargetData;
 
 /** Cached Queries backed by LevelDB. */
 class LevelDbTargetCache : public TargetCache {
@@ -124,6 +126,19 @@ class LevelDbTargetCache : public TargetCache {
   // Non-interface methods
   void Start();
 
+  /**
+   * Called by LevelDbPersistence when a transaction starts. Target changes of a
+   * previous transaction that never committed are forgotten: they were never
+   * added to the cache of recently used targets.
+   */
+  void OnTransactionStarted();
+
+  /**
+   * Called by LevelDbPersistence once the current transaction has committed,
+   * adding the targets it wrote to the cache of recently used targets.
+   */
+  void OnTransactionCommitted();
+
   void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback);
 
  private:
@@ -154,6 +169,29 @@ class LevelDbTargetCache : public TargetCache {
   nanopb::Message<firestore_client_TargetGlobal> metadata_;
 
   model::SnapshotVersion last_remote_snapshot_version_;
+
+  /**
+   * Drops the cached target for `canonical_id` and, once the current
+   * transaction commits, replaces it with `target_data`, or leaves it out if
+   * `target_data` is empty.
+   */
+  void CacheOnCommit(const std::string& canonical_id,
+                     absl::optional<TargetData> target_data);
+
+  /**
+   * A cache of recently used targets keyed by canonical ID, so that repeated
+   * lookups of the same target skip the index scan and the target proto
+   * decode. It only ever holds committed targets.
+   */
+  util::LruCache<std::string, TargetData> targets_by_canonical_id_;
+
+  /**
+   * Targets written by the current transaction, keyed by canonical ID, to
+   * apply to `targets_by_canonical_id_` when it commits. Until then, lookups of
+   * these canonical IDs go to LevelDB.
+   */
+  std::unordered_map<std::string, absl::optional<TargetData>>
+      targets_written_in_transaction_;
 };
 
 }  // namespace local
@@ -29,20 +29,26 @@
 #include "Firestore/Protos/nanopb/google/firestore/admin/index.nanopb.h"
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/Protos/nanopb/google/firestore/v1/write.nanopb.h"
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/ordered_code.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 
 namespace firebase {
@@ -71,11 +77,18 @@ using nanopb::Message;
 using nanopb::Reader;
 using nanopb::ReleaseFieldOwnership;
 using nanopb::SafeReadBoolean;
+using nanopb::ScanFields;
 using nanopb::SetRepeatedField;
+using nanopb::StringReader;
 using nanopb::Writer;
+using util::OrderedCode;
 using util::Status;
 using util::StringFormat;
 
+// The first byte of a binary index state. Index states used to be stored as
+// JSON objects, which start with '{'.
+constexpr char kIndexStateFormatBinary = '\x01';
+
 }  // namespace
 
 Message<firestore_client_MaybeDocument> LocalSerializer::EncodeMaybeDocument(
@@ -135,6 +148,40 @@ MutableDocument LocalSerializer::DecodeMaybeDocument(
   UNREACHABLE();
 }
 
+MutableDocument LocalSerializer::DecodeMaybeDocument(
+    Reader* reader, std::shared_ptr<const std::string> encoded) const {
+  if (!reader->status().ok()) return {};
+
+  absl::optional<absl::string_view> document;
+  bool has_committed_mutations = false;
+  ScanFields(
+      reader->context(), *encoded,
+      [&](uint32_t tag, absl::string_view contents) {
+        if (tag == firestore_client_MaybeDocument_document_tag) {
+          document = contents;
+        }
+      },
+      [&](uint32_t tag, uint64_t value) {
+        if (tag == firestore_client_MaybeDocument_has_committed_mutations_tag) {
+          has_committed_mutations = value != 0;
+        }
+      });
+  if (!reader->status().ok()) return {};
+
+  if (!document) {
+    // Missing and unknown documents have no fields to defer.
+    StringReader proto_reader{*encoded};
+    auto proto =
+        Message<firestore_client_MaybeDocument>::TryParse(&proto_reader);
+    MutableDocument result = DecodeMaybeDocument(&proto_reader, *proto);
+    reader->set_status(proto_reader.status());
+    return result;
+  }
+
+  return DecodeDocument(reader, std::move(encoded), *document,
+                        has_committed_mutations);
+}
+
 google_firestore_v1_Document LocalSerializer::EncodeDocument(
     const MutableDocument& doc) const {
   google_firestore_v1_Document result{};
@@ -179,6 +226,40 @@ MutableDocument LocalSerializer::DecodeDocument(
   return document;
 }
 
+MutableDocument LocalSerializer::DecodeDocument(
+    Reader* reader,
+    std::shared_ptr<const std::string> storage,
+    absl::string_view encoded_document,
+    bool has_committed_mutations) const {
+  google_protobuf_Timestamp update_time{};
+  ByteString name;
+  ScanFields(reader->context(), encoded_document,
+             [&](uint32_t tag, absl::string_view contents) {
+               if (tag == google_firestore_v1_Document_name_tag) {
+                 name = ByteString{contents};
+               } else if (tag == google_firestore_v1_Document_update_time_tag) {
+                 StringReader timestamp_reader{contents};
+                 timestamp_reader.Read(google_protobuf_Timestamp_fields,
+                                       &update_time);
+                 if (!timestamp_reader.ok()) {
+                   reader->set_status(timestamp_reader.status());
+                 }
+               }
+             });
+  if (!reader->status().ok()) return {};
+
+  SnapshotVersion version =
+      rpc_serializer_.DecodeVersion(reader->context(), update_time);
+
+  MutableDocument document = MutableDocument::FoundDocument(
+      rpc_serializer_.DecodeKey(reader->context(), name.get()), version,
+      ObjectValue::FromEncodedDocument(std::move(storage), encoded_document));
+  if (has_committed_mutations) {
+    document.SetHasCommittedMutations();
+  }
+  return document;
+}
+
 firestore_client_NoDocument LocalSerializer::EncodeNoDocument(
     const MutableDocument& no_doc) const {
   firestore_client_NoDocument result{};
@@ -508,6 +589,68 @@ std::vector<model::Segment> LocalSerializer::DecodeFieldIndexSegments(
   return result;
 }
 
+std::string LocalSerializer::EncodeIndexState(
+    const model::IndexState& state) const {
+  const model::IndexOffset& offset = state.index_offset();
+  const Timestamp& read_time = offset.read_time().timestamp();
+  const model::ResourcePath& path = offset.document_key().path();
+
+  std::string result(1, kIndexStateFormatBinary);
+  OrderedCode::WriteSignedNumIncreasing(&result, state.sequence_number());
+  OrderedCode::WriteSignedNumIncreasing(&result, read_time.seconds());
+  OrderedCode::WriteSignedNumIncreasing(&result, read_time.nanoseconds());
+  OrderedCode::WriteSignedNumIncreasing(&result, offset.largest_batch_id());
+  OrderedCode::WriteNumIncreasing(&result, path.size());
+  for (absl::string_view segment : path) {
+    OrderedCode::WriteString(&result, segment);
+  }
+  return result;
+}
+
+model::IndexState LocalSerializer::DecodeIndexState(
+    Reader* reader, absl::string_view encoded) const {
+  if (encoded.empty() || encoded[0] != kIndexStateFormatBinary) {
+    reader->Fail("Index state is not in the binary format");
+    return {};
+  }
+  encoded.remove_prefix(1);
+
+  int64_t sequence_number = 0;
+  int64_t seconds = 0;
+  int64_t nanos = 0;
+  int64_t largest_batch_id = 0;
+  uint64_t segment_count = 0;
+  if (!OrderedCode::ReadSignedNumIncreasing(&encoded, &sequence_number) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &seconds) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &nanos) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &largest_batch_id) ||
+      !OrderedCode::ReadNumIncreasing(&encoded, &segment_count)) {
+    reader->Fail("Failed to read index state");
+    return {};
+  }
+
+  std::vector<std::string> segments;
+  for (uint64_t i = 0; i != segment_count; ++i) {
+    std::string segment;
+    if (!OrderedCode::ReadString(&encoded, &segment)) {
+      reader->Fail("Failed to read index state document key");
+      return {};
+    }
+    segments.push_back(std::move(segment));
+  }
+  model::ResourcePath path{std::move(segments)};
+  if (!model::DocumentKey::IsDocumentKey(path)) {
+    reader->Fail(StringFormat("Invalid index state document key: %s",
+                              path.CanonicalString()));
+    return {};
+  }
+
+  return {sequence_number,
+          SnapshotVersion(Timestamp(seconds, static_cast<int32_t>(nanos))),
+          model::DocumentKey(std::move(path)),
+          static_cast<model::BatchId>(largest_batch_id)};
+}
+
 nanopb::Message<google_firestore_admin_v1_Index>
 LocalSerializer::EncodeFieldIndexSegments(
     const std::vector<model::Segment>& segments) const {
@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_SERIALIZER_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -100,6 +101,14 @@ class LocalSerializer {
   model::MutableDocument DecodeMaybeDocument(
       nanopb::Reader* reader, firestore_client_MaybeDocument& proto) const;
 
+  /**
+   * @brief Decodes an encoded MaybeDocument proto to the equivalent model
+   * without decoding the fields of a found document. The fields are decoded
+   * from `encoded` when they are first accessed.
+   */
+  model::MutableDocument DecodeMaybeDocument(
+      nanopb::Reader* reader, std::shared_ptr<const std::string> encoded) const;
+
   /**
    * @brief Encodes a TargetData to the equivalent nanopb proto, representing a
    * ::firestore::proto::Target, for local storage.
@@ -157,6 +166,20 @@ class LocalSerializer {
   std::vector<model::Segment> DecodeFieldIndexSegments(
       nanopb::Reader* reader, google_firestore_admin_v1_Index& index) const;
 
+  /**
+   * Encodes the backfill state of a field index for the index_state table.
+   * States are rewritten on every backfill step and all read at startup, so
+   * they use a compact binary encoding rather than a proto or JSON.
+   */
+  std::string EncodeIndexState(const model::IndexState& state) const;
+
+  /**
+   * Decodes an index state written by `EncodeIndexState`. Fails the reader if
+   * `encoded` is not a valid index state.
+   */
+  model::IndexState DecodeIndexState(nanopb::Reader* reader,
+                                     absl::string_view encoded) const;
+
   /**
    * @brief Encodes a `Mutation` to the equivalent nanopb proto for local
    * storage.
@@ -188,6 +211,16 @@ class LocalSerializer {
                                         google_firestore_v1_Document& proto,
                                         bool has_committed_mutations) const;
 
+  /**
+   * Decodes the key and version of the encoded Document in `encoded_document`,
+   * leaving its fields encoded in `storage` until they are accessed.
+   */
+  model::MutableDocument DecodeDocument(
+      nanopb::Reader* reader,
+      std::shared_ptr<const std::string> storage,
+      absl::string_view encoded_document,
+      bool has_committed_mutations) const;
+
   firestore_client_NoDocument EncodeNoDocument(
       const model::MutableDocument& no_doc) const;
 
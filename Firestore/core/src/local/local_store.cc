@@ -25,6 +25,7 @@
 #include "Firestore/core/src/local/bundle_cache.h"
 #include "Firestore/core/src/local/index_backfiller.h"
 #include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/local_store_snapshot.h"
 #include "Firestore/core/src/local/local_view_changes.h"
 #include "Firestore/core/src/local/local_write_result.h"
 #include "Firestore/core/src/local/lru_garbage_collector.h"
@@ -33,6 +34,7 @@
 #include "Firestore/core/src/local/query_engine.h"
 #include "Firestore/core/src/local/query_result.h"
 #include "Firestore/core/src/local/reference_delegate.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/local/target_cache.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/mutable_document.h"
@@ -43,6 +45,7 @@
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/set_util.h"
 #include "Firestore/core/src/util/to_string.h"
+#include "absl/memory/memory.h"
 
 namespace firebase {
 namespace firestore {
@@ -129,12 +132,17 @@ LocalStore::LocalStore(Persistence* persistence,
 LocalStore::~LocalStore() = default;
 
 void LocalStore::Start() {
-  StartMutationQueue();
-  StartIndexManager();
-  overlay_migration_manager_->Run();
-  TargetId target_id = target_cache_->highest_target_id();
-  target_id_generator_ =
-      TargetIdGenerator::TargetCacheTargetIdGenerator(target_id);
+  startup_timings_.Measure(StartupTimings::Phase::kStartMutationQueue,
+                           [&] { StartMutationQueue(); });
+  if (!staged_startup_) {
+    EnsureIndexManagerStarted();
+    EnsureOverlaysMigrated();
+  }
+  startup_timings_.Measure(StartupTimings::Phase::kReadTargetMetadata, [&] {
+    TargetId target_id = target_cache_->highest_target_id();
+    target_id_generator_ =
+        TargetIdGenerator::TargetCacheTargetIdGenerator(target_id);
+  });
 }
 
 void LocalStore::StartMutationQueue() {
@@ -145,7 +153,29 @@ void LocalStore::StartIndexManager() {
   persistence_->Run("Start IndexManager", [&] { index_manager_->Start(); });
 }
 
+void LocalStore::EnsureIndexManagerStarted() {
+  if (index_manager_started_) {
+    return;
+  }
+  startup_timings_.Measure(StartupTimings::Phase::kStartIndexManager,
+                           [&] { StartIndexManager(); });
+  index_manager_started_ = true;
+}
+
+void LocalStore::EnsureOverlaysMigrated() {
+  if (overlays_migrated_) {
+    return;
+  }
+  startup_timings_.Measure(StartupTimings::Phase::kMigrateOverlays,
+                           [&] { overlay_migration_manager_->Run(); });
+  overlays_migrated_ = true;
+}
+
 DocumentMap LocalStore::HandleUserChange(const User& user) {
+  // The migration covers all users, and releases the components of users
+  // other than the initial one when it's done.
+  EnsureOverlaysMigrated();
+
   // Swap out the mutation queue, grabbing the pending mutation batches before
   // and after.
   std::vector<MutationBatch> old_batches = persistence_->Run(
@@ -159,7 +189,12 @@ DocumentMap LocalStore::HandleUserChange(const User& user) {
   remote_document_cache_->SetIndexManager(index_manager_);
 
   StartMutationQueue();
-  StartIndexManager();
+  if (staged_startup_) {
+    // The new user's indexes are loaded when they are first needed.
+    index_manager_started_ = false;
+  } else {
+    StartIndexManager();
+  }
 
   persistence_->ReleaseOtherUserSpecificComponents(user.uid());
 
@@ -191,6 +226,7 @@ DocumentMap LocalStore::HandleUserChange(const User& user) {
 }
 
 LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
+  EnsureOverlaysMigrated();
   Timestamp local_write_time = Timestamp::Now();
   DocumentKeySet keys;
   for (const Mutation& mutation : mutations) {
@@ -251,6 +287,7 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
 
 DocumentMap LocalStore::AcknowledgeBatch(
     const MutationBatchResult& batch_result) {
+  EnsureOverlaysMigrated();
   return persistence_->Run("Acknowledge batch", [&] {
     const MutationBatch& batch = batch_result.batch();
     mutation_queue_->AcknowledgeBatch(batch, batch_result.stream_token());
@@ -291,6 +328,7 @@ void LocalStore::ApplyBatchResult(const MutationBatchResult& batch_result) {
 }
 
 DocumentMap LocalStore::RejectBatch(BatchId batch_id) {
+  EnsureOverlaysMigrated();
   return persistence_->Run("Reject batch", [&] {
     absl::optional<MutationBatch> to_reject =
         mutation_queue_->LookupMutationBatch(batch_id);
@@ -321,6 +359,7 @@ const SnapshotVersion& LocalStore::GetLastRemoteSnapshotVersion() const {
 
 model::DocumentMap LocalStore::ApplyRemoteEvent(
     const remote::RemoteEvent& remote_event) {
+  EnsureOverlaysMigrated();
   const SnapshotVersion& last_remote_version =
       target_cache_->GetLastRemoteSnapshotVersion();
 
@@ -492,6 +531,7 @@ absl::optional<MutationBatch> LocalStore::GetNextMutationBatch(
 }
 
 const Document LocalStore::ReadDocument(const DocumentKey& key) {
+  EnsureOverlaysMigrated();
   return persistence_->Run("ReadDocument",
                            [&] { return local_documents_->GetDocument(key); });
 }
@@ -555,6 +595,8 @@ void LocalStore::ReleaseTarget(TargetId target_id) {
 
 QueryResult LocalStore::ExecuteQuery(
     const core::QueryOrPipeline& query_or_pipeline, bool use_previous_results) {
+  EnsureIndexManagerStarted();
+  EnsureOverlaysMigrated();
   return persistence_->Run("ExecuteQuery", [&] {
     absl::optional<TargetData> target_data =
         GetTargetData(query_or_pipeline.ToTargetOrPipeline());
@@ -576,6 +618,22 @@ QueryResult LocalStore::ExecuteQuery(
   });
 }
 
+std::unique_ptr<LocalStoreSnapshot> LocalStore::TakeSnapshot() {
+  EnsureOverlaysMigrated();
+  return persistence_->Run(
+      "TakeSnapshot", [&]() -> std::unique_ptr<LocalStoreSnapshot> {
+        std::unique_ptr<RemoteDocumentCache> remote_documents =
+            remote_document_cache_->CreateSnapshot();
+        std::shared_ptr<DocumentOverlayCache> overlays =
+            document_overlay_cache_->CreateSnapshot();
+        if (!remote_documents || !overlays) {
+          return nullptr;
+        }
+        return absl::make_unique<LocalStoreSnapshot>(
+            std::move(remote_documents), std::move(overlays));
+      });
+}
+
 DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
   return persistence_->Run("RemoteDocumentKeysForTarget", [&] {
     return target_cache_->GetMatchingKeys(target_id);
@@ -588,7 +646,9 @@ LruResults LocalStore::CollectGarbage(LruGarbageCollector* garbage_collector) {
   });
 }
 
-size_t LocalStore::Backfill() const {
+size_t LocalStore::Backfill() {
+  EnsureIndexManagerStarted();
+  EnsureOverlaysMigrated();
   return persistence_->Run("Backfill Indexes", [&] {
     return index_backfiller_->WriteIndexEntries(this);
   });
@@ -610,6 +670,7 @@ void LocalStore::SaveBundle(const bundle::BundleMetadata& metadata) {
 
 DocumentMap LocalStore::ApplyBundledDocuments(
     const MutableDocumentMap& bundled_documents, const std::string& bundle_id) {
+  EnsureOverlaysMigrated();
   // Allocates a target to hold all document keys from the bundle, such that
   // they will not get garbage collected right away.
   TargetData umbrella_target =
@@ -669,6 +730,7 @@ void LocalStore::SaveNamedQuery(const bundle::NamedQuery& query,
 }
 
 std::vector<model::FieldIndex> LocalStore::GetFieldIndexes() {
+  EnsureIndexManagerStarted();
   return persistence_->Run("Get FieldIndexes",
                            [&] { return index_manager_->GetFieldIndexes(); });
 }
@@ -681,6 +743,7 @@ absl::optional<bundle::NamedQuery> LocalStore::GetNamedQuery(
 
 void LocalStore::ConfigureFieldIndexes(
     std::vector<FieldIndex> new_field_indexes) {
+  EnsureIndexManagerStarted();
   // This lambda function takes a rvalue vector as parameter,
   // then coverts it to a sorted set based on the compare function above.
   auto convertToSet = [](std::vector<FieldIndex>&& vec) {
@@ -708,7 +771,8 @@ void LocalStore::SetIndexAutoCreationEnabled(bool is_enabled) const {
   query_engine_->SetIndexAutoCreationEnabled(is_enabled);
 }
 
-void LocalStore::DeleteAllFieldIndexes() const {
+void LocalStore::DeleteAllFieldIndexes() {
+  EnsureIndexManagerStarted();
   // This step is not wrapped in `persistence_->Run()`.
   // The reason is `persistence_->Run()` always assume each operation is
   // executed in one transaction, while `DeleteAllFieldIndexes()` might need
@@ -30,6 +30,7 @@
 #include "Firestore/core/src/local/document_overlay_cache.h"
 #include "Firestore/core/src/local/overlay_migration_manager.h"
 #include "Firestore/core/src/local/reference_set.h"
+#include "Firestore/core/src/local/startup_timings.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/model_fwd.h"
@@ -60,6 +61,7 @@ namespace local {
 class BundleCache;
 class IndexManager;
 class LocalDocumentsView;
+class LocalStoreSnapshot;
 class LocalViewChanges;
 class LocalWriteResult;
 class LruGarbageCollector;
@@ -124,6 +126,23 @@ class LocalStore : public bundle::BundleCallback {
   /** Performs any initial startup actions required by the local store. */
   void Start();
 
+  /**
+   * Makes `Start` defer loading the field indexes and migrating overlays until
+   * an operation first needs them, so that reads of cached documents can be
+   * served sooner after startup. Must be called before `Start`.
+   */
+  void EnableStagedStartup() {
+    staged_startup_ = true;
+  }
+
+  /**
+   * Returns how long each phase of starting the local store took. Deferred
+   * phases are recorded when they first run.
+   */
+  StartupTimings* startup_timings() {
+    return &startup_timings_;
+  }
+
   /**
    * Tells the LocalStore that the currently authenticated user has changed.
    *
@@ -226,6 +245,12 @@ class LocalStore : public bundle::BundleCallback {
   QueryResult ExecuteQuery(const core::QueryOrPipeline& query_or_pipeline,
                            bool use_previous_results);
 
+  /**
+   * Returns a read-only snapshot of the local documents that can be read from
+   * other threads, or null if the persistence layer doesn't support snapshots.
+   */
+  std::unique_ptr<LocalStoreSnapshot> TakeSnapshot();
+
   /**
    * Notify the local store of the changed views to locally pin / unpin
    * documents.
@@ -256,7 +281,7 @@ class LocalStore : public bundle::BundleCallback {
    * Runs a single backfill operation and returns the number of documents
    * processed.
    */
-  size_t Backfill() const;
+  size_t Backfill();
 
   /**
    * Returns whether the given bundle has already been loaded and its create
@@ -292,7 +317,7 @@ class LocalStore : public bundle::BundleCallback {
 
   void SetIndexAutoCreationEnabled(bool is_enabled) const;
 
-  void DeleteAllFieldIndexes() const;
+  void DeleteAllFieldIndexes();
 
  private:
   friend class IndexBackfiller;
@@ -322,6 +347,18 @@ class LocalStore : public bundle::BundleCallback {
 
   void StartIndexManager();
 
+  /**
+   * Starts the index manager if that was deferred. Must be called outside of
+   * a transaction.
+   */
+  void EnsureIndexManagerStarted();
+
+  /**
+   * Migrates overlays if that was deferred. Must be called outside of a
+   * transaction.
+   */
+  void EnsureOverlaysMigrated();
+
   void ApplyBatchResult(const model::MutationBatchResult& batch_result);
 
   /**
@@ -382,6 +419,11 @@ class LocalStore : public bundle::BundleCallback {
   /** Used to generate target IDs for queries tracked locally. */
   core::TargetIdGenerator target_id_generator_;
 
+  bool staged_startup_ = false;
+  bool index_manager_started_ = false;
+  bool overlays_migrated_ = false;
+  StartupTimings startup_timings_;
+
   /**
    * The set of all mutations that have been sent but not yet been applied to
    * the backend.
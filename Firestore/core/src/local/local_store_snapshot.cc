@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/local_store_snapshot.h"
+
+#include <utility>
+
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/document_overlay_cache.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "absl/memory/memory.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using core::Query;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentMap;
+using model::IndexOffset;
+
+LocalStoreSnapshot::LocalStoreSnapshot(
+    std::unique_ptr<RemoteDocumentCache> remote_document_cache,
+    std::shared_ptr<DocumentOverlayCache> document_overlay_cache)
+    : remote_document_cache_(std::move(remote_document_cache)),
+      document_overlay_cache_(std::move(document_overlay_cache)) {
+  // The overlays already include all pending writes, so the view never needs
+  // the mutation queue. Without an index manager, the view can't look up the
+  // collections of a collection group.
+  local_documents_ = absl::make_unique<LocalDocumentsView>(
+      remote_document_cache_.get(), /*mutation_queue=*/nullptr,
+      document_overlay_cache_.get(), /*index_manager=*/nullptr);
+}
+
+// Out of line because of unique_ptrs to incomplete types.
+LocalStoreSnapshot::~LocalStoreSnapshot() = default;
+
+Document LocalStoreSnapshot::ReadDocument(const DocumentKey& key) const {
+  return local_documents_->GetDocument(key);
+}
+
+DocumentMap LocalStoreSnapshot::ExecuteQuery(const Query& query) const {
+  HARD_ASSERT(!query.IsCollectionGroupQuery(),
+              "Cannot run collection group query %s against a snapshot",
+              query.ToString());
+  return local_documents_->GetDocumentsMatchingQuery(
+      core::QueryOrPipeline(query), IndexOffset::None());
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
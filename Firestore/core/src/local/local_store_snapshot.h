@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_STORE_SNAPSHOT_H_
+#define FIRESTORE_CORE_SRC_LOCAL_LOCAL_STORE_SNAPSHOT_H_
+
+#include <memory>
+
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/model_fwd.h"
+
+namespace firebase {
+namespace firestore {
+
+namespace core {
+class Query;
+}  // namespace core
+
+namespace local {
+
+class DocumentOverlayCache;
+class LocalDocumentsView;
+class RemoteDocumentCache;
+
+/**
+ * A read-only view of the local documents as of the moment it was taken,
+ * created by `LocalStore::TakeSnapshot()`.
+ *
+ * Unlike the `LocalStore`, a snapshot can be read from any thread and by
+ * several threads at once, without a transaction. It includes pending writes,
+ * but doesn't see any changes made after it was taken.
+ */
+class LocalStoreSnapshot {
+ public:
+  LocalStoreSnapshot(
+      std::unique_ptr<RemoteDocumentCache> remote_document_cache,
+      std::shared_ptr<DocumentOverlayCache> document_overlay_cache);
+
+  ~LocalStoreSnapshot();
+
+  /**
+   * Returns the local view of the document with the given key, or an invalid
+   * document if not found.
+   */
+  model::Document ReadDocument(const model::DocumentKey& key) const;
+
+  /**
+   * Returns the local view of the documents matching `query` by scanning the
+   * query's collection. Collection group queries aren't supported, since
+   * finding their collections requires the index manager.
+   */
+  model::DocumentMap ExecuteQuery(const core::Query& query) const;
+
+ private:
+  std::unique_ptr<RemoteDocumentCache> remote_document_cache_;
+  // Possibly shared with other snapshots; only ever read.
+  std::shared_ptr<DocumentOverlayCache> document_overlay_cache_;
+  std::unique_ptr<LocalDocumentsView> local_documents_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_LOCAL_STORE_SNAPSHOT_H_
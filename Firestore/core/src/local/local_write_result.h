@@ -22,6 +22,7 @@
 #include "Firestore/core/src/immutable/sorted_map.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/overlayed_document.h"
 #include "Firestore/core/src/model/types.h"
 
 namespace firebase {
@@ -36,7 +36,7 @@ using model::ResourcePath;
 bool MemoryCollectionParentIndex::Add(const ResourcePath& collection_path) {
   HARD_ASSERT(collection_path.size() % 2 == 1, "Expected a collection path.");
 
-  std::string collection_id = collection_path.last_segment();
+  std::string collection_id(collection_path.last_segment());
   ResourcePath parent_path = collection_path.PopLast();
   std::set<ResourcePath>& existing_parents = index_[collection_id];
   bool inserted = existing_parents.insert(parent_path).second;
@@ -95,8 +95,14 @@ const DocumentMap QueryEngine::GetDocumentsMatchingQuery(
 void QueryEngine::CreateCacheIndexes(const core::QueryOrPipeline& query,
                                      const QueryContext& context,
                                      size_t result_size) const {
-  if (query.IsPipeline()) {
-    LOG_DEBUG("SDK will skip creating cache indexes for pipelines.");
+  absl::optional<core::Target> target =
+      query.IsPipeline() ? core::ToIndexTarget(query.pipeline())
+                         : query.query().ToTarget();
+  if (!target) {
+    LOG_DEBUG(
+        "SDK will skip creating cache indexes for pipeline: %s, since none of "
+        "its filters can be served from an index.",
+        query.ToString());
     return;
   }
 
@@ -117,7 +123,7 @@ void QueryEngine::CreateCacheIndexes(const core::QueryOrPipeline& query,
 
   if (context.GetDocumentReadCount() >
       relative_index_read_cost_per_document_ * result_size) {
-    index_manager_->CreateTargetIndexes(query.query().ToTarget());
+    index_manager_->CreateTargetIndexes(*target);
     LOG_DEBUG(
         "The SDK decides to create cache indexes for query: %s, as using cache "
         "indexes may help improve performance.",
@@ -132,8 +138,7 @@ void QueryEngine::SetIndexAutoCreationEnabled(bool is_enabled) {
 absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
     const core::QueryOrPipeline& query_or_pipeline) const {
   if (query_or_pipeline.IsPipeline()) {
-    LOG_DEBUG("Skipping using indexes for pipelines.");
-    return absl::nullopt;
+    return PerformPipelineUsingIndex(query_or_pipeline);
   }
 
   const auto& query = query_or_pipeline.query();
@@ -197,6 +202,54 @@ absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
   return AppendRemainingResults(previous_results, query_or_pipeline, offset);
 }
 
+absl::optional<DocumentMap> QueryEngine::PerformPipelineUsingIndex(
+    const core::QueryOrPipeline& pipeline) const {
+  if (pipeline.MatchesAllDocuments()) {
+    // Don't use indexes for pipelines that can be executed by scanning the
+    // collection.
+    return absl::nullopt;
+  }
+
+  absl::optional<core::Target> target =
+      core::ToIndexTarget(pipeline.pipeline());
+  if (!target) {
+    // None of the pipeline's filters can be looked up in an index.
+    return absl::nullopt;
+  }
+
+  const IndexManager::IndexType index_type =
+      index_manager_->GetIndexType(*target);
+  if (index_type == IndexManager::IndexType::NONE) {
+    // The target cannot be served from any index.
+    return absl::nullopt;
+  }
+
+  auto keys = index_manager_->GetDocumentsMatchingTarget(*target);
+  HARD_ASSERT(
+      keys.has_value(),
+      "index manager must return results for partial and full indexes.");
+
+  DocumentKeySet indexed_keys;
+  for (const auto& key : keys.value()) {
+    indexed_keys = indexed_keys.insert(key);
+  }
+
+  // The target returns a superset of the documents that match the pipeline,
+  // whether or not the index is partial, so every document is run through the
+  // pipeline again. It has no limit, so there is nothing to refill: the
+  // pipeline's limit is applied once local edits are merged in.
+  DocumentMap indexed_documents =
+      local_documents_view_->GetDocuments(indexed_keys);
+  model::IndexOffset offset = index_manager_->GetMinOffset(*target);
+  DocumentSet previous_results = ApplyQuery(pipeline, indexed_documents);
+
+  LOG_DEBUG("Using index to execute pipeline: %s", pipeline.ToString());
+
+  // Retrieve all results for documents that were updated since the index was
+  // last updated.
+  return AppendRemainingResults(previous_results, pipeline, offset);
+}
+
 absl::optional<DocumentMap> QueryEngine::PerformQueryUsingRemoteKeys(
     const core::QueryOrPipeline& query,
     const DocumentKeySet& remote_keys,
@@ -93,6 +93,14 @@ class QueryEngine {
   absl::optional<model::DocumentMap> PerformQueryUsingIndex(
       const core::QueryOrPipeline& query_or_pipeline) const;
 
+  /**
+   * Performs a pipeline using the index of the target its leading filters
+   * translate to, and runs the documents it returns through the pipeline.
+   * Returns nullopt if no such target or no index for it exists.
+   */
+  absl::optional<model::DocumentMap> PerformPipelineUsingIndex(
+      const core::QueryOrPipeline& pipeline) const;
+
   /**
    * Performs a query based on the target's persisted query mapping. Returns
    * nullopt if the mapping is not available or cannot be used.
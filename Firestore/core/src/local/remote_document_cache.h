@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 
+#include <memory>
 #include <string>
 
 #include "Firestore/core/src/core/pipeline_util.h"  // Added
@@ -151,6 +152,17 @@ class RemoteDocumentCache {
    * @param manager A pointer to an `IndexManager` owned by `Persistence`.
    */
   virtual void SetIndexManager(IndexManager* manager) = 0;
+
+  /**
+   * Returns a read-only copy of the cache as of now, which can be read from
+   * any thread and outside of a transaction, or null if this cache doesn't
+   * support snapshots.
+   *
+   * Must be called in a transaction.
+   */
+  virtual std::unique_ptr<RemoteDocumentCache> CreateSnapshot() const {
+    return nullptr;
+  }
 };
 
 }  // namespace local
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/startup_timings.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+const char* PhaseName(StartupTimings::Phase phase) {
+  switch (phase) {
+    case StartupTimings::Phase::kOpenPersistence:
+      return "open persistence";
+    case StartupTimings::Phase::kStartMutationQueue:
+      return "start mutation queue";
+    case StartupTimings::Phase::kStartIndexManager:
+      return "start index manager";
+    case StartupTimings::Phase::kMigrateOverlays:
+      return "migrate overlays";
+    case StartupTimings::Phase::kReadTargetMetadata:
+      return "read target metadata";
+    case StartupTimings::Phase::kStartRemoteStore:
+      return "start remote store";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+std::string StartupTimings::ToString() const {
+  std::string description;
+  for (size_t i = 0; i != kPhaseCount; ++i) {
+    if (!durations_[i]) {
+      continue;
+    }
+    absl::StrAppend(&description, description.empty() ? "" : ", ",
+                    PhaseName(static_cast<Phase>(i)), ": ",
+                    durations_[i]->count(), "us");
+  }
+  return description.empty() ? "no phases have run" : description;
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
+#define FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
+
+#include <array>
+#include <chrono>
+#include <string>
+
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * How long each phase of starting the client took, so that cold start
+ * regressions can be measured. Phases that are deferred until first use are
+ * recorded when they run; until then their duration is unknown.
+ */
+class StartupTimings {
+ public:
+  using Duration = std::chrono::microseconds;
+
+  enum class Phase {
+    /** Opening the persistence layer, including any schema migrations. */
+    kOpenPersistence,
+    /** Starting the mutation queue of the current user. */
+    kStartMutationQueue,
+    /** Loading the field indexes and their states. */
+    kStartIndexManager,
+    /** Computing overlays for mutations written before overlays existed. */
+    kMigrateOverlays,
+    /** Reading the highest target id. */
+    kReadTargetMetadata,
+    /** Starting the remote store. */
+    kStartRemoteStore,
+  };
+
+  /** Runs `work` and records how long it took as the duration of `phase`. */
+  template <typename Work>
+  void Measure(Phase phase, const Work& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    Record(phase, std::chrono::duration_cast<Duration>(
+                      std::chrono::steady_clock::now() - start));
+  }
+
+  void Record(Phase phase, Duration duration) {
+    durations_[static_cast<size_t>(phase)] = duration;
+  }
+
+  /** Returns how long `phase` took, or nullopt if it hasn't run. */
+  absl::optional<Duration> duration(Phase phase) const {
+    return durations_[static_cast<size_t>(phase)];
+  }
+
+  /** Describes the duration of each phase that has run, for logging. */
+  std::string ToString() const;
+
+ private:
+  static constexpr size_t kPhaseCount =
+      static_cast<size_t>(Phase::kStartRemoteStore) + 1;
+
+  std::array<absl::optional<Duration>, kPhaseCount> durations_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_STARTUP_TIMINGS_H_
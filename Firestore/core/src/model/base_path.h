@@ -18,8 +18,15 @@
 #define FIRESTORE_CORE_SRC_MODEL_BASE_PATH_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,12 +34,75 @@
 #include "Firestore/core/src/util/comparison.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/hashing.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
 namespace model {
 namespace impl {
 
+/**
+ * The immutable storage behind a path: the offsets at which each segment is
+ * encoded, followed by the encoded segments, in a single reference-counted
+ * allocation. Paths derived by `PopFirst` and `PopLast` view a range of the
+ * same buffer.
+ */
+class PathBuffer {
+ public:
+  /**
+   * Allocates a buffer for `size` segments encoded in `byte_count` bytes, with
+   * a reference count of one. The offsets and bytes are uninitialized.
+   */
+  static PathBuffer* Allocate(size_t size, size_t byte_count) {
+    HARD_ASSERT(byte_count <= std::numeric_limits<uint32_t>::max(),
+                "path of %s bytes is too long", byte_count);
+    void* memory = ::operator new(sizeof(PathBuffer) +
+                                  (size + 1) * sizeof(uint32_t) + byte_count);
+    return new (memory) PathBuffer(size);
+  }
+
+  PathBuffer(const PathBuffer&) = delete;
+  PathBuffer& operator=(const PathBuffer&) = delete;
+
+  void Ref() {
+    ref_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Unref() {
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~PathBuffer();
+      ::operator delete(this);
+    }
+  }
+
+  /**
+   * The offset in `bytes()` of each encoded segment, followed by the total
+   * number of bytes.
+   */
+  uint32_t* offsets() {
+    return reinterpret_cast<uint32_t*>(this + 1);
+  }
+  const uint32_t* offsets() const {
+    return reinterpret_cast<const uint32_t*>(this + 1);
+  }
+
+  char* bytes() {
+    return reinterpret_cast<char*>(offsets() + size_ + 1);
+  }
+  const char* bytes() const {
+    return reinterpret_cast<const char*>(offsets() + size_ + 1);
+  }
+
+ private:
+  explicit PathBuffer(size_t size) : size_{static_cast<uint32_t>(size)} {
+  }
+  ~PathBuffer() = default;
+
+  std::atomic<uint32_t> ref_count_{1};
+  uint32_t size_;
+};
+
 /**
  * BasePath represents a path sequence in the Firestore database. It is composed
  * of an ordered sequence of string segments.
@@ -40,6 +110,16 @@ namespace impl {
  * BasePath is reassignable and movable. Apart from those, all other mutating
  * operations return new independent instances.
  *
+ * The segments are stored back to back in a single `PathBuffer`, each one
+ * preceded by its length, along with the offset of each segment. Indexing is
+ * constant time, and copying a path, `PopFirst` and `PopLast` share the buffer
+ * instead of allocating. Since the encoding of a segment never is a prefix of
+ * the encoding of another one, equality and prefix checks come down to
+ * comparing bytes with `memcmp`, and ordering only compares the segment in
+ * which the bytes first differ. Segments are exposed as `absl::string_view`s
+ * into the buffer, which remain valid as long as the path or a path derived
+ * from it is alive.
+ *
  * ## Subclassing Notes
  *
  * BasePath is strictly meant as a base class for concrete implementations. It
@@ -54,52 +134,108 @@ class BasePath {
   using SegmentsT = std::vector<std::string>;
 
  public:
-  using const_iterator = SegmentsT::const_iterator;
+  /** Iterates over the segments of a path, as `absl::string_view`s. */
+  class const_iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = absl::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const absl::string_view*;
+    using reference = const absl::string_view&;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+      return segment_;
+    }
+    pointer operator->() const {
+      return &segment_;
+    }
+
+    const_iterator& operator++() {
+      Load(index_ + 1);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator result = *this;
+      ++*this;
+      return result;
+    }
+    const_iterator operator+(difference_type n) const {
+      return const_iterator{path_, index_ + static_cast<size_t>(n)};
+    }
+
+    friend bool operator==(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class BasePath;
+
+    const_iterator(const BasePath* path, size_t index) : path_{path} {
+      Load(index);
+    }
+
+    void Load(size_t index) {
+      index_ = index;
+      if (index_ < path_->size()) {
+        segment_ = (*path_)[index_];
+      }
+    }
+
+    const BasePath* path_ = nullptr;
+    size_t index_ = 0;
+    absl::string_view segment_;
+  };
 
   /** Returns i-th segment of the path. */
-  const std::string& operator[](const size_t i) const {
-    HARD_ASSERT(i < segments_.size(), "index %s out of range", i);
-    return segments_[i];
+  absl::string_view operator[](const size_t i) const {
+    HARD_ASSERT(i < size(), "index %s out of range", i);
+    return DecodeSegment(buffer_->bytes() + buffer_->offsets()[begin_ + i]);
   }
 
   /** Returns the first segment of the path. */
-  const std::string& first_segment() const {
+  absl::string_view first_segment() const {
     HARD_ASSERT(!empty(), "Cannot call first_segment on empty path");
-    return segments_[0];
+    return (*this)[0];
   }
   /** Returns the last segment of the path. */
-  const std::string& last_segment() const {
+  absl::string_view last_segment() const {
     HARD_ASSERT(!empty(), "Cannot call last_segment on empty path");
-    return segments_[size() - 1];
+    return (*this)[size() - 1];
   }
 
   size_t size() const {
-    return segments_.size();
+    return end_ - begin_;
   }
   bool empty() const {
-    return segments_.empty();
+    return begin_ == end_;
   }
 
   const_iterator begin() const {
-    return segments_.begin();
+    return const_iterator{this, 0};
   }
   const_iterator end() const {
-    return segments_.end();
+    return const_iterator{this, size()};
   }
 
   /**
    * Returns a new path which is the result of concatenating this path with an
    * additional segment.
    */
-  T Append(const std::string& segment) const {
-    auto appended = segments_;
-    appended.push_back(segment);
-    return T{std::move(appended)};
-  }
-  T Append(std::string&& segment) const {
-    auto appended = segments_;
-    appended.push_back(std::move(segment));
-    return T{std::move(appended)};
+  T Append(absl::string_view segment) const {
+    T result;
+    BasePath& appended = result;
+    appended.Allocate(size() + 1,
+                      Bytes().size() + EncodedLength(segment.size()));
+    appended.AppendSegments(*this);
+    appended.AppendSegment(segment);
+    return result;
   }
 
   /**
@@ -107,9 +243,14 @@ class BasePath {
    * another path.
    */
   T Append(const T& path) const {
-    auto appended = segments_;
-    appended.insert(appended.end(), path.begin(), path.end());
-    return T{std::move(appended)};
+    const BasePath& other = path;
+    T result;
+    BasePath& appended = result;
+    appended.Allocate(size() + other.size(),
+                      Bytes().size() + other.Bytes().size());
+    appended.AppendSegments(*this);
+    appended.AppendSegments(other);
+    return result;
   }
 
   /**
@@ -119,7 +260,7 @@ class BasePath {
   T PopFirst(const size_t n = 1) const {
     HARD_ASSERT(n <= size(), "Cannot call PopFirst(%s) on path of length %s", n,
                 size());
-    return T{begin() + n, end()};
+    return Slice(begin_ + static_cast<uint32_t>(n), end_);
   }
 
   /**
@@ -128,7 +269,7 @@ class BasePath {
    */
   T PopLast() const {
     HARD_ASSERT(!empty(), "Cannot call PopLast() on empty path");
-    return T{begin(), end() - 1};
+    return Slice(begin_, end_ - 1);
   }
 
   /**
@@ -137,7 +278,7 @@ class BasePath {
    * Empty path is a prefix of any path. Any path is a prefix of itself.
    */
   bool IsPrefixOf(const T& rhs) const {
-    return size() <= rhs.size() && std::equal(begin(), end(), rhs.begin());
+    return size() <= rhs.size() && IsBufferPrefixOf(rhs);
   }
 
   /**
@@ -147,7 +288,7 @@ class BasePath {
    */
   bool IsImmediateParentOf(const T& potential_child) const {
     return size() + 1 == potential_child.size() &&
-           std::equal(begin(), end(), potential_child.begin());
+           IsBufferPrefixOf(potential_child);
   }
 
   /**
@@ -156,42 +297,204 @@ class BasePath {
    * ascending order, followed by string segments in lexicographical order.
    */
   util::ComparisonResult CompareTo(const T& rhs) const {
-    size_t min_size = std::min(size(), rhs.size());
-    for (size_t i = 0; i < min_size; ++i) {
-      auto cmp = CompareSegments(segments_[i], rhs.segments_[i]);
-      if (!util::Same(cmp)) return cmp;
+    const BasePath& other = rhs;
+    absl::string_view lhs_bytes = Bytes();
+    absl::string_view rhs_bytes = other.Bytes();
+    size_t common = std::min(lhs_bytes.size(), rhs_bytes.size());
+    size_t mismatch = static_cast<size_t>(
+        std::mismatch(lhs_bytes.begin(), lhs_bytes.begin() + common,
+                      rhs_bytes.begin())
+            .first -
+        lhs_bytes.begin());
+    if (mismatch == common) {
+      // The shorter encoding ends on a segment boundary, so its segments are
+      // a prefix of the other path's.
+      return util::Compare(size(), other.size());
     }
-    return util::Compare(size(), rhs.size());
+
+    // Both paths share every segment that ends before `mismatch`, so only the
+    // segment containing it needs to be compared, and it starts at the same
+    // offset in both.
+    size_t i = SegmentAt(mismatch);
+    return CompareSegments((*this)[i], other[i]);
   }
 
   friend bool operator==(const BasePath& lhs, const BasePath& rhs) {
-    return lhs.segments_ == rhs.segments_;
+    return lhs.size() == rhs.size() && lhs.Bytes() == rhs.Bytes();
   }
 
   size_t Hash() const {
-    return util::Hash(segments_);
+    return util::Hash(Bytes());
   }
 
  protected:
   BasePath() = default;
   template <typename IterT>
-  BasePath(const IterT begin, const IterT end) : segments_{begin, end} {
+  BasePath(const IterT begin, const IterT end) {
+    size_t size = 0;
+    size_t byte_count = 0;
+    for (IterT it = begin; it != end; ++it) {
+      ++size;
+      byte_count += EncodedLength(absl::string_view{*it}.size());
+    }
+    if (size == 0) return;
+
+    Allocate(size, byte_count);
+    for (IterT it = begin; it != end; ++it) {
+      AppendSegment(*it);
+    }
   }
-  BasePath(std::initializer_list<std::string> list) : segments_{list} {
+  BasePath(std::initializer_list<std::string> list)
+      : BasePath{list.begin(), list.end()} {
   }
-  explicit BasePath(SegmentsT&& segments) : segments_{std::move(segments)} {
+  explicit BasePath(const SegmentsT& segments)
+      : BasePath{segments.begin(), segments.end()} {
+  }
+
+  BasePath(const BasePath& other)
+      : buffer_{other.buffer_}, begin_{other.begin_}, end_{other.end_} {
+    if (buffer_) buffer_->Ref();
+  }
+  BasePath& operator=(const BasePath& other) {
+    if (other.buffer_) other.buffer_->Ref();
+    if (buffer_) buffer_->Unref();
+    buffer_ = other.buffer_;
+    begin_ = other.begin_;
+    end_ = other.end_;
+    return *this;
+  }
+
+  // A moved-from path is left empty.
+  BasePath(BasePath&& other) noexcept
+      : buffer_{std::exchange(other.buffer_, nullptr)},
+        begin_{std::exchange(other.begin_, 0)},
+        end_{std::exchange(other.end_, 0)} {
+  }
+  BasePath& operator=(BasePath&& other) noexcept {
+    if (this != &other) {
+      if (buffer_) buffer_->Unref();
+      buffer_ = std::exchange(other.buffer_, nullptr);
+      begin_ = std::exchange(other.begin_, 0);
+      end_ = std::exchange(other.end_, 0);
+    }
+    return *this;
+  }
+
+  ~BasePath() {
+    if (buffer_) buffer_->Unref();
   }
 
  private:
-  SegmentsT segments_;
+  /** Returns the number of bytes used to encode a segment of `length`. */
+  static size_t EncodedLength(size_t length) {
+    size_t result = length + 1;
+    for (; length >= 0x80; length >>= 7) {
+      ++result;
+    }
+    return result;
+  }
+
+  /**
+   * Decodes the segment whose length is encoded at `position`. Lengths are
+   * written 7 bits at a time, least significant first, with the high bit set
+   * on all but the last byte.
+   */
+  static absl::string_view DecodeSegment(const char* position) {
+    size_t length = 0;
+    for (int shift = 0;; shift += 7) {
+      auto byte = static_cast<unsigned char>(*position++);
+      length |= static_cast<size_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) break;
+    }
+    return absl::string_view{position, length};
+  }
+
+  /** Makes this path an empty path with room for the given segments. */
+  void Allocate(size_t size, size_t byte_count) {
+    HARD_ASSERT(buffer_ == nullptr);
+    buffer_ = PathBuffer::Allocate(size, byte_count);
+    buffer_->offsets()[0] = 0;
+  }
+
+  /** Appends a segment to the buffer allocated by `Allocate`. */
+  void AppendSegment(absl::string_view segment) {
+    uint32_t* offsets = buffer_->offsets();
+    char* out = buffer_->bytes() + offsets[end_];
+    size_t length = segment.size();
+    for (; length >= 0x80; length >>= 7) {
+      *out++ = static_cast<char>((length & 0x7f) | 0x80);
+    }
+    *out++ = static_cast<char>(length);
+    std::memcpy(out, segment.data(), segment.size());
+    ++end_;
+    offsets[end_] =
+        static_cast<uint32_t>(out + segment.size() - buffer_->bytes());
+  }
+
+  /** Appends all segments of `other` to the buffer allocated by `Allocate`. */
+  void AppendSegments(const BasePath& other) {
+    if (other.empty()) return;
+
+    absl::string_view bytes = other.Bytes();
+    uint32_t* offsets = buffer_->offsets();
+    const uint32_t start = offsets[end_];
+    std::memcpy(buffer_->bytes() + start, bytes.data(), bytes.size());
+
+    const uint32_t* other_offsets = other.buffer_->offsets();
+    const uint32_t other_start = other_offsets[other.begin_];
+    for (uint32_t i = other.begin_ + 1; i <= other.end_; ++i) {
+      offsets[++end_] = start + (other_offsets[i] - other_start);
+    }
+  }
+
+  /** Returns the encoded segments of this path. */
+  absl::string_view Bytes() const {
+    if (empty()) return {};
+    const uint32_t* offsets = buffer_->offsets();
+    return absl::string_view{buffer_->bytes() + offsets[begin_],
+                             offsets[end_] - offsets[begin_]};
+  }
+
+  /** Returns the index of the segment encoded at `Bytes()[position]`. */
+  size_t SegmentAt(size_t position) const {
+    const uint32_t* offsets = buffer_->offsets();
+    const uint32_t target = offsets[begin_] + static_cast<uint32_t>(position);
+    const uint32_t* after =
+        std::upper_bound(offsets + begin_, offsets + end_, target);
+    return static_cast<size_t>(after - (offsets + begin_)) - 1;
+  }
+
+  /** Returns a path holding segments `[begin, end)` of this path's buffer. */
+  T Slice(uint32_t begin, uint32_t end) const {
+    T result;
+    if (begin == end) return result;
+
+    BasePath& sliced = result;
+    buffer_->Ref();
+    sliced.buffer_ = buffer_;
+    sliced.begin_ = begin;
+    sliced.end_ = end;
+    return result;
+  }
+
+  /** Returns true if the segments of this path start those of `rhs`. */
+  bool IsBufferPrefixOf(const BasePath& rhs) const {
+    return absl::StartsWith(rhs.Bytes(), Bytes());
+  }
+
+  // Null for an empty path.
+  PathBuffer* buffer_ = nullptr;
+  // The range of segments in `buffer_` that make up this path.
+  uint32_t begin_ = 0;
+  uint32_t end_ = 0;
 
   static const size_t kNumericIdPrefixLength = 4;
   static const size_t kNumericIdSuffixLength = 2;
   static const size_t kNumericIdTotalOverhead =
       kNumericIdPrefixLength + kNumericIdSuffixLength;
 
-  static util::ComparisonResult CompareSegments(const std::string& lhs,
-                                                const std::string& rhs) {
+  static util::ComparisonResult CompareSegments(absl::string_view lhs,
+                                                absl::string_view rhs) {
     bool isLhsNumeric = IsNumericId(lhs);
     bool isRhsNumeric = IsNumericId(rhs);
 
@@ -206,15 +509,18 @@ class BasePath {
     }
   }
 
-  static bool IsNumericId(const std::string& segment) {
+  // Compares in place rather than through `substr`, since this runs for every
+  // segment of every path comparison.
+  static bool IsNumericId(absl::string_view segment) {
     return segment.size() > kNumericIdTotalOverhead &&
-           segment.substr(0, kNumericIdPrefixLength) == "__id" &&
-           segment.substr(segment.size() - kNumericIdSuffixLength) == "__";
+           segment.compare(0, kNumericIdPrefixLength, "__id") == 0 &&
+           segment.compare(segment.size() - kNumericIdSuffixLength,
+                           kNumericIdSuffixLength, "__") == 0;
   }
 
-  static int64_t ExtractNumericId(const std::string& segment) {
-    return std::stol(segment.substr(kNumericIdPrefixLength,
-                                    segment.size() - kNumericIdSuffixLength));
+  static int64_t ExtractNumericId(absl::string_view segment) {
+    return std::stol(std::string(segment.substr(
+        kNumericIdPrefixLength, segment.size() - kNumericIdSuffixLength)));
   }
 };
 
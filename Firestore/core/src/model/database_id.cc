@@ -43,7 +43,8 @@ DatabaseId DatabaseId::FromName(const std::string& name) {
   // database_id not empty
   HARD_ASSERT(!resource_name[3].empty());
 
-  return DatabaseId{resource_name[1], resource_name[3]};
+  return DatabaseId{std::string(resource_name[1]),
+                    std::string(resource_name[3])};
 }
 
 util::ComparisonResult DatabaseId::CompareTo(
@@ -36,17 +36,14 @@ void AssertValidPath(const ResourcePath& path) {
 
 }  // namespace
 
-DocumentKey::DocumentKey() : path_{std::make_shared<ResourcePath>()} {
-}
+DocumentKey::DocumentKey() = default;
 
-DocumentKey::DocumentKey(const ResourcePath& path)
-    : path_{std::make_shared<ResourcePath>(path)} {
-  AssertValidPath(*path_);
+DocumentKey::DocumentKey(const ResourcePath& path) : path_{path} {
+  AssertValidPath(path_);
 }
 
-DocumentKey::DocumentKey(ResourcePath&& path)
-    : path_{std::make_shared<ResourcePath>(std::move(path))} {
-  AssertValidPath(*path_);
+DocumentKey::DocumentKey(ResourcePath&& path) : path_{std::move(path)} {
+  AssertValidPath(path_);
 }
 
 DocumentKey DocumentKey::FromPathString(const std::string& path) {
@@ -91,7 +88,7 @@ bool operator>(const DocumentKey& lhs, const DocumentKey& rhs) {
 }
 
 size_t DocumentKey::Hash() const {
-  return util::Hash(ToString());
+  return path().Hash();
 }
 
 std::string DocumentKey::ToString() const {
@@ -103,14 +100,13 @@ std::ostream& operator<<(std::ostream& os, const DocumentKey& key) {
 }
 
 const ResourcePath& DocumentKey::path() const {
-  return path_ ? *path_ : Empty().path();
+  return path_;
 }
 
 /** Returns true if the document is in the specified collection_id. */
 bool DocumentKey::HasCollectionGroup(absl::string_view collection_group) const {
-  const auto collection_id_opt = GetCollectionGroup();
-  return collection_id_opt.has_value() &&
-         collection_id_opt.value() == collection_group;
+  const size_t size = path().size();
+  return size >= 2 && path()[size - 2] == collection_group;
 }
 
 absl::optional<std::string> DocumentKey::GetCollectionGroup() const {
@@ -118,7 +114,7 @@ absl::optional<std::string> DocumentKey::GetCollectionGroup() const {
   if (size < 2) {
     return absl::nullopt;
   }
-  return path()[size - 2];
+  return std::string(path()[size - 2]);
 }
 
 size_t DocumentKeyHash::operator()(const DocumentKey& key) const noexcept {
@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 
+#include "Firestore/core/src/model/resource_path.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
@@ -35,8 +36,6 @@ enum class ComparisonResult;
 
 namespace model {
 
-class ResourcePath;
-
 /**
  * DocumentKey represents the location of a document in the Firestore database.
  */
@@ -89,9 +88,9 @@ class DocumentKey {
   absl::optional<std::string> GetCollectionGroup() const;
 
  private:
-  // This is an optimization to make passing DocumentKey around cheaper (it's
-  // copied often).
-  std::shared_ptr<const ResourcePath> path_;
+  // Copying a ResourcePath only shares its segment buffer, so keys are cheap
+  // to pass around (they're copied often) without an extra indirection.
+  ResourcePath path_;
 };
 
 inline bool operator!=(const DocumentKey& lhs, const DocumentKey& rhs) {
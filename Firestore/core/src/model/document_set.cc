@@ -16,11 +16,14 @@
 
 #include "Firestore/core/src/model/document_set.h"
 
+#include <algorithm>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/immutable/sorted_set.h"
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/util/empty.h"
 #include "Firestore/core/src/util/hashing.h"
 #include "Firestore/core/src/util/to_string.h"
 #include "absl/algorithm/container.h"
@@ -46,6 +49,44 @@ DocumentSet::DocumentSet(DocumentComparator&& comparator)
     : index_{}, sorted_set_{std::move(comparator)} {
 }
 
+DocumentSet DocumentSet::FromDocuments(DocumentComparator&& comparator,
+                                       std::vector<Document> documents) {
+  // Callers usually pass the documents already in comparator order.
+  auto ascending = [&comparator](const Document& lhs, const Document& rhs) {
+    return util::Ascending(comparator.Compare(lhs, rhs));
+  };
+  if (!std::is_sorted(documents.begin(), documents.end(), ascending)) {
+    std::sort(documents.begin(), documents.end(), ascending);
+  }
+
+  // The index needs key order, which is sorted separately so that
+  // `documents` keeps the comparator order.
+  std::vector<std::pair<DocumentKey, Document>> index_entries;
+  index_entries.reserve(documents.size());
+  for (const Document& document : documents) {
+    index_entries.emplace_back(document->key(), document);
+  }
+  auto by_key = [](const std::pair<DocumentKey, Document>& lhs,
+                   const std::pair<DocumentKey, Document>& rhs) {
+    return lhs.first < rhs.first;
+  };
+  if (!std::is_sorted(index_entries.begin(), index_entries.end(), by_key)) {
+    std::sort(index_entries.begin(), index_entries.end(), by_key);
+  }
+  DocumentMap index = DocumentMap::FromSortedEntries(index_entries.begin(),
+                                                     index_entries.end());
+
+  std::vector<std::pair<Document, util::Empty>> set_entries;
+  set_entries.reserve(documents.size());
+  for (Document& document : documents) {
+    set_entries.emplace_back(std::move(document), util::Empty{});
+  }
+  SetType set{SetType::map_type::FromSortedEntries(
+      set_entries.begin(), set_entries.end(), comparator)};
+
+  return {std::move(index), std::move(set)};
+}
+
 bool operator==(const DocumentSet& lhs, const DocumentSet& rhs) {
   return absl::c_equal(lhs.sorted_set_, rhs.sorted_set_);
 }
@@ -69,6 +69,14 @@ class DocumentSet : public immutable::SortedContainer {
    */
   explicit DocumentSet(DocumentComparator&& comparator);
 
+  /**
+   * Creates a DocumentSet of the given documents, which must have distinct
+   * keys, sorted by the given comparator. The documents are sorted up front
+   * and the set is built in a single pass, rather than one insert at a time.
+   */
+  static DocumentSet FromDocuments(DocumentComparator&& comparator,
+                                   std::vector<Document> documents);
+
   size_t size() const {
     return index_.size();
   }
@@ -70,7 +70,7 @@ bool IsValidIdentifier(const std::string& segment) {
 
 /** A custom formatter to be used with absl::StrJoin(). */
 struct JoinEscaped {
-  static std::string escaped_segment(const std::string& segment) {
+  static std::string escaped_segment(absl::string_view segment) {
     auto escaped = absl::StrReplaceAll(segment, {{"\\", "\\\\"}, {"`", "\\`"}});
     const bool needs_escaping = !IsValidIdentifier(escaped);
     if (needs_escaping) {
@@ -81,7 +81,7 @@ struct JoinEscaped {
   }
 
   template <typename T>
-  void operator()(T* out, const std::string& segment) {
+  void operator()(T* out, absl::string_view segment) {
     out->append(escaped_segment(segment));
   }
 };
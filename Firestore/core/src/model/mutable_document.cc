@@ -26,9 +26,9 @@ namespace firestore {
 namespace model {
 
 MutableDocument MutableDocument::InvalidDocument(DocumentKey document_key) {
-  return {std::move(document_key),         DocumentType::kInvalid,
-          SnapshotVersion::None(),         SnapshotVersion::None(),
-          std::make_shared<ObjectValue>(), DocumentState::kSynced};
+  return {std::move(document_key), DocumentType::kInvalid,
+          SnapshotVersion::None(), SnapshotVersion::None(),
+          EmptyValue(),            DocumentState::kSynced};
 }
 
 MutableDocument MutableDocument::FoundDocument(DocumentKey document_key,
@@ -71,7 +71,7 @@ MutableDocument& MutableDocument::ConvertToNoDocument(
     const SnapshotVersion& version) {
   version_ = version;
   document_type_ = DocumentType::kNoDocument;
-  value_ = std::make_shared<ObjectValue>();
+  value_ = EmptyValue();
   document_state_ = DocumentState::kSynced;
   return *this;
 }
@@ -80,7 +80,7 @@ MutableDocument& MutableDocument::ConvertToUnknownDocument(
     const SnapshotVersion& version) {
   version_ = version;
   document_type_ = DocumentType::kUnknownDocument;
-  value_ = std::make_shared<ObjectValue>();
+  value_ = EmptyValue();
   document_state_ = DocumentState::kHasCommittedMutations;
   return *this;
 }
@@ -103,14 +103,31 @@ MutableDocument& MutableDocument::WithReadTime(
 }
 
 MutableDocument MutableDocument::Clone() const {
+  // The empty value is never modified, so clones can keep sharing it.
+  std::shared_ptr<ObjectValue> value =
+      value_ == EmptyValue() ? value_ : std::make_shared<ObjectValue>(*value_);
   return {key_,
           document_type_,
           version_,
           read_time_,
-          std::make_shared<ObjectValue>(DeepClone(value_->Get())),
+          std::move(value),
           document_state_};
 }
 
+ObjectValue& MutableDocument::mutable_data() {
+  // Copies made before this point keep sharing the empty value.
+  if (value_ == EmptyValue()) {
+    value_ = std::make_shared<ObjectValue>();
+  }
+  return *value_;
+}
+
+const std::shared_ptr<ObjectValue>& MutableDocument::EmptyValue() {
+  static const auto* empty =
+      new std::shared_ptr<ObjectValue>(std::make_shared<ObjectValue>());
+  return *empty;
+}
+
 size_t MutableDocument::Hash() const {
   return key_.Hash();
 }
@@ -173,10 +173,17 @@ class MutableDocument {
     return value_->Get();
   }
 
-  ObjectValue& data() const {
+  const ObjectValue& data() const {
     return *value_;
   }
 
+  /**
+   * Returns the document's data for modification. Documents without data
+   * share a single empty value until they are first written to, so this gives
+   * the document its own copy first if needed.
+   */
+  ObjectValue& mutable_data();
+
   std::shared_ptr<ObjectValue> shared_data() const {
     return value_;
   }
@@ -234,13 +241,16 @@ class MutableDocument {
         document_state_{document_state} {
   }
 
+  /** The empty value shared by all documents without data. Never modified. */
+  static const std::shared_ptr<ObjectValue>& EmptyValue();
+
   DocumentKey key_;
   DocumentType document_type_ = DocumentType::kInvalid;
   SnapshotVersion version_;
   SnapshotVersion read_time_;
   // Using a shared pointer to ObjectValue makes MutableDocument copy-assignable
   // without having to manually create a deep clone of its Protobuf contents.
-  std::shared_ptr<ObjectValue> value_ = std::make_shared<ObjectValue>();
+  std::shared_ptr<ObjectValue> value_ = EmptyValue();
   DocumentState document_state_ = DocumentState::kSynced;
 };
 
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 
@@ -27,8 +28,9 @@
 #include "Firestore/core/src/nanopb/fields_array.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
-#include "Firestore/core/src/util/hashing.h"
+#include "Firestore/core/src/nanopb/reader.h"
 
+#include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 
@@ -49,7 +51,9 @@ using nanopb::MakeString;
 using nanopb::MakeStringView;
 using nanopb::Message;
 using nanopb::ReleaseFieldOwnership;
+using nanopb::ScanFields;
 using nanopb::SetRepeatedField;
+using nanopb::StringReader;
 
 size_t CalculateSizeOfUnion(
     const google_firestore_v1_MapValue& map_value,
@@ -152,6 +156,61 @@ void ApplyChanges(
   parent->fields_count = CheckedSize(target_count);
 }
 
+/**
+ * Decodes the values of the top-level fields with the given keys from an
+ * encoded Document in a single pass, without decoding any other field. Keys
+ * that are not present map to nullopt.
+ */
+std::map<std::string, absl::optional<Message<google_firestore_v1_Value>>>
+DecodeDocumentFields(absl::string_view document,
+                     const std::set<std::string>& keys) {
+  constexpr uint32_t kKeyTag = google_firestore_v1_Document_FieldsEntry_key_tag;
+  constexpr uint32_t kValueTag =
+      google_firestore_v1_Document_FieldsEntry_value_tag;
+
+  std::map<std::string, absl::optional<Message<google_firestore_v1_Value>>>
+      result;
+  for (const std::string& key : keys) {
+    result.emplace(key, absl::nullopt);
+  }
+
+  util::ReadContext context;
+  size_t remaining = keys.size();
+  ScanFields(&context, document, [&](uint32_t tag, absl::string_view entry) {
+    if (tag != google_firestore_v1_Document_fields_tag || remaining == 0) {
+      return;
+    }
+
+    absl::string_view entry_key;
+    absl::string_view entry_value;
+    ScanFields(&context, entry,
+               [&](uint32_t field_tag, absl::string_view field) {
+                 if (field_tag == kKeyTag) {
+                   entry_key = field;
+                 } else if (field_tag == kValueTag) {
+                   entry_value = field;
+                 }
+               });
+
+    auto it = result.find(std::string{entry_key});
+    if (it == result.end() || it->second) return;
+
+    StringReader reader{entry_value};
+    auto value = Message<google_firestore_v1_Value>::TryParse(&reader);
+    if (!reader.ok()) {
+      context.set_status(reader.status());
+      return;
+    }
+    SortFields(*value);
+    it->second = std::move(value);
+    --remaining;
+  });
+  HARD_ASSERT(context.ok(), "Document proto failed to parse: %s",
+              context.status().ToString());
+
+  return result;
+}
+
 }  // namespace
 
 ObjectValue::ObjectValue() {
@@ -167,7 +226,22 @@ ObjectValue::ObjectValue(Message<google_firestore_v1_Value> value)
 }
 
 ObjectValue::ObjectValue(const ObjectValue& other)
-    : value_(DeepClone(*other.value_)) {
+    : fingerprint_(other.fingerprint_) {
+  // Copies of an object that has not been decoded yet share its encoded
+  // document and decode it on their own, so copying stays cheap.
+  if (other.encoded_ &&
+      !other.encoded_->decoded.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(other.encoded_->mutex);
+    if (!other.encoded_->decoded.load(std::memory_order_relaxed)) {
+      value_->which_value_type = google_firestore_v1_Value_map_value_tag;
+      value_->map_value = {};
+      encoded_ = absl::make_unique<EncodedDocument>();
+      encoded_->storage = other.encoded_->storage;
+      encoded_->document = other.encoded_->document;
+      return;
+    }
+  }
+  value_ = DeepClone(*other.decoded_value());
 }
 
 ObjectValue ObjectValue::FromMapValue(
@@ -194,6 +268,16 @@ ObjectValue ObjectValue::FromFieldsEntry(
   return ObjectValue{std::move(value)};
 }
 
+ObjectValue ObjectValue::FromEncodedDocument(
+    std::shared_ptr<const std::string> storage,
+    absl::string_view encoded_document) {
+  ObjectValue result;
+  result.encoded_ = absl::make_unique<EncodedDocument>();
+  result.encoded_->storage = std::move(storage);
+  result.encoded_->document = encoded_document;
+  return result;
+}
+
 // TODO(b/443765747) Revert back to absl::flat_hash_map after the absl version
 // is upgraded to later than 20250127.0
 ObjectValue ObjectValue::FromAggregateFieldsEntry(
@@ -230,7 +314,7 @@ ObjectValue ObjectValue::FromAggregateFieldsEntry(
 }
 
 FieldMask ObjectValue::ToFieldMask() const {
-  return ExtractFieldMask(value_->map_value);
+  return ExtractFieldMask(decoded_value()->map_value);
 }
 
 FieldMask ObjectValue::ExtractFieldMask(
@@ -264,13 +348,16 @@ FieldMask ObjectValue::ExtractFieldMask(
 absl::optional<google_firestore_v1_Value> ObjectValue::Get(
     const FieldPath& path) const {
   if (path.empty()) {
-    return *value_;
+    return *decoded_value();
   }
 
-  google_firestore_v1_Value nested_value = *value_;
-  for (const std::string& segment : path) {
+  const google_firestore_v1_Value* field = FindField(path.first_segment());
+  if (!field) return absl::nullopt;
+
+  google_firestore_v1_Value nested_value = *field;
+  for (size_t i = 1; i < path.size(); ++i) {
     google_firestore_v1_MapValue_FieldsEntry* entry =
-        FindEntry(nested_value, segment);
+        FindEntry(nested_value, path[i]);
     if (!entry) return absl::nullopt;
     nested_value = entry->value;
   }
@@ -279,28 +366,95 @@ absl::optional<google_firestore_v1_Value> ObjectValue::Get(
 
 absl::optional<google_firestore_v1_Value> ObjectValue::Get(
     const std::string& key) const {
-  google_firestore_v1_MapValue_FieldsEntry* entry = FindEntry(*value_, key);
-  if (!entry) return absl::nullopt;
-  return entry->value;
+  const google_firestore_v1_Value* field = FindField(key);
+  if (!field) return absl::nullopt;
+  return *field;
 }
 
 google_firestore_v1_Value ObjectValue::Get() const {
-  return *value_;
+  return *decoded_value();
+}
+
+const Message<google_firestore_v1_Value>& ObjectValue::decoded_value() const {
+  if (!encoded_ || encoded_->decoded.load(std::memory_order_acquire)) {
+    return value_;
+  }
+
+  std::lock_guard<std::mutex> lock(encoded_->mutex);
+  if (!encoded_->decoded.load(std::memory_order_relaxed)) {
+    StringReader reader{encoded_->document};
+    auto document = Message<google_firestore_v1_Document>::TryParse(&reader);
+    HARD_ASSERT(reader.ok(), "Document proto failed to parse: %s",
+                reader.status().ToString());
+    value_ = std::move(
+        FromFieldsEntry(document->fields, document->fields_count).value_);
+
+    encoded_->storage.reset();
+    encoded_->document = {};
+    encoded_->decoded.store(true, std::memory_order_release);
+  }
+  return value_;
+}
+
+void ObjectValue::PrefetchFields(const std::set<std::string>& keys) const {
+  if (!encoded_ || encoded_->decoded.load(std::memory_order_acquire)) return;
+
+  std::lock_guard<std::mutex> lock(encoded_->mutex);
+  if (encoded_->decoded.load(std::memory_order_relaxed)) return;
+
+  std::set<std::string> missing;
+  for (const std::string& key : keys) {
+    if (encoded_->fields.find(key) == encoded_->fields.end()) {
+      missing.insert(key);
+    }
+  }
+  if (missing.empty()) return;
+
+  for (auto& field : DecodeDocumentFields(encoded_->document, missing)) {
+    encoded_->fields.insert(std::move(field));
+  }
+}
+
+google_firestore_v1_Value* ObjectValue::mutable_value() {
+  decoded_value();
+  return value_.get();
+}
+
+const google_firestore_v1_Value* ObjectValue::FindField(
+    absl::string_view key) const {
+  if (encoded_ && !encoded_->decoded.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(encoded_->mutex);
+    if (!encoded_->decoded.load(std::memory_order_relaxed)) {
+      auto it = encoded_->fields.find(std::string{key});
+      if (it == encoded_->fields.end()) {
+        auto decoded =
+            DecodeDocumentFields(encoded_->document, {std::string{key}});
+        it = encoded_->fields.insert(std::move(*decoded.begin())).first;
+      }
+      return it->second ? it->second->get() : nullptr;
+    }
+  }
+
+  google_firestore_v1_MapValue_FieldsEntry* entry =
+      FindEntry(*decoded_value(), key);
+  return entry ? &entry->value : nullptr;
 }
 
 void ObjectValue::Set(const FieldPath& path,
                       Message<google_firestore_v1_Value> value) {
   HARD_ASSERT(!path.empty(), "Cannot set field for empty path on ObjectValue");
+  fingerprint_ = util::ThreadSafeMemoizer<uint64_t>();
 
   google_firestore_v1_MapValue* parent_map = ParentMap(path.PopLast());
 
   std::map<std::string, Message<google_firestore_v1_Value>> upserts;
-  upserts[path.last_segment()] = std::move(value);
+  upserts[std::string(path.last_segment())] = std::move(value);
 
   ApplyChanges(parent_map, std::move(upserts), /*deletes=*/{});
 }
 
 void ObjectValue::SetAll(TransformMap data) {
+  fingerprint_ = util::ThreadSafeMemoizer<uint64_t>();
   FieldPath parent;
 
   std::map<std::string, Message<google_firestore_v1_Value>> upserts;
@@ -321,9 +475,9 @@ void ObjectValue::SetAll(TransformMap data) {
     }
 
     if (value) {
-      upserts[path.last_segment()] = std::move(*value);
+      upserts[std::string(path.last_segment())] = std::move(*value);
     } else {
-      deletes.insert(path.last_segment());
+      deletes.emplace(path.last_segment());
     }
   }
 
@@ -333,9 +487,10 @@ void ObjectValue::SetAll(TransformMap data) {
 
 void ObjectValue::Delete(const FieldPath& path) {
   HARD_ASSERT(!path.empty(), "Cannot delete field with empty path");
+  fingerprint_ = util::ThreadSafeMemoizer<uint64_t>();
 
-  google_firestore_v1_Value* nested_value = value_.get();
-  for (const std::string& segment : path.PopLast()) {
+  google_firestore_v1_Value* nested_value = mutable_value();
+  for (absl::string_view segment : path.PopLast()) {
     auto* entry = FindEntry(*nested_value, segment);
     // If the entry is not found, exit early. There is nothing to delete.
     if (!entry) return;
@@ -344,24 +499,30 @@ void ObjectValue::Delete(const FieldPath& path) {
 
   // We can only delete a leaf entry if its parent is a map.
   if (IsMap(*nested_value)) {
-    std::set<std::string> deletes{path.last_segment()};
+    std::set<std::string> deletes{std::string(path.last_segment())};
     ApplyChanges(&nested_value->map_value, /*upserts=*/{}, deletes);
   }
 }
 
 std::string ObjectValue::ToString() const {
-  return CanonicalId(*value_);
+  return CanonicalId(*decoded_value());
 }
 
 size_t ObjectValue::Hash() const {
-  return util::Hash(CanonicalId(*value_));
+  return static_cast<size_t>(Fingerprint());
+}
+
+uint64_t ObjectValue::Fingerprint() const {
+  return fingerprint_.value([&] {
+    return std::make_shared<uint64_t>(model::Fingerprint(*decoded_value()));
+  });
 }
 
 google_firestore_v1_MapValue* ObjectValue::ParentMap(const FieldPath& path) {
-  google_firestore_v1_Value* parent = value_.get();
+  google_firestore_v1_Value* parent = mutable_value();
 
   // Find a or create a parent map entry for `path`.
-  for (const std::string& segment : path) {
+  for (absl::string_view segment : path) {
     google_firestore_v1_MapValue_FieldsEntry* entry =
         FindEntry(*parent, segment);
 
@@ -383,7 +544,7 @@ google_firestore_v1_MapValue* ObjectValue::ParentMap(const FieldPath& path) {
       new_entry->map_value = {};
 
       std::map<std::string, Message<google_firestore_v1_Value>> upserts;
-      upserts[segment] = std::move(new_entry);
+      upserts[std::string(segment)] = std::move(new_entry);
       ApplyChanges(&parent->map_value, std::move(upserts), /*deletes=*/{});
 
       parent = &(FindEntry(*parent, segment)->value);
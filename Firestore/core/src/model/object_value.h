@@ -17,7 +17,10 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_OBJECT_VALUE_H_
 #define FIRESTORE_CORE_SRC_MODEL_OBJECT_VALUE_H_
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <set>
 #include <string>
@@ -31,8 +34,10 @@
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/thread_safe_memoizer.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace firebase {
@@ -70,6 +75,21 @@ class ObjectValue {
   static ObjectValue FromFieldsEntry(
       google_firestore_v1_Document_FieldsEntry* fields_entry, pb_size_t count);
 
+  /**
+   * Creates a new ObjectValue that is backed by the fields of an encoded
+   * `google.firestore.v1.Document` message. The fields are only decoded once
+   * they are accessed: `Get()` with a non-empty path decodes just the
+   * top-level field that the path starts with, and any other access decodes
+   * all fields.
+   *
+   * @param storage The buffer that holds `encoded_document`. It is kept alive
+   * until all fields have been decoded.
+   * @param encoded_document The encoded Document message.
+   */
+  static ObjectValue FromEncodedDocument(
+      std::shared_ptr<const std::string> storage,
+      absl::string_view encoded_document);
+
   /**
    * Creates a new ObjectValue that is backed by the provided aggregation
    * result. ObjectValue takes on ownership of the data and zeroes out the
@@ -105,6 +125,15 @@ class ObjectValue {
    */
   absl::optional<google_firestore_v1_Value> Get(const std::string& key) const;
 
+  /**
+   * If this object was created from an encoded document that has not been
+   * decoded yet, decodes the top-level fields with the given keys in a single
+   * pass over the document. `Get()` calls for paths that start with these
+   * fields then don't need to scan the document again. Has no effect
+   * otherwise.
+   */
+  void PrefetchFields(const std::set<std::string>& keys) const;
+
   /**
    * Returns the ObjectValue in its Protobuf representation.
    */
@@ -141,11 +170,48 @@ class ObjectValue {
 
   size_t Hash() const;
 
+  /**
+   * Returns a fingerprint of this object's contents. The fingerprint is
+   * computed on first use and cached until the object is modified. Objects
+   * that compare equal always have the same fingerprint.
+   */
+  uint64_t Fingerprint() const;
+
   friend bool operator==(const ObjectValue& lhs, const ObjectValue& rhs);
   friend std::ostream& operator<<(std::ostream& out,
                                   const ObjectValue& object_value);
 
  private:
+  /** The encoded fields of an ObjectValue that has not been decoded yet. */
+  struct EncodedDocument {
+    std::shared_ptr<const std::string> storage;
+    absl::string_view document;
+
+    std::mutex mutex;
+    std::atomic<bool> decoded{false};
+
+    /**
+     * Top-level fields decoded by `Get()` before the whole document was
+     * decoded, or nullopt for fields that are not present. Values returned by
+     * `Get()` point into these messages, so they live as long as the object.
+     */
+    std::map<std::string,
+             absl::optional<nanopb::Message<google_firestore_v1_Value>>>
+        fields;
+  };
+
+  /** Returns the backing map value, decoding it first if needed. */
+  const nanopb::Message<google_firestore_v1_Value>& decoded_value() const;
+
+  /** Returns the backing map value for modification, decoding it if needed. */
+  google_firestore_v1_Value* mutable_value();
+
+  /**
+   * Returns the top-level field with the given key, or nullptr if there is no
+   * such field. Only decodes that field if the object is not decoded yet.
+   */
+  const google_firestore_v1_Value* FindField(absl::string_view key) const;
+
   /** Returns the field mask for the provided map value. */
   FieldMask ExtractFieldMask(const google_firestore_v1_MapValue& value) const;
 
@@ -155,11 +221,24 @@ class ObjectValue {
    */
   google_firestore_v1_MapValue* ParentMap(const FieldPath& path);
 
-  nanopb::Message<google_firestore_v1_Value> value_;
+  // Filled in on first access if the object was created from an encoded
+  // document; see `decoded_value()`.
+  mutable nanopb::Message<google_firestore_v1_Value> value_;
+  std::unique_ptr<EncodedDocument> encoded_;
+
+  /** Memoized result of `Fingerprint()`; reset by every mutation. */
+  mutable util::ThreadSafeMemoizer<uint64_t> fingerprint_;
 };
 
 inline bool operator==(const ObjectValue& lhs, const ObjectValue& rhs) {
-  return *lhs.value_ == *rhs.value_;
+  if (&lhs == &rhs) {
+    return true;
+  }
+  // Differing fingerprints prove inequality without walking both trees.
+  if (lhs.Fingerprint() != rhs.Fingerprint()) {
+    return false;
+  }
+  return *lhs.decoded_value() == *rhs.decoded_value();
 }
 
 inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
@@ -168,7 +247,7 @@ inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
 
 inline std::ostream& operator<<(std::ostream& out,
                                 const ObjectValue& object_value) {
-  return out << "ObjectValue(" << *object_value.value_ << ")";
+  return out << "ObjectValue(" << *object_value.decoded_value() << ")";
 }
 
 }  // namespace model
@@ -87,7 +87,7 @@ void PatchMutation::Rep::ApplyToRemoteDocument(
     return;
   }
 
-  ObjectValue& data = document.data();
+  ObjectValue& data = document.mutable_data();
   auto transform_results =
       ServerTransformResults(data, mutation_result.transform_results());
   data.SetAll(GetPatch());
@@ -106,7 +106,7 @@ absl::optional<FieldMask> PatchMutation::Rep::ApplyToLocalView(
     return previous_mask;
   }
 
-  ObjectValue& data = document.data();
+  ObjectValue& data = document.mutable_data();
   auto transform_results = LocalTransformResults(data, local_write_time);
   data.SetAll(GetPatch());
   data.SetAll(std::move(transform_results));
@@ -34,7 +34,7 @@ using core::Target;
 TargetIndexMatcher::TargetIndexMatcher(const core::Target& target) {
   collection_id_ = target.collection_group() != nullptr
                        ? *target.collection_group()
-                       : target.path().last_segment();
+                       : std::string(target.path().last_segment());
   order_bys_ = target.order_bys();
 
   for (const Filter& filter : target.filters()) {
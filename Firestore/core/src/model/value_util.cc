@@ -488,6 +488,144 @@ bool Equals(const google_firestore_v1_ArrayValue& lhs,
   return ArrayEquals(lhs, rhs);
 }
 
+namespace {
+
+/** Scrambles the bits of `value` (the MurmurHash3 64-bit finalizer). */
+uint64_t MixFingerprint(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+/** Combines `value` into `state` in an order-dependent way. */
+uint64_t CombineFingerprint(uint64_t state, uint64_t value) {
+  return MixFingerprint(state ^ (value + 0x9e3779b97f4a7c15ULL + (state << 6) +
+                                 (state >> 2)));
+}
+
+/** Computes the 64-bit FNV-1a hash of `bytes`. */
+uint64_t FingerprintBytes(absl::string_view bytes) {
+  uint64_t result = 0xcbf29ce484222325ULL;
+  for (char c : bytes) {
+    result ^= static_cast<uint8_t>(c);
+    result *= 0x100000001b3ULL;
+  }
+  return result;
+}
+
+/**
+ * Fingerprints a double so that all values that compare as the same number
+ * (including NaNs and signed zeros) produce the same result.
+ */
+uint64_t FingerprintDouble(double value) {
+  if (value == 0.0) {
+    value = 0.0;
+  }
+  return MixFingerprint(util::DoubleBits(value));
+}
+
+uint64_t FingerprintTimestamp(const google_protobuf_Timestamp& timestamp) {
+  return CombineFingerprint(MixFingerprint(timestamp.seconds),
+                            static_cast<uint64_t>(timestamp.nanos));
+}
+
+uint64_t FingerprintReference(const google_firestore_v1_Value& value) {
+  // References compare segment-wise, so empty segments must not contribute.
+  uint64_t result = 0;
+  for (absl::string_view segment :
+       absl::StrSplit(nanopb::MakeStringView(value.reference_value), '/',
+                      absl::SkipEmpty())) {
+    result = CombineFingerprint(result, FingerprintBytes(segment));
+  }
+  return result;
+}
+
+uint64_t FingerprintMap(const google_firestore_v1_MapValue& value) {
+  // Maps are compared irrespective of field order, so entries are combined
+  // with a commutative sum.
+  uint64_t result = value.fields_count;
+  for (pb_size_t i = 0; i < value.fields_count; ++i) {
+    const google_firestore_v1_MapValue_FieldsEntry& entry = value.fields[i];
+    result += CombineFingerprint(
+        FingerprintBytes(nanopb::MakeStringView(entry.key)),
+        Fingerprint(entry.value));
+  }
+  return MixFingerprint(result);
+}
+
+}  // namespace
+
+uint64_t Fingerprint(const google_firestore_v1_Value& value) {
+  TypeOrder type_order = GetTypeOrder(value);
+  uint64_t result;
+  switch (type_order) {
+    case TypeOrder::kNull:
+      result = 0;
+      break;
+
+    case TypeOrder::kBoolean:
+      result = value.boolean_value ? 1 : 0;
+      break;
+
+    case TypeOrder::kNumber:
+      // Integers and doubles that represent the same number compare as equal
+      // inside of maps, so both are fingerprinted as doubles.
+      result = FingerprintDouble(
+          value.which_value_type == google_firestore_v1_Value_integer_value_tag
+              ? static_cast<double>(value.integer_value)
+              : value.double_value);
+      break;
+
+    case TypeOrder::kTimestamp:
+      result = FingerprintTimestamp(value.timestamp_value);
+      break;
+
+    case TypeOrder::kServerTimestamp:
+      result = FingerprintTimestamp(GetLocalWriteTime(value));
+      break;
+
+    case TypeOrder::kString:
+      result = FingerprintBytes(nanopb::MakeStringView(value.string_value));
+      break;
+
+    case TypeOrder::kBlob:
+      result = FingerprintBytes(nanopb::MakeStringView(value.bytes_value));
+      break;
+
+    case TypeOrder::kReference:
+      result = FingerprintReference(value);
+      break;
+
+    case TypeOrder::kGeoPoint:
+      result = CombineFingerprint(
+          FingerprintDouble(value.geo_point_value.latitude),
+          FingerprintDouble(value.geo_point_value.longitude));
+      break;
+
+    case TypeOrder::kArray:
+      result = value.array_value.values_count;
+      for (pb_size_t i = 0; i < value.array_value.values_count; ++i) {
+        result =
+            CombineFingerprint(result, Fingerprint(value.array_value.values[i]));
+      }
+      break;
+
+    case TypeOrder::kVector:
+    case TypeOrder::kMap:
+    case TypeOrder::kMaxValue:
+      result = FingerprintMap(value.map_value);
+      break;
+
+    default:
+      HARD_FAIL("Invalid type value: %s", type_order);
+  }
+
+  return CombineFingerprint(static_cast<uint64_t>(type_order), result);
+}
+
 std::string CanonifyTimestamp(const google_firestore_v1_Value& value) {
   return absl::StrFormat("time(%d,%d)", value.timestamp_value.seconds,
                          value.timestamp_value.nanos);
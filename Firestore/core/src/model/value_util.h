@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_VALUE_UTIL_H_
 #define FIRESTORE_CORE_SRC_MODEL_VALUE_UTIL_H_
 
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -115,6 +116,16 @@ bool Equals(const google_firestore_v1_ArrayValue& left,
 StrictEqualsResult StrictEquals(const google_firestore_v1_Value& left,
                                 const google_firestore_v1_Value& right);
 
+/**
+ * Returns a 64-bit fingerprint of the provided field value.
+ *
+ * Values that are equal according to `Equals()` (or that compare as `Same`)
+ * always produce the same fingerprint, so differing fingerprints prove that
+ * two values are not equal. Fingerprints are only stable within a process and
+ * must not be persisted.
+ */
+uint64_t Fingerprint(const google_firestore_v1_Value& value);
+
 /**
  * Generates the canonical ID for the provided field value (as used in Target
  * serialization).
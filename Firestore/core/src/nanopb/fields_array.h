@@ -130,6 +130,11 @@ inline const pb_field_t* FieldsArray<google_firestore_v1_Target_QueryTarget>() {
   return google_firestore_v1_Target_QueryTarget_fields;
 }
 
+template <>
+inline const pb_field_t* FieldsArray<google_firestore_v1_Document>() {
+  return google_firestore_v1_Document_fields;
+}
+
 template <>
 inline const pb_field_t* FieldsArray<google_firestore_v1_Value>() {
   return google_firestore_v1_Value_fields;
@@ -181,6 +186,11 @@ inline const pb_field_t* FieldsArray<firestore_NamedQuery>() {
   return firestore_NamedQuery_fields;
 }
 
+template <>
+inline const pb_field_t* FieldsArray<firestore_BundleElement>() {
+  return firestore_BundleElement_fields;
+}
+
 template <>
 inline const pb_field_t* FieldsArray<google_firestore_admin_v1_Index>() {
   return google_firestore_admin_v1_Index_fields;
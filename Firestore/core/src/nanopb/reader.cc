@@ -44,6 +44,45 @@ void StringReader::Read(const pb_field_t fields[], void* dest_struct) {
   }
 }
 
+void ScanFields(
+    util::ReadContext* context,
+    absl::string_view bytes,
+    const std::function<void(uint32_t, absl::string_view)>& on_delimited,
+    const std::function<void(uint32_t, uint64_t)>& on_varint) {
+  if (!context->ok()) return;
+
+  pb_istream_t stream = pb_istream_from_buffer(
+      reinterpret_cast<const pb_byte_t*>(bytes.data()), bytes.size());
+
+  pb_wire_type_t wire_type;
+  uint32_t tag;
+  bool eof = false;
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    if (wire_type == PB_WT_STRING) {
+      pb_istream_t substream;
+      if (!pb_make_string_substream(&stream, &substream)) break;
+
+      // The substream starts where the bytes still unread by both streams do.
+      size_t start = bytes.size() - stream.bytes_left - substream.bytes_left;
+      absl::string_view contents = bytes.substr(start, substream.bytes_left);
+      if (!pb_close_string_substream(&stream, &substream)) break;
+      on_delimited(tag, contents);
+
+    } else if (wire_type == PB_WT_VARINT && on_varint) {
+      uint64_t value;
+      if (!pb_decode_varint(&stream, &value)) break;
+      on_varint(tag, value);
+
+    } else if (!pb_skip_field(&stream, wire_type)) {
+      break;
+    }
+  }
+
+  if (!eof) {
+    context->Fail(PB_GET_ERROR(&stream));
+  }
+}
+
 }  // namespace nanopb
 }  // namespace firestore
 }  // namespace firebase
@@ -20,6 +20,7 @@
 #include <pb.h>
 #include <pb_decode.h>
 
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -142,6 +143,21 @@ class StringReader : public Reader {
   pb_istream_t stream_{};
 };
 
+/**
+ * Walks the top-level fields of the encoded message in `bytes` without
+ * decoding any nested message. Calls `on_delimited` with the field number and
+ * contents of each length-delimited field (strings, bytes and messages), where
+ * the contents are a view into `bytes`, and `on_varint` with the field number
+ * and value of each varint field. Other fields are skipped.
+ *
+ * Fails the given `context` if `bytes` is not a well-formed message.
+ */
+void ScanFields(
+    util::ReadContext* context,
+    absl::string_view bytes,
+    const std::function<void(uint32_t, absl::string_view)>& on_delimited,
+    const std::function<void(uint32_t, uint64_t)>& on_varint = {});
+
 }  // namespace nanopb
 }  // namespace firestore
 }  // namespace firebase
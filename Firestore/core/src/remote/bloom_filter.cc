@@ -17,6 +17,7 @@
 #include "Firestore/core/src/remote/bloom_filter.h"
 
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/md5.h"
@@ -60,10 +61,14 @@ bool HasSameBits(const BloomFilter& lhs, const BloomFilter& rhs) {
 }  // namespace
 
 BloomFilter::Hash BloomFilter::Md5HashDigest(absl::string_view key) const {
-  std::array<uint8_t, 16> md5_digest{util::CalculateMd5Digest(key)};
+  return HashFromDigest(util::CalculateMd5Digest(key));
+}
 
+BloomFilter::Hash BloomFilter::HashFromDigest(
+    const std::array<uint8_t, 16>& md5_digest) {
   // TODO(Mila): Handle big endian processor b/271174523.
-  uint64_t* hash128 = reinterpret_cast<uint64_t*>(md5_digest.data());
+  const uint64_t* hash128 =
+      reinterpret_cast<const uint64_t*>(md5_digest.data());
   static_assert(sizeof(uint64_t[2]) == sizeof(uint8_t[16]), "");
 
   return Hash{hash128[0], hash128[1]};
@@ -129,7 +134,24 @@ StatusOr<BloomFilter> BloomFilter::Create(ByteString bitmap,
 bool BloomFilter::MightContain(absl::string_view value) const {
   // Empty bitmap should return false on membership check.
   if (bit_count_ == 0) return false;
-  Hash hash = Md5HashDigest(value);
+  return MightContainHash(Md5HashDigest(value));
+}
+
+std::vector<bool> BloomFilter::MightContainAll(
+    absl::string_view prefix, const std::vector<std::string>& suffixes) const {
+  std::vector<bool> result(suffixes.size(), false);
+  // Empty bitmap should return false on membership check.
+  if (bit_count_ == 0) return result;
+
+  std::vector<std::array<uint8_t, 16>> md5_digests =
+      util::CalculateMd5Digests(prefix, suffixes);
+  for (size_t i = 0; i < md5_digests.size(); ++i) {
+    result[i] = MightContainHash(HashFromDigest(md5_digests[i]));
+  }
+  return result;
+}
+
+bool BloomFilter::MightContainHash(const Hash& hash) const {
   // The `hash_count_` and `bit_count_` fields are guaranteed to be
   // non-negative when the `BloomFilter` object is constructed.
   for (int32_t i = 0; i < hash_count_; ++i) {
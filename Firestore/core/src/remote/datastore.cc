@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/datastore.h"
 
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -52,6 +54,7 @@ using core::DatabaseInfo;
 using credentials::AuthCredentialsProvider;
 using credentials::AuthToken;
 using model::AggregateField;
+using model::Document;
 using model::DocumentKey;
 using model::Mutation;
 using util::AsyncQueue;
@@ -136,6 +139,23 @@ void Datastore::Shutdown() {
   rpc_executor_->ExecuteBlocking([] {});
 }
 
+void Datastore::EnableMessageCompression(
+    api::Settings::MessageCompression compression, size_t threshold_bytes) {
+  grpc_compression_algorithm algorithm = GRPC_COMPRESS_NONE;
+  switch (compression) {
+    case api::Settings::MessageCompression::kNone:
+      algorithm = GRPC_COMPRESS_NONE;
+      break;
+    case api::Settings::MessageCompression::kGzip:
+      algorithm = GRPC_COMPRESS_GZIP;
+      break;
+    case api::Settings::MessageCompression::kDeflate:
+      algorithm = GRPC_COMPRESS_DEFLATE;
+      break;
+  }
+  grpc_connection_.EnableMessageCompression(algorithm, threshold_bytes);
+}
+
 void Datastore::PollGrpcQueue() {
   HARD_ASSERT(rpc_executor_->IsCurrentExecutor(),
               "PollGrpcQueue should only be called on the "
@@ -153,11 +173,20 @@ void Datastore::PollGrpcQueue() {
   }
 }
 
+void Datastore::DecodeWatchResponsesOn(
+    std::shared_ptr<AsyncQueue> decode_queue) {
+  watch_decode_queue_ = std::move(decode_queue);
+}
+
 std::shared_ptr<WatchStream> Datastore::CreateWatchStream(
     WatchStreamCallback* callback) {
-  return std::make_shared<WatchStream>(
+  auto stream = std::make_shared<WatchStream>(
       worker_queue_, auth_credentials_, app_check_credentials_,
       datastore_serializer_.serializer(), &grpc_connection_, callback);
+  if (watch_decode_queue_) {
+    stream->DecodeResponsesOn(watch_decode_queue_);
+  }
+  return stream;
 }
 
 std::shared_ptr<WriteStream> Datastore::CreateWriteStream(
@@ -210,16 +239,50 @@ void Datastore::CommitMutationsWithCredentials(
 
 void Datastore::LookupDocuments(const std::vector<DocumentKey>& keys,
                                 LookupCallback&& user_callback) {
+  // Sort by key.
+  auto results = std::make_shared<std::map<DocumentKey, Document>>();
+
+  // TODO(c++14): lambda captures using move.
+  auto document_callback = [results](Document doc) {
+    DocumentKey key = doc->key();
+    (*results)[std::move(key)] = std::move(doc);
+    return Status::OK();
+  };
+
+  auto finish_callback = [results, user_callback](const Status& status) {
+    if (!status.ok()) {
+      user_callback(status);
+      return;
+    }
+
+    std::vector<Document> docs;
+    docs.reserve(results->size());
+    for (auto& kv : *results) {
+      docs.push_back(std::move(kv.second));
+    }
+    StatusOr<std::vector<Document>> result{std::move(docs)};
+    user_callback(result);
+  };
+
+  LookupDocuments(keys, std::move(document_callback),
+                  std::move(finish_callback));
+}
+
+void Datastore::LookupDocuments(const std::vector<DocumentKey>& keys,
+                                LookupDocumentCallback&& document_callback,
+                                util::StatusCallback&& finish_callback) {
   ResumeRpcWithCredentials(
       // TODO(c++14): move into lambda.
-      [this, keys, user_callback](const StatusOr<AuthToken>& auth_token,
-                                  const std::string& app_check_token) mutable {
+      [this, keys, document_callback, finish_callback](
+          const StatusOr<AuthToken>& auth_token,
+          const std::string& app_check_token) mutable {
         if (!auth_token.ok()) {
-          user_callback(auth_token.status());
+          finish_callback(auth_token.status());
           return;
         }
-        LookupDocumentsWithCredentials(auth_token.ValueOrDie(), app_check_token,
-                                       keys, std::move(user_callback));
+        LookupDocumentsWithCredentials(
+            auth_token.ValueOrDie(), app_check_token, keys,
+            std::move(document_callback), std::move(finish_callback));
       });
 }
 
@@ -227,7 +290,8 @@ void Datastore::LookupDocumentsWithCredentials(
     const credentials::AuthToken& auth_token,
     const std::string& app_check_token,
     const std::vector<DocumentKey>& keys,
-    LookupCallback&& user_callback) {
+    LookupDocumentCallback&& document_callback,
+    util::StatusCallback&& finish_callback) {
   grpc::ByteBuffer message =
       MakeByteBuffer(datastore_serializer_.EncodeLookupRequest(keys));
 
@@ -238,16 +302,28 @@ void Datastore::LookupDocumentsWithCredentials(
   active_calls_.push_back(std::move(call_owning));
 
   // TODO(c++14): lambda captures using move.
+  // An error raised while decoding or delivering a document finishes the call
+  // right away; it's reported through `close_callback`.
+  auto message_callback = [this, document_callback](
+                              const grpc::ByteBuffer& response) -> Status {
+    StatusOr<Document> maybe_doc =
+        datastore_serializer_.DecodeLookupResponse(response);
+    if (!maybe_doc.ok()) {
+      return maybe_doc.status();
+    }
+    return document_callback(std::move(maybe_doc).ValueOrDie());
+  };
+
   auto responses_callback =
-      [this, user_callback](const std::vector<grpc::ByteBuffer>& result) {
-        user_callback(datastore_serializer_.MergeLookupResponses(result));
+      [finish_callback](const std::vector<grpc::ByteBuffer>&) {
+        finish_callback(Status::OK());
       };
 
-  auto close_callback = [this, user_callback, call](const util::Status& status,
-                                                    bool callback_fired) {
-    // Trigger user_callback with an error status
+  auto close_callback = [this, finish_callback, call](
+                            const util::Status& status, bool callback_fired) {
+    // Trigger finish_callback with an error status
     if (!callback_fired) {
-      user_callback(status);
+      finish_callback(status);
     }
     if (!status.ok()) {
       LogGrpcCallFinished("BatchGetDocuments", call, status);
@@ -256,7 +332,8 @@ void Datastore::LookupDocumentsWithCredentials(
     RemoveGrpcCall(call);
   };
 
-  call->Start(keys.size(), responses_callback, close_callback);
+  call->Start(keys.size(), message_callback, responses_callback,
+              close_callback);
 }
 
 void Datastore::RunAggregateQuery(
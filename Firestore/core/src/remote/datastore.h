@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_DATASTORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_DATASTORE_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -24,6 +25,7 @@
 
 #include "Firestore/core/src/api/api_fwd.h"
 #include "Firestore/core/src/api/pipeline.h"
+#include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/core/core_fwd.h"
 #include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/credentials/credentials_fwd.h"
@@ -73,6 +75,7 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
  public:
   using LookupCallback =
       std::function<void(const util::StatusOr<std::vector<model::Document>>&)>;
+  using LookupDocumentCallback = std::function<util::Status(model::Document)>;
   using CommitCallback = std::function<void(const util::Status&)>;
 
   Datastore(
@@ -91,6 +94,20 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   /** Cancels any pending gRPC calls and drains the gRPC completion queue. */
   void Shutdown();
 
+  /**
+   * Compresses messages of at least `threshold_bytes` sent on calls and
+   * streams created from now on. Call before creating any streams or calls.
+   */
+  void EnableMessageCompression(api::Settings::MessageCompression compression,
+                                size_t threshold_bytes);
+
+  /**
+   * Makes watch streams created from now on decode their responses on
+   * `decode_queue` rather than on the worker queue. Call before creating any
+   * streams.
+   */
+  void DecodeWatchResponsesOn(std::shared_ptr<util::AsyncQueue> decode_queue);
+
   /**
    * Creates a new `WatchStream` that is still unstarted but uses a common
    * shared channel.
@@ -109,6 +126,21 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   void LookupDocuments(const std::vector<model::DocumentKey>& keys,
                        LookupCallback&& user_callback);
 
+  /**
+   * Looks up the given documents, decoding each response as soon as it
+   * arrives and handing the document to `document_callback`, so that the
+   * responses never have to be buffered. Documents are delivered in the order
+   * the backend returns them, not in key order.
+   *
+   * `finish_callback` is invoked exactly once: with an ok status after every
+   * document has been delivered, or with the error that ended the lookup. If
+   * `document_callback` returns an error, no further documents are delivered
+   * and that error is passed to `finish_callback`.
+   */
+  void LookupDocuments(const std::vector<model::DocumentKey>& keys,
+                       LookupDocumentCallback&& document_callback,
+                       util::StatusCallback&& finish_callback);
+
   void RunAggregateQuery(const core::Query& query,
                          const std::vector<model::AggregateField>& aggregates,
                          api::AggregateQueryCallback&& result_callback);
@@ -191,7 +223,8 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
       const credentials::AuthToken& auth_token,
       const std::string& app_check_token,
       const std::vector<model::DocumentKey>& keys,
-      LookupCallback&& user_callback);
+      LookupDocumentCallback&& document_callback,
+      util::StatusCallback&& finish_callback);
 
   void RunAggregateQueryWithCredentials(
       const credentials::AuthToken& auth_token,
@@ -219,6 +252,7 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   bool is_shut_down_ = false;
 
   std::shared_ptr<util::AsyncQueue> worker_queue_;
+  std::shared_ptr<util::AsyncQueue> watch_decode_queue_;
   std::shared_ptr<credentials::AppCheckCredentialsProvider>
       app_check_credentials_;
   std::shared_ptr<credentials::AuthCredentialsProvider> auth_credentials_;
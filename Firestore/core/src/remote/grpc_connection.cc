@@ -255,8 +255,13 @@ void GrpcConnection::Shutdown() {
 }
 
 std::unique_ptr<grpc::ClientContext> GrpcConnection::CreateContext(
-    const AuthToken& auth_token, const std::string& app_check_token) const {
+    const AuthToken& auth_token,
+    const std::string& app_check_token,
+    bool compress) const {
   auto context = absl::make_unique<grpc::ClientContext>();
+  if (compress && compression_algorithm_ != GRPC_COMPRESS_NONE) {
+    context->set_compression_algorithm(compression_algorithm_);
+  }
 
   absl::string_view auth = auth_token.user().is_authenticated()
                                ? auth_token.token()
@@ -346,7 +351,9 @@ std::unique_ptr<GrpcStream> GrpcConnection::CreateStream(
     GrpcStreamObserver* observer) {
   EnsureActiveStub();
 
-  auto context = CreateContext(auth_token, app_check_token);
+  // Streams decide whether to compress each message as it is written.
+  auto context =
+      CreateContext(auth_token, app_check_token, /*compress=*/true);
   auto call =
       grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
   return absl::make_unique<GrpcStream>(std::move(context), std::move(call),
@@ -360,7 +367,8 @@ std::unique_ptr<GrpcUnaryCall> GrpcConnection::CreateUnaryCall(
     const grpc::ByteBuffer& message) {
   EnsureActiveStub();
 
-  auto context = CreateContext(auth_token, app_check_token);
+  auto context = CreateContext(auth_token, app_check_token,
+                               !ShouldSkipCompression(message));
   auto call = grpc_stub_->PrepareUnaryCall(context.get(), MakeString(rpc_name),
                                            message, grpc_queue_);
   return absl::make_unique<GrpcUnaryCall>(std::move(context), std::move(call),
@@ -374,13 +382,31 @@ std::unique_ptr<GrpcStreamingReader> GrpcConnection::CreateStreamingReader(
     const grpc::ByteBuffer& message) {
   EnsureActiveStub();
 
-  auto context = CreateContext(auth_token, app_check_token);
+  auto context = CreateContext(auth_token, app_check_token,
+                               !ShouldSkipCompression(message));
   auto call =
       grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
   return absl::make_unique<GrpcStreamingReader>(
       std::move(context), std::move(call), worker_queue_, this, message);
 }
 
+void GrpcConnection::EnableMessageCompression(
+    grpc_compression_algorithm algorithm, size_t threshold_bytes) {
+  compression_algorithm_ = algorithm;
+  compression_threshold_bytes_ = threshold_bytes;
+}
+
+bool GrpcConnection::ShouldSkipCompression(
+    const grpc::ByteBuffer& message) const {
+  return message.Length() < MinCompressedMessageBytes();
+}
+
+size_t GrpcConnection::MinCompressedMessageBytes() const {
+  return compression_algorithm_ != GRPC_COMPRESS_NONE
+             ? compression_threshold_bytes_
+             : 0;
+}
+
 void GrpcConnection::RegisterConnectivityMonitor() {
   connectivity_monitor_->AddCallback(
       [this](ConnectivityMonitor::NetworkStatus /*ignored*/) {
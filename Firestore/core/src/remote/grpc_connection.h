@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_GRPC_CONNECTION_H_
 #define FIRESTORE_CORE_SRC_REMOTE_GRPC_CONNECTION_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -92,6 +93,27 @@ class GrpcConnection {
   void Register(GrpcCall* call);
   void Unregister(GrpcCall* call);
 
+  /**
+   * Compresses the messages sent on calls and streams created from now on
+   * using the given `algorithm`, except for messages smaller than
+   * `threshold_bytes`.
+   */
+  void EnableMessageCompression(grpc_compression_algorithm algorithm,
+                                size_t threshold_bytes);
+
+  /**
+   * Whether the given message should be sent uncompressed on a call that
+   * otherwise compresses its messages, because it is below the threshold.
+   */
+  bool ShouldSkipCompression(const grpc::ByteBuffer& message) const;
+
+  /**
+   * The size below which messages are sent uncompressed; zero if compression
+   * is disabled. Streams capture this when they are created, since they can
+   * outlive their registration with this connection.
+   */
+  size_t MinCompressedMessageBytes() const;
+
   static void SetClientLanguage(std::string language_token);
 
   /**
@@ -111,7 +133,8 @@ class GrpcConnection {
  private:
   std::unique_ptr<grpc::ClientContext> CreateContext(
       const credentials::AuthToken& auth_token,
-      const std::string& app_check_token) const;
+      const std::string& app_check_token,
+      bool compress) const;
   std::shared_ptr<grpc::Channel> CreateChannel() const;
   void EnsureActiveStub();
 
@@ -128,6 +151,9 @@ class GrpcConnection {
   std::vector<GrpcCall*> active_calls_;
 
   FirebaseMetadataProvider* firebase_metadata_provider_ = nullptr;
+
+  grpc_compression_algorithm compression_algorithm_ = GRPC_COMPRESS_NONE;
+  size_t compression_threshold_bytes_ = 0;
 };
 
 }  // namespace remote
@@ -93,6 +93,8 @@ GrpcStream::GrpcStream(
       call_{std::move(NOT_NULL(call))},
       worker_queue_{NOT_NULL(worker_queue)},
       grpc_connection_{NOT_NULL(grpc_connection)},
+      min_compressed_message_bytes_{
+          grpc_connection->MinCompressedMessageBytes()},
       observer_{NOT_NULL(observer)} {
   grpc_connection_->Register(this);
 }
@@ -151,6 +153,9 @@ void GrpcStream::MaybeWrite(absl::optional<BufferedWrite> maybe_write) {
   }
 
   BufferedWrite write = std::move(maybe_write).value();
+  if (write.message.Length() < min_compressed_message_bytes_) {
+    write.options.set_no_compression();
+  }
   auto completion = NewCompletion(
       Type::Write,
       [this](const std::shared_ptr<GrpcCompletion>&) { OnWrite(); });
@@ -269,10 +274,13 @@ bool GrpcStream::TryLastWrite(grpc::ByteBuffer&& message) {
   }
 
   BufferedWrite last_write = std::move(maybe_write).value();
+  grpc::WriteOptions options;
+  if (last_write.message.Length() < min_compressed_message_bytes_) {
+    options.set_no_compression();
+  }
   auto completion = NewCompletion(Type::Write, {});
   *completion->message() = last_write.message;
-  call_->WriteLast(*completion->message(), grpc::WriteOptions{},
-                   completion.get());
+  call_->WriteLast(*completion->message(), options, completion.get());
 
   // Empirically, the write normally takes less than a millisecond to finish
   // (both with and without network connection), and never more than several
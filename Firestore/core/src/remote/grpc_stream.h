@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_GRPC_STREAM_H_
 #define FIRESTORE_CORE_SRC_REMOTE_GRPC_STREAM_H_
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
@@ -231,6 +232,9 @@ class GrpcStream : public GrpcCall {
 
   std::shared_ptr<util::AsyncQueue> worker_queue_;
   GrpcConnection* grpc_connection_ = nullptr;
+  // Copied from the connection, which is no longer reachable once this stream
+  // unregisters from it.
+  size_t min_compressed_message_bytes_ = 0;
 
   GrpcStreamObserver* observer_ = nullptr;
   internal::BufferedWriter buffered_writer_;
@@ -54,6 +54,15 @@ void GrpcStreamingReader::Start(util::StatusOr<size_t> expected_response_count,
   stream_->Start();
 }
 
+void GrpcStreamingReader::Start(util::StatusOr<size_t> expected_response_count,
+                                MessageCallback&& message_callback,
+                                ResponsesCallback&& responses_callback,
+                                CloseCallback&& close_callback) {
+  message_callback_ = std::move(message_callback);
+  Start(std::move(expected_response_count), std::move(responses_callback),
+        std::move(close_callback));
+}
+
 void GrpcStreamingReader::FinishImmediately() {
   stream_->FinishImmediately();
 }
@@ -69,11 +78,24 @@ void GrpcStreamingReader::OnStreamStart() {
 }
 
 void GrpcStreamingReader::OnStreamRead(const grpc::ByteBuffer& message) {
-  // Accumulate responses, responses_callback_ will be fired if
-  // GrpcStreamingReader has received all the responses.
-  responses_.push_back(message);
+  // Accumulate responses (unless they are delivered one by one),
+  // responses_callback_ will be fired if GrpcStreamingReader has received all
+  // the responses.
+  ++response_count_;
+  if (message_callback_) {
+    Status status = message_callback_(message);
+    if (!status.ok()) {
+      // The remaining responses are of no use; don't wait for the server to
+      // send them. Invoking the callback ends this reader's lifetime.
+      stream_->FinishImmediately();
+      close_callback_(status, callback_fired_);
+      return;
+    }
+  } else {
+    responses_.push_back(message);
+  }
   if (expected_response_count_.ok() &&
-      responses_.size() == expected_response_count_.ValueOrDie()) {
+      response_count_ == expected_response_count_.ValueOrDie()) {
     callback_fired_ = true;
     responses_callback_(responses_);
   }
@@ -44,11 +44,16 @@ class GrpcConnection;
 /**
  * Sends a single request to the server, reads one or more streaming server
  * responses, and invokes the given callback with the accumulated responses.
+ *
+ * Alternatively, each response can be handed to a `MessageCallback` as soon as
+ * it is read, in which case responses are not accumulated. If the callback
+ * rejects a response, the call is finished without reading the rest.
  */
 class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
  public:
   using ResponsesT = grpc::ByteBuffer;
   using ResponsesCallback = std::function<void(const std::vector<ResponsesT>)>;
+  using MessageCallback = std::function<util::Status(const ResponsesT&)>;
   using CloseCallback = std::function<void(const util::Status&, bool)>;
 
   GrpcStreamingReader(
@@ -67,6 +72,20 @@ class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
              ResponsesCallback&& responses_callback,
              CloseCallback&& close_callback);
 
+  /**
+   * Starts the call; the given `message_callback` will be invoked with each
+   * response as it is read, and the `responses_callback` will be invoked with
+   * an empty vector once all the responses have been read. If the call fails,
+   * the `close_callback` will be invoked with a non-ok status.
+   *
+   * If `message_callback` returns a non-ok status, the call is finished right
+   * away and `close_callback` is invoked with that status.
+   */
+  void Start(util::StatusOr<size_t> expected_response_count,
+             MessageCallback&& message_callback,
+             ResponsesCallback&& responses_callback,
+             CloseCallback&& close_callback);
+
   /**
    * If the call is in progress, attempts to cancel the call; otherwise, it's
    * a no-op. Cancellation is done on best-effort basis; however:
@@ -105,7 +124,9 @@ class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
   grpc::ByteBuffer request_;
 
   util::StatusOr<size_t> expected_response_count_;
+  size_t response_count_ = 0;
   bool callback_fired_ = false;
+  MessageCallback message_callback_;
   ResponsesCallback responses_callback_;
   CloseCallback close_callback_;
   std::vector<ResponsesT> responses_;
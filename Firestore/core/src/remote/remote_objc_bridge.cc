@@ -16,7 +16,8 @@
 
 #include "Firestore/core/src/remote/remote_objc_bridge.h"
 
-#include <map>
+#include <pb_encode.h>
+
 #include <unordered_map>
 
 #include "Firestore/core/src/core/database_info.h"
@@ -168,6 +169,16 @@ WriteStreamSerializer::EncodeEmptyMutationsList(
   return EncodeWriteMutationsRequest({}, last_stream_token);
 }
 
+size_t WriteStreamSerializer::CalculateByteSize(
+    const std::vector<Mutation>& mutations) const {
+  Message<google_firestore_v1_WriteRequest> request =
+      EncodeWriteMutationsRequest(mutations, {});
+  size_t size = 0;
+  bool ok = pb_get_encoded_size(&size, request.fields(), request.get());
+  HARD_ASSERT(ok, "Unable to calculate the size of a write request");
+  return size;
+}
+
 Message<google_firestore_v1_WriteResponse> WriteStreamSerializer::ParseResponse(
     Reader* reader) const {
   return Message<google_firestore_v1_WriteResponse>::TryParse(reader);
@@ -244,34 +255,17 @@ DatastoreSerializer::EncodeLookupRequest(
   return result;
 }
 
-StatusOr<std::vector<model::Document>>
-DatastoreSerializer::MergeLookupResponses(
-    const std::vector<grpc::ByteBuffer>& responses) const {
-  // Sort by key.
-  std::map<DocumentKey, Document> results;
-
-  for (const auto& response : responses) {
-    ByteBufferReader reader{response};
-    auto message =
-        Message<google_firestore_v1_BatchGetDocumentsResponse>::TryParse(
-            &reader);
-
-    Document doc = serializer_.DecodeMaybeDocument(reader.context(), *message);
-    if (!reader.ok()) {
-      return reader.status();
-    }
-
-    results[doc->key()] = std::move(doc);
-  }
+StatusOr<model::Document> DatastoreSerializer::DecodeLookupResponse(
+    const grpc::ByteBuffer& response) const {
+  ByteBufferReader reader{response};
+  auto message =
+      Message<google_firestore_v1_BatchGetDocumentsResponse>::TryParse(&reader);
 
-  std::vector<Document> docs;
-  docs.reserve(results.size());
-  for (const auto& kv : results) {
-    docs.push_back(kv.second);
+  Document doc = serializer_.DecodeMaybeDocument(reader.context(), *message);
+  if (!reader.ok()) {
+    return reader.status();
   }
-
-  StatusOr<std::vector<Document>> result{std::move(docs)};
-  return result;
+  return doc;
 }
 
 // TODO(b/443765747) Revert back to absl::flat_hash_map after the absl version
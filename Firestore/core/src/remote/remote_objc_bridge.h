@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -105,6 +106,12 @@ class WriteStreamSerializer {
   nanopb::Message<google_firestore_v1_WriteRequest> EncodeEmptyMutationsList(
       const nanopb::ByteString& last_stream_token) const;
 
+  /**
+   * Returns the number of bytes the given mutations occupy in an encoded write
+   * request, excluding the stream token.
+   */
+  size_t CalculateByteSize(const std::vector<model::Mutation>& mutations) const;
+
   nanopb::Message<google_firestore_v1_WriteResponse> ParseResponse(
       nanopb::Reader* reader) const;
   model::SnapshotVersion DecodeCommitVersion(
@@ -132,11 +139,11 @@ class DatastoreSerializer {
   EncodeLookupRequest(const std::vector<model::DocumentKey>& keys) const;
 
   /**
-   * Merges results of the streaming read together. The array is sorted by the
-   * document key.
+   * Decodes a single response of the streaming read, each of which carries one
+   * document (or the fact that it is missing).
    */
-  util::StatusOr<std::vector<model::Document>> MergeLookupResponses(
-      const std::vector<grpc::ByteBuffer>& responses) const;
+  util::StatusOr<model::Document> DecodeLookupResponse(
+      const grpc::ByteBuffer& response) const;
 
   // TODO(b/443765747) Revert back to absl::flat_hash_map after the absl version
   // is upgraded to later than 20250127.0
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/remote_store.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <utility>
 
@@ -43,6 +45,7 @@ using model::AggregateField;
 using model::BatchId;
 using model::DocumentKeySet;
 using model::kBatchIdUnknown;
+using model::Mutation;
 using model::MutationBatch;
 using model::MutationBatchResult;
 using model::MutationResult;
@@ -53,12 +56,6 @@ using nanopb::ByteString;
 using util::AsyncQueue;
 using util::Status;
 
-/**
- * The maximum number of pending writes to allow.
- * TODO(b/35853402): Negotiate this value with the backend.
- */
-constexpr int kMaxPendingWrites = 10;
-
 RemoteStore::RemoteStore(
     LocalStore* local_store,
     std::shared_ptr<Datastore> datastore,
@@ -134,6 +131,7 @@ void RemoteStore::DisableNetworkInternal() {
               write_pipeline_.size());
     write_pipeline_.clear();
   }
+  ResetSentWrites(/*failed=*/false);
 
   CleanUpWatchStreamState();
 }
@@ -404,9 +402,9 @@ void RemoteStore::RunPipeline(
 // Write Stream
 
 void RemoteStore::FillWritePipeline() {
-  BatchId last_batch_id_retrieved = write_pipeline_.empty()
-                                        ? kBatchIdUnknown
-                                        : write_pipeline_.back().batch_id();
+  BatchId last_batch_id_retrieved =
+      write_pipeline_.empty() ? kBatchIdUnknown
+                              : write_pipeline_.back().batch.batch_id();
   while (CanAddToWritePipeline()) {
     absl::optional<MutationBatch> batch =
         local_store_->GetNextMutationBatch(last_batch_id_retrieved);
@@ -416,30 +414,97 @@ void RemoteStore::FillWritePipeline() {
       }
       break;
     }
-    AddToWritePipeline(*batch);
     last_batch_id_retrieved = batch->batch_id();
+    PushToWritePipeline(std::move(*batch));
   }
 
+  // Send everything fetched above at once, so that consecutive writes can be
+  // packed into the same request.
+  SendPendingWrites();
+
   if (ShouldStartWriteStream()) {
     StartWriteStream();
   }
 }
 
 bool RemoteStore::CanAddToWritePipeline() const {
-  return CanUseNetwork() && write_pipeline_.size() < kMaxPendingWrites;
+  return CanUseNetwork() && write_pipeline_.size() < write_window_.size();
 }
 
 void RemoteStore::AddToWritePipeline(const MutationBatch& batch) {
   HARD_ASSERT(CanAddToWritePipeline(),
               "AddToWritePipeline called when pipeline is full");
 
-  write_pipeline_.push_back(batch);
+  PushToWritePipeline(batch);
+  SendPendingWrites();
+}
+
+void RemoteStore::PushToWritePipeline(MutationBatch batch) {
+  // Measure the batch once here rather than every time it is considered for
+  // packing.
+  size_t byte_size = max_coalesced_write_bytes_ > 0
+                         ? write_stream_->CalculateByteSize(batch.mutations())
+                         : 0;
+  write_pipeline_.push_back(PendingWrite{std::move(batch), byte_size});
+}
+
+void RemoteStore::EnableWriteBatchCoalescing(size_t max_request_bytes) {
+  max_coalesced_write_bytes_ = max_request_bytes;
+  for (PendingWrite& write : write_pipeline_) {
+    write.byte_size = write_stream_->CalculateByteSize(write.batch.mutations());
+  }
+}
+
+void RemoteStore::SendPendingWrites() {
+  if (!write_stream_->IsOpen() || !write_stream_->handshake_complete()) {
+    return;
+  }
 
-  if (write_stream_->IsOpen() && write_stream_->handshake_complete()) {
-    write_stream_->WriteMutations(batch.mutations());
+  while (sent_write_count_ < write_pipeline_.size()) {
+    size_t end = NextWriteRequestEnd(sent_write_count_);
+    if (end - sent_write_count_ == 1) {
+      write_stream_->WriteMutations(
+          write_pipeline_[sent_write_count_].batch.mutations());
+    } else {
+      std::vector<Mutation> mutations;
+      for (size_t i = sent_write_count_; i != end; ++i) {
+        const std::vector<Mutation>& batch_mutations =
+            write_pipeline_[i].batch.mutations();
+        mutations.insert(mutations.end(), batch_mutations.begin(),
+                         batch_mutations.end());
+      }
+      write_stream_->WriteMutations(mutations);
+    }
+
+    write_window_.OnRequestSent(end - sent_write_count_,
+                                WritePipelineWindow::Clock::now());
+    sent_write_count_ = end;
   }
 }
 
+size_t RemoteStore::NextWriteRequestEnd(size_t begin) const {
+  size_t end = begin + 1;
+  if (max_coalesced_write_bytes_ == 0 ||
+      write_pipeline_[begin].batch.batch_id() <= last_uncoalesced_batch_id_) {
+    return end;
+  }
+
+  size_t request_bytes = write_pipeline_[begin].byte_size;
+  for (; end != write_pipeline_.size(); ++end) {
+    size_t batch_bytes = write_pipeline_[end].byte_size;
+    if (request_bytes + batch_bytes > max_coalesced_write_bytes_) {
+      break;
+    }
+    request_bytes += batch_bytes;
+  }
+  return end;
+}
+
+void RemoteStore::ResetSentWrites(bool failed) {
+  sent_write_count_ = 0;
+  write_window_.OnStreamClosed(failed);
+}
+
 bool RemoteStore::ShouldStartWriteStream() const {
   return CanUseNetwork() && !write_stream_->IsStarted() &&
          !write_pipeline_.empty();
@@ -460,25 +525,57 @@ void RemoteStore::OnWriteStreamHandshakeComplete() {
   local_store_->SetLastStreamToken(write_stream_->last_stream_token());
 
   // Send the write pipeline now that the stream is established.
-  for (const MutationBatch& write : write_pipeline_) {
-    write_stream_->WriteMutations(write.mutations());
-  }
+  ResetSentWrites(/*failed=*/false);
+  SendPendingWrites();
 }
 
 void RemoteStore::OnWriteStreamMutationResult(
     SnapshotVersion commit_version,
     std::vector<MutationResult> mutation_results) {
   // This is a response to a write containing mutations and should be correlated
-  // to the first write in our write pipeline.
+  // to the first write (or writes, if they were packed into one request) in
+  // our write pipeline.
   HARD_ASSERT(!write_pipeline_.empty(), "Got result for empty write pipeline");
 
-  MutationBatch batch = write_pipeline_.front();
-  write_pipeline_.erase(write_pipeline_.begin());
+  size_t batch_count =
+      write_window_.OnResponseReceived(WritePipelineWindow::Clock::now());
+  HARD_ASSERT(batch_count <= write_pipeline_.size(),
+              "Got result for %s writes with only %s in the write pipeline",
+              batch_count, write_pipeline_.size());
 
-  MutationBatchResult batch_result(std::move(batch), commit_version,
-                                   std::move(mutation_results),
-                                   write_stream_->last_stream_token());
-  sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+  std::vector<MutationBatch> batches;
+  batches.reserve(batch_count);
+  for (size_t i = 0; i != batch_count; ++i) {
+    batches.push_back(std::move(write_pipeline_[i].batch));
+  }
+  write_pipeline_.erase(write_pipeline_.begin(),
+                        write_pipeline_.begin() + batch_count);
+  sent_write_count_ -= std::min(sent_write_count_, batch_count);
+
+  if (batch_count == 1) {
+    MutationBatchResult batch_result(std::move(batches.front()), commit_version,
+                                     std::move(mutation_results),
+                                     write_stream_->last_stream_token());
+    sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+  } else {
+    // Results are returned in the order of the writes in the request, so they
+    // can be handed back to each batch in turn.
+    size_t results_begin = 0;
+    for (MutationBatch& batch : batches) {
+      size_t results_end = results_begin + batch.mutations().size();
+      HARD_ASSERT(results_end <= mutation_results.size(),
+                  "Write response has fewer results than mutations");
+      std::vector<MutationResult> batch_results(
+          std::make_move_iterator(mutation_results.begin() + results_begin),
+          std::make_move_iterator(mutation_results.begin() + results_end));
+      results_begin = results_end;
+
+      MutationBatchResult batch_result(std::move(batch), commit_version,
+                                       std::move(batch_results),
+                                       write_stream_->last_stream_token());
+      sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+    }
+  }
 
   // It's possible that with the completion of this mutation another slot has
   // freed up.
@@ -509,6 +606,8 @@ void RemoteStore::OnWriteStreamClose(const Status& status) {
     }
   }
 
+  ResetSentWrites(/*failed=*/!status.ok());
+
   // The write stream might have been started by refilling the write pipeline
   // for failed writes
   if (ShouldStartWriteStream()) {
@@ -546,9 +645,19 @@ void RemoteStore::HandleWriteError(const Status& status) {
     return;
   }
 
+  // A packed request is applied atomically, so there is no telling which of its
+  // writes was at fault. Resend them one per request to find out.
+  size_t batch_count = write_window_.next_response_batch_count();
+  if (batch_count > 1 && batch_count <= write_pipeline_.size()) {
+    last_uncoalesced_batch_id_ =
+        write_pipeline_[batch_count - 1].batch.batch_id();
+    write_stream_->InhibitBackoff();
+    return;
+  }
+
   // If this was a permanent error, the request itself was the problem so it's
   // not going to succeed if we resend it.
-  MutationBatch batch = write_pipeline_.front();
+  MutationBatch batch = std::move(write_pipeline_.front().batch);
   write_pipeline_.erase(write_pipeline_.begin());
 
   // In this case it's also unlikely that the server itself is melting
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -32,6 +33,7 @@
 #include "Firestore/core/src/remote/remote_event.h"
 #include "Firestore/core/src/remote/watch_change.h"
 #include "Firestore/core/src/remote/watch_stream.h"
+#include "Firestore/core/src/remote/write_pipeline_window.h"
 #include "Firestore/core/src/remote/write_stream.h"
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/status_fwd.h"
@@ -189,6 +191,17 @@ class RemoteStore : public TargetMetadataProvider,
    */
   void AddToWritePipeline(const model::MutationBatch& batch);
 
+  /**
+   * Allows consecutive mutation batches to be packed into a single write
+   * request of up to `max_request_bytes` bytes. Results are still reported to
+   * the `SyncEngine` per batch.
+   *
+   * The backend applies a write request atomically, so if a packed request is
+   * permanently rejected, its batches are resent one per request to find the
+   * batch at fault.
+   */
+  void EnableWriteBatchCoalescing(size_t max_request_bytes);
+
   /** Returns a new transaction backed by this remote store. */
   // TODO(c++14): return a plain value when it becomes possible to move
   // `Transaction` into lambdas.
@@ -221,6 +234,17 @@ class RemoteStore : public TargetMetadataProvider,
       std::vector<model::MutationResult> mutation_results) override;
 
  private:
+  /** A write in `write_pipeline_`. */
+  struct PendingWrite {
+    model::MutationBatch batch;
+
+    /**
+     * The encoded size of the batch's mutations, or zero if writes are sent one
+     * per request.
+     */
+    size_t byte_size = 0;
+  };
+
   void RestartNetwork();
   void DisableNetworkInternal();
 
@@ -250,6 +274,30 @@ class RemoteStore : public TargetMetadataProvider,
    */
   bool ShouldStartWriteStream() const;
 
+  /**
+   * Appends `batch` to `write_pipeline_`, measuring its encoded size if writes
+   * may be packed together.
+   */
+  void PushToWritePipeline(model::MutationBatch batch);
+
+  /**
+   * Sends the writes in `write_pipeline_` that have not yet been sent on the
+   * current write stream, if the stream is ready to accept them.
+   */
+  void SendPendingWrites();
+
+  /**
+   * Returns the index one past the last write in `write_pipeline_` that
+   * should be sent in the same request as the write at `begin`.
+   */
+  size_t NextWriteRequestEnd(size_t begin) const;
+
+  /**
+   * Forgets which writes have been sent, because the write stream is being
+   * (re)established. `failed` indicates whether the previous stream failed.
+   */
+  void ResetSentWrites(bool failed);
+
   void HandleHandshakeError(const util::Status& status);
   void HandleWriteError(const util::Status& status);
 
@@ -300,7 +348,7 @@ class RemoteStore : public TargetMetadataProvider,
   std::unique_ptr<WatchChangeAggregator> watch_change_aggregator_;
 
   /**
-   * A list of up to `kMaxPendingWrites` writes that we have fetched from the
+   * A list of up to `write_window_.size()` writes that we have fetched from the
    * `LocalStore` via `FillWritePipeline` and have or will send to the write
    * stream.
    *
@@ -316,7 +364,31 @@ class RemoteStore : public TargetMetadataProvider,
    * purely based on order, and so we can just remove writes from the front of
    * the `write_pipeline_` as we receive responses.
    */
-  std::vector<model::MutationBatch> write_pipeline_;
+  std::vector<PendingWrite> write_pipeline_;
+
+  /**
+   * The number of writes at the front of `write_pipeline_` that have been sent
+   * on the current write stream.
+   */
+  size_t sent_write_count_ = 0;
+
+  /**
+   * Sizes the write pipeline and records how many writes each outstanding
+   * request carries.
+   */
+  WritePipelineWindow write_window_;
+
+  /**
+   * The byte budget for packing several writes into one request, or zero if
+   * each write is sent in its own request.
+   */
+  size_t max_coalesced_write_bytes_ = 0;
+
+  /**
+   * Writes with batch IDs up to and including this one are sent one per
+   * request, because a packed request containing them was rejected.
+   */
+  model::BatchId last_uncoalesced_batch_id_ = model::kBatchIdUnknown;
 };
 
 }  // namespace remote
@@ -768,7 +768,7 @@ google_firestore_v1_Target_QueryTarget Serializer::EncodeQueryTarget(
     HARD_ASSERT(path.size() % 2 != 0,
                 "Document queries with filters are not supported.");
     result.parent = EncodeQueryPath(path.PopLast());
-    from.collection_id = EncodeString(path.last_segment());
+    from.collection_id = EncodeString(std::string(path.last_segment()));
   }
 
   // Encode the filters.
@@ -1706,6 +1706,64 @@ std::unique_ptr<api::EvaluableStage> Serializer::DecodeStage(
     }
     context->Fail("Invalid 'sort' stage: missing arguments");
     return nullptr;
+  } else if (stage_name == "offset") {
+    if (args_count >= 1 && current_args[0].which_value_type ==
+                               google_firestore_v1_Value_integer_value_tag) {
+      return std::make_unique<api::OffsetStage>(current_args[0].integer_value);
+    }
+    context->Fail("Invalid 'offset' stage: missing or invalid arguments");
+    return nullptr;
+  } else if (stage_name == "select" || stage_name == "add_fields" ||
+             stage_name == "distinct") {
+    if (args_count >= 1) {
+      auto exprs = DecodeNamedExpressions(context, current_args[0]);
+      if (!context->status().ok()) return nullptr;
+      if (stage_name == "select") {
+        return std::make_unique<api::SelectStage>(std::move(exprs));
+      } else if (stage_name == "add_fields") {
+        return std::make_unique<api::AddFields>(std::move(exprs));
+      }
+      return std::make_unique<api::DistinctStage>(std::move(exprs));
+    }
+    context->Fail(StringFormat("Invalid '%s' stage: missing arguments",
+                               stage_name));
+    return nullptr;
+  } else if (stage_name == "remove_fields") {
+    std::vector<api::Field> fields;
+    fields.reserve(args_count);
+    for (pb_size_t i = 0; i < args_count; ++i) {
+      auto expr = DecodeExpression(context, current_args[i]);
+      if (!context->status().ok()) return nullptr;
+      auto field = dynamic_cast<const api::Field*>(expr.get());
+      if (field == nullptr) {
+        context->Fail(StringFormat(
+            "Invalid argument for 'remove_fields' stage at index %s: expected "
+            "a field",
+            i));
+        return nullptr;
+      }
+      fields.push_back(*field);
+    }
+    return std::make_unique<api::RemoveFieldsStage>(std::move(fields));
+  } else if (stage_name == "unnest") {
+    if (args_count >= 2) {
+      std::shared_ptr<api::Expr> field =
+          DecodeExpression(context, current_args[0]);
+      std::shared_ptr<api::Expr> alias =
+          DecodeExpression(context, current_args[1]);
+      absl::optional<std::shared_ptr<api::Expr>> index_field;
+      for (pb_size_t i = 0; i < proto_stage.options_count; ++i) {
+        if (DecodeString(proto_stage.options[i].key) == "index_field") {
+          index_field = std::shared_ptr<api::Expr>(
+              DecodeExpression(context, proto_stage.options[i].value));
+        }
+      }
+      if (!context->status().ok()) return nullptr;
+      return std::make_unique<api::Unnest>(std::move(field), std::move(alias),
+                                           std::move(index_field));
+    }
+    context->Fail("Invalid 'unnest' stage: missing arguments");
+    return nullptr;
   }
 
   context->Fail(StringFormat("Unsupported stage type: %s", stage_name));
@@ -1744,6 +1802,28 @@ std::unique_ptr<api::Expr> Serializer::DecodeExpression(
   }
 }
 
+std::unordered_map<std::string, std::shared_ptr<api::Expr>>
+Serializer::DecodeNamedExpressions(
+    util::ReadContext* context,
+    const google_firestore_v1_Value& proto_value) const {
+  std::unordered_map<std::string, std::shared_ptr<api::Expr>> result;
+  if (!context->status().ok()) return result;
+
+  if (proto_value.which_value_type != google_firestore_v1_Value_map_value_tag) {
+    context->Fail("Invalid proto_value type for named expressions, expected "
+                  "map_value.");
+    return result;
+  }
+
+  const auto& map_value = proto_value.map_value;
+  for (pb_size_t i = 0; i < map_value.fields_count; ++i) {
+    auto expr = DecodeExpression(context, map_value.fields[i].value);
+    if (!context->status().ok()) return result;
+    result.emplace(DecodeString(map_value.fields[i].key), std::move(expr));
+  }
+  return result;
+}
+
 api::FunctionExpr Serializer::DecodeFunctionExpression(
     util::ReadContext* context,
     const google_firestore_v1_Function& proto_function) const {
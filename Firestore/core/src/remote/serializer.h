@@ -373,6 +373,9 @@ class Serializer {
   std::unique_ptr<api::Expr> DecodeExpression(
       util::ReadContext* context,
       const google_firestore_v1_Value& proto_value) const;
+  std::unordered_map<std::string, std::shared_ptr<api::Expr>>
+  DecodeNamedExpressions(util::ReadContext* context,
+                         const google_firestore_v1_Value& proto_value) const;
   api::FunctionExpr DecodeFunctionExpression(
       util::ReadContext* context,
       const google_firestore_v1_Function& proto_function) const;
@@ -258,14 +258,85 @@ void Stream::OnStreamRead(const grpc::ByteBuffer& message) {
                   grpc_stream_->GetResponseHeaders()));
   }
 
-  Status read_status = NotifyStreamResponse(message);
-  if (!read_status.ok()) {
-    grpc_stream_->FinishImmediately();
-    // Don't expect gRPC to produce status -- since the error happened on the
-    // client, we have all the information we need.
-    OnStreamFinish(read_status);
+  if (decode_queue_) {
+    DecodeOffQueue(message);
     return;
   }
+
+  HandleResponseStatus(NotifyStreamResponse(message));
+}
+
+bool Stream::HandleResponseStatus(const Status& status) {
+  if (status.ok()) {
+    return true;
+  }
+
+  grpc_stream_->FinishImmediately();
+  // Don't expect gRPC to produce status -- since the error happened on the
+  // client, we have all the information we need.
+  Finish(status);
+  return false;
+}
+
+void Stream::DecodeResponsesOn(std::shared_ptr<AsyncQueue> decode_queue) {
+  EnsureOnQueue();
+  HARD_ASSERT(!IsStarted(), "Decode queue set on a started stream");
+
+  decode_queue_ = std::move(decode_queue);
+}
+
+Stream::ResponseHandler Stream::DecodeStreamResponse(
+    const grpc::ByteBuffer& message) {
+  return [this, message] { return NotifyStreamResponse(message); };
+}
+
+void Stream::DecodeOffQueue(const grpc::ByteBuffer& message) {
+  std::weak_ptr<Stream> weak_this{shared_from_this()};
+  int close_count = close_count_;
+
+  decode_queue_->Enqueue([weak_this, message, close_count] {
+    auto strong_this = weak_this.lock();
+    if (!strong_this) {
+      return;
+    }
+
+    ResponseHandler handler = strong_this->DecodeStreamResponse(message);
+    {
+      std::lock_guard<std::mutex> lock(strong_this->decoded_responses_mutex_);
+      strong_this->decoded_responses_.emplace_back(close_count,
+                                                   std::move(handler));
+    }
+
+    strong_this->worker_queue_->EnqueueRelaxed([weak_this] {
+      if (auto strong_this = weak_this.lock()) {
+        strong_this->HandleDecodedResponses();
+      }
+    });
+  });
+}
+
+void Stream::HandleDecodedResponses() {
+  EnsureOnQueue();
+
+  while (true) {
+    std::pair<int, ResponseHandler> response;
+    {
+      std::lock_guard<std::mutex> lock(decoded_responses_mutex_);
+      if (decoded_responses_.empty()) {
+        return;
+      }
+      response = std::move(decoded_responses_.front());
+      decoded_responses_.pop_front();
+    }
+
+    // Drop responses that were read before the stream was last closed.
+    if (response.first != close_count_) {
+      continue;
+    }
+    if (!HandleResponseStatus(response.second())) {
+      return;
+    }
+  }
 }
 
 // Stopping
@@ -353,6 +424,40 @@ void Stream::HandleErrorStatus(const Status& status) {
 void Stream::OnStreamFinish(const Status& status) {
   EnsureOnQueue();
 
+  if (decode_queue_) {
+    // Handle the responses that arrived before the stream finished and are
+    // still being decoded first. The decode queue runs this after them, and
+    // hands back to the worker queue the same way decoded responses do.
+    std::weak_ptr<Stream> weak_this{shared_from_this()};
+    int close_count = close_count_;
+    bool enqueued = decode_queue_->Enqueue([weak_this, status, close_count] {
+      auto strong_this = weak_this.lock();
+      if (!strong_this) {
+        return;
+      }
+      strong_this->worker_queue_->EnqueueRelaxed([weak_this, status,
+                                                  close_count] {
+        auto strong_this = weak_this.lock();
+        // The stream may have been stopped in the meantime, or one of the
+        // responses may fail and close it.
+        if (!strong_this || strong_this->close_count_ != close_count) {
+          return;
+        }
+        strong_this->HandleDecodedResponses();
+        if (strong_this->close_count_ == close_count) {
+          strong_this->Finish(status);
+        }
+      });
+    });
+    if (enqueued) {
+      return;
+    }
+  }
+
+  Finish(status);
+}
+
+void Stream::Finish(const Status& status) {
   if (!status.ok()) {
     LOG_WARN("%s Stream error: '%s'", GetDebugDescription(), status.ToString());
   } else {
@@ -375,6 +480,11 @@ void Stream::Write(grpc::ByteBuffer&& message) {
   HARD_ASSERT(IsOpen(), "Cannot write when the stream is not open.");
 
   CancelIdleCheck();
+  if (grpc_stream_->IsFinished()) {
+    // The stream is about to close once the responses still being decoded are
+    // handled; the message is resent when the stream restarts.
+    return;
+  }
   grpc_stream_->Write(std::move(message));
 }
 
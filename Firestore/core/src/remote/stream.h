@@ -17,8 +17,12 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_STREAM_H_
 #define FIRESTORE_CORE_SRC_REMOTE_STREAM_H_
 
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/credentials/credentials_fwd.h"
@@ -198,6 +202,17 @@ class Stream : public GrpcStreamObserver,
    */
   void CancelIdleCheck();
 
+  /**
+   * Makes the stream decode its responses on `decode_queue` rather than on the
+   * worker queue. Decoded responses are still handled on the worker queue, in
+   * the order they arrived, and before the stream closes if it finishes while
+   * they are being decoded. Responses to a stream that has since been closed
+   * are dropped.
+   *
+   * Must be called before the stream is started.
+   */
+  void DecodeResponsesOn(std::shared_ptr<util::AsyncQueue> decode_queue);
+
   // `GrpcStreamObserver` interface -- do not use.
   void OnStreamStart() override;
   void OnStreamRead(const grpc::ByteBuffer& message) override;
@@ -209,6 +224,9 @@ class Stream : public GrpcStreamObserver,
   void Write(grpc::ByteBuffer&& message);
   std::string GetDebugDescription() const;
 
+  /** Handles a decoded response on the worker queue. */
+  using ResponseHandler = std::function<util::Status()>;
+
   ExponentialBackoff backoff_;
 
  private:
@@ -228,13 +246,30 @@ class Stream : public GrpcStreamObserver,
   virtual void NotifyStreamOpen() = 0;
   virtual util::Status NotifyStreamResponse(
       const grpc::ByteBuffer& message) = 0;
+  /**
+   * Does the part of handling `message` that doesn't touch the stream's state,
+   * and returns the rest. When the stream has a decode queue, this runs on
+   * that queue, and the returned handler runs on the worker queue.
+   *
+   * By default, `message` is handled entirely by `NotifyStreamResponse`.
+   */
+  virtual ResponseHandler DecodeStreamResponse(const grpc::ByteBuffer& message);
   virtual void NotifyStreamClose(const util::Status& status) = 0;
   // PORTING NOTE: C++ cannot rely on RTTI, unlike other platforms.
   virtual std::string GetDebugName() const = 0;
 
   void Close(const util::Status& status);
+  void Finish(const util::Status& status);
   void HandleErrorStatus(const util::Status& status);
 
+  /**
+   * Closes the stream if handling a response failed. Returns whether the
+   * stream is still open.
+   */
+  bool HandleResponseStatus(const util::Status& status);
+  void DecodeOffQueue(const grpc::ByteBuffer& message);
+  void HandleDecodedResponses();
+
   void RequestCredentials();
   void ResumeStartWithCredentials(
       const util::StatusOr<credentials::AuthToken>& auth_token,
@@ -260,6 +295,13 @@ class Stream : public GrpcStreamObserver,
   // Used to prevent auth if the stream happens to be restarted before token is
   // received.
   int close_count_ = 0;
+
+  std::shared_ptr<util::AsyncQueue> decode_queue_;
+
+  // Responses decoded on `decode_queue_` that are waiting to be handled on the
+  // worker queue, each with the close count at the time it was read.
+  std::mutex decoded_responses_mutex_;
+  std::deque<std::pair<int, ResponseHandler>> decoded_responses_;
 };
 
 }  // namespace remote
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/watch_stream.h"
 
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "Firestore/core/src/model/mutation.h"
@@ -36,6 +38,7 @@ using local::TargetData;
 using model::TargetId;
 using remote::ByteBufferReader;
 using util::AsyncQueue;
+using util::LogIsDebugEnabled;
 using util::Status;
 using util::TimerId;
 
@@ -93,26 +96,43 @@ void WatchStream::NotifyStreamOpen() {
 }
 
 Status WatchStream::NotifyStreamResponse(const grpc::ByteBuffer& message) {
+  return DecodeStreamResponse(message)();
+}
+
+Stream::ResponseHandler WatchStream::DecodeStreamResponse(
+    const grpc::ByteBuffer& message) {
   ByteBufferReader reader{message};
   auto response = watch_serializer_.ParseResponse(&reader);
   if (!reader.ok()) {
-    return reader.status();
+    Status status = reader.status();
+    return [status] { return status; };
   }
 
-  LOG_DEBUG("%s response: %s", GetDebugDescription(), response.ToString());
-
-  // A successful response means the stream is healthy.
-  backoff_.Reset();
+  // Decoding consumes the response, so describe it first.
+  std::string description;
+  if (LogIsDebugEnabled()) {
+    description = response.ToString();
+  }
 
-  auto watch_change = watch_serializer_.DecodeWatchChange(&reader, *response);
+  std::shared_ptr<WatchChange> watch_change =
+      watch_serializer_.DecodeWatchChange(&reader, *response);
   auto version = watch_serializer_.DecodeSnapshotVersion(&reader, *response);
-  if (!reader.ok()) {
-    return reader.status();
-  }
+  Status status = reader.status();
+
+  return [this, description, watch_change, version, status] {
+    LOG_DEBUG("%s response: %s", GetDebugDescription(), description);
+
+    // A successful response means the stream is healthy.
+    backoff_.Reset();
+
+    if (!status.ok()) {
+      return status;
+    }
 
-  callback_->OnWatchStreamChange(*watch_change, version);
+    callback_->OnWatchStreamChange(*watch_change, version);
 
-  return Status::OK();
+    return Status::OK();
+  };
 }
 
 void WatchStream::NotifyStreamClose(const Status& status) {
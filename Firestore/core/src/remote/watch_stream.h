@@ -117,6 +117,8 @@ class WatchStream : public Stream {
 
   void NotifyStreamOpen() override;
   util::Status NotifyStreamResponse(const grpc::ByteBuffer& message) override;
+  ResponseHandler DecodeStreamResponse(
+      const grpc::ByteBuffer& message) override;
   void NotifyStreamClose(const util::Status& status) override;
 
   std::string GetDebugName() const override {
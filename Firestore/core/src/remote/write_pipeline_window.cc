@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/write_pipeline_window.h"
+
+#include <algorithm>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+namespace {
+
+using Seconds = std::chrono::duration<double>;
+
+/**
+ * Below this many estimated queued batches the window grows; above
+ * `kMaxQueuedBatches` it shrinks.
+ */
+constexpr double kMinQueuedBatches = 2;
+constexpr double kMaxQueuedBatches = 4;
+
+/** The weight of a new sample in the smoothed round-trip time. */
+constexpr double kRttSmoothing = 0.125;
+
+}  // namespace
+
+constexpr size_t WritePipelineWindow::kMinSize;
+constexpr size_t WritePipelineWindow::kMaxSize;
+
+void WritePipelineWindow::OnRequestSent(size_t batch_count,
+                                        Clock::time_point now) {
+  HARD_ASSERT(batch_count > 0, "Write requests must carry at least one batch");
+
+  outstanding_batch_count_ += batch_count;
+  outstanding_.push_back(Request{batch_count, now, outstanding_batch_count_});
+
+  if (!adjusted_at_valid_) {
+    adjusted_at_ = now;
+    adjusted_at_valid_ = true;
+  }
+}
+
+size_t WritePipelineWindow::OnResponseReceived(Clock::time_point now) {
+  if (outstanding_.empty()) {
+    return 1;
+  }
+
+  Request request = outstanding_.front();
+  outstanding_.pop_front();
+  outstanding_batch_count_ -= request.batch_count;
+
+  double rtt = Seconds(now - request.sent_at).count();
+  if (rtt <= 0) {
+    // Responses that arrive without measurable delay carry no information
+    // about the path to the backend.
+    return request.batch_count;
+  }
+
+  if (smoothed_rtt_ == 0) {
+    min_rtt_ = rtt;
+    smoothed_rtt_ = rtt;
+  } else {
+    min_rtt_ = std::min(min_rtt_, rtt);
+    smoothed_rtt_ += kRttSmoothing * (rtt - smoothed_rtt_);
+  }
+
+  Adjust(request, rtt, now);
+  return request.batch_count;
+}
+
+size_t WritePipelineWindow::next_response_batch_count() const {
+  return outstanding_.empty() ? 1 : outstanding_.front().batch_count;
+}
+
+void WritePipelineWindow::OnStreamClosed(bool failed) {
+  outstanding_.clear();
+  outstanding_batch_count_ = 0;
+  adjusted_at_valid_ = false;
+
+  if (failed) {
+    size_ = std::max(kMinSize, size_ / 2);
+  }
+}
+
+void WritePipelineWindow::Adjust(const Request& request,
+                                 double rtt,
+                                 Clock::time_point now) {
+  // Only a window that was actually full says anything about whether it is
+  // too small; an application that writes slowly never fills it.
+  if (request.in_flight_batch_count < size_) {
+    return;
+  }
+  if (Seconds(now - adjusted_at_).count() < smoothed_rtt_) {
+    return;
+  }
+
+  double acknowledgement_rate = request.in_flight_batch_count / rtt;
+  double queued_batches =
+      static_cast<double>(size_) - acknowledgement_rate * min_rtt_;
+  if (queued_batches < kMinQueuedBatches) {
+    size_ = std::min(kMaxSize, size_ + 1);
+  } else if (queued_batches > kMaxQueuedBatches) {
+    size_ = std::max(kMinSize, size_ - 1);
+  }
+  adjusted_at_ = now;
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
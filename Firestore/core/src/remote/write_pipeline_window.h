@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_WINDOW_H_
+#define FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_WINDOW_H_
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * Tracks the write requests in flight on the write stream and decides how many
+ * mutation batches the `RemoteStore` may have outstanding at once.
+ *
+ * The window starts at `kMinSize`, which was historically the fixed limit, and
+ * adapts in the manner of TCP Vegas. When a request sent with a full window is
+ * acknowledged, the acknowledgement rate it implies (the batches in flight
+ * divided by its round-trip time) is compared with the rate the window would
+ * achieve at the minimum observed round-trip time. Their difference estimates
+ * the number of batches queued in the backend or the network. While that
+ * estimate is small the window grows by one batch; when it is large the window
+ * shrinks by one. The window is adjusted at most once per round trip, and
+ * stream failures halve it.
+ *
+ * Responses on the write stream arrive in request order, so the window also
+ * serves as the record of how many batches each outstanding request carried.
+ */
+class WritePipelineWindow {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /** The smallest window, which is also the initial window. */
+  static constexpr size_t kMinSize = 10;
+
+  /** The largest window. */
+  static constexpr size_t kMaxSize = 100;
+
+  /** The number of batches in the current window. */
+  size_t size() const {
+    return size_;
+  }
+
+  /** Records that a request carrying `batch_count` batches was sent. */
+  void OnRequestSent(size_t batch_count, Clock::time_point now);
+
+  /**
+   * Records the response to the oldest outstanding request and returns the
+   * number of batches that request carried. Returns 1 if there is no
+   * outstanding request on record.
+   */
+  size_t OnResponseReceived(Clock::time_point now);
+
+  /**
+   * Returns the number of batches carried by the oldest outstanding request,
+   * or 1 if there is no outstanding request on record.
+   */
+  size_t next_response_batch_count() const;
+
+  /**
+   * Forgets all outstanding requests because the stream was closed. If
+   * `failed` is true, the window is also halved.
+   */
+  void OnStreamClosed(bool failed);
+
+ private:
+  struct Request {
+    size_t batch_count = 0;
+    Clock::time_point sent_at;
+    // The number of batches in flight once this request was sent.
+    size_t in_flight_batch_count = 0;
+  };
+
+  void Adjust(const Request& request, double rtt, Clock::time_point now);
+
+  size_t size_ = kMinSize;
+
+  std::deque<Request> outstanding_;
+  size_t outstanding_batch_count_ = 0;
+
+  // Round-trip time estimates, in seconds. Zero until the first sample.
+  double min_rtt_ = 0;
+  double smoothed_rtt_ = 0;
+
+  bool adjusted_at_valid_ = false;
+  Clock::time_point adjusted_at_;
+};
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_WINDOW_H_
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_WRITE_STREAM_H_
 #define FIRESTORE_CORE_SRC_REMOTE_WRITE_STREAM_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -129,6 +130,13 @@ class WriteStream : public Stream {
   /** Sends a group of mutations to the Firestore backend to apply. */
   virtual void WriteMutations(const std::vector<model::Mutation>& mutations);
 
+  /**
+   * Returns the number of bytes the given mutations would add to a request
+   * sent by `WriteMutations`.
+   */
+  virtual size_t CalculateByteSize(
+      const std::vector<model::Mutation>& mutations) const;
+
  protected:
   // For tests only
   void SetHandshakeComplete(bool value = true) {
@@ -16,7 +16,11 @@
 
 #include "Firestore/core/src/util/async_queue.h"
 
+#include <future>
+#include <memory>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/task.h"
@@ -44,19 +48,24 @@ AsyncQueue::~AsyncQueue() {
 }
 
 void AsyncQueue::EnterRestrictedMode() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if (mode_ == Mode::kDisposed) return;
-
-  mode_ = Mode::kRestricted;
+  // A disposed queue stays disposed.
+  Mode expected = Mode::kRunning;
+  mode_.compare_exchange_strong(expected, Mode::kRestricted);
 }
 
 void AsyncQueue::Dispose() {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    mode_ = Mode::kDisposed;
-  }
+  mode_ = Mode::kDisposed;
 
+  // If an operation is disposing the queue, the drain running it discards
+  // the rest once the operation returns.
+  bool called_from_drain = executor_->IsCurrentExecutor() && is_draining_;
   executor_->Dispose();
+
+  // No drain runs from here on, so the operations that are still pending
+  // would otherwise only be destroyed along with the queue.
+  if (!called_from_drain) {
+    DiscardPendingOperations();
+  }
 }
 
 void AsyncQueue::VerifyIsCurrentExecutor() const {
@@ -100,26 +109,88 @@ bool AsyncQueue::Enqueue(const Operation& operation) {
 }
 
 bool AsyncQueue::EnqueueEvenWhileRestricted(const Operation& operation) {
-  std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ == Mode::kDisposed) return false;
 
-  executor_->Execute(Wrap(operation));
+  Push(operation);
   return true;
 }
 
 bool AsyncQueue::is_running() const {
-  std::lock_guard<std::mutex> lock(mutex_);
   return mode_ == Mode::kRunning;
 }
 
 bool AsyncQueue::EnqueueRelaxed(const Operation& operation) {
-  std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ != Mode::kRunning) return false;
 
-  executor_->Execute(Wrap(operation));
+  Push(operation);
   return true;
 }
 
+void AsyncQueue::Push(const Operation& operation) {
+  operations_.Push(operation);
+
+  // Only the push that finds no pending operations submits a drain; the
+  // drains run in order on the executor and each takes the operations counted
+  // before it starts. If the executor has been disposed in the meantime, it
+  // rejects the drain and the operation is never run.
+  if (pending_operations_.fetch_add(1) == 0) {
+    executor_->Execute([this] { Drain(); });
+  }
+
+  // A push that raced with `Dispose` can land after the pending operations
+  // have been discarded.
+  if (operations_discarded_) {
+    DiscardPendingOperations();
+  }
+}
+
+void AsyncQueue::Drain() {
+  // Take only the operations pending when this drain starts. Resetting the
+  // count makes the next push submit a drain of its own, behind whatever else
+  // the executor has to run by then, so a steady stream of operations can't
+  // keep delayed operations and other executor tasks from running.
+  size_t count = pending_operations_.exchange(0);
+  is_draining_ = true;
+  for (size_t i = 0; i < count; ++i) {
+    Operation operation = PopOperation();
+
+    // Operations that haven't started when `Dispose` is called are
+    // discarded.
+    if (mode_ == Mode::kDisposed) continue;
+    ExecuteBlocking(operation);
+  }
+  is_draining_ = false;
+
+  // The drains submitted after the queue was disposed never run.
+  if (mode_ == Mode::kDisposed) {
+    DiscardPendingOperations();
+  }
+}
+
+AsyncQueue::Operation AsyncQueue::PopOperation() {
+  Operation operation;
+  while (!operations_.TryPop(&operation)) {
+    // A push is halfway done; its operation shows up momentarily.
+    std::this_thread::yield();
+  }
+  return operation;
+}
+
+void AsyncQueue::DiscardPendingOperations() {
+  // Destroy the operations without holding the lock: anything they own, such
+  // as the promise `EnqueueBlocking` waits on, may try to enqueue again.
+  std::vector<Operation> discarded;
+  {
+    std::lock_guard<std::mutex> lock(discard_mutex_);
+    operations_discarded_ = true;
+    size_t count = pending_operations_.exchange(0);
+    discarded.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      discarded.push_back(PopOperation());
+    }
+  }
+}
+
 DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
                                                const TimerId timer_id,
                                                const Operation& operation) {
@@ -161,7 +232,23 @@ void AsyncQueue::VerifySequentialOrder() const {
 
 void AsyncQueue::EnqueueBlocking(const Operation& operation) {
   VerifySequentialOrder();
-  executor_->ExecuteBlocking(Wrap(operation));
+  HARD_ASSERT(!executor_->IsCurrentExecutor(),
+              "EnqueueBlocking on the current queue will lead to a deadlock");
+  if (mode_ == Mode::kDisposed) return;
+
+  // Go through the mailbox so that the operation runs after any operations
+  // enqueued before it. If the queue is disposed before the operation runs,
+  // `Dispose` discards the operation along with the promise, which breaks it
+  // and ends the wait.
+  auto finished = std::make_shared<std::promise<void>>();
+  std::future<void> future = finished->get_future();
+  Push([operation, finished] {
+    operation();
+    finished->set_value();
+  });
+  // Only the operation may keep the promise alive.
+  finished.reset();
+  future.wait();
 }
 
 bool AsyncQueue::IsScheduled(const TimerId timer_id) const {
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/mpsc_queue.h"
 
 namespace firebase {
 namespace firestore {
@@ -236,6 +237,21 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
 
   Operation Wrap(const Operation& operation);
 
+  // Puts `operation` on `operations_`, and submits a drain to the executor if
+  // there was none pending.
+  void Push(const Operation& operation);
+
+  // Runs the operations that are pending on `operations_` when it starts.
+  void Drain();
+
+  // Takes the next operation off `operations_`, waiting for a push that is
+  // halfway done if need be.
+  Operation PopOperation();
+
+  // Destroys the operations left on `operations_` once no drain will run
+  // them.
+  void DiscardPendingOperations();
+
   // Asserts that the current invocation happens asynchronously on the queue.
   void VerifyIsCurrentExecutor() const;
   void VerifySequentialOrder() const;
@@ -243,8 +259,25 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   std::atomic<bool> is_operation_in_progress_;
   std::unique_ptr<Executor> executor_;
 
+  // Operations for immediate execution. Enqueuing one takes no locks: they are
+  // run in FIFO order by a single drain on the executor, which is submitted
+  // when the count of pending operations goes up from zero. Delayed operations
+  // go straight to the executor's schedule.
+  MpscQueue<Operation> operations_;
+  std::atomic<size_t> pending_operations_{0};
+
+  // Only accessed on the executor.
+  bool is_draining_ = false;
+
+  // Set once the queue is disposed and nothing will drain `operations_`
+  // anymore; from then on, whoever pushes discards.
+  std::atomic<bool> operations_discarded_{false};
+  std::mutex discard_mutex_;
+
+  std::atomic<Mode> mode_{Mode::kRunning};
+
+  // Guards `timer_ids_to_skip_`.
   mutable std::mutex mutex_;
-  Mode mode_ = Mode::kRunning;
 
   std::vector<TimerId> timer_ids_to_skip_;
 };
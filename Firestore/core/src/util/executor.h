@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_UTIL_EXECUTOR_H_
 
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -99,6 +100,13 @@ class Executor {
   // Like `Execute`, but blocks until the `operation` finishes, consequently
   // draining immediate operations from the executor.
   virtual void ExecuteBlocking(Operation&& operation) = 0;
+  // Runs `operation(i)` for every `i` in `[0, count)` and blocks until all of
+  // the calls finish. The calls are spread over the executor's threads, in no
+  // particular order, and the calling thread takes part, so this is safe to
+  // call from an operation running on this executor. Submitting the whole
+  // range at once is much cheaper than calling `Execute` for every index.
+  virtual void ExecuteAll(size_t count,
+                          const std::function<void(size_t)>& operation) = 0;
 
   // Scheduled the given `operation` to be executed after `delay` milliseconds
   // from now, and returns a handle that allows to cancel the operation
@@ -58,6 +58,8 @@ class ExecutorLibdispatch : public Executor {
 
   void Execute(Operation&& operation) override;
   void ExecuteBlocking(Operation&& operation) override;
+  void ExecuteAll(size_t count,
+                  const std::function<void(size_t)>& operation) override;
   DelayedOperation Schedule(Milliseconds delay,
                             Tag tag,
                             Operation&& operation) override;
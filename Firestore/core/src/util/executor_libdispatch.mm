@@ -134,6 +134,32 @@ void ExecutorLibdispatch::ExecuteBlocking(Operation&& operation) {
   dispatch_sync_f(dispatch_queue_, task, InvokeSync);
 }
 
+void ExecutorLibdispatch::ExecuteAll(
+    size_t count, const std::function<void(size_t)>& operation) {
+  bool run_inline = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    run_inline = disposed_;
+  }
+
+  // `dispatch_apply` on the current queue deadlocks if the queue is serial.
+  if (run_inline || GetCurrentQueueLabel() == GetQueueLabel(dispatch_queue_)) {
+    for (size_t i = 0; i < count; ++i) {
+      operation(i);
+    }
+    return;
+  }
+
+  // `dispatch_apply` spreads the calls over the queue and the calling thread,
+  // and returns once all of them have finished.
+  void* context = const_cast<std::function<void(size_t)>*>(&operation);
+  dispatch_apply_f(count, dispatch_queue_, context,
+                   [](void* raw_operation, size_t i) {
+                     (*static_cast<std::function<void(size_t)>*>(
+                         raw_operation))(i);
+                   });
+}
+
 DelayedOperation ExecutorLibdispatch::Schedule(Milliseconds delay,
                                                Tag tag,
                                                Operation&& operation) {
@@ -17,6 +17,7 @@
 #include "Firestore/core/src/util/executor_std.h"
 
 #include <future>
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -48,23 +49,236 @@ std::string ThreadIdToString(const std::thread::id thread_id) {
   return stream.str();
 }
 
+/**
+ * The indices of an `ExecuteAll` call, shared by the threads that take part in
+ * it. Every participant owns a range of the indices that are left: it runs
+ * indices from the front of its own range and, once that is empty, steals the
+ * back half of another participant's range. Ranges are packed into a single
+ * atomic word and updated with compare-and-swap, so no locks are taken until
+ * the last index has been run.
+ */
+class WorkStealingBatch {
+ public:
+  WorkStealingBatch(size_t count,
+                    size_t participants,
+                    const std::function<void(size_t)>* operation)
+      : operation_(operation), count_(count), ranges_(participants) {
+    for (size_t i = 0; i < participants; ++i) {
+      ranges_[i].bounds.store(Pack(count * i / participants,
+                                   count * (i + 1) / participants));
+    }
+  }
+
+  /** Runs indices as the given participant until none are left to claim. */
+  void Run(size_t participant) {
+    size_t completed = 0;
+    size_t index = 0;
+    while (PopFront(participant, &index) || Steal(participant, &index)) {
+      (*operation_)(index);
+      ++completed;
+    }
+
+    if (completed > 0 &&
+        completed_.fetch_add(completed) + completed == count_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_.notify_all();
+    }
+  }
+
+  /** Blocks until every index has been run. */
+  void AwaitCompletion() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return completed_ == count_; });
+  }
+
+ private:
+  struct Range {
+    std::atomic<uint64_t> bounds{0};
+    // Keeps the ranges of different participants on different cache lines.
+    char padding[56];
+  };
+
+  static uint64_t Pack(size_t begin, size_t end) {
+    return static_cast<uint64_t>(begin) << 32 | static_cast<uint64_t>(end);
+  }
+  static size_t Begin(uint64_t bounds) {
+    return static_cast<size_t>(bounds >> 32);
+  }
+  static size_t End(uint64_t bounds) {
+    return static_cast<size_t>(bounds & 0xffffffff);
+  }
+
+  bool PopFront(size_t participant, size_t* index) {
+    std::atomic<uint64_t>& range = ranges_[participant].bounds;
+    uint64_t bounds = range.load();
+    while (Begin(bounds) < End(bounds)) {
+      if (range.compare_exchange_weak(
+              bounds, Pack(Begin(bounds) + 1, End(bounds)))) {
+        *index = Begin(bounds);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Only called once the participant's own range is empty. Nobody else writes
+  // to an empty range, so the rest of the stolen range can be stored there.
+  bool Steal(size_t participant, size_t* index) {
+    for (size_t i = 1; i < ranges_.size(); ++i) {
+      std::atomic<uint64_t>& victim =
+          ranges_[(participant + i) % ranges_.size()].bounds;
+      uint64_t bounds = victim.load();
+      while (Begin(bounds) < End(bounds)) {
+        size_t middle = Begin(bounds) + (End(bounds) - Begin(bounds)) / 2;
+        if (victim.compare_exchange_weak(bounds,
+                                         Pack(Begin(bounds), middle))) {
+          *index = middle;
+          ranges_[participant].bounds.store(Pack(middle + 1, End(bounds)));
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  const std::function<void(size_t)>* operation_ = nullptr;
+  size_t count_ = 0;
+  std::vector<Range> ranges_;
+
+  std::atomic<size_t> completed_{0};
+  std::mutex mutex_;
+  std::condition_variable done_;
+};
+
+/**
+ * The operations submitted to one worker for immediate execution. Other
+ * workers take from it once their own queue is empty.
+ */
+class WorkerQueue {
+ public:
+  void Push(Executor::Operation&& operation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    operations_.push_back(std::move(operation));
+  }
+
+  bool Pop(Executor::Operation* operation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return PopLocked(operation);
+  }
+
+  // Gives up instead of waiting for the owner or another thief.
+  bool Steal(Executor::Operation* operation) {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    return lock.owns_lock() && PopLocked(operation);
+  }
+
+  std::deque<Executor::Operation> TakeAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(operations_);
+  }
+
+ private:
+  bool PopLocked(Executor::Operation* operation) {
+    if (operations_.empty()) return false;
+    *operation = std::move(operations_.front());
+    operations_.pop_front();
+    return true;
+  }
+
+  std::mutex mutex_;
+  std::deque<Executor::Operation> operations_;
+};
+
 }  // namespace
 
 class ExecutorStd::SharedState {
  public:
-  // Operations scheduled for immediate execution are also put on the schedule
-  // (with due time set to `Immediate`).
+  explicit SharedState(size_t workers) {
+    for (size_t i = 0; i < workers; ++i) {
+      worker_queues_.push_back(absl::make_unique<WorkerQueue>());
+    }
+  }
+
+  // Puts `operation` on the next worker's queue in turn.
+  void Push(Operation&& operation) {
+    size_t worker = next_worker_.fetch_add(1, std::memory_order_relaxed);
+    worker_queues_[worker % worker_queues_.size()]->Push(std::move(operation));
+    pending_operations_.fetch_add(1);
+    WakeIdleWorker();
+  }
+
+  // Takes an operation from the given worker's queue, or else from another
+  // worker's.
+  bool Take(size_t worker, Operation* operation) {
+    if (disposed_) return false;
+
+    size_t workers = worker_queues_.size();
+    bool taken = worker_queues_[worker]->Pop(operation);
+    for (size_t i = 1; !taken && i < workers; ++i) {
+      taken = worker_queues_[(worker + i) % workers]->Steal(operation);
+    }
+    if (taken) {
+      pending_operations_.fetch_sub(1);
+    }
+    return taken;
+  }
+
+  // Removes every operation that is waiting for immediate execution.
+  std::vector<Operation> TakeAll() {
+    std::vector<Operation> result;
+    for (const auto& queue : worker_queues_) {
+      for (Operation& operation : queue->TakeAll()) {
+        result.push_back(std::move(operation));
+      }
+    }
+    pending_operations_.fetch_sub(result.size());
+    return result;
+  }
+
+  // Blocks until the schedule has a due task. Workers only wait on the
+  // schedule once every queue is empty, so a push that finds a worker waiting
+  // puts a no-op task on the schedule to wake it up.
+  Task* WaitForTask() {
+    idle_workers_.fetch_add(1);
+    // A push that didn't see this worker as idle has already counted its
+    // operation.
+    if (pending_operations_ > 0) {
+      idle_workers_.fetch_sub(1);
+      return nullptr;
+    }
+    Task* task = schedule_.PopBlocking();
+    idle_workers_.fetch_sub(1);
+    return task;
+  }
+
+  void WakeIdleWorker() {
+    if (idle_workers_ > 0) {
+      schedule_.Push(Task::Create(nullptr, Immediate(), kNoTag, 0, [] {}));
+    }
+  }
+
+  // Delayed operations and the tasks that stop the workers. Operations
+  // submitted for immediate execution go on the worker queues instead.
   class Schedule schedule_;
+
+  std::atomic<bool> disposed_{false};
+
+ private:
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::atomic<size_t> next_worker_{0};
+  std::atomic<size_t> pending_operations_{0};
+  std::atomic<int> idle_workers_{0};
 };
 
 // MARK: - ExecutorStd
 
-ExecutorStd::ExecutorStd(int threads)
-    : state_(std::make_shared<SharedState>()) {
+ExecutorStd::ExecutorStd(int threads) {
   HARD_ASSERT(threads > 0);
 
+  state_ = std::make_shared<SharedState>(static_cast<size_t>(threads));
   for (int i = 0; i < threads; ++i) {
-    worker_thread_pool_.emplace_back(&ExecutorStd::PollingThread, state_);
+    worker_thread_pool_.emplace_back(&ExecutorStd::PollingThread, state_,
+                                     static_cast<size_t>(i));
   }
 }
 
@@ -73,15 +287,20 @@ ExecutorStd::~ExecutorStd() {
 }
 
 void ExecutorStd::Dispose() {
+  // Destroyed without holding the lock, in case they submit more work.
+  std::vector<Operation> discarded;
   {
     std::lock_guard<std::mutex> lock(mutex_);
 
     // Do nothing if already disposed.
-    if (state_ == nullptr) {
+    if (state_->disposed_) {
       return;
     }
 
+    // Workers stop taking operations from their queues once this is set.
+    state_->disposed_ = true;
     state_->schedule_.Clear();
+    discarded = state_->TakeAll();
 
     // Enqueue one Task with the kShutdownTag for each worker. Workers will
     // finish whatever task they're currently working on, execute this task,
@@ -95,12 +314,10 @@ void ExecutorStd::Dispose() {
     for (size_t i = 0; i < worker_thread_pool_.size(); ++i) {
       PushOnScheduleLocked(Immediate(), kShutdownTag, [] {});
     }
-
-    state_ = nullptr;
   }
 
-  // Now that `state_` has been released, join any threads while not holding
-  // the lock to avoid deadlocks where the thread tries to access the executor.
+  // Join any threads while not holding the lock to avoid deadlocks where the
+  // thread tries to access the executor.
   for (std::thread& thread : worker_thread_pool_) {
     // If the current thread is running this destructor, we can't join the
     // thread. Instead detach it and rely on PollingThread to exit cleanly.
@@ -113,17 +330,20 @@ void ExecutorStd::Dispose() {
 }
 
 void ExecutorStd::Execute(Operation&& operation) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if (!state_) return;
+  // Doesn't take `mutex_`: an operation that races with `Dispose` lands on a
+  // worker queue that is no longer read. The operation may destroy this
+  // executor before `Push` returns, so keep the shared state alive.
+  std::shared_ptr<SharedState> state = state_;
+  if (state->disposed_) return;
 
-  PushOnScheduleLocked(Immediate(), kNoTag, std::move(operation));
+  state->Push(std::move(operation));
 }
 
 DelayedOperation ExecutorStd::Schedule(const Milliseconds delay,
                                        Tag tag,
                                        Operation&& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
-  if (!state_) return {};
+  if (state_->disposed_) return {};
 
   // While negative delay can be interpreted as a request for immediate
   // execution, supporting it would provide a hacky way to modify FIFO ordering
@@ -132,6 +352,9 @@ DelayedOperation ExecutorStd::Schedule(const Milliseconds delay,
 
   const auto target_time = MakeTargetTime(delay);
   const auto id = PushOnScheduleLocked(target_time, tag, std::move(operation));
+  // Idle workers sleep until the earliest task on the schedule is due, and
+  // this one may be due sooner.
+  state_->WakeIdleWorker();
   return DelayedOperation(this, id);
 }
 
@@ -143,10 +366,13 @@ void ExecutorStd::Cancel(const Id operation_id) {
   Task* removed = nullptr;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!state_) return;
+    if (state_->disposed_) return;
 
-    removed = state_->schedule_.RemoveIf(
-        [operation_id](const Task& t) { return t.id() == operation_id; });
+    // Only delayed operations can be cancelled; the tasks that wake workers
+    // up all share id 0.
+    removed = state_->schedule_.RemoveIf([operation_id](const Task& t) {
+      return !t.is_immediate() && t.id() == operation_id;
+    });
   }
 
   if (removed) {
@@ -172,9 +398,21 @@ ExecutorStd::Id ExecutorStd::PushOnScheduleLocked(const TimePoint when,
   return id;
 }
 
-void ExecutorStd::PollingThread(std::shared_ptr<SharedState> state) {
+void ExecutorStd::PollingThread(std::shared_ptr<SharedState> state,
+                                size_t worker) {
   for (;;) {
-    Task* task = state->schedule_.PopBlocking();
+    // Operations for immediate execution come before any delayed ones.
+    Operation operation;
+    if (state->Take(worker, &operation)) {
+      operation();
+      continue;
+    }
+
+    Task* task = state->schedule_.PopIfDue();
+    if (task == nullptr) {
+      task = state->WaitForTask();
+      if (task == nullptr) continue;
+    }
     bool shutdown_requested = task->tag() == kShutdownTag;
 
     task->ExecuteAndRelease();
@@ -223,6 +461,32 @@ void ExecutorStd::ExecuteBlocking(Operation&& operation) {
   signal_finished.get_future().wait();
 }
 
+void ExecutorStd::ExecuteAll(size_t count,
+                             const std::function<void(size_t)>& operation) {
+  if (count == 0) return;
+  HARD_ASSERT(count <= std::numeric_limits<uint32_t>::max(),
+              "ExecuteAll: too many operations (%s)", count);
+
+  // The calling thread is one of the participants. If it is one of the
+  // workers, it can't help itself.
+  size_t helpers = worker_thread_pool_.size();
+  if (IsCurrentExecutor()) --helpers;
+  helpers = std::min(helpers, count - 1);
+
+  auto batch = std::make_shared<WorkStealingBatch>(count, helpers + 1,
+                                                   &operation);
+  // A disposed executor rejects the helpers, and the calling thread runs
+  // every operation itself.
+  if (!state_->disposed_) {
+    for (size_t i = 1; i <= helpers; ++i) {
+      state_->Push([batch, i] { batch->Run(i); });
+    }
+  }
+
+  batch->Run(0);
+  batch->AwaitCompletion();
+}
+
 bool ExecutorStd::IsTagScheduled(const Tag tag) const {
   return state_->schedule_.Contains(
       [&tag](const Task& t) { return t.tag() == tag; });
@@ -230,7 +494,7 @@ bool ExecutorStd::IsTagScheduled(const Tag tag) const {
 
 bool ExecutorStd::IsIdScheduled(const Id id) const {
   return state_->schedule_.Contains(
-      [&id](const Task& t) { return t.id() == id; });
+      [&id](const Task& t) { return !t.is_immediate() && t.id() == id; });
 }
 
 Task* ExecutorStd::PopFromSchedule() {
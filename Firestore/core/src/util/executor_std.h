@@ -50,6 +50,8 @@ class ExecutorStd : public Executor {
 
   void Execute(Operation&& operation) override;
   void ExecuteBlocking(Operation&& operation) override;
+  void ExecuteAll(size_t count,
+                  const std::function<void(size_t)>& operation) override;
 
   DelayedOperation Schedule(Milliseconds delay,
                             Tag tag,
@@ -71,7 +73,8 @@ class ExecutorStd : public Executor {
   void OnCompletion(Task* task) override;
   void Cancel(Id operation_id) override;
 
-  static void PollingThread(std::shared_ptr<SharedState> state);
+  static void PollingThread(std::shared_ptr<SharedState> state,
+                            size_t worker);
   Id NextIdLocked();
 
   // A mutex that provides mutual exclusion to users of the Executor interface.
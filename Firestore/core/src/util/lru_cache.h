@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_LRU_CACHE_H_
+#define FIRESTORE_CORE_SRC_UTIL_LRU_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/**
+ * A map with a bounded total cost that evicts the least recently used entries
+ * when full. By default every entry costs 1, so the capacity bounds the number
+ * of entries; callers can instead give each entry a cost such as its size in
+ * bytes.
+ *
+ * Entries are kept in a list ordered from most to least recently used, and an
+ * `unordered_map` indexes the list by key, so lookups, insertions, and
+ * removals all have average constant-time complexity.
+ *
+ * The template arguments `K` and `V` are the key and value types. The
+ * remaining variadic template arguments are passed as the template arguments
+ * to `unordered_map`, allowing custom hashing and comparison functions to be
+ * specified.
+ *
+ * This class is not thread-safe.
+ */
+template <typename K, typename V, typename... UnorderedMapArgs>
+class LruCache {
+ public:
+  explicit LruCache(size_t capacity) : capacity_(capacity) {
+    HARD_ASSERT(capacity_ > 0, "LruCache capacity must be positive");
+  }
+
+  /**
+   * Returns a pointer to the value for the given key and marks it as the most
+   * recently used entry, or returns `nullptr` if the key is not present.
+   *
+   * The returned pointer is invalidated by the next mutation of this cache.
+   */
+  V* get(const K& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->value;
+  }
+
+  /**
+   * Inserts or replaces the value for the given key, marking it as the most
+   * recently used entry and evicting least recently used entries while the
+   * cache is over capacity.
+   *
+   * An entry whose cost alone exceeds the capacity is not retained; any
+   * existing entry for its key is removed instead.
+   */
+  void put(const K& key, V value, size_t cost = 1) {
+    if (cost > capacity_) {
+      remove(key);
+      return;
+    }
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      total_cost_ -= it->second->cost;
+      it->second->value = std::move(value);
+      it->second->cost = cost;
+      entries_.splice(entries_.begin(), entries_, it->second);
+    } else {
+      entries_.push_front(Entry{key, std::move(value), cost});
+      index_.emplace(key, entries_.begin());
+    }
+
+    total_cost_ += cost;
+    while (total_cost_ > capacity_) {
+      total_cost_ -= entries_.back().cost;
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+  }
+
+  /**
+   * Removes the entry for the given key, if present. Returns `true` if an
+   * entry was removed.
+   */
+  bool remove(const K& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return false;
+    }
+    total_cost_ -= it->second->cost;
+    entries_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  /**
+   * Removes every entry for which `predicate(key, value)` returns true.
+   *
+   * This method has linear complexity in the number of entries.
+   */
+  template <typename Predicate>
+  void remove_if(const Predicate& predicate) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (predicate(it->key, it->value)) {
+        total_cost_ -= it->cost;
+        index_.erase(it->key);
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void clear() {
+    index_.clear();
+    entries_.clear();
+    total_cost_ = 0;
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /** The sum of the costs of all entries; never more than `capacity()`. */
+  size_t total_cost() const {
+    return total_cost_;
+  }
+
+ private:
+  struct Entry {
+    K key;
+    V value;
+    size_t cost = 0;
+  };
+  using EntryList = std::list<Entry>;
+
+  size_t capacity_ = 0;
+  size_t total_cost_ = 0;
+
+  // Ordered from most recently used (front) to least recently used (back).
+  EntryList entries_;
+  std::unordered_map<K, typename EntryList::iterator, UnorderedMapArgs...>
+      index_;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_LRU_CACHE_H_
@@ -17,6 +17,7 @@
 #include "Firestore/core/src/util/md5.h"
 
 #include <algorithm>
+#include <numeric>
 
 namespace firebase {
 namespace firestore {
@@ -291,6 +292,132 @@ void MD5Final(MD5Digest* digest, MD5Context* context) {
 
 }  // namespace
 
+namespace {
+
+// The number of messages that `CalculateMd5Digests` hashes together. Eight
+// 32-bit lanes fill an AVX2 register, or two SSE2 or NEON registers.
+constexpr size_t kLaneCount = 8;
+
+using Lanes = std::array<uint32_t, kLaneCount>;
+
+/* The central step of the MD5 algorithm, applied to every lane. */
+#define MD5LANESTEP(f, w, x, y, z, word, k, s)                              \
+  for (size_t lane = 0; lane < kLaneCount; ++lane) {                        \
+    MD5STEP(f, w[lane], x[lane], y[lane], z[lane], in[word][lane] + k, s); \
+  }
+
+/*
+ * Does what MD5Transform does, for `kLaneCount` messages at once: `in[i]`
+ * holds the i-th longword of every message's block. The loops over the lanes
+ * have no dependencies between iterations, so they are vectorized.
+ */
+void MD5TransformLanes(std::array<Lanes, 4>* buf,
+                       const std::array<Lanes, 16>& in) {
+  Lanes a = (*buf)[0];
+  Lanes b = (*buf)[1];
+  Lanes c = (*buf)[2];
+  Lanes d = (*buf)[3];
+
+  MD5LANESTEP(F1, a, b, c, d, 0, 0xd76aa478, 7);
+  MD5LANESTEP(F1, d, a, b, c, 1, 0xe8c7b756, 12);
+  MD5LANESTEP(F1, c, d, a, b, 2, 0x242070db, 17);
+  MD5LANESTEP(F1, b, c, d, a, 3, 0xc1bdceee, 22);
+  MD5LANESTEP(F1, a, b, c, d, 4, 0xf57c0faf, 7);
+  MD5LANESTEP(F1, d, a, b, c, 5, 0x4787c62a, 12);
+  MD5LANESTEP(F1, c, d, a, b, 6, 0xa8304613, 17);
+  MD5LANESTEP(F1, b, c, d, a, 7, 0xfd469501, 22);
+  MD5LANESTEP(F1, a, b, c, d, 8, 0x698098d8, 7);
+  MD5LANESTEP(F1, d, a, b, c, 9, 0x8b44f7af, 12);
+  MD5LANESTEP(F1, c, d, a, b, 10, 0xffff5bb1, 17);
+  MD5LANESTEP(F1, b, c, d, a, 11, 0x895cd7be, 22);
+  MD5LANESTEP(F1, a, b, c, d, 12, 0x6b901122, 7);
+  MD5LANESTEP(F1, d, a, b, c, 13, 0xfd987193, 12);
+  MD5LANESTEP(F1, c, d, a, b, 14, 0xa679438e, 17);
+  MD5LANESTEP(F1, b, c, d, a, 15, 0x49b40821, 22);
+
+  MD5LANESTEP(F2, a, b, c, d, 1, 0xf61e2562, 5);
+  MD5LANESTEP(F2, d, a, b, c, 6, 0xc040b340, 9);
+  MD5LANESTEP(F2, c, d, a, b, 11, 0x265e5a51, 14);
+  MD5LANESTEP(F2, b, c, d, a, 0, 0xe9b6c7aa, 20);
+  MD5LANESTEP(F2, a, b, c, d, 5, 0xd62f105d, 5);
+  MD5LANESTEP(F2, d, a, b, c, 10, 0x02441453, 9);
+  MD5LANESTEP(F2, c, d, a, b, 15, 0xd8a1e681, 14);
+  MD5LANESTEP(F2, b, c, d, a, 4, 0xe7d3fbc8, 20);
+  MD5LANESTEP(F2, a, b, c, d, 9, 0x21e1cde6, 5);
+  MD5LANESTEP(F2, d, a, b, c, 14, 0xc33707d6, 9);
+  MD5LANESTEP(F2, c, d, a, b, 3, 0xf4d50d87, 14);
+  MD5LANESTEP(F2, b, c, d, a, 8, 0x455a14ed, 20);
+  MD5LANESTEP(F2, a, b, c, d, 13, 0xa9e3e905, 5);
+  MD5LANESTEP(F2, d, a, b, c, 2, 0xfcefa3f8, 9);
+  MD5LANESTEP(F2, c, d, a, b, 7, 0x676f02d9, 14);
+  MD5LANESTEP(F2, b, c, d, a, 12, 0x8d2a4c8a, 20);
+
+  MD5LANESTEP(F3, a, b, c, d, 5, 0xfffa3942, 4);
+  MD5LANESTEP(F3, d, a, b, c, 8, 0x8771f681, 11);
+  MD5LANESTEP(F3, c, d, a, b, 11, 0x6d9d6122, 16);
+  MD5LANESTEP(F3, b, c, d, a, 14, 0xfde5380c, 23);
+  MD5LANESTEP(F3, a, b, c, d, 1, 0xa4beea44, 4);
+  MD5LANESTEP(F3, d, a, b, c, 4, 0x4bdecfa9, 11);
+  MD5LANESTEP(F3, c, d, a, b, 7, 0xf6bb4b60, 16);
+  MD5LANESTEP(F3, b, c, d, a, 10, 0xbebfbc70, 23);
+  MD5LANESTEP(F3, a, b, c, d, 13, 0x289b7ec6, 4);
+  MD5LANESTEP(F3, d, a, b, c, 0, 0xeaa127fa, 11);
+  MD5LANESTEP(F3, c, d, a, b, 3, 0xd4ef3085, 16);
+  MD5LANESTEP(F3, b, c, d, a, 6, 0x04881d05, 23);
+  MD5LANESTEP(F3, a, b, c, d, 9, 0xd9d4d039, 4);
+  MD5LANESTEP(F3, d, a, b, c, 12, 0xe6db99e5, 11);
+  MD5LANESTEP(F3, c, d, a, b, 15, 0x1fa27cf8, 16);
+  MD5LANESTEP(F3, b, c, d, a, 2, 0xc4ac5665, 23);
+
+  MD5LANESTEP(F4, a, b, c, d, 0, 0xf4292244, 6);
+  MD5LANESTEP(F4, d, a, b, c, 7, 0x432aff97, 10);
+  MD5LANESTEP(F4, c, d, a, b, 14, 0xab9423a7, 15);
+  MD5LANESTEP(F4, b, c, d, a, 5, 0xfc93a039, 21);
+  MD5LANESTEP(F4, a, b, c, d, 12, 0x655b59c3, 6);
+  MD5LANESTEP(F4, d, a, b, c, 3, 0x8f0ccc92, 10);
+  MD5LANESTEP(F4, c, d, a, b, 10, 0xffeff47d, 15);
+  MD5LANESTEP(F4, b, c, d, a, 1, 0x85845dd1, 21);
+  MD5LANESTEP(F4, a, b, c, d, 8, 0x6fa87e4f, 6);
+  MD5LANESTEP(F4, d, a, b, c, 15, 0xfe2ce6e0, 10);
+  MD5LANESTEP(F4, c, d, a, b, 6, 0xa3014314, 15);
+  MD5LANESTEP(F4, b, c, d, a, 13, 0x4e0811a1, 21);
+  MD5LANESTEP(F4, a, b, c, d, 4, 0xf7537e82, 6);
+  MD5LANESTEP(F4, d, a, b, c, 11, 0xbd3af235, 10);
+  MD5LANESTEP(F4, c, d, a, b, 2, 0x2ad7d2bb, 15);
+  MD5LANESTEP(F4, b, c, d, a, 9, 0xeb86d391, 21);
+
+  for (size_t lane = 0; lane < kLaneCount; ++lane) {
+    (*buf)[0][lane] += a[lane];
+    (*buf)[1][lane] += b[lane];
+    (*buf)[2][lane] += c[lane];
+    (*buf)[3][lane] += d[lane];
+  }
+}
+
+#undef MD5LANESTEP
+
+/*
+ * Appends the MD5 padding for a message of `length` bytes to `tail`, which
+ * holds the bytes of the message after its last whole 64-byte block.
+ */
+void AppendPadding(std::string* tail, uint64_t length) {
+  size_t size = tail->size();
+  tail->resize((size + 8) / 64 * 64 + 64, '\0');
+  (*tail)[size] = static_cast<char>(0x80);
+  uint64_t bits = length << 3;
+  for (size_t i = 0; i < 8; ++i) {
+    (*tail)[tail->size() - 8 + i] = static_cast<char>(bits >> (8 * i));
+  }
+}
+
+uint32_t LoadLittleEndian(const char* bytes) {
+  const auto* b = reinterpret_cast<const uint8_t*>(bytes);
+  return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8 |
+         static_cast<uint32_t>(b[2]) << 16 | static_cast<uint32_t>(b[3]) << 24;
+}
+
+}  // namespace
+
 std::array<uint8_t, 16> CalculateMd5Digest(absl::string_view s) {
   MD5Context ctx;
   MD5Init(&ctx);
@@ -301,6 +428,76 @@ std::array<uint8_t, 16> CalculateMd5Digest(absl::string_view s) {
   return digest;
 }
 
+std::vector<std::array<uint8_t, 16>> CalculateMd5Digests(
+    absl::string_view prefix, const std::vector<std::string>& suffixes) {
+  // The state after the whole blocks of the prefix is shared by all messages.
+  size_t shared_length = prefix.size() - prefix.size() % 64;
+  MD5Context context;
+  MD5Init(&context);
+  MD5Update(&context, prefix.substr(0, shared_length));
+  const Context* shared = reinterpret_cast<const Context*>(&context);
+  absl::string_view prefix_tail = prefix.substr(shared_length);
+
+  // The lanes of a group are transformed until its longest message is done, so
+  // group messages of similar lengths.
+  std::vector<size_t> order(suffixes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return suffixes[lhs].size() < suffixes[rhs].size();
+  });
+
+  std::vector<std::array<uint8_t, 16>> digests(suffixes.size());
+  std::array<std::string, kLaneCount> tails;
+  for (size_t start = 0; start < order.size(); start += kLaneCount) {
+    size_t count = std::min(kLaneCount, order.size() - start);
+    size_t block_count = 0;
+    for (size_t lane = 0; lane < count; ++lane) {
+      const std::string& suffix = suffixes[order[start + lane]];
+      std::string& tail = tails[lane];
+      tail.assign(prefix_tail.data(), prefix_tail.size());
+      tail.append(suffix);
+      AppendPadding(&tail, prefix.size() + suffix.size());
+      block_count = std::max(block_count, tail.size() / 64);
+    }
+
+    std::array<Lanes, 4> buf;
+    for (size_t i = 0; i < 4; ++i) {
+      buf[i].fill(shared->buf[i]);
+    }
+    for (size_t block = 0; block < block_count; ++block) {
+      std::array<Lanes, 16> in{};
+      for (size_t lane = 0; lane < count; ++lane) {
+        if (block * 64 < tails[lane].size()) {
+          const char* data = tails[lane].data() + block * 64;
+          for (size_t word = 0; word < 16; ++word) {
+            in[word][lane] = LoadLittleEndian(data + word * 4);
+          }
+        }
+      }
+
+      std::array<Lanes, 4> before = buf;
+      MD5TransformLanes(&buf, in);
+
+      // Messages that are already done keep their state.
+      for (size_t lane = 0; lane < count; ++lane) {
+        if (block * 64 >= tails[lane].size()) {
+          for (size_t i = 0; i < 4; ++i) {
+            buf[i][lane] = before[i][lane];
+          }
+        }
+      }
+    }
+
+    for (size_t lane = 0; lane < count; ++lane) {
+      std::array<uint8_t, 16>& digest = digests[order[start + lane]];
+      for (size_t i = 0; i < 16; ++i) {
+        digest[i] = static_cast<uint8_t>(buf[i / 4][lane] >> (8 * (i % 4)));
+      }
+    }
+  }
+  return digests;
+}
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
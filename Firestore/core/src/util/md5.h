@@ -19,6 +19,8 @@
 
 #include <array>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 
@@ -31,6 +33,16 @@ namespace util {
  */
 std::array<uint8_t, 16> CalculateMd5Digest(absl::string_view);
 
+/**
+ * Calculates the md5 digests of `prefix` followed by each of the given
+ * suffixes, in order. The result is the same as calling `CalculateMd5Digest`
+ * on every concatenation, but faster: the whole 64-byte blocks of the prefix
+ * are only hashed once, and the messages are then hashed several at a time,
+ * in lanes that the compiler maps onto vector registers.
+ */
+std::vector<std::array<uint8_t, 16>> CalculateMd5Digests(
+    absl::string_view prefix, const std::vector<std::string>& suffixes);
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_MPSC_QUEUE_H_
+#define FIRESTORE_CORE_SRC_UTIL_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/**
+ * A lock-free FIFO queue that any number of threads may push to, and that one
+ * thread at a time pops from.
+ *
+ * Values are kept in intrusive nodes that are linked with a single atomic
+ * exchange on push, so producers never wait for each other or for the
+ * consumer. This is Dmitry Vyukov's intrusive MPSC queue: the consumer keeps a
+ * stub node around so that the queue is never truly empty.
+ *
+ * A push is linked in two steps, so for a moment after a producer has started
+ * pushing, values pushed after it may not be visible yet. `TryPop` returns
+ * false in that case; the value shows up once the producer finishes.
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /** Destroys the values that were never popped. No pushes may be running. */
+  ~MpscQueue() {
+    T value;
+    while (TryPop(&value)) {
+    }
+  }
+
+  /** Adds `value` to the back of the queue. Safe to call from any thread. */
+  void Push(T value) {
+    PushNode(new Node(std::move(value)));
+  }
+
+  /**
+   * Moves the value at the front of the queue into `value` and returns true,
+   * or returns false if no value is ready. Must not be called concurrently
+   * with itself.
+   */
+  bool TryPop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) return false;
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next == nullptr) {
+      // `tail` is the last node. To take it, put the stub behind it, unless a
+      // push is in progress, in which case the next node isn't linked yet.
+      if (tail != head_.load(std::memory_order_acquire)) return false;
+      PushNode(&stub_);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next == nullptr) return false;
+    }
+
+    tail_ = next;
+    *value = std::move(tail->value);
+    delete tail;
+    return true;
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T&& value) : value(std::move(value)) {
+    }
+
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  void PushNode(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  // The most recently pushed node, shared by the producers.
+  std::atomic<Node*> head_;
+
+  // The node at the front of the queue, only used by the consumer.
+  Node* tail_ = nullptr;
+
+  Node stub_;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_MPSC_QUEUE_H_
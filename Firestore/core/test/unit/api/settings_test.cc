@@ -33,6 +33,14 @@ TEST(Settings, CopyConstructor) {
     settings.set_ssl_enabled(true);
     settings.set_persistence_enabled(true);
     settings.set_cache_size_bytes(100);
+    settings.set_parallel_view_computation_enabled(true);
+    settings.set_max_coalesced_write_bytes(64 * 1024);
+    settings.set_message_compression(Settings::MessageCompression::kGzip);
+    settings.set_message_compression_threshold_bytes(512);
+    settings.set_decoded_document_cache_size_bytes(4 * 1024 * 1024);
+    settings.set_concurrent_cache_reads_enabled(true);
+    settings.set_staged_startup_enabled(true);
+    settings.set_sharded_execution_enabled(true);
 
     Settings copy(settings);
 
@@ -41,6 +49,14 @@ TEST(Settings, CopyConstructor) {
     EXPECT_EQ(settings.persistence_enabled(), copy.persistence_enabled());
     EXPECT_EQ(settings.cache_size_bytes(), copy.cache_size_bytes());
     EXPECT_EQ(settings.local_cache_settings(), copy.local_cache_settings());
+    EXPECT_TRUE(copy.parallel_view_computation_enabled());
+    EXPECT_EQ(copy.max_coalesced_write_bytes(), 64 * 1024);
+    EXPECT_EQ(copy.message_compression(), Settings::MessageCompression::kGzip);
+    EXPECT_EQ(copy.message_compression_threshold_bytes(), 512);
+    EXPECT_EQ(copy.decoded_document_cache_size_bytes(), 4 * 1024 * 1024);
+    EXPECT_TRUE(copy.concurrent_cache_reads_enabled());
+    EXPECT_TRUE(copy.staged_startup_enabled());
+    EXPECT_TRUE(copy.sharded_execution_enabled());
   }
   {
     Settings settings;
@@ -181,6 +197,71 @@ TEST(Settings, EqualityAndHash) {
     settings2.set_local_cache_settings(
         PersistentCacheSettings{}.WithSizeBytes(2000000));
 
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_parallel_view_computation_enabled(true);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_max_coalesced_write_bytes(64 * 1024);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_message_compression(Settings::MessageCompression::kDeflate);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_message_compression_threshold_bytes(0);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_decoded_document_cache_size_bytes(1024 * 1024);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_concurrent_cache_reads_enabled(true);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_staged_startup_enabled(true);
+
+    EXPECT_NE(settings1, settings2);
+    EXPECT_NE(settings1.Hash(), settings2.Hash());
+  }
+  {
+    Settings settings1;
+    Settings settings2;
+    settings2.set_sharded_execution_enabled(true);
+
     EXPECT_NE(settings1, settings2);
     EXPECT_NE(settings1.Hash(), settings2.Hash());
   }
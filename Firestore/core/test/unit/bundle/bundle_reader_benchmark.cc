@@ -0,0 +1,142 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "Firestore/Protos/cpp/firestore/bundle.pb.h"
+#include "Firestore/Protos/cpp/google/firestore/v1/document.pb.h"
+#include "Firestore/core/src/bundle/bundle_reader.h"
+#include "Firestore/core/src/bundle/bundle_serializer.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/byte_stream_cpp.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/test/unit/testutil/bundle_builder.h"
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "google/protobuf/util/json_util.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+namespace {
+
+using ProtoBundleElement = ::firestore::BundleElement;
+using ProtoDocument = ::google::firestore::v1::Document;
+using ProtoValue = ::google::firestore::v1::Value;
+using model::DatabaseId;
+using util::ByteStreamCpp;
+
+std::string ToJson(const ProtoBundleElement& element) {
+  std::string json;
+  auto status = google::protobuf::util::MessageToJsonString(element, &json);
+  HARD_ASSERT(status.ok());
+  return json;
+}
+
+ProtoBundleElement DocumentElement(int index) {
+  ProtoBundleElement element;
+  ProtoDocument* document = element.mutable_document();
+  document->set_name("projects/p/databases/default/documents/coll/doc-" +
+                     std::to_string(index));
+  document->mutable_update_time()->set_seconds(1000 + index);
+
+  // A mix of the value types that are most expensive to decode from JSON.
+  auto& fields = *document->mutable_fields();
+  for (int i = 0; i < 10; ++i) {
+    std::string suffix = std::to_string(i);
+    fields["int_" + suffix].set_integer_value(index * 1000 + i);
+    fields["double_" + suffix].set_double_value(index + i / 10.0);
+    fields["string_" + suffix].set_string_value(std::string(32, 'a' + i));
+    fields["bytes_" + suffix].set_bytes_value(std::string(32, '\x01' + i));
+    ProtoValue& timestamp = fields["timestamp_" + suffix];
+    timestamp.mutable_timestamp_value()->set_seconds(1600000000 + i);
+    timestamp.mutable_timestamp_value()->set_nanos(123456789);
+  }
+  return element;
+}
+
+ProtoBundleElement MetadataElement(int documents, uint64_t total_bytes) {
+  ProtoBundleElement element;
+  auto* metadata = element.mutable_metadata();
+  metadata->set_id("bundle");
+  metadata->set_version(1);
+  metadata->mutable_create_time()->set_seconds(1000);
+  metadata->set_total_documents(documents);
+  metadata->set_total_bytes(total_bytes);
+  return element;
+}
+
+std::string JsonBundle(int documents) {
+  std::string body;
+  for (int i = 0; i < documents; ++i) {
+    std::string json = ToJson(DocumentElement(i));
+    body.append(std::to_string(json.size()));
+    body.append(json);
+  }
+  std::string metadata = ToJson(MetadataElement(documents, body.size()));
+  return std::to_string(metadata.size()) + metadata + body;
+}
+
+std::string BinaryBundle(int documents) {
+  testutil::BinaryBundleWriter writer;
+  for (int i = 0; i < documents; ++i) {
+    writer.AddElement(DocumentElement(i).SerializeAsString());
+  }
+  return writer.Build(
+      MetadataElement(documents, writer.body_size()).SerializeAsString());
+}
+
+void ReadBundle(benchmark::State& state, const std::string& bundle) {
+  remote::Serializer remote_serializer(DatabaseId("p", "default"));
+  BundleSerializer bundle_serializer(remote_serializer);
+
+  for (auto _ : state) {
+    BundleReader reader(bundle_serializer,
+                        absl::make_unique<ByteStreamCpp>(
+                            absl::make_unique<std::stringstream>(bundle)));
+    int64_t elements = 0;
+    while (reader.GetNextElement() != nullptr) {
+      ++elements;
+    }
+    HARD_ASSERT(reader.reader_status().ok());
+    benchmark::DoNotOptimize(elements);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(bundle.size()));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+  state.counters["bundle_bytes"] = static_cast<double>(bundle.size());
+}
+
+void BM_ReadJsonBundle(benchmark::State& state) {
+  ReadBundle(state, JsonBundle(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_ReadJsonBundle)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_ReadBinaryBundle(benchmark::State& state) {
+  ReadBundle(state, BinaryBundle(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_ReadBinaryBundle)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
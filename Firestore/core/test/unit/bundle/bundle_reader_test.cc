@@ -34,6 +34,7 @@
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/byte_stream_cpp.h"
 #include "Firestore/core/test/unit/nanopb/nanopb_testing.h"
+#include "Firestore/core/test/unit/testutil/bundle_builder.h"
 #include "Firestore/core/test/unit/testutil/status_testing.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "google/protobuf/util/json_util.h"
@@ -83,6 +84,7 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_named_query() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_writer_.AddElement(element.SerializeAsString());
     return json;
   }
 
@@ -92,6 +94,7 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_document_metadata() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_writer_.AddElement(element.SerializeAsString());
     return json;
   }
 
@@ -101,9 +104,15 @@ class BundleReaderTest : public ::testing::Test {
     *element.mutable_document() = data;
     MessageToJsonString(element, &json);
     elements_.push_back(json);
+    binary_writer_.AddElement(element.SerializeAsString());
     return json;
   }
 
+  /** Adds an already serialized element to the binary bundle only. */
+  void AddRawBinaryElement(const std::string& element) {
+    binary_writer_.AddElement(element);
+  }
+
   std::string BuildBundle(const std::string& bundle_id,
                           model::SnapshotVersion create_time,
                           int32_t documents) {
@@ -132,6 +141,24 @@ class BundleReaderTest : public ::testing::Test {
     return std::to_string(metadata_str.size()) + metadata_str + bundle;
   }
 
+  std::string BuildBinaryBundle(const std::string& bundle_id,
+                                model::SnapshotVersion create_time,
+                                int32_t documents) {
+    ProtoBundleMetadata metadata;
+    metadata.set_id(bundle_id);
+    metadata.set_version(1);
+    metadata.set_total_documents(documents);
+    metadata.mutable_create_time()->set_nanos(
+        create_time.timestamp().nanoseconds());
+    metadata.mutable_create_time()->set_seconds(
+        create_time.timestamp().seconds());
+    metadata.set_total_bytes(binary_writer_.body_size());
+    ProtoBundleElement element;
+    *element.mutable_metadata() = metadata;
+
+    return binary_writer_.Build(element.SerializeAsString());
+  }
+
   std::unique_ptr<util::ByteStream> ToByteStream(const std::string& bundle) {
     auto bundle_istream = absl::make_unique<std::stringstream>(bundle);
     return absl::make_unique<ByteStreamCpp>(
@@ -335,6 +362,7 @@ class BundleReaderTest : public ::testing::Test {
 
  private:
   std::vector<std::string> elements_;
+  testutil::BinaryBundleWriter binary_writer_;
 };
 
 TEST_F(BundleReaderTest, ReadsEmptyBundle) {
@@ -578,6 +606,136 @@ TEST_F(BundleReaderTest, FailsWhenBundleIsSomehowCorrupted) {
   }
 }
 
+TEST_F(BundleReaderTest, ReadsEmptyBinaryBundle) {
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 0);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  std::vector<std::unique_ptr<BundleElement>> elements =
+      VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+
+  EXPECT_EQ(reader.format(), BundleReader::Format::Binary);
+  EXPECT_EQ(elements.size(), 0);
+}
+
+TEST_F(BundleReaderTest, ReadsQueryAndDocumentFromBinaryBundle) {
+  AddNamedQuery(LimitQuery());
+  AddNamedQuery(LimitToLastQuery());
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+  AddDocumentMetadata(DeletedDocumentMetadata());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 2);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  std::vector<std::unique_ptr<BundleElement>> elements =
+      VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+
+  EXPECT_EQ(reader.format(), BundleReader::Format::Binary);
+  EXPECT_EQ(elements.size(), 5);
+  {
+    SCOPED_TRACE("LimitQuery");
+    VerifyNamedQueryEncodesToOriginal(
+        *static_cast<NamedQuery*>(elements[0].get()), LimitQuery());
+  }
+  {
+    SCOPED_TRACE("LimitToLastQuery");
+    VerifyNamedQueryEncodesToOriginal(
+        *static_cast<NamedQuery*>(elements[1].get()), LimitToLastQuery());
+  }
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[2].get()),
+      DocumentMetadata1());
+  VerifyDocumentEncodesToOriginal(
+      *static_cast<BundleDocument*>(elements[3].get()), Document1());
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[4].get()),
+      DeletedDocumentMetadata());
+}
+
+TEST_F(BundleReaderTest, ReadsLargeDocumentFromBinaryBundle) {
+  AddDocumentMetadata(DocumentMetadata2());
+  AddDocument(LargeDocument2());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  std::vector<std::unique_ptr<BundleElement>> elements =
+      VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[0].get()),
+      DocumentMetadata2());
+  VerifyDocumentEncodesToOriginal(
+      *static_cast<BundleDocument*>(elements[1].get()), LargeDocument2());
+}
+
+TEST_F(BundleReaderTest, DetectsJsonBundle) {
+  const auto& bundle =
+      BuildBundle("bundle-1", testutil::Version(6000004000), 0);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  EXPECT_EQ(reader.format(), BundleReader::Format::Unknown);
+  VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+  EXPECT_EQ(reader.format(), BundleReader::Format::Json);
+}
+
+TEST_F(BundleReaderTest, FailsWithBadBinaryHeader) {
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 0);
+  std::string bad_header(bundle);
+  bad_header[1] = 'X';
+  BundleReader reader(bundle_serializer, ToByteStream(bad_header));
+
+  EXPECT_EQ(reader.GetBundleMetadata(), BundleMetadata());
+  EXPECT_EQ(reader.GetNextElement(), nullptr);
+  EXPECT_NOT_OK(reader.reader_status());
+}
+
+TEST_F(BundleReaderTest, FailsWhenBinaryBundleIsTruncated) {
+  AddDocumentMetadata(DocumentMetadata1());
+  AddDocument(Document1());
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  BundleReader reader(bundle_serializer,
+                      ToByteStream(bundle.substr(0, bundle.size() - 1)));
+
+  while (reader.GetNextElement() != nullptr) {
+  }
+  EXPECT_NOT_OK(reader.reader_status());
+}
+
+TEST_F(BundleReaderTest, FailsWhenBinaryElementIsCorrupted) {
+  // A document element whose declared length runs past the element's end.
+  AddRawBinaryElement(std::string("\x22\x10\x0a\x03", 4));
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  EXPECT_EQ(reader.GetBundleMetadata().bundle_id(), "bundle-1");
+  EXPECT_EQ(reader.GetNextElement(), nullptr);
+  EXPECT_NOT_OK(reader.reader_status());
+}
+
+TEST_F(BundleReaderTest, FailsWhenBinaryDocumentIsFromAnotherProject) {
+  ProtoDocument document = Document1();
+  document.set_name(
+      "projects/other/databases/default/documents/bundle/docs/colls/doc-1");
+  AddDocument(document);
+
+  const auto& bundle =
+      BuildBinaryBundle("bundle-1", testutil::Version(6000004000), 1);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+
+  EXPECT_EQ(reader.GetBundleMetadata().bundle_id(), "bundle-1");
+  EXPECT_EQ(reader.GetNextElement(), nullptr);
+  EXPECT_NOT_OK(reader.reader_status());
+}
+
 }  //  namespace
 }  //  namespace bundle
 }  //  namespace firestore
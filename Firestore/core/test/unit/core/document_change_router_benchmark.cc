@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/core/document_change_router.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/core/view.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "Firestore/core/test/unit/testutil/view_testing.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using model::Document;
+using model::DocumentKeySet;
+using model::DocumentMap;
+
+using testutil::Doc;
+using testutil::Map;
+
+// Each listener watches its own collection; events touch documents spread
+// evenly across all of the watched collections.
+std::string CollectionPath(int index) {
+  return "rooms/room-" + std::to_string(index) + "/messages";
+}
+
+std::vector<View> MakeViews(int listeners) {
+  std::vector<View> views;
+  views.reserve(listeners);
+  for (int i = 0; i < listeners; ++i) {
+    views.emplace_back(
+        QueryOrPipeline(testutil::Query(CollectionPath(i)).AddingFilter(
+            testutil::Filter("sort", ">", 0))),
+        DocumentKeySet{});
+  }
+  return views;
+}
+
+DocumentMap MakeEvent(int listeners, int event_size) {
+  std::vector<Document> docs;
+  docs.reserve(event_size);
+  for (int i = 0; i < event_size; ++i) {
+    docs.push_back(Doc(CollectionPath(i % listeners) + "/doc-" +
+                           std::to_string(i),
+                       1, Map("sort", i + 1, "text", "message")));
+  }
+  return testutil::DocUpdates(docs);
+}
+
+void BM_FanOutToAllViews(benchmark::State& state) {
+  int listeners = static_cast<int>(state.range(0));
+  int event_size = static_cast<int>(state.range(1));
+  std::vector<View> views = MakeViews(listeners);
+  DocumentMap changes = MakeEvent(listeners, event_size);
+
+  for (auto _ : state) {
+    for (const View& view : views) {
+      benchmark::DoNotOptimize(view.ComputeDocumentChanges(changes));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * event_size);
+}
+
+void BM_FanOutWithRouter(benchmark::State& state) {
+  int listeners = static_cast<int>(state.range(0));
+  int event_size = static_cast<int>(state.range(1));
+  std::vector<View> views = MakeViews(listeners);
+  std::vector<QueryOrPipeline> queries;
+  for (int i = 0; i < listeners; ++i) {
+    queries.emplace_back(testutil::Query(CollectionPath(i)));
+  }
+  DocumentMap changes = MakeEvent(listeners, event_size);
+
+  for (auto _ : state) {
+    DocumentChangeRouter router(changes);
+    for (int i = 0; i < listeners; ++i) {
+      benchmark::DoNotOptimize(
+          views[i].ComputeDocumentChanges(router.ChangesFor(queries[i])));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * event_size);
+}
+
+void FanOutArguments(benchmark::internal::Benchmark* b) {
+  for (int listeners : {1, 30, 300}) {
+    for (int event_size : {1, 100, 1000}) {
+      b->Args({listeners, event_size});
+    }
+  }
+}
+
+BENCHMARK(BM_FanOutToAllViews)->Apply(FanOutArguments);
+BENCHMARK(BM_FanOutWithRouter)->Apply(FanOutArguments);
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
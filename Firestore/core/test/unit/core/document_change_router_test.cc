@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/document_change_router.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "Firestore/core/test/unit/testutil/view_testing.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using model::DocumentKey;
+using model::DocumentMap;
+
+using testing::ElementsAre;
+using testutil::Doc;
+using testutil::DocUpdates;
+using testutil::Key;
+using testutil::Map;
+
+api::RealtimePipeline PipelineFrom(
+    std::shared_ptr<api::EvaluableStage> source) {
+  std::vector<std::shared_ptr<api::EvaluableStage>> stages;
+  stages.push_back(std::move(source));
+  return api::RealtimePipeline(std::move(stages), TestSerializer());
+}
+
+std::vector<DocumentKey> Keys(const DocumentMap& changes) {
+  std::vector<DocumentKey> result;
+  for (const auto& kv : changes) {
+    result.push_back(kv.first);
+  }
+  return result;
+}
+
+DocumentMap TestChanges() {
+  return DocUpdates({Doc("rooms/eros/messages/1", 0, Map("text", "a")),
+                     Doc("rooms/eros/messages/2", 0, Map("text", "b")),
+                     Doc("rooms/other/messages/1", 0, Map("text", "c")),
+                     Doc("rooms/eros", 0, Map("name", "eros")),
+                     Doc("users/alice", 0, Map("name", "alice"))});
+}
+
+TEST(DocumentChangeRouterTest, RoutesCollectionQueries) {
+  DocumentMap changes = TestChanges();
+  DocumentChangeRouter router(changes);
+
+  EXPECT_THAT(Keys(router.ChangesFor(
+                  QueryOrPipeline(testutil::Query("rooms/eros/messages")))),
+              ElementsAre(Key("rooms/eros/messages/1"),
+                          Key("rooms/eros/messages/2")));
+  EXPECT_THAT(Keys(router.ChangesFor(QueryOrPipeline(testutil::Query("rooms")))),
+              ElementsAre(Key("rooms/eros")));
+  EXPECT_TRUE(
+      router.ChangesFor(QueryOrPipeline(testutil::Query("rooms/none/messages")))
+          .empty());
+}
+
+TEST(DocumentChangeRouterTest, RoutesDocumentQueries) {
+  DocumentMap changes = TestChanges();
+  DocumentChangeRouter router(changes);
+
+  // Document queries are routed to the document's parent collection.
+  EXPECT_THAT(
+      Keys(router.ChangesFor(QueryOrPipeline(testutil::Query("users/alice")))),
+      ElementsAre(Key("users/alice")));
+}
+
+TEST(DocumentChangeRouterTest, RoutesCollectionGroupQueries) {
+  DocumentMap changes = TestChanges();
+  DocumentChangeRouter router(changes);
+
+  EXPECT_THAT(Keys(router.ChangesFor(
+                  QueryOrPipeline(testutil::CollectionGroupQuery("messages")))),
+              ElementsAre(Key("rooms/eros/messages/1"),
+                          Key("rooms/eros/messages/2"),
+                          Key("rooms/other/messages/1")));
+  EXPECT_TRUE(router
+                  .ChangesFor(QueryOrPipeline(
+                      testutil::CollectionGroupQuery("comments")))
+                  .empty());
+}
+
+TEST(DocumentChangeRouterTest, RoutesPipelines) {
+  DocumentMap changes = TestChanges();
+  DocumentChangeRouter router(changes);
+
+  EXPECT_THAT(Keys(router.ChangesFor(QueryOrPipeline(PipelineFrom(
+                  std::make_shared<api::CollectionSource>("/users"))))),
+              ElementsAre(Key("users/alice")));
+  EXPECT_THAT(
+      Keys(router.ChangesFor(QueryOrPipeline(PipelineFrom(
+          std::make_shared<api::CollectionGroupSource>("messages"))))),
+      ElementsAre(Key("rooms/eros/messages/1"), Key("rooms/eros/messages/2"),
+                  Key("rooms/other/messages/1")));
+
+  // Database-wide pipelines can match any document.
+  EXPECT_EQ(router
+                .ChangesFor(QueryOrPipeline(
+                    PipelineFrom(std::make_shared<api::DatabaseSource>())))
+                .size(),
+            changes.size());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
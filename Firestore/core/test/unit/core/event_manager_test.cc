@@ -16,18 +16,29 @@
 
 #include "Firestore/core/src/core/event_manager.h"
 
+#include <future>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_util.h"
 #include "Firestore/core/src/core/query_listener.h"
 #include "Firestore/core/src/core/sync_engine.h"
 #include "Firestore/core/src/core/view_snapshot.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/empty.h"
+#include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -43,6 +54,8 @@ using testing::_;
 using testing::ElementsAre;
 using testing::StrictMock;
 using testutil::Query;
+using util::AsyncQueue;
+using util::Empty;
 using util::StatusOr;
 using util::StatusOrCallback;
 
@@ -127,6 +140,33 @@ TEST(EventManagerTest, HandlesUnlistenOnUnknownListenerGracefully) {
   event_manager.RemoveQueryListener(listener);
 }
 
+TEST(EventManagerTest, RejectsPipelinesThatCannotBeListenedTo) {
+  std::vector<std::shared_ptr<api::EvaluableStage>> stages;
+  stages.push_back(std::make_shared<api::CollectionSource>("foo"));
+  stages.push_back(std::make_shared<api::OffsetStage>(1));
+  auto query = QueryOrPipeline(
+      api::RealtimePipeline(std::move(stages), TestSerializer()));
+
+  absl::optional<util::Status> error;
+  auto listener = QueryListener::Create(
+      query, ListenOptions::DefaultOptions(),
+      EventListener<ViewSnapshot>::Create(
+          [&error](const StatusOr<ViewSnapshot>& maybe_snapshot) {
+            error = maybe_snapshot.status();
+          }));
+
+  StrictMock<MockEventSource> mock_event_source;
+  EXPECT_CALL(mock_event_source, SetCallback(_));
+  EventManager event_manager(&mock_event_source);
+
+  // Expecting no activity from mock_event_source.
+  event_manager.AddQueryListener(listener);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(error->code(), Error::kErrorInvalidArgument);
+
+  event_manager.RemoveQueryListener(listener);
+}
+
 ViewSnapshot make_empty_view_snapshot(const core::QueryOrPipeline& query) {
   DocumentSet empty_docs{query.Comparator()};
   // sync_state_changed has to be `true` to prevent an assertion about a
@@ -175,6 +215,88 @@ TEST(EventManagerTest, NotifiesListenersInTheRightOrder) {
   ASSERT_THAT(event_order, ElementsAre("listener1", "listener3", "listener2"));
 }
 
+TEST(EventManagerTest, NotifiesListenersOnTheEventQueueInTheRightOrder) {
+  auto query1 = QueryOrPipeline(Query("foo/bar"));
+  auto query2 = QueryOrPipeline(Query("bar/baz"));
+  // Only changed on the event queue.
+  std::vector<std::string> event_order;
+
+  auto listener1 = QueryListener::Create(query1, [&](StatusOr<ViewSnapshot>) {
+    event_order.push_back("listener1");
+  });
+  auto listener2 = QueryListener::Create(query2, [&](StatusOr<ViewSnapshot>) {
+    event_order.push_back("listener2");
+  });
+  auto listener3 = QueryListener::Create(query1, [&](StatusOr<ViewSnapshot>) {
+    event_order.push_back("listener3");
+  });
+  std::shared_ptr<EventListener<Empty>> in_sync_listener =
+      EventListener<Empty>::Create(
+          [&](StatusOr<Empty>) { event_order.push_back("in sync"); });
+
+  MockEventSource mock_event_source;
+  EventManager event_manager(&mock_event_source);
+  std::shared_ptr<AsyncQueue> event_queue = testutil::AsyncQueueForTesting();
+  event_manager.NotifyListenersOn(event_queue);
+
+  // Hold up the event queue so that no listener can be called yet.
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  event_queue->Enqueue([unblocked] { unblocked.wait(); });
+
+  EXPECT_CALL(mock_event_source, Listen(query1, true));
+  event_manager.AddQueryListener(listener1);
+  EXPECT_CALL(mock_event_source, Listen(query2, true));
+  event_manager.AddQueryListener(listener2);
+  event_manager.AddQueryListener(listener3);
+  event_manager.AddSnapshotsInSyncListener(in_sync_listener);
+
+  event_manager.OnViewSnapshots({make_empty_view_snapshot(query1),
+                                 make_empty_view_snapshot(query2)});
+
+  EXPECT_TRUE(event_order.empty());
+
+  unblock.set_value();
+  event_queue->EnqueueBlocking([] {});
+
+  ASSERT_THAT(event_order, ElementsAre("in sync", "listener1", "listener3",
+                                       "listener2", "in sync"));
+}
+
+TEST(EventManagerTest, RunsCallbacksAfterTheEventsRaisedBeforeThem) {
+  auto query = QueryOrPipeline(Query("foo/bar"));
+  // Only changed on the event queue.
+  std::vector<std::string> event_order;
+
+  auto listener = QueryListener::Create(query, [&](StatusOr<ViewSnapshot>) {
+    event_order.push_back("listener");
+  });
+
+  MockEventSource mock_event_source;
+  EventManager event_manager(&mock_event_source);
+  std::shared_ptr<AsyncQueue> event_queue = testutil::AsyncQueueForTesting();
+  event_manager.NotifyListenersOn(event_queue);
+
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  event_queue->Enqueue([unblocked] { unblocked.wait(); });
+
+  EXPECT_CALL(mock_event_source, Listen(query, true));
+  event_manager.AddQueryListener(listener);
+
+  // A write raises its latency-compensated snapshot before it is
+  // acknowledged; the acknowledgement must not overtake the snapshot.
+  event_manager.OnViewSnapshots({make_empty_view_snapshot(query)});
+  event_manager.RunAfterEvents([&] { event_order.push_back("write"); });
+
+  EXPECT_TRUE(event_order.empty());
+
+  unblock.set_value();
+  event_queue->EnqueueBlocking([] {});
+
+  ASSERT_THAT(event_order, ElementsAre("listener", "write"));
+}
+
 TEST(EventManagerTest, WillForwardOnlineStateChanges) {
   core::Query query = Query("foo/bar");
 
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Firestore/core/src/api/expressions.h"
@@ -38,10 +39,12 @@ namespace firebase {
 namespace firestore {
 namespace core {
 
+using api::AddFields;
 using api::AggregateStage;
 using api::CollectionGroupSource;
 using api::CollectionSource;
 using api::DatabaseSource;
+using api::DistinctStage;
 using api::DocumentsSource;
 using api::EvaluableStage;
 using api::Expr;
@@ -52,11 +55,11 @@ using api::LimitStage;
 using api::OffsetStage;
 using api::Ordering;
 using api::RealtimePipeline;
+using api::RemoveFieldsStage;
 using api::SelectStage;
 using api::SortStage;
+using api::Unnest;
 using api::Where;
-// using api::AddFields; // Not EvaluableStage
-// using api::DistinctStage; // Not EvaluableStage
 
 using model::DatabaseId;
 using model::DocumentKey;
@@ -142,15 +145,17 @@ TEST_F(CanonifyEqPipelineTest, CanonifyMultipleStages) {
       ")asc)|limit(10)|sort(fld(bar)desc,fld(__name__)asc)");
 }
 
-// TEST_F(CanonifyEqPipelineTest, CanonifyAddFields) {
-//   // Requires constructing pipeline with AddFields stage
-//   // RealtimePipeline p = StartPipeline("test");
-//   // p = p.AddingStage(std::make_shared<api::AddFields>(...)); // AddFields
-//   not Evaluable
-//   // EXPECT_EQ(GetPipelineCanonicalId(p),
-//   //
-//   "collection(/test)|add_fields(__create_time__=fld(__create_time__),__name__=fld(__name__),__update_time__=fld(__update_time__),existingField=fld(existingField),val=cst(10))|sort(fld(__name__)ascending)");
-// }
+TEST_F(CanonifyEqPipelineTest, CanonifyAddFields) {
+  RealtimePipeline p = StartPipeline("test");
+  p = p.AddingStage(std::make_shared<AddFields>(
+      std::unordered_map<std::string, std::shared_ptr<Expr>>{
+          {"val", SharedConstant(Value(10LL))},
+          {"existingField", std::make_shared<Field>("existingField")}}));
+
+  EXPECT_EQ(GetPipelineCanonicalId(p),
+            "collection(test)|add_fields(existingField=fld(existingField),val="
+            "cst(10))|sort(fld(__name__)asc)");
+}
 
 // TEST_F(CanonifyEqPipelineTest, CanonifyAggregateWithGrouping) {
 //   // Requires constructing pipeline with AggregateStage stage
@@ -169,32 +174,50 @@ TEST_F(CanonifyEqPipelineTest, CanonifyMultipleStages) {
 //   "collection(/test)|aggregate(totalValue=fn(sum,[fld(value)]))grouping(category=fld(category))|sort(fld(__name__)ascending)");
 // }
 
-// TEST_F(CanonifyEqPipelineTest, CanonifyDistinct) {
-//   // Requires constructing pipeline with DistinctStage stage
-//   // RealtimePipeline p = StartPipeline("test");
-//   // p = p.AddingStage(std::make_shared<api::DistinctStage>(...)); //
-//   DistinctStage not Evaluable
-//   // EXPECT_EQ(GetPipelineCanonicalId(p),
-//   //
-//   "collection(/test)|distinct(category=fld(category),city=fld(city))|sort(fld(__name__)ascending)");
-// }
+TEST_F(CanonifyEqPipelineTest, CanonifyDistinct) {
+  RealtimePipeline p = StartPipeline("test");
+  p = p.AddingStage(std::make_shared<DistinctStage>(
+      std::unordered_map<std::string, std::shared_ptr<Expr>>{
+          {"city", std::make_shared<Field>("city")},
+          {"category", std::make_shared<Field>("category")}}));
 
-// TEST_F(CanonifyEqPipelineTest, CanonifySelect) {
-//   // Requires constructing pipeline with SelectStage stage
-//   // RealtimePipeline p = StartPipeline("test");
-//   // p = p.AddingStage(std::make_shared<api::SelectStage>(...)); //
-//   SelectStage not Evaluable
-//   // EXPECT_EQ(GetPipelineCanonicalId(p),
-//   //
-//   "collection(/test)|select(__create_time__=fld(__create_time__),__name__=fld(__name__),__update_time__=fld(__update_time__),age=fld(age),name=fld(name))|sort(fld(__name__)ascending)");
-// }
+  EXPECT_EQ(GetPipelineCanonicalId(p),
+            "collection(test)|distinct(category=fld(category),city=fld(city))|"
+            "sort(fld(__name__)asc)");
+}
 
-// TEST_F(CanonifyEqPipelineTest, CanonifyOffset) {
-//   // OffsetStage is not EvaluableStage. Test skipped.
-//   RealtimePipeline p = StartPipeline("test");
-//   EXPECT_EQ(GetPipelineCanonicalId(p),
-//            "collection(/test)|offset(5)|sort(fld(__name__)ascending)");
-// }
+TEST_F(CanonifyEqPipelineTest, CanonifySelect) {
+  RealtimePipeline p = StartPipeline("test");
+  p = p.AddingStage(std::make_shared<SelectStage>(
+      std::unordered_map<std::string, std::shared_ptr<Expr>>{
+          {"name", std::make_shared<Field>("name")},
+          {"age", std::make_shared<Field>("age")}}));
+
+  EXPECT_EQ(GetPipelineCanonicalId(p),
+            "collection(test)|select(age=fld(age),name=fld(name))|sort(fld(__"
+            "name__)asc)");
+}
+
+TEST_F(CanonifyEqPipelineTest, CanonifyOffset) {
+  RealtimePipeline p = StartPipeline("test");
+  p = p.AddingStage(std::make_shared<OffsetStage>(5));
+
+  EXPECT_EQ(GetPipelineCanonicalId(p),
+            "collection(test)|sort(fld(__name__)asc)|offset(5)");
+}
+
+TEST_F(CanonifyEqPipelineTest, CanonifyRemoveFieldsAndUnnest) {
+  RealtimePipeline p = StartPipeline("test");
+  p = p.AddingStage(std::make_shared<RemoveFieldsStage>(
+      std::vector<Field>{Field("a"), Field("b.c")}));
+  p = p.AddingStage(std::make_shared<Unnest>(std::make_shared<Field>("tags"),
+                                             std::make_shared<Field>("tag"),
+                                             std::make_shared<Field>("index")));
+
+  EXPECT_EQ(GetPipelineCanonicalId(p),
+            "collection(test)|remove_fields(fld(a),fld(b.c))|unnest(fld(tags),"
+            "fld(tag),fld(index))|sort(fld(__name__)asc)");
+}
 
 // TEST_F(CanonifyEqPipelineTest, CanonifyFindNearest) {
 //    // FindNearestStage is not EvaluableStage. Test skipped.
@@ -297,22 +320,27 @@ TEST_F(CanonifyEqPipelineTest, EqReturnsFalseForDifferentStageOrder) {
   EXPECT_FALSE(v1 == v2);  // Expect FALSE based on TS
 }
 
-// TEST_F(CanonifyEqPipelineTest, EqReturnsTrueForDifferentSelectOrder) {
-//   // Requires constructing pipeline with SelectStage stage
-//   // RealtimePipeline p1 = StartPipeline("test");
-//   // p1 = p1.AddingStage(std::make_shared<Where>(...));
-//   // p1 = p1.AddingStage(std::make_shared<SelectStage>(...)); // SelectStage
-//   not Evaluable
-//
-//   // RealtimePipeline p2 = StartPipeline("test");
-//   // p2 = p2.AddingStage(std::make_shared<Where>(...));
-//   // p2 = p2.AddingStage(std::make_shared<SelectStage>(...)); // SelectStage
-//   not Evaluable
-//
-//   // QueryOrPipeline v1 = p1;
-//   // QueryOrPipeline v2 = p2;
-//   // EXPECT_TRUE(v1 == v2); // Expect TRUE based on TS
-// }
+TEST_F(CanonifyEqPipelineTest, EqReturnsTrueForDifferentSelectOrder) {
+  RealtimePipeline p1 = StartPipeline("test");
+  p1 = p1.AddingStage(std::make_shared<Where>(EqExpr(
+      {std::make_shared<api::Field>("foo"), SharedConstant(Value(42LL))})));
+  p1 = p1.AddingStage(std::make_shared<SelectStage>(
+      std::unordered_map<std::string, std::shared_ptr<Expr>>{
+          {"name", std::make_shared<Field>("name")},
+          {"age", std::make_shared<Field>("age")}}));
+
+  RealtimePipeline p2 = StartPipeline("test");
+  p2 = p2.AddingStage(std::make_shared<Where>(EqExpr(
+      {std::make_shared<api::Field>("foo"), SharedConstant(Value(42LL))})));
+  p2 = p2.AddingStage(std::make_shared<SelectStage>(
+      std::unordered_map<std::string, std::shared_ptr<Expr>>{
+          {"age", std::make_shared<Field>("age")},
+          {"name", std::make_shared<Field>("name")}}));
+
+  QueryOrPipeline v1 = QueryOrPipeline(p1);
+  QueryOrPipeline v2 = QueryOrPipeline(p2);
+  EXPECT_TRUE(v1 == v2);  // Expect TRUE based on TS
+}
 
 }  // namespace core
 }  // namespace firestore
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Firestore/core/src/api/expressions.h"
+#include "Firestore/core/src/api/firestore.h"
+#include "Firestore/core/src/api/ordering.h"
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_run.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"  // Shared utils
+#include "Firestore/core/test/unit/testutil/expression_test_util.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using api::CollectionSource;
+using api::DistinctStage;
+using api::EvaluableStage;
+using api::Expr;
+using api::Field;
+using api::Ordering;
+using api::RealtimePipeline;
+using api::SortStage;
+using model::PipelineInputOutputVector;
+using testing::IsEmpty;
+using testutil::Doc;
+using testutil::Map;
+using testutil::WrapObject;
+
+using Exprs = std::unordered_map<std::string, std::shared_ptr<Expr>>;
+
+// Test Fixture for Distinct Pipeline tests
+class DistinctPipelineTest : public ::testing::Test {
+ public:
+  // Helper to create a pipeline starting with a collection stage
+  RealtimePipeline StartPipeline(const std::string& collection_path) {
+    std::vector<std::shared_ptr<EvaluableStage>> stages;
+    stages.push_back(std::make_shared<CollectionSource>(collection_path));
+    return RealtimePipeline(std::move(stages), TestSerializer());
+  }
+};
+
+TEST_F(DistinctPipelineTest, ReturnsOneResultPerGroup) {
+  auto doc1 = Doc("cities/a", 1000, Map("country", "us", "state", "ny"));
+  auto doc2 = Doc("cities/b", 1000, Map("country", "us", "state", "ca"));
+  auto doc3 = Doc("cities/c", 1000, Map("country", "us", "state", "ny"));
+  auto doc4 = Doc("cities/d", 1000, Map("country", "fr", "state", "idf"));
+
+  RealtimePipeline pipeline = StartPipeline("/cities");
+  pipeline = pipeline.AddingStage(std::make_shared<DistinctStage>(
+      Exprs{{"country", std::make_shared<Field>("country")},
+            {"state", std::make_shared<Field>("state")}}));
+
+  // Each result takes the key of the first document in its group.
+  PipelineInputOutputVector results =
+      RunPipeline(pipeline, {doc1, doc2, doc3, doc4});
+  EXPECT_THAT(results,
+              ReturnsDocs(PipelineInputOutputVector{doc1, doc2, doc4}));
+  EXPECT_EQ(results[0].data(), WrapObject("country", "us", "state", "ny"));
+  EXPECT_EQ(results[1].data(), WrapObject("country", "us", "state", "ca"));
+  EXPECT_EQ(results[2].data(), WrapObject("country", "fr", "state", "idf"));
+}
+
+TEST_F(DistinctPipelineTest, GroupsEqualNumbersTogether) {
+  auto doc1 = Doc("scores/a", 1000, Map("score", 1LL));
+  auto doc2 = Doc("scores/b", 1000, Map("score", 1.0));
+  auto doc3 = Doc("scores/c", 1000, Map("score", 2LL));
+
+  RealtimePipeline pipeline = StartPipeline("/scores");
+  pipeline = pipeline.AddingStage(std::make_shared<DistinctStage>(
+      Exprs{{"score", std::make_shared<Field>("score")}}));
+
+  EXPECT_THAT(RunPipeline(pipeline, {doc1, doc2, doc3}),
+              ReturnsDocs(PipelineInputOutputVector{doc1, doc3}));
+}
+
+TEST_F(DistinctPipelineTest, GroupsMissingFieldsAsNull) {
+  auto doc1 = Doc("cities/a", 1000, Map("country", "us"));
+  auto doc2 = Doc("cities/b", 1000, Map("name", "unknown"));
+  auto doc3 = Doc("cities/c", 1000, Map("country", nullptr));
+
+  RealtimePipeline pipeline = StartPipeline("/cities");
+  pipeline = pipeline.AddingStage(std::make_shared<DistinctStage>(
+      Exprs{{"country", std::make_shared<Field>("country")}}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1, doc2, doc3});
+  EXPECT_THAT(results, ReturnsDocs(PipelineInputOutputVector{doc1, doc2}));
+  EXPECT_EQ(results[1].data(), WrapObject("country", nullptr));
+}
+
+TEST_F(DistinctPipelineTest, SortsResultsByLaterSort) {
+  auto doc1 = Doc("cities/a", 1000, Map("country", "us"));
+  auto doc2 = Doc("cities/b", 1000, Map("country", "fr"));
+  auto doc3 = Doc("cities/c", 1000, Map("country", "us"));
+
+  RealtimePipeline pipeline = StartPipeline("/cities");
+  pipeline = pipeline.AddingStage(std::make_shared<DistinctStage>(
+      Exprs{{"country", std::make_shared<Field>("country")}}));
+  pipeline = pipeline.AddingStage(std::make_shared<SortStage>(
+      std::vector<Ordering>{Ordering(std::make_shared<Field>("country"),
+                                     Ordering::Direction::ASCENDING)}));
+
+  EXPECT_THAT(RunPipeline(pipeline, {doc1, doc2, doc3}),
+              ReturnsDocs(PipelineInputOutputVector{doc2, doc1}));
+}
+
+TEST_F(DistinctPipelineTest, EmptyInput) {
+  RealtimePipeline pipeline = StartPipeline("/cities");
+  pipeline = pipeline.AddingStage(std::make_shared<DistinctStage>(
+      Exprs{{"country", std::make_shared<Field>("country")}}));
+
+  EXPECT_THAT(RunPipeline(pipeline, {}), IsEmpty());
+}
+
+TEST_F(DistinctPipelineTest, CannotBeListenedTo) {
+  EXPECT_FALSE(IsListenableStage(DistinctStage(
+      Exprs{{"country", std::make_shared<Field>("country")}})));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/api/expressions.h"
+#include "Firestore/core/src/api/firestore.h"
+#include "Firestore/core/src/api/ordering.h"
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_run.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"  // Shared utils
+#include "Firestore/core/test/unit/testutil/expression_test_util.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using api::CollectionSource;
+using api::EvaluableStage;
+using api::Field;
+using api::LimitStage;
+using api::OffsetStage;
+using api::Ordering;
+using api::RealtimePipeline;
+using api::SortStage;
+using model::Document;
+using model::PipelineInputOutputVector;
+using testing::IsEmpty;
+using testutil::Doc;
+using testutil::Map;
+
+// Test Fixture for Offset Pipeline tests
+class OffsetPipelineTest : public ::testing::Test {
+ public:
+  // Helper to create a pipeline starting with a collection stage
+  RealtimePipeline StartPipeline(const std::string& collection_path) {
+    std::vector<std::shared_ptr<EvaluableStage>> stages;
+    stages.push_back(std::make_shared<CollectionSource>(collection_path));
+    return RealtimePipeline(std::move(stages), TestSerializer());
+  }
+
+  // Common test documents
+  PipelineInputOutputVector CreateDocs() {
+    auto doc1 = Doc("k/a", 1000, Map("a", 4LL));
+    auto doc2 = Doc("k/b", 1000, Map("a", 3LL));
+    auto doc3 = Doc("k/c", 1000, Map("a", 2LL));
+    auto doc4 = Doc("k/d", 1000, Map("a", 1LL));
+    return {doc1, doc2, doc3, doc4};
+  }
+};
+
+TEST_F(OffsetPipelineTest, OffsetZero) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(0));
+
+  EXPECT_THAT(RunPipeline(pipeline, documents), ReturnsDocs(documents));
+}
+
+TEST_F(OffsetPipelineTest, OffsetSkipsByKeyWithoutSort) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(2));
+
+  EXPECT_THAT(RunPipeline(pipeline, {documents[3], documents[1], documents[0],
+                                     documents[2]}),
+              ReturnsDocs(
+                  PipelineInputOutputVector{documents[2], documents[3]}));
+}
+
+TEST_F(OffsetPipelineTest, OffsetAfterSort) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<SortStage>(
+      std::vector<Ordering>{Ordering(std::make_shared<Field>("a"),
+                                     Ordering::Direction::ASCENDING)}));
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(1));
+
+  EXPECT_THAT(RunPipeline(pipeline, documents),
+              ReturnsDocs(PipelineInputOutputVector{documents[2], documents[1],
+                                                    documents[0]}));
+}
+
+TEST_F(OffsetPipelineTest, OffsetThenLimit) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(1));
+  pipeline = pipeline.AddingStage(std::make_shared<LimitStage>(2));
+
+  EXPECT_THAT(RunPipeline(pipeline, documents),
+              ReturnsDocs(
+                  PipelineInputOutputVector{documents[1], documents[2]}));
+}
+
+TEST_F(OffsetPipelineTest, OffsetPastEnd) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(4));
+
+  EXPECT_THAT(RunPipeline(pipeline, documents), IsEmpty());
+}
+
+TEST_F(OffsetPipelineTest, DocumentsMatchRegardlessOfOffset) {
+  PipelineInputOutputVector documents = CreateDocs();
+  RealtimePipeline pipeline = StartPipeline("/k");
+  pipeline = pipeline.AddingStage(std::make_shared<OffsetStage>(2));
+
+  EXPECT_TRUE(QueryOrPipeline(pipeline).Matches(Document(documents[0])));
+}
+
+TEST_F(OffsetPipelineTest, CannotBeListenedTo) {
+  EXPECT_FALSE(IsListenableStage(OffsetStage(1)));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Firestore/core/src/api/expressions.h"
+#include "Firestore/core/src/api/firestore.h"
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_run.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"  // Shared utils
+#include "Firestore/core/test/unit/testutil/expression_test_util.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using api::AddFields;
+using api::CollectionSource;
+using api::EvaluableStage;
+using api::Expr;
+using api::Field;
+using api::RealtimePipeline;
+using api::RemoveFieldsStage;
+using api::SelectStage;
+using api::Where;
+using model::PipelineInputOutputVector;
+using testing::IsEmpty;
+using testutil::AddExpr;
+using testutil::Doc;
+using testutil::GtExpr;
+using testutil::Map;
+using testutil::SharedConstant;
+using testutil::Value;
+using testutil::WrapObject;
+
+using Exprs = std::unordered_map<std::string, std::shared_ptr<Expr>>;
+
+// Test Fixture for Select, AddFields and RemoveFields Pipeline tests
+class ProjectionPipelineTest : public ::testing::Test {
+ public:
+  // Helper to create a pipeline starting with a collection stage
+  RealtimePipeline StartPipeline(const std::string& collection_path) {
+    std::vector<std::shared_ptr<EvaluableStage>> stages;
+    stages.push_back(std::make_shared<CollectionSource>(collection_path));
+    return RealtimePipeline(std::move(stages), TestSerializer());
+  }
+};
+
+TEST_F(ProjectionPipelineTest, SelectKeepsOnlySelectedFields) {
+  auto doc1 = Doc("users/a", 1000,
+                  Map("name", "alice", "age", 30LL, "address",
+                      Map("city", "nyc", "zip", "10001")));
+  auto doc2 = Doc("users/b", 1000, Map("name", "bob"));
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<SelectStage>(
+      Exprs{{"name", std::make_shared<Field>("name")},
+            {"age", std::make_shared<Field>("age")}}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1, doc2});
+  EXPECT_THAT(results, ReturnsDocs(PipelineInputOutputVector{doc1, doc2}));
+  EXPECT_EQ(results[0].data(), WrapObject("name", "alice", "age", 30LL));
+  // Fields that are missing from the document are left out.
+  EXPECT_EQ(results[1].data(), WrapObject("name", "bob"));
+  // The inputs are left as they were.
+  EXPECT_EQ(doc1.data(), WrapObject("name", "alice", "age", 30LL, "address",
+                                    Map("city", "nyc", "zip", "10001")));
+}
+
+TEST_F(ProjectionPipelineTest, SelectEvaluatesExpressionsAndNestedFields) {
+  auto doc1 = Doc("users/a", 1000,
+                  Map("age", 30LL, "address", Map("city", "nyc", "zip", "1")));
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<SelectStage>(
+      Exprs{{"next_age", AddExpr({std::make_shared<Field>("age"),
+                                  SharedConstant(Value(1LL))})},
+            {"city", std::make_shared<Field>("address.city")}}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1});
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].data(), WrapObject("next_age", 31LL, "city", "nyc"));
+}
+
+TEST_F(ProjectionPipelineTest, WhereAfterSelectSeesSelectedFields) {
+  auto doc1 = Doc("users/a", 1000, Map("score", 10LL));
+  auto doc2 = Doc("users/b", 1000, Map("score", 1LL));
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<SelectStage>(
+      Exprs{{"points", std::make_shared<Field>("score")}}));
+  pipeline = pipeline.AddingStage(std::make_shared<Where>(
+      GtExpr({std::make_shared<Field>("points"), SharedConstant(Value(5LL))})));
+
+  EXPECT_THAT(RunPipeline(pipeline, {doc1, doc2}),
+              ReturnsDocs(PipelineInputOutputVector{doc1}));
+
+  pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<SelectStage>(
+      Exprs{{"points", std::make_shared<Field>("score")}}));
+  pipeline = pipeline.AddingStage(std::make_shared<Where>(
+      GtExpr({std::make_shared<Field>("score"), SharedConstant(Value(5LL))})));
+
+  EXPECT_THAT(RunPipeline(pipeline, {doc1, doc2}), IsEmpty());
+}
+
+TEST_F(ProjectionPipelineTest, AddFieldsKeepsExistingFields) {
+  auto doc1 = Doc("users/a", 1000, Map("name", "alice", "age", 30LL));
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<AddFields>(
+      Exprs{{"age", AddExpr({std::make_shared<Field>("age"),
+                             SharedConstant(Value(1LL))})},
+            {"verified", SharedConstant(true)}}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1});
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].key(), doc1.key());
+  EXPECT_EQ(results[0].data(),
+            WrapObject("name", "alice", "age", 31LL, "verified", true));
+  EXPECT_EQ(doc1.data(), WrapObject("name", "alice", "age", 30LL));
+}
+
+TEST_F(ProjectionPipelineTest, RemoveFieldsRemovesTopLevelAndNestedFields) {
+  auto doc1 = Doc("users/a", 1000,
+                  Map("name", "alice", "age", 30LL, "address",
+                      Map("city", "nyc", "zip", "10001")));
+  auto doc2 = Doc("users/b", 1000, Map("name", "bob"));
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<RemoveFieldsStage>(
+      std::vector<Field>{Field("age"), Field("address.zip")}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1, doc2});
+  EXPECT_THAT(results, ReturnsDocs(PipelineInputOutputVector{doc1, doc2}));
+  EXPECT_EQ(results[0].data(),
+            WrapObject("name", "alice", "address", Map("city", "nyc")));
+  EXPECT_EQ(results[1].data(), WrapObject("name", "bob"));
+}
+
+TEST_F(ProjectionPipelineTest, ProjectionsKeepMutationState) {
+  auto doc1 = Doc("users/a", 1000, Map("name", "alice", "age", 30LL))
+                  .SetHasLocalMutations();
+
+  RealtimePipeline pipeline = StartPipeline("/users");
+  pipeline = pipeline.AddingStage(std::make_shared<SelectStage>(
+      Exprs{{"name", std::make_shared<Field>("name")}}));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1});
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_TRUE(results[0].has_local_mutations());
+}
+
+TEST_F(ProjectionPipelineTest, ProjectionsCannotBeListenedTo) {
+  Exprs fields{{"name", std::make_shared<Field>("name")}};
+  EXPECT_FALSE(IsListenableStage(SelectStage(fields)));
+  EXPECT_FALSE(IsListenableStage(AddFields(fields)));
+  EXPECT_FALSE(IsListenableStage(RemoveFieldsStage({Field("name")})));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/api/expressions.h"
+#include "Firestore/core/src/api/firestore.h"
+#include "Firestore/core/src/api/realtime_pipeline.h"
+#include "Firestore/core/src/api/stages.h"
+#include "Firestore/core/src/core/pipeline_run.h"
+#include "Firestore/core/src/core/pipeline_util.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/test/unit/core/pipeline/utils.h"  // Shared utils
+#include "Firestore/core/test/unit/testutil/expression_test_util.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using api::CollectionSource;
+using api::EvaluableStage;
+using api::Field;
+using api::RealtimePipeline;
+using api::Unnest;
+using api::Where;
+using model::PipelineInputOutputVector;
+using testing::IsEmpty;
+using testutil::Array;
+using testutil::Doc;
+using testutil::EqExpr;
+using testutil::Map;
+using testutil::SharedConstant;
+using testutil::Value;
+using testutil::WrapObject;
+
+// Test Fixture for Unnest Pipeline tests
+class UnnestPipelineTest : public ::testing::Test {
+ public:
+  // Helper to create a pipeline starting with a collection stage
+  RealtimePipeline StartPipeline(const std::string& collection_path) {
+    std::vector<std::shared_ptr<EvaluableStage>> stages;
+    stages.push_back(std::make_shared<CollectionSource>(collection_path));
+    return RealtimePipeline(std::move(stages), TestSerializer());
+  }
+};
+
+TEST_F(UnnestPipelineTest, ReturnsOneResultPerElement) {
+  auto doc1 = Doc("books/a", 1000,
+                  Map("title", "a", "tags", Array(Value("x"), Value("y"))));
+  auto doc2 =
+      Doc("books/b", 1000, Map("title", "b", "tags", Array(Value("z"))));
+
+  RealtimePipeline pipeline = StartPipeline("/books");
+  pipeline = pipeline.AddingStage(std::make_shared<Unnest>(
+      std::make_shared<Field>("tags"), std::make_shared<Field>("tag"),
+      absl::nullopt));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1, doc2});
+  EXPECT_THAT(results,
+              ReturnsDocs(PipelineInputOutputVector{doc1, doc1, doc2}));
+  EXPECT_EQ(results[0].data(),
+            WrapObject("title", "a", "tags", Array(Value("x"), Value("y")),
+                       "tag", "x"));
+  EXPECT_EQ(results[1].data(),
+            WrapObject("title", "a", "tags", Array(Value("x"), Value("y")),
+                       "tag", "y"));
+  EXPECT_EQ(results[2].data(),
+            WrapObject("title", "b", "tags", Array(Value("z")), "tag", "z"));
+}
+
+TEST_F(UnnestPipelineTest, AddsIndexField) {
+  auto doc1 = Doc("books/a", 1000, Map("tags", Array(Value("x"), Value("y"))));
+
+  RealtimePipeline pipeline = StartPipeline("/books");
+  pipeline = pipeline.AddingStage(std::make_shared<Unnest>(
+      std::make_shared<Field>("tags"), std::make_shared<Field>("tags"),
+      std::make_shared<Field>("index")));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1});
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].data(), WrapObject("tags", "x", "index", 0LL));
+  EXPECT_EQ(results[1].data(), WrapObject("tags", "y", "index", 1LL));
+}
+
+TEST_F(UnnestPipelineTest, SkipsDocumentsWithoutArrays) {
+  auto doc1 = Doc("books/a", 1000, Map("tags", Array()));
+  auto doc2 = Doc("books/b", 1000, Map("tags", "x"));
+  auto doc3 = Doc("books/c", 1000, Map("title", "c"));
+
+  RealtimePipeline pipeline = StartPipeline("/books");
+  pipeline = pipeline.AddingStage(std::make_shared<Unnest>(
+      std::make_shared<Field>("tags"), std::make_shared<Field>("tag"),
+      absl::nullopt));
+
+  EXPECT_THAT(RunPipeline(pipeline, {doc1, doc2, doc3}), IsEmpty());
+}
+
+TEST_F(UnnestPipelineTest, WhereAfterUnnestFiltersElements) {
+  auto doc1 = Doc("books/a", 1000, Map("tags", Array(Value("x"), Value("y"))));
+  auto doc2 = Doc("books/b", 1000, Map("tags", Array(Value("z"))));
+
+  RealtimePipeline pipeline = StartPipeline("/books");
+  pipeline = pipeline.AddingStage(std::make_shared<Unnest>(
+      std::make_shared<Field>("tags"), std::make_shared<Field>("tag"),
+      absl::nullopt));
+  pipeline = pipeline.AddingStage(std::make_shared<Where>(
+      EqExpr({std::make_shared<Field>("tag"), SharedConstant("y")})));
+
+  PipelineInputOutputVector results = RunPipeline(pipeline, {doc1, doc2});
+  EXPECT_THAT(results, ReturnsDocs(PipelineInputOutputVector{doc1}));
+  EXPECT_EQ(results[0].data(),
+            WrapObject("tags", Array(Value("x"), Value("y")), "tag", "y"));
+}
+
+TEST_F(UnnestPipelineTest, CannotBeListenedTo) {
+  EXPECT_FALSE(IsListenableStage(Unnest(std::make_shared<Field>("tags"),
+                                        std::make_shared<Field>("tag"),
+                                        absl::nullopt)));
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
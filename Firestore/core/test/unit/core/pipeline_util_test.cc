@@ -267,6 +267,83 @@ TEST(PipelineUtilTest, TargetOrPipelineInUnorderedMap) {
   EXPECT_EQ(map.count(TargetOrPipeline(TestPipeline(0))), 0);  // Empty pipeline
 }
 
+TEST(PipelineUtilTest, ToIndexTargetTranslatesFilters) {
+  core::Query query = testutil::Query("coll")
+                          .AddingFilter(testutil::Filter("a", "==", 1))
+                          .AddingFilter(testutil::Filter("b", ">", 2))
+                          .AddingFilter(testutil::Filter(
+                              "c", "in", testutil::Array(1, 2)));
+  api::RealtimePipeline pipeline(ToPipelineStages(query), TestSerializer());
+
+  EXPECT_EQ(ToIndexTarget(pipeline), query.ToTarget());
+}
+
+TEST(PipelineUtilTest, ToIndexTargetTranslatesCollectionGroups) {
+  core::Query query = testutil::CollectionGroupQuery("coll").AddingFilter(
+      testutil::Filter("a", "array-contains", 1));
+  api::RealtimePipeline pipeline(ToPipelineStages(query), TestSerializer());
+
+  EXPECT_EQ(ToIndexTarget(pipeline), query.ToTarget());
+}
+
+TEST(PipelineUtilTest, ToIndexTargetSwapsOperandsOfComparisons) {
+  auto pipeline = StartPipeline("coll").AddingStage(
+      std::make_shared<api::Where>(testutil::LtExpr(
+          {testutil::SharedConstant(testutil::Value(1LL)),
+           std::make_shared<Field>("a")})));
+
+  EXPECT_EQ(ToIndexTarget(pipeline),
+            testutil::Query("coll")
+                .AddingFilter(testutil::Filter("a", ">", 1))
+                .ToTarget());
+}
+
+TEST(PipelineUtilTest, ToIndexTargetLeavesOutConditionsWithoutFilters) {
+  auto pipeline = StartPipeline("coll").AddingStage(
+      std::make_shared<api::Where>(testutil::AndExpr(
+          {testutil::EqExpr({std::make_shared<Field>("a"),
+                             testutil::SharedConstant(testutil::Value(1LL))}),
+           testutil::NeqExpr({std::make_shared<Field>("b"),
+                              testutil::SharedConstant(testutil::Value(2LL))}),
+           testutil::EqExpr({std::make_shared<Field>("c"),
+                             testutil::SharedConstant(nullptr)}),
+           testutil::OrExpr(
+               {testutil::EqExpr(
+                    {std::make_shared<Field>("d"),
+                     testutil::SharedConstant(testutil::Value(3LL))}),
+                testutil::EqExpr(
+                    {std::make_shared<Field>("e"),
+                     testutil::SharedConstant(testutil::Value(4LL))})})})));
+
+  EXPECT_EQ(ToIndexTarget(pipeline),
+            testutil::Query("coll")
+                .AddingFilter(testutil::Filter("a", "==", 1))
+                .ToTarget());
+
+  auto unindexable = StartPipeline("coll").AddingStage(
+      std::make_shared<api::Where>(
+          testutil::NeqExpr({std::make_shared<Field>("b"),
+                             testutil::SharedConstant(testutil::Value(2LL))})));
+  EXPECT_EQ(ToIndexTarget(unindexable), absl::nullopt);
+}
+
+TEST(PipelineUtilTest, ToIndexTargetStopsAtLimit) {
+  auto pipeline =
+      StartPipeline("coll")
+          .AddingStage(std::make_shared<api::Where>(testutil::EqExpr(
+              {std::make_shared<Field>("a"),
+               testutil::SharedConstant(testutil::Value(1LL))})))
+          .AddingStage(std::make_shared<api::LimitStage>(10))
+          .AddingStage(std::make_shared<api::Where>(testutil::EqExpr(
+              {std::make_shared<Field>("b"),
+               testutil::SharedConstant(testutil::Value(2LL))})));
+
+  EXPECT_EQ(ToIndexTarget(pipeline),
+            testutil::Query("coll")
+                .AddingFilter(testutil::Filter("a", "==", 1))
+                .ToTarget());
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
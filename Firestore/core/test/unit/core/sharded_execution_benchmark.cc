@@ -0,0 +1,300 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/event_manager.h"
+#include "Firestore/core/src/core/listen_options.h"
+#include "Firestore/core/src/core/query_listener.h"
+#include "Firestore/core/src/core/sync_engine.h"
+#include "Firestore/core/src/core/view.h"
+#include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/watch_change.h"
+#include "Firestore/core/src/remote/watch_stream.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "Firestore/core/test/unit/testutil/view_testing.h"
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/support/byte_buffer.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using model::DatabaseId;
+using model::Document;
+using model::DocumentKeySet;
+using model::ObjectValue;
+using model::SnapshotVersion;
+using model::TargetId;
+using nanopb::Message;
+using remote::DocumentWatchChange;
+using remote::Serializer;
+using remote::WatchChange;
+using remote::WatchStream;
+using remote::WatchStreamCallback;
+using util::AsyncQueue;
+using util::Executor;
+using util::Status;
+using util::StatusOr;
+
+constexpr int kResponses = 1000;
+constexpr int kFieldsPerDocument = 20;
+constexpr TargetId kTargetId = 2;
+
+const char* kCollection = "rooms";
+
+/**
+ * A watch stream that is always open and never touches the network: responses
+ * are fed to it with `OnStreamRead`, as gRPC would.
+ */
+class FakeWatchStream : public WatchStream {
+ public:
+  FakeWatchStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  Serializer serializer,
+                  WatchStreamCallback* callback)
+      : WatchStream{worker_queue,
+                    std::make_shared<EmptyAuthCredentialsProvider>(),
+                    std::make_shared<EmptyAppCheckCredentialsProvider>(),
+                    std::move(serializer),
+                    /*grpc_connection=*/nullptr,
+                    callback} {
+  }
+
+  void Start() override {
+    open_ = true;
+  }
+  void Stop() override {
+    open_ = false;
+  }
+  bool IsStarted() const override {
+    return open_;
+  }
+  bool IsOpen() const override {
+    return open_;
+  }
+
+ private:
+  bool open_ = false;
+};
+
+class FakeQueryEventSource : public QueryEventSource {
+ public:
+  void SetCallback(SyncEngineCallback*) override {
+  }
+  TargetId Listen(QueryOrPipeline, bool) override {
+    return kTargetId;
+  }
+  void ListenToRemoteStore(QueryOrPipeline) override {
+  }
+  void StopListening(const QueryOrPipeline&, bool) override {
+  }
+  void StopListeningToRemoteStoreOnly(const QueryOrPipeline&) override {
+  }
+};
+
+/** A response from the backend that adds a document to the collection. */
+grpc::ByteBuffer MakeDocumentChange(const Serializer& serializer, int index) {
+  ObjectValue value;
+  for (int i = 0; i < kFieldsPerDocument; ++i) {
+    value.Set(testutil::Field("field" + std::to_string(i)),
+              testutil::Value("value " + std::to_string(i)));
+  }
+
+  Message<google_firestore_v1_ListenResponse> response;
+  response->which_response_type =
+      google_firestore_v1_ListenResponse_document_change_tag;
+  google_firestore_v1_DocumentChange& change = response->document_change;
+  change.document = serializer.EncodeDocument(
+      testutil::Key(std::string(kCollection) + "/doc-" + std::to_string(index)),
+      value);
+  change.document.has_update_time = true;
+  change.document.update_time =
+      Serializer::EncodeVersion(testutil::Version(1));
+  change.target_ids_count = 1;
+  change.target_ids = nanopb::MakeArray<int32_t>(1);
+  change.target_ids[0] = kTargetId;
+
+  return remote::MakeByteBuffer(response);
+}
+
+/**
+ * The parts of a client that a watch response goes through on its way to
+ * snapshot listeners: the watch stream decodes it, a view of the query applies
+ * it, standing in for the remote store and sync engine, and the event manager
+ * raises the resulting snapshot to every listener.
+ */
+class Client : public WatchStreamCallback {
+ public:
+  Client(bool sharded, int listeners)
+      : worker_queue_{AsyncQueue::Create(Executor::CreateSerial(
+            "com.google.firebase.firestore.benchmark.worker"))},
+        event_manager_{&query_event_source_},
+        view_{QueryOrPipeline(testutil::Query(kCollection)), DocumentKeySet{}} {
+    if (sharded) {
+      decode_queue_ = AsyncQueue::Create(Executor::CreateSerial(
+          "com.google.firebase.firestore.benchmark.decode"));
+      event_queue_ = AsyncQueue::Create(Executor::CreateSerial(
+          "com.google.firebase.firestore.benchmark.events"));
+      event_manager_.NotifyListenersOn(event_queue_);
+    }
+
+    worker_queue_->EnqueueBlocking([&] {
+      stream_ = std::make_shared<FakeWatchStream>(
+          worker_queue_, Serializer{DatabaseId{"p", "d"}}, this);
+      if (decode_queue_) {
+        stream_->DecodeResponsesOn(decode_queue_);
+      }
+      stream_->Start();
+
+      for (int i = 0; i < listeners; ++i) {
+        event_manager_.AddQueryListener(QueryListener::Create(
+            QueryOrPipeline(testutil::Query(kCollection)),
+            ListenOptions::FromOptions(/*include_metadata_changes=*/false,
+                                       ListenSource::Cache),
+            [this](const StatusOr<ViewSnapshot>& snapshot) {
+              received_changes_ += static_cast<int64_t>(
+                  snapshot.ValueOrDie().document_changes().size());
+            }));
+      }
+    });
+  }
+
+  ~Client() override {
+    worker_queue_->EnqueueBlocking([&] {
+      stream_->Stop();
+      stream_.reset();
+    });
+    if (event_queue_) event_queue_->Dispose();
+    if (decode_queue_) decode_queue_->Dispose();
+    worker_queue_->Dispose();
+  }
+
+  /** Delivers `responses`, and waits until every listener has seen them. */
+  void Deliver(const std::vector<grpc::ByteBuffer>& responses) {
+    for (const grpc::ByteBuffer& response : responses) {
+      worker_queue_->Enqueue([this, response] {
+        stream_->OnStreamRead(response);
+      });
+    }
+
+    // Every queue hands work on before finishing it, so waiting for each in
+    // the order the work goes through them waits for all of it.
+    worker_queue_->EnqueueBlocking([] {});
+    if (decode_queue_) {
+      decode_queue_->EnqueueBlocking([] {});
+      worker_queue_->EnqueueBlocking([] {});
+      event_queue_->EnqueueBlocking([] {});
+    }
+  }
+
+  int64_t received_changes() const {
+    return received_changes_;
+  }
+
+  void OnWatchStreamOpen() override {
+  }
+
+  void OnWatchStreamChange(const WatchChange& change,
+                           const SnapshotVersion&) override {
+    const auto& document_change =
+        static_cast<const DocumentWatchChange&>(change);
+    absl::optional<ViewSnapshot> snapshot = testutil::ApplyChanges(
+        &view_, {Document(*document_change.new_document())}, absl::nullopt);
+    if (snapshot) {
+      std::vector<ViewSnapshot> snapshots;
+      snapshots.push_back(std::move(*snapshot));
+      event_manager_.OnViewSnapshots(std::move(snapshots));
+    }
+  }
+
+  void OnWatchStreamClose(const Status&) override {
+  }
+
+ private:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::shared_ptr<AsyncQueue> decode_queue_;
+  std::shared_ptr<AsyncQueue> event_queue_;
+
+  FakeQueryEventSource query_event_source_;
+  EventManager event_manager_;
+  View view_;
+  std::shared_ptr<FakeWatchStream> stream_;
+
+  // Only changed by listeners, which are called one at a time.
+  int64_t received_changes_ = 0;
+};
+
+/**
+ * Streams document changes through a client whose work is all on the worker
+ * queue, or sharded across the worker, decode and event queues, to
+ * `state.range(1)` listeners.
+ */
+void BM_WatchResponsesToListeners(benchmark::State& state) {
+  bool sharded = state.range(0) != 0;
+  auto listeners = static_cast<int>(state.range(1));
+
+  Serializer serializer{DatabaseId{"p", "d"}};
+  std::vector<grpc::ByteBuffer> responses;
+  responses.reserve(kResponses);
+  for (int i = 0; i < kResponses; ++i) {
+    responses.push_back(MakeDocumentChange(serializer, i));
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto client = absl::make_unique<Client>(sharded, listeners);
+    state.ResumeTiming();
+
+    client->Deliver(responses);
+
+    state.PauseTiming();
+    benchmark::DoNotOptimize(client->received_changes());
+    client.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * kResponses);
+}
+BENCHMARK(BM_WatchResponsesToListeners)
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({0, 16})
+    ->Args({1, 16})
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/sync_engine.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/sync_engine_callback.h"
+#include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/remote_event.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/remote/watch_change.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using credentials::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using model::DatabaseId;
+using model::DocumentKey;
+using model::MutableDocument;
+using model::OnlineState;
+using model::TargetId;
+using remote::ConnectivityMonitor;
+using remote::Datastore;
+using remote::DocumentWatchChange;
+using remote::FirebaseMetadataProvider;
+using remote::RemoteStore;
+using remote::WatchChangeAggregator;
+using remote::WatchTargetChange;
+using remote::WatchTargetChangeState;
+using testutil::Doc;
+using testutil::Filter;
+using testutil::Map;
+using testutil::Version;
+using util::AsyncQueue;
+using util::Status;
+
+/** Records the snapshots the `SyncEngine` emits, one entry per call. */
+class RecordingCallback : public SyncEngineCallback {
+ public:
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+  void OnViewSnapshots(std::vector<ViewSnapshot>&& snapshots) override {
+    emitted.push_back(std::move(snapshots));
+  }
+  void OnError(const QueryOrPipeline&, const Status&) override {
+  }
+
+  std::vector<std::vector<ViewSnapshot>> emitted;
+};
+
+/**
+ * Everything the `SyncEngine` emits for a sequence of events, along with the
+ * limbo resolutions it started.
+ */
+struct Outcome {
+  std::vector<std::vector<ViewSnapshot>> emitted;
+  std::map<DocumentKey, TargetId> active_limbo_resolutions;
+  std::vector<DocumentKey> enqueued_limbo_resolutions;
+};
+
+/**
+ * Listens to several queries over the same documents, makes them current, and
+ * then takes documents out of their targets, so that each view changes and
+ * reports its own limbo documents.
+ */
+Outcome RunViews(bool parallel) {
+  std::shared_ptr<AsyncQueue> worker_queue = testutil::AsyncQueueForTesting();
+  std::unique_ptr<Persistence> persistence =
+      local::MemoryPersistenceWithEagerGcForTesting();
+  QueryEngine query_engine;
+  LocalStore local_store(persistence.get(), &query_engine,
+                         User::Unauthenticated());
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor =
+      remote::CreateNoOpConnectivityMonitor();
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider =
+      remote::CreateFirebaseMetadataProviderNoOp();
+  auto datastore = std::make_shared<Datastore>(
+      DatabaseInfo{DatabaseId{"p", "d"}, "", "localhost", false}, worker_queue,
+      std::make_shared<EmptyAuthCredentialsProvider>(),
+      std::make_shared<EmptyAppCheckCredentialsProvider>(),
+      connectivity_monitor.get(), firebase_metadata_provider.get());
+  RecordingCallback callback;
+  Outcome outcome;
+
+  worker_queue->EnqueueBlocking([&] {
+    local_store.Start();
+    // The network stays disabled, so listens are only recorded.
+    RemoteStore remote_store(&local_store, datastore, worker_queue,
+                             connectivity_monitor.get(), [](OnlineState) {});
+    SyncEngine sync_engine(&local_store, &remote_store,
+                           User::Unauthenticated(),
+                           /*max_concurrent_limbo_resolutions=*/100);
+    remote_store.set_sync_engine(&sync_engine);
+    sync_engine.SetCallback(&callback);
+    if (parallel) {
+      sync_engine.EnableParallelViewComputation();
+    }
+
+    // View `i` holds the documents whose value is at least `i`.
+    std::vector<TargetId> target_ids;
+    for (int i = 0; i != 4; ++i) {
+      target_ids.push_back(sync_engine.Listen(QueryOrPipeline(
+          testutil::Query("coll").AddingFilter(Filter("value", ">=", i)))));
+    }
+
+    std::vector<MutableDocument> docs;
+    for (int i = 0; i != 5; ++i) {
+      docs.push_back(Doc("coll/" + std::string(1, 'a' + i), 1000,
+                         Map("value", i)));
+    }
+
+    WatchChangeAggregator aggregator{&remote_store};
+    for (const MutableDocument& doc : docs) {
+      aggregator.HandleDocumentChange(
+          DocumentWatchChange{target_ids, {}, doc.key(), doc});
+    }
+    aggregator.HandleTargetChange(
+        WatchTargetChange{WatchTargetChangeState::Current, target_ids,
+                          testutil::ResumeToken(1000)});
+    sync_engine.ApplyRemoteEvent(aggregator.CreateRemoteEvent(Version(1000)));
+
+    // The documents stay in the views but are no longer in their targets.
+    for (const MutableDocument& doc : {docs[0], docs[1]}) {
+      aggregator.HandleDocumentChange(
+          DocumentWatchChange{{}, target_ids, doc.key(), absl::nullopt});
+    }
+    sync_engine.ApplyRemoteEvent(aggregator.CreateRemoteEvent(Version(2000)));
+
+    outcome.emitted = std::move(callback.emitted);
+    outcome.active_limbo_resolutions =
+        sync_engine.GetActiveLimboDocumentResolutions();
+    outcome.enqueued_limbo_resolutions =
+        sync_engine.GetEnqueuedLimboDocumentResolutions();
+
+    remote_store.Shutdown();
+  });
+
+  return outcome;
+}
+
+}  // namespace
+
+TEST(SyncEngineTest, ParallelViewComputationMatchesSerialOrder) {
+  Outcome serial = RunViews(/*parallel=*/false);
+  Outcome parallel = RunViews(/*parallel=*/true);
+
+  // One call per listen, then one per remote event with a snapshot for each
+  // view it changed. The second event only changes the views that now have
+  // documents in limbo.
+  ASSERT_EQ(serial.emitted.size(), 6u);
+  EXPECT_EQ(serial.emitted[4].size(), 4u);
+  EXPECT_EQ(serial.emitted[5].size(), 2u);
+  EXPECT_EQ(serial.active_limbo_resolutions.size(), 2u);
+
+  EXPECT_EQ(serial.emitted, parallel.emitted);
+  EXPECT_EQ(serial.active_limbo_resolutions, parallel.active_limbo_resolutions);
+  EXPECT_EQ(serial.enqueued_limbo_resolutions,
+            parallel.enqueued_limbo_resolutions);
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
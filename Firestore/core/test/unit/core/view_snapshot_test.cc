@@ -129,6 +129,31 @@ TEST(ViewSnapshotTest, ViewSnapshotConstructor) {
   ASSERT_EQ(snapshot.has_cached_results(), has_cached_results);
 }
 
+TEST(ViewSnapshotTest, FromInitialDocuments) {
+  QueryOrPipeline query = QueryOrPipeline(testutil::Query("c"));
+  MutableDocument doc1 = Doc("c/a", 1, Map());
+  MutableDocument doc2 = Doc("c/b", 1, Map());
+  DocumentSet documents = DocumentSet{DocumentComparator::ByKey()};
+  documents = documents.insert(doc1).insert(doc2);
+
+  ViewSnapshot snapshot = ViewSnapshot::FromInitialDocuments(
+      query, documents, DocumentKeySet{},
+      /*from_cache=*/true, /*excludes_metadata_changes=*/false,
+      /*has_cached_results=*/false);
+  ViewSnapshot copy = snapshot;
+
+  std::vector<DocumentViewChange> expected{
+      DocumentViewChange{doc1, Type::Added},
+      DocumentViewChange{doc2, Type::Added}};
+  ASSERT_EQ(snapshot.documents(), documents);
+  ASSERT_TRUE(snapshot.old_documents().empty());
+  ASSERT_EQ(snapshot.document_changes(), expected);
+  ASSERT_TRUE(snapshot.sync_state_changed());
+
+  // Copies share the changes once created.
+  ASSERT_EQ(&copy.document_changes(), &snapshot.document_changes());
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
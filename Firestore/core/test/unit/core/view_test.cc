@@ -671,6 +671,74 @@ TEST(ViewTest, SuppressesWriteAcknowledgementIfWatchHasNotCaughtUp) {
                                      DocumentViewChange::Type::Metadata}));
 }
 
+/**
+ * Asserts that the one-shot snapshot of `docs` is the snapshot that applying
+ * `docs` to a new view of `query` produces.
+ */
+void ExpectInitialSnapshotMatchesView(const Query& query,
+                                      const std::vector<Document>& docs) {
+  View view(QueryOrPipeline(query), DocumentKeySet{});
+  absl::optional<ViewSnapshot> expected =
+      ApplyChanges(&view, docs, absl::nullopt);
+  ASSERT_TRUE(expected.has_value());
+
+  ViewSnapshot actual = View::ComputeInitialSnapshot(query, DocUpdates(docs));
+
+  ASSERT_EQ(actual.query_or_pipeline(), expected->query_or_pipeline());
+  ASSERT_EQ(actual.documents(), expected->documents());
+  ASSERT_EQ(actual.document_changes(), expected->document_changes());
+  ASSERT_EQ(actual.mutated_keys(), expected->mutated_keys());
+  ASSERT_EQ(actual.from_cache(), expected->from_cache());
+  ASSERT_EQ(actual.has_pending_writes(), expected->has_pending_writes());
+  ASSERT_EQ(actual.sync_state_changed(), expected->sync_state_changed());
+}
+
+TEST(ViewTest, ComputesInitialSnapshotLikeView) {
+  Document doc1 = Doc("rooms/eros/messages/1", 0, Map("sort", 3));
+  Document doc2 = Doc("rooms/eros/messages/2", 0, Map("sort", 1));
+  Document doc3 =
+      Doc("rooms/eros/messages/3", 0, Map("sort", 2)).SetHasLocalMutations();
+  Document doc4 = Doc("rooms/eros/messages/4", 0, Map("sort", 5));
+  Document doc5 = Doc("rooms/eros/messages/5", 0, Map("text", "no sort"));
+  Document doc6 = Doc("rooms/other/messages/1", 0, Map("sort", 0));
+  std::vector<Document> docs{doc1, doc2, doc3, doc4, doc5, doc6};
+
+  Query by_sort = QueryForMessages().AddingOrderBy(OrderBy("sort"));
+  ExpectInitialSnapshotMatchesView(QueryForMessages(), docs);
+  ExpectInitialSnapshotMatchesView(by_sort, docs);
+  ExpectInitialSnapshotMatchesView(
+      QueryForMessages().AddingFilter(Filter("sort", "<=", 2)), docs);
+  ExpectInitialSnapshotMatchesView(by_sort.WithLimitToFirst(2), docs);
+  ExpectInitialSnapshotMatchesView(by_sort.WithLimitToLast(2), docs);
+  ExpectInitialSnapshotMatchesView(by_sort.WithLimitToFirst(10), docs);
+  ExpectInitialSnapshotMatchesView(by_sort, {});
+}
+
+TEST(ViewTest, InitialSnapshotAppliesLimits) {
+  Document doc1 = Doc("rooms/eros/messages/1", 0, Map("sort", 3));
+  Document doc2 = Doc("rooms/eros/messages/2", 0, Map("sort", 1));
+  Document doc3 =
+      Doc("rooms/eros/messages/3", 0, Map("sort", 2)).SetHasLocalMutations();
+  Document doc4 = Doc("rooms/eros/messages/4", 0, Map("sort", 4));
+  model::DocumentMap docs = DocUpdates({doc1, doc2, doc3, doc4});
+  Query by_sort = QueryForMessages().AddingOrderBy(OrderBy("sort"));
+
+  ViewSnapshot first =
+      View::ComputeInitialSnapshot(by_sort.WithLimitToFirst(2), docs);
+  ASSERT_THAT(first.documents(), ElementsAre(doc2, doc3));
+  ASSERT_TRUE(first.from_cache());
+  ASSERT_TRUE(first.has_pending_writes());
+  ASSERT_THAT(
+      first.document_changes(),
+      ElementsAre(DocumentViewChange{doc2, DocumentViewChange::Type::Added},
+                  DocumentViewChange{doc3, DocumentViewChange::Type::Added}));
+
+  ViewSnapshot last =
+      View::ComputeInitialSnapshot(by_sort.WithLimitToLast(2), docs);
+  ASSERT_THAT(last.documents(), ElementsAre(doc1, doc4));
+  ASSERT_FALSE(last.has_pending_writes());
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
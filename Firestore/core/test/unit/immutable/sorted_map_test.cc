@@ -122,6 +122,16 @@ TYPED_TEST(SortedMapTest, Increasing) {
   ASSERT_EQ(Pairs(empty), Collect(map));
 }
 
+TYPED_TEST(SortedMapTest, FromSortedEntries) {
+  for (int n : {0, 1, 2, this->large_number()}) {
+    std::vector<std::pair<int, int>> entries = Pairs(Sequence(n));
+    TypeParam map =
+        TypeParam::FromSortedEntries(entries.begin(), entries.end());
+    ASSERT_EQ(static_cast<size_t>(n), map.size());
+    ASSERT_SEQ_EQ(entries, map);
+  }
+}
+
 TYPED_TEST(SortedMapTest, Overwrite) {
   TypeParam map = TypeParam().insert(10, 10).insert(10, 8);
 
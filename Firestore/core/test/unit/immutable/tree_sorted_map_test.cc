@@ -17,6 +17,8 @@
 #include "Firestore/core/src/immutable/tree_sorted_map.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "Firestore/core/src/util/secure_random.h"
 #include "Firestore/core/test/unit/immutable/testing.h"
@@ -230,6 +232,44 @@ TEST(TreeSortedMap, InitializerIsSorted) {
   EXPECT_TRUE(std::is_sorted(map.begin(), map.end()));
 }
 
+/**
+ * Returns the black height of `node`, asserting that it is the same on every
+ * path and that the node satisfies the left-leaning red-black invariants.
+ */
+int CheckedBlackHeight(const IntMap::node_type& node) {
+  if (node.empty()) {
+    return 1;
+  }
+  EXPECT_FALSE(node.right().red()) << "Red right child of " << node.key();
+  if (node.red()) {
+    EXPECT_FALSE(node.left().red()) << "Red child of red " << node.key();
+  }
+  EXPECT_EQ(node.size(), node.left().size() + 1 + node.right().size());
+
+  int left_height = CheckedBlackHeight(node.left());
+  int right_height = CheckedBlackHeight(node.right());
+  EXPECT_EQ(left_height, right_height) << "Unbalanced at " << node.key();
+  return left_height + (node.red() ? 0 : 1);
+}
+
+TEST(TreeSortedMap, FromSortedEntriesBuildsValidTrees) {
+  for (int size = 0; size <= 200; ++size) {
+    std::vector<std::pair<int, int>> entries = Pairs(Sequence(size));
+    IntMap map = IntMap::FromSortedEntries(entries.begin(), entries.end());
+
+    EXPECT_EQ(static_cast<size_t>(size), map.size());
+    EXPECT_FALSE(map.root().red());
+    CheckedBlackHeight(map.root());
+    EXPECT_EQ(entries, Collect(map));
+
+    // The tree stays valid when modified.
+    IntMap modified = map.insert(-1, -1).erase(size / 2);
+    CheckedBlackHeight(modified.root());
+    EXPECT_TRUE(NotFound(modified, size / 2));
+    EXPECT_TRUE(Found(modified, -1, -1));
+  }
+}
+
 }  // namespace impl
 }  // namespace immutable
 }  // namespace firestore
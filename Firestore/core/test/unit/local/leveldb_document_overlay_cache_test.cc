@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <memory>
+#include <stdexcept>
 #include <type_traits>
 
+#include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/leveldb_document_overlay_cache.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/persistence.h"
 #include "Firestore/core/src/model/mutation.h"
 #include "Firestore/core/src/model/patch_mutation.h"
@@ -56,7 +60,10 @@ class LevelDbDocumentOverlayCacheTestHelper final {
 
 namespace {
 
+using credentials::User;
 using model::Mutation;
+using model::ResourcePath;
+using testutil::Key;
 using testutil::Map;
 using testutil::PatchMutation;
 
@@ -182,6 +189,78 @@ TEST_F(LevelDbDocumentOverlayCacheTest, IndexesAreCreatedAndDestroyed) {
   });
 }
 
+TEST_F(LevelDbDocumentOverlayCacheTest,
+       ForgetsOverlayChangesOfUncommittedTransactions) {
+  Mutation mutation1 = PatchMutation("coll/doc1", Map("foo", "1"));
+  Mutation mutation2 = PatchMutation("coll/doc2", Map("foo", "2"));
+  persistence_->Run("Save",
+                    [&] { this->SaveOverlaysWithMutations(100, {mutation1}); });
+
+  EXPECT_ANY_THROW(persistence_->Run("Abandoned", [&] {
+    this->SaveOverlaysWithMutations(101, {mutation2});
+    cache_->RemoveOverlaysForBatchId(100);
+    throw std::runtime_error("abandoned");
+  }));
+
+  persistence_->Run("Verify", [&] {
+    EXPECT_EQ(cache_->GetOverlay(Key("coll/doc1"))->mutation(), mutation1);
+    EXPECT_FALSE(cache_->GetOverlay(Key("coll/doc2")).has_value());
+    EXPECT_EQ(cache_->GetOverlays(ResourcePath::FromString("coll"), -1).size(),
+              1u);
+  });
+}
+
+TEST_F(LevelDbDocumentOverlayCacheTest, SharesSnapshotUntilOverlaysChange) {
+  Mutation mutation1 = PatchMutation("coll/doc1", Map("foo", "1"));
+  Mutation mutation2 = PatchMutation("coll/doc2", Map("foo", "2"));
+  persistence_->Run("Test", [&] {
+    this->SaveOverlaysWithMutations(100, {mutation1});
+
+    std::shared_ptr<DocumentOverlayCache> first = cache_->CreateSnapshot();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(cache_->CreateSnapshot(), first);
+
+    this->SaveOverlaysWithMutations(101, {mutation2});
+    std::shared_ptr<DocumentOverlayCache> second = cache_->CreateSnapshot();
+    EXPECT_NE(second, first);
+    EXPECT_FALSE(first->GetOverlay(Key("coll/doc2")).has_value());
+    EXPECT_EQ(second->GetOverlay(Key("coll/doc2"))->mutation(), mutation2);
+
+    cache_->RemoveOverlaysForBatchId(100);
+    std::shared_ptr<DocumentOverlayCache> third = cache_->CreateSnapshot();
+    EXPECT_NE(third, second);
+    EXPECT_TRUE(second->GetOverlay(Key("coll/doc1")).has_value());
+    EXPECT_FALSE(third->GetOverlay(Key("coll/doc1")).has_value());
+  });
+}
+
+TEST_F(LevelDbDocumentOverlayCacheTest, LoadsExistingOverlaysOnFirstUse) {
+  persistence_->Run("Test", [&] {
+    Mutation mutation1 = PatchMutation("coll/doc1", Map("foo", "1"));
+    Mutation mutation2 = PatchMutation("coll/doc2", Map("foo", "2"));
+    Mutation mutation3 = PatchMutation("other/doc3", Map("foo", "3"));
+    this->SaveOverlaysWithMutations(100, {mutation1, mutation2});
+    this->SaveOverlaysWithMutations(101, {mutation3});
+
+    // A new cache for the same user must see the overlays written through the
+    // original instance.
+    LocalSerializer serializer = MakeLocalSerializer();
+    LevelDbDocumentOverlayCache cache(
+        User("user"), static_cast<LevelDbPersistence*>(persistence_.get()),
+        &serializer);
+
+    EXPECT_EQ(cache.GetOverlay(Key("coll/doc1"))->mutation(), mutation1);
+    EXPECT_EQ(cache.GetOverlays(ResourcePath::FromString("coll"), -1).size(),
+              2u);
+    EXPECT_EQ(cache.GetOverlays("other", 100, 10).size(), 1u);
+
+    cache.RemoveOverlaysForBatchId(100);
+    EXPECT_FALSE(cache.GetOverlay(Key("coll/doc1")).has_value());
+    EXPECT_TRUE(
+        cache.GetOverlays(ResourcePath::FromString("coll"), -1).empty());
+  });
+}
+
 }  // namespace
 }  // namespace local
 }  // namespace firestore
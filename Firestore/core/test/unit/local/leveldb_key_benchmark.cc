@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::ResourcePath;
+
+// Remote document keys of messages in 100 rooms, as read by a collection scan.
+std::vector<std::string> MakeRemoteDocumentKeys(int count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    keys.push_back(LevelDbRemoteDocumentKey::Key(DocumentKey::FromSegments(
+        {"rooms", "room-" + std::to_string(i % 100), "messages",
+         "message-" + std::to_string(i)})));
+  }
+  return keys;
+}
+
+void BM_DecodeRemoteDocumentKeys(benchmark::State& state) {
+  std::vector<std::string> keys =
+      MakeRemoteDocumentKeys(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    for (const std::string& key : keys) {
+      LevelDbRemoteDocumentKey decoded;
+      bool ok = decoded.Decode(key);
+      HARD_ASSERT(ok, "Failed to decode key");
+      benchmark::DoNotOptimize(decoded.document_key());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DecodeRemoteDocumentKeys)->Arg(1000)->Arg(10000);
+
+// Decodes keys the way a collection scan does: check the parent path of each
+// key, and collect the matching keys into a set.
+void BM_DecodeIntoDocumentKeySet(benchmark::State& state) {
+  std::vector<std::string> keys =
+      MakeRemoteDocumentKeys(static_cast<int>(state.range(0)));
+  ResourcePath collection = ResourcePath::FromString("rooms/room-7/messages");
+
+  for (auto _ : state) {
+    DocumentKeySet result;
+    LevelDbRemoteDocumentKey decoded;
+    for (const std::string& key : keys) {
+      bool ok = decoded.Decode(key);
+      HARD_ASSERT(ok, "Failed to decode key");
+      const DocumentKey& document_key = decoded.document_key();
+      if (collection.IsImmediateParentOf(document_key.path())) {
+        result = result.insert(document_key);
+      }
+    }
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DecodeIntoDocumentKeySet)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
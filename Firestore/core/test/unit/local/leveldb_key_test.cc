@@ -266,6 +266,17 @@ TEST(LevelDbQueryTargetKeyTest, EncodeDecodeCycle) {
   ASSERT_EQ(target_id, key.target_id());
 }
 
+TEST(LevelDbQueryTargetKeyTest, CanonicalIdHashIsFixedWidth) {
+  std::string short_hash = LevelDbQueryTargetKey::CanonicalIdHash("foo");
+  std::string long_hash =
+      LevelDbQueryTargetKey::CanonicalIdHash(std::string(10000, 'x'));
+
+  ASSERT_EQ(16u, short_hash.size());
+  ASSERT_EQ(16u, long_hash.size());
+  ASSERT_NE(short_hash, long_hash);
+  ASSERT_EQ(short_hash, LevelDbQueryTargetKey::CanonicalIdHash("foo"));
+}
+
 TEST(LevelDbQueryKeyTest, Description) {
   AssertExpectedKeyDescription("[query_target: canonical_id=foo target_id=42]",
                                LevelDbQueryTargetKey::Key("foo", 42));
@@ -583,6 +594,43 @@ TEST(IndexStateKeyTest, Description) {
       LevelDbIndexStateKey::Key("foo-bar?baz!quux", 99));
 }
 
+TEST(BinaryIndexStateKeyTest, Prefixing) {
+  auto table_key = LevelDbBinaryIndexStateKey::KeyPrefix();
+
+  ASSERT_TRUE(absl::StartsWith(LevelDbBinaryIndexStateKey::Key("user_a", 0),
+                               table_key));
+  ASSERT_TRUE(
+      absl::StartsWith(LevelDbBinaryIndexStateKey::Key("user_a", 0),
+                       LevelDbBinaryIndexStateKey::KeyPrefix("user_a")));
+
+  ASSERT_FALSE(absl::StartsWith(LevelDbBinaryIndexStateKey::Key("user_a", 0),
+                                LevelDbIndexStateKey::KeyPrefix()));
+  ASSERT_FALSE(absl::StartsWith(LevelDbBinaryIndexStateKey::Key("user_a", 0),
+                                LevelDbBinaryIndexStateKey::Key("user_b", 0)));
+}
+
+TEST(BinaryIndexStateKeyTest, EncodeDecodeCycle) {
+  LevelDbBinaryIndexStateKey key;
+
+  std::vector<std::pair<std::string, int32_t>> ids{
+      {"foo/bar", 0}, {"foo/bar2", 1}, {"foo-bar?baz!quux", -1}};
+  for (auto&& id : ids) {
+    auto encoded = LevelDbBinaryIndexStateKey::Key(id.first, id.second);
+    bool ok = key.Decode(encoded);
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(id.first, key.user_id());
+    ASSERT_EQ(id.second, key.index_id());
+  }
+
+  ASSERT_FALSE(key.Decode(LevelDbIndexStateKey::Key("foo/bar", 0)));
+}
+
+TEST(BinaryIndexStateKeyTest, Description) {
+  AssertExpectedKeyDescription(
+      "[binary_index_state: user_id=foo-bar?baz!quux index_id=99]",
+      LevelDbBinaryIndexStateKey::Key("foo-bar?baz!quux", 99));
+}
+
 TEST(IndexEntryKeyTest, Prefixing) {
   auto table_key = LevelDbIndexEntryKey::KeyPrefix();
 
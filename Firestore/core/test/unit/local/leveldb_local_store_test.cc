@@ -17,6 +17,7 @@
 #include "Firestore/core/src/core/filter.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/local_store_snapshot.h"
 #include "Firestore/core/src/model/delete_mutation.h"
 #include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/set_mutation.h"
@@ -189,6 +190,49 @@ TEST_F(LevelDbLocalStoreTest, DeletedDocumentRemovesIndex) {
   FSTAssertQueryReturned();
 }
 
+TEST_F(LevelDbLocalStoreTest, SnapshotsIncludePendingWrites) {
+  core::Query query =
+      testutil::Query("coll").AddingFilter(Filter("matches", "==", true));
+  int target_id = AllocateQuery(query);
+  ApplyRemoteEvent(
+      AddedRemoteEvent(Doc("coll/a", 10, Map("matches", true)), {target_id}));
+  WriteMutation(SetMutation("coll/b", Map("matches", true)));
+
+  std::unique_ptr<LocalStoreSnapshot> snapshot = local_store_.TakeSnapshot();
+  ASSERT_NE(snapshot, nullptr);
+
+  model::DocumentMap documents = snapshot->ExecuteQuery(query);
+  EXPECT_EQ(documents.size(), 2u);
+  EXPECT_TRUE(documents.contains(Key("coll/a")));
+  EXPECT_TRUE(documents.contains(Key("coll/b")));
+
+  model::Document document = snapshot->ReadDocument(Key("coll/b"));
+  EXPECT_TRUE(document->is_found_document());
+  EXPECT_TRUE(document->has_local_mutations());
+}
+
+TEST_F(LevelDbLocalStoreTest, SnapshotsDoNotSeeLaterChanges) {
+  core::Query query = testutil::Query("coll");
+  int target_id = AllocateQuery(query);
+  ApplyRemoteEvent(
+      AddedRemoteEvent(Doc("coll/a", 10, Map("count", 1)), {target_id}));
+
+  std::unique_ptr<LocalStoreSnapshot> snapshot = local_store_.TakeSnapshot();
+  ASSERT_NE(snapshot, nullptr);
+
+  ApplyRemoteEvent(
+      AddedRemoteEvent(Doc("coll/b", 20, Map("count", 2)), {target_id}));
+  WriteMutation(SetMutation("coll/a", Map("count", 3)));
+  WriteMutation(SetMutation("coll/c", Map("count", 4)));
+
+  model::DocumentMap documents = snapshot->ExecuteQuery(query);
+  ASSERT_EQ(documents.size(), 1u);
+  EXPECT_EQ(documents.get(Key("coll/a")).value()->data(),
+            Doc("coll/a", 10, Map("count", 1)).data());
+  EXPECT_FALSE(snapshot->ReadDocument(Key("coll/b"))->is_valid_document());
+  EXPECT_FALSE(snapshot->ReadDocument(Key("coll/c"))->is_valid_document());
+}
+
 TEST_F(LevelDbLocalStoreTest, UsesIndexes) {
   FieldIndex index =
       MakeFieldIndex("coll", 0, FieldIndex::InitialState(), "matches",
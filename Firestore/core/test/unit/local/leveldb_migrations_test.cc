@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
@@ -27,7 +28,10 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 #include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/ordered_code.h"
 #include "Firestore/core/src/util/path.h"
 #include "Firestore/core/test/unit/local/persistence_testing.h"
@@ -48,8 +52,10 @@ using leveldb::Status;
 using model::BatchId;
 using model::DocumentKey;
 using model::ListenSequenceNumber;
+using model::SnapshotVersion;
 using model::TargetId;
 using nanopb::Message;
+using nanopb::StringReader;
 using testutil::Filter;
 using testutil::Key;
 using testutil::Query;
@@ -258,7 +264,7 @@ TEST_F(LevelDbMigrationsTest, AddsSentinelRows) {
       const DocumentKey& key = document_key.document_key();
       std::string sentinel_key = LevelDbDocumentTargetKey::SentinelKey(key);
       ASSERT_TRUE(transaction.Get(sentinel_key, &buffer).ok());
-      int doc_number = atoi(key.path().last_segment().c_str());
+      int doc_number = atoi(std::string(key.path().last_segment()).c_str());
       // If the document number is odd, we expect the original old sequence
       // number that we wrote. If it's even, we expect that the migration added
       // the new sequence number from the target global
@@ -493,7 +499,7 @@ TEST_F(LevelDbMigrationsTest, RewritesCanonicalIds) {
 
   // Run migration and verify canonical id is rewritten with valid string.
   {
-    LevelDbMigrations::RunMigrations(db_.get(), *serializer_);
+    LevelDbMigrations::RunMigrations(db_.get(), 7, *serializer_);
 
     LevelDbTransaction transaction(
         db_.get(), "Read target to verify canonical ID rewritten");
@@ -513,6 +519,148 @@ TEST_F(LevelDbMigrationsTest, RewritesCanonicalIds) {
   }
 }
 
+TEST_F(LevelDbMigrationsTest, HashesQueryTargetCanonicalIds) {
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+  auto query = Query("collection").AddingFilter(Filter("foo", "==", "bar"));
+  TargetData target_data(core::TargetOrPipeline(query.ToTarget()),
+                         /* target_id= */ 2,
+                         /* sequence_number= */ 1, QueryPurpose::Listen);
+  const std::string& canonical_id =
+      target_data.target_or_pipeline().CanonicalId();
+  auto full_key =
+      LevelDbQueryTargetKey::Key(canonical_id, target_data.target_id());
+  auto hashed_key = LevelDbQueryTargetKey::Key(
+      LevelDbQueryTargetKey::CanonicalIdHash(canonical_id),
+      target_data.target_id());
+
+  {
+    LevelDbTransaction transaction(db_.get(),
+                                   "Write target with full canonical ID");
+    transaction.Put(LevelDbTargetKey::Key(2),
+                    serializer_->EncodeTargetData(target_data));
+    std::string empty_buffer;
+    transaction.Put(full_key, empty_buffer);
+    transaction.Commit();
+  }
+
+  // Running the migration twice (as happens after a downgrade) must leave
+  // both keys behind.
+  for (int i = 0; i < 2; ++i) {
+    LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+    LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+
+    LevelDbTransaction transaction(db_.get(),
+                                   "Read target to verify key was hashed");
+    std::string value;
+    ASSERT_TRUE(transaction.Get(hashed_key, &value).ok());
+    ASSERT_TRUE(transaction.Get(full_key, &value).ok());
+    transaction.Commit();
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, KeepsQueryTargetsAcrossDowngrade) {
+  auto make_target = [](const char* collection, TargetId target_id) {
+    return TargetData(core::TargetOrPipeline(Query(collection).ToTarget()),
+                      target_id, /* sequence_number= */ 1,
+                      QueryPurpose::Listen);
+  };
+  auto full_key = [](const TargetData& target_data) {
+    return LevelDbQueryTargetKey::Key(
+        target_data.target_or_pipeline().CanonicalId(),
+        target_data.target_id());
+  };
+  auto hashed_key = [](const TargetData& target_data) {
+    return LevelDbQueryTargetKey::Key(
+        LevelDbQueryTargetKey::CanonicalIdHash(
+            target_data.target_or_pipeline().CanonicalId()),
+        target_data.target_id());
+  };
+  TargetData removed = make_target("removed", 2);
+  TargetData added = make_target("added", 3);
+
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write target before upgrade");
+    transaction.Put(LevelDbTargetKey::Key(2),
+                    serializer_->EncodeTargetData(removed));
+    transaction.Put(full_key(removed), "");
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+
+  // Acting as the downgraded SDK, which only knows the full keys: the target
+  // written before the upgrade can still be found. Replace it with another.
+  {
+    LevelDbTransaction transaction(db_.get(), "Change targets after downgrade");
+    std::string value;
+    ASSERT_TRUE(transaction.Get(full_key(removed), &value).ok());
+    transaction.Delete(LevelDbTargetKey::Key(2));
+    transaction.Delete(full_key(removed));
+    transaction.Put(LevelDbTargetKey::Key(3),
+                    serializer_->EncodeTargetData(added));
+    transaction.Put(full_key(added), "");
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Read targets after upgrade");
+    std::string value;
+    EXPECT_TRUE(transaction.Get(hashed_key(added), &value).ok());
+    EXPECT_TRUE(transaction.Get(full_key(added), &value).ok());
+    EXPECT_TRUE(transaction.Get(hashed_key(removed), &value).IsNotFound());
+    EXPECT_TRUE(transaction.Get(full_key(removed), &value).IsNotFound());
+    transaction.Commit();
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, EncodesIndexStatesInBinary) {
+  LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+  std::string json_key = LevelDbIndexStateKey::Key("user", 1);
+  std::string invalid_key = LevelDbIndexStateKey::Key("user", 2);
+  std::string json_value = R"({"seconds":10,"nanos":20,"key":"coll/doc",)"
+                           R"("seq_num":3,"largest_batch":4})";
+  std::string invalid_value = R"({"seconds":10})";
+  model::IndexState json_state(
+      /* sequence_number= */ 3, SnapshotVersion(Timestamp(10, 20)),
+      Key("coll/doc"), /* largest_batch_id= */ 4);
+
+  {
+    LevelDbTransaction transaction(db_.get(), "Write index states");
+    transaction.Put(json_key, json_value);
+    transaction.Put(invalid_key, invalid_value);
+    transaction.Commit();
+  }
+
+  // Running the migration twice (as happens after a downgrade) must leave the
+  // states readable.
+  for (int i = 0; i < 2; ++i) {
+    LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+    LevelDbMigrations::RunMigrations(db_.get(), 10, *serializer_);
+
+    LevelDbTransaction transaction(db_.get(), "Read index states");
+    std::string value;
+    ASSERT_TRUE(
+        transaction.Get(LevelDbBinaryIndexStateKey::Key("user", 1), &value)
+            .ok());
+    StringReader reader{value};
+    EXPECT_EQ(json_state, serializer_->DecodeIndexState(&reader, value));
+    EXPECT_TRUE(reader.ok());
+    EXPECT_TRUE(
+        transaction.Get(LevelDbBinaryIndexStateKey::Key("user", 2), &value)
+            .IsNotFound());
+
+    // The JSON states stay behind for earlier versions of the SDK.
+    ASSERT_TRUE(transaction.Get(json_key, &value).ok());
+    EXPECT_EQ(json_value, value);
+    ASSERT_TRUE(transaction.Get(invalid_key, &value).ok());
+    EXPECT_EQ(invalid_value, value);
+    transaction.Commit();
+  }
+}
+
 TEST_F(LevelDbMigrationsTest, CanDowngrade) {
   // First, run all of the migrations
   LevelDbMigrations::RunMigrations(db_.get(), *serializer_);
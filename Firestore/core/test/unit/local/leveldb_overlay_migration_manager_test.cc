@@ -18,9 +18,12 @@
 
 #include <memory>
 
+#include "Firestore/core/src/core/pipeline_util.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_store.h"
 #include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/startup_timings.h"
 #include "Firestore/core/src/model/delete_mutation.h"
 #include "Firestore/core/src/model/patch_mutation.h"
 #include "Firestore/core/src/model/set_mutation.h"
@@ -337,6 +340,43 @@ TEST_F(LevelDbOverlayMigrationManagerTest, CreateOverlaysForDifferentUsers) {
                     [&] { EXPECT_FALSE(has_pending_overlay_migration()); });
 }
 
+TEST_F(LevelDbOverlayMigrationManagerTest, StagedStartupDefersMigration) {
+  WriteRemoteDocument(Doc("foo/bar", 2, Map("it", "original")));
+  WriteMutation(SetMutation("foo/bar", Map("foo", "bar")));
+
+  persistence_->Shutdown();
+  persistence_ =
+      LevelDbPersistence::Create(dir_, *serializer_, LruParams::Default())
+          .ValueOrDie();
+
+  local_store_ =
+      absl::make_unique<LocalStore>(persistence_.get(), query_engine_.get(),
+                                    credentials::User::Unauthenticated());
+  local_store_->EnableStagedStartup();
+  local_store_->Start();
+
+  using Phase = StartupTimings::Phase;
+  const StartupTimings& timings = *local_store_->startup_timings();
+  EXPECT_TRUE(timings.duration(Phase::kStartMutationQueue).has_value());
+  EXPECT_TRUE(timings.duration(Phase::kReadTargetMetadata).has_value());
+  EXPECT_FALSE(timings.duration(Phase::kMigrateOverlays).has_value());
+  EXPECT_FALSE(timings.duration(Phase::kStartIndexManager).has_value());
+  persistence_->Run("Verify flag",
+                    [&] { EXPECT_TRUE(has_pending_overlay_migration()); });
+
+  // Reading a document migrates the overlays, but doesn't need the indexes.
+  EXPECT_EQ(Doc("foo/bar", 2, Map("foo", "bar")).SetHasLocalMutations(),
+            local_store_->ReadDocument(Key("foo/bar")));
+  EXPECT_TRUE(timings.duration(Phase::kMigrateOverlays).has_value());
+  EXPECT_FALSE(timings.duration(Phase::kStartIndexManager).has_value());
+  persistence_->Run("Verify flag",
+                    [&] { EXPECT_FALSE(has_pending_overlay_migration()); });
+
+  local_store_->ExecuteQuery(core::QueryOrPipeline(testutil::Query("foo")),
+                             /* use_previous_results= */ false);
+  EXPECT_TRUE(timings.duration(Phase::kStartIndexManager).has_value());
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
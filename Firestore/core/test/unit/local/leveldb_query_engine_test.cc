@@ -641,6 +641,92 @@ TEST_F(LevelDbQueryEngineTest, OrderByEquality) {
   });
 }
 
+TEST_F(LevelDbQueryEngineTest, CombinesIndexedWithNonIndexedPipelineResults) {
+  persistence_->Run("CombinesIndexedWithNonIndexedPipelineResults", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+    should_use_pipeline_ = true;
+
+    auto doc1 = Doc("coll/a", 1, Map("foo", true));
+    auto doc2 = Doc("coll/b", 2, Map("foo", true));
+    auto doc3 = Doc("coll/c", 3, Map("foo", true));
+    auto doc4 = Doc("coll/d", 3, Map("foo", true)).SetHasLocalMutations();
+
+    index_manager_->AddFieldIndex(
+        MakeFieldIndex("coll", "foo", model::Segment::kAscending));
+
+    AddDocuments({doc1, doc2});
+    index_manager_->UpdateIndexEntries(DocumentMap({doc1, doc2}));
+    index_manager_->UpdateCollectionGroup(
+        "coll", model::IndexOffset::FromDocument(doc2));
+
+    AddDocuments({doc3});
+    AddMutation(SetMutation("coll/d", Map("foo", true)));
+
+    core::Query query = Query("coll").AddingFilter(Filter("foo", "==", true));
+
+    DocumentSet docs = ExpectOptimizedCollectionScan(
+        [&] { return RunQuery(query, SnapshotVersion::None()); });
+    EXPECT_EQ(docs, DocSet(query.Comparator(), {doc1, doc2, doc3, doc4}));
+  });
+}
+
+TEST_F(LevelDbQueryEngineTest, UsesPartialIndexForLimitPipelines) {
+  persistence_->Run("UsesPartialIndexForLimitPipelines", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+    should_use_pipeline_ = true;
+
+    auto doc1 = Doc("coll/1", 1, Map("a", 1, "b", 0));
+    auto doc2 = Doc("coll/2", 1, Map("a", 1, "b", 1));
+    auto doc3 = Doc("coll/3", 1, Map("a", 1, "b", 2));
+    auto doc4 = Doc("coll/4", 1, Map("a", 1, "b", 3));
+    auto doc5 = Doc("coll/5", 1, Map("a", 2, "b", 3));
+    AddDocuments({doc1, doc2, doc3, doc4, doc5});
+
+    index_manager_->AddFieldIndex(
+        MakeFieldIndex("coll", "a", model::Segment::kAscending));
+    index_manager_->UpdateIndexEntries(
+        DocumentMap({doc1, doc2, doc3, doc4, doc5}));
+    index_manager_->UpdateCollectionGroup(
+        "coll", model::IndexOffset::FromDocument(doc5));
+
+    core::Query query = Query("coll")
+                            .AddingFilter(Filter("a", "==", 1))
+                            .AddingFilter(Filter("b", ">=", 1))
+                            .AddingOrderBy(OrderBy("b"))
+                            .WithLimitToFirst(2);
+    DocumentSet docs = ExpectOptimizedCollectionScan(
+        [&] { return RunQuery(query, SnapshotVersion::None()); });
+    EXPECT_EQ(docs, DocSet(query.Comparator(), {doc2, doc3}));
+  });
+}
+
+TEST_F(LevelDbQueryEngineTest, ScansCollectionForUnindexablePipelines) {
+  persistence_->Run("ScansCollectionForUnindexablePipelines", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+    should_use_pipeline_ = true;
+
+    auto doc1 = Doc("coll/1", 1, Map("a", 1));
+    auto doc2 = Doc("coll/2", 1, Map("a", 2));
+    AddDocuments({doc1, doc2});
+
+    index_manager_->AddFieldIndex(
+        MakeFieldIndex("coll", "a", model::Segment::kAscending));
+    index_manager_->UpdateIndexEntries(DocumentMap({doc1, doc2}));
+    index_manager_->UpdateCollectionGroup(
+        "coll", model::IndexOffset::FromDocument(doc2));
+
+    // A pipeline's `not_equal` also keeps documents without the field, which
+    // no index lookup returns.
+    core::Query query = Query("coll").AddingFilter(Filter("a", "!=", 1));
+    DocumentSet docs = ExpectFullCollectionScan<DocumentSet>(
+        [&] { return RunQuery(query, SnapshotVersion::None()); });
+    EXPECT_EQ(docs, DocSet(query.Comparator(), {doc2}));
+  });
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/firestore/local/maybe_document.nanopb.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_remote_document_cache.h"
+#include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using model::MutableDocument;
+using model::MutableDocumentMap;
+using model::ObjectValue;
+using nanopb::Message;
+using nanopb::StringReader;
+using testutil::Field;
+using testutil::Filter;
+using testutil::Value;
+
+constexpr int kDocumentCount = 1000;
+constexpr int kFieldsPerDocument = 100;
+
+/**
+ * A document with `kFieldsPerDocument` text fields and a `score` field. One in
+ * a hundred documents has a score of 7.
+ */
+MutableDocument MakeLargeDocument(int index) {
+  ObjectValue data;
+  for (int i = 0; i != kFieldsPerDocument; ++i) {
+    data.Set(Field("field" + std::to_string(i)),
+             Value("The quick brown fox jumps over the lazy dog " +
+                   std::to_string(i)));
+  }
+  data.Set(Field("score"), Value(index % 100));
+
+  return MutableDocument::FoundDocument(
+      testutil::Key("rooms/room-" + std::to_string(index)),
+      testutil::Version(1), std::move(data));
+}
+
+core::Query SelectiveQuery() {
+  return testutil::Query("rooms").AddingFilter(Filter("score", "==", 7));
+}
+
+/** The encoded documents, as stored in the remote document cache. */
+std::vector<std::string> EncodeDocuments(const LocalSerializer& serializer) {
+  std::vector<std::string> encoded;
+  for (int i = 0; i != kDocumentCount; ++i) {
+    encoded.push_back(nanopb::MakeStdString(
+        serializer.EncodeMaybeDocument(MakeLargeDocument(i))));
+  }
+  return encoded;
+}
+
+void BM_DecodeAndMatchEagerly(benchmark::State& state) {
+  LocalSerializer serializer = MakeLocalSerializer();
+  std::vector<std::string> encoded = EncodeDocuments(serializer);
+  core::Query query = SelectiveQuery();
+
+  for (auto _ : state) {
+    int matches = 0;
+    for (const std::string& bytes : encoded) {
+      StringReader reader{bytes};
+      auto message = Message<firestore_client_MaybeDocument>::TryParse(&reader);
+      MutableDocument document =
+          serializer.DecodeMaybeDocument(&reader, *message);
+      HARD_ASSERT(reader.ok(), "Failed to decode document");
+      if (query.Matches(document)) ++matches;
+    }
+    HARD_ASSERT(matches == kDocumentCount / 100, "Unexpected matches");
+  }
+  state.SetItemsProcessed(state.iterations() * kDocumentCount);
+}
+BENCHMARK(BM_DecodeAndMatchEagerly);
+
+void BM_DecodeAndMatchLazily(benchmark::State& state) {
+  LocalSerializer serializer = MakeLocalSerializer();
+  std::vector<std::string> encoded = EncodeDocuments(serializer);
+  core::Query query = SelectiveQuery();
+
+  for (auto _ : state) {
+    int matches = 0;
+    for (const std::string& bytes : encoded) {
+      StringReader reader;
+      MutableDocument document = serializer.DecodeMaybeDocument(
+          &reader, std::make_shared<const std::string>(bytes));
+      HARD_ASSERT(reader.ok(), "Failed to decode document");
+      if (query.Matches(document)) ++matches;
+    }
+    HARD_ASSERT(matches == kDocumentCount / 100, "Unexpected matches");
+  }
+  state.SetItemsProcessed(state.iterations() * kDocumentCount);
+}
+BENCHMARK(BM_DecodeAndMatchLazily);
+
+// Runs the selective query against the LevelDB remote document cache, which
+// decodes documents lazily. With an argument of 2, the query also orders by a
+// second field, so that two fields are read from every document.
+void BM_SelectiveCollectionQuery(benchmark::State& state) {
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting();
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+  persistence->Run("Add documents", [&] {
+    for (int i = 0; i != kDocumentCount; ++i) {
+      cache->Add(MakeLargeDocument(i), testutil::Version(1));
+    }
+  });
+  core::Query selective_query = SelectiveQuery();
+  if (state.range(0) == 2) {
+    selective_query =
+        selective_query.AddingOrderBy(testutil::OrderBy("field50"));
+  }
+  core::QueryOrPipeline query{selective_query};
+
+  for (auto _ : state) {
+    persistence->Run("Query documents", [&] {
+      MutableDocumentMap results =
+          cache->GetDocumentsMatchingQuery(query, model::IndexOffset::None());
+      HARD_ASSERT(results.size() == kDocumentCount / 100,
+                  "Unexpected matches");
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * kDocumentCount);
+}
+BENCHMARK(BM_SelectiveCollectionQuery)
+    ->Arg(1)
+    ->Arg(2)
+    ->Unit(benchmark::kMillisecond);
+
+// Reads the same few hot documents over and over, with the given budget for
+// the in-memory document cache (zero disables it).
+void BM_RepeatedGets(benchmark::State& state) {
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting();
+  LevelDbRemoteDocumentCache* cache = persistence->remote_document_cache();
+  if (state.range(0) > 0) {
+    cache->EnableDocumentCache(static_cast<size_t>(state.range(0)));
+  }
+
+  constexpr int kHotDocuments = 10;
+  persistence->Run("Add documents", [&] {
+    for (int i = 0; i != kHotDocuments; ++i) {
+      cache->Add(MakeLargeDocument(i), testutil::Version(1));
+    }
+  });
+
+  for (auto _ : state) {
+    persistence->Run("Get documents", [&] {
+      for (int i = 0; i != kHotDocuments; ++i) {
+        MutableDocument document =
+            cache->Get(testutil::Key("rooms/room-" + std::to_string(i)));
+        benchmark::DoNotOptimize(document.data().Get(Field("score")));
+      }
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * kHotDocuments);
+  state.counters["hits"] = benchmark::Counter(
+      static_cast<double>(cache->document_cache_hits()),
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RepeatedGets)->Arg(0)->Arg(1024 * 1024);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -19,11 +19,15 @@
 #include <string>
 
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_remote_document_cache.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/util/ordered_code.h"
 #include "Firestore/core/test/unit/local/persistence_testing.h"
 #include "Firestore/core/test/unit/local/remote_document_cache_test.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
 #include "absl/memory/memory.h"
+#include "gtest/gtest.h"
 #include "leveldb/db.h"
 
 namespace firebase {
@@ -32,6 +36,13 @@ namespace local {
 namespace {
 
 using leveldb::WriteOptions;
+using model::MutableDocument;
+using testutil::Doc;
+using testutil::Field;
+using testutil::Key;
+using testutil::Map;
+using testutil::Value;
+using testutil::Version;
 using util::OrderedCode;
 
 // A dummy document value, useful for testing code that's known to examine only
@@ -62,7 +73,7 @@ void WriteDummyRow(LevelDbPersistence* db,
   db->ptr()->Put(WriteOptions(), key, kDummy);
 }
 
-std::unique_ptr<Persistence> PersistenceFactory() {
+std::unique_ptr<LevelDbPersistence> LevelDbPersistenceWithDummyRows() {
   auto persistence = LevelDbPersistenceForTesting();
 
   // Write rows that go before and after remote document cache keys to ensure
@@ -78,12 +89,103 @@ std::unique_ptr<Persistence> PersistenceFactory() {
   return persistence;
 }
 
+std::unique_ptr<Persistence> PersistenceFactory() {
+  return LevelDbPersistenceWithDummyRows();
+}
+
+std::unique_ptr<Persistence> PersistenceWithDocumentCacheFactory() {
+  auto persistence = LevelDbPersistenceWithDummyRows();
+  persistence->remote_document_cache()->EnableDocumentCache(1024 * 1024);
+  return persistence;
+}
+
+class LevelDbDocumentCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    persistence_ = LevelDbPersistenceForTesting();
+    cache_ = persistence_->remote_document_cache();
+    cache_->EnableDocumentCache(1024 * 1024);
+  }
+
+  void Add(const MutableDocument& document) {
+    persistence_->Run("Add document",
+                      [&] { cache_->Add(document, document.version()); });
+  }
+
+  MutableDocument Get(const char* path) {
+    return persistence_->Run("Get document",
+                             [&] { return cache_->Get(Key(path)); });
+  }
+
+  std::unique_ptr<LevelDbPersistence> persistence_;
+  LevelDbRemoteDocumentCache* cache_ = nullptr;
+};
+
 }  // namespace
 
 INSTANTIATE_TEST_SUITE_P(LevelDbRemoteDocumentCacheTest,
                          RemoteDocumentCacheTest,
                          testing::Values(PersistenceFactory));
 
+INSTANTIATE_TEST_SUITE_P(LevelDbRemoteDocumentCacheWithDocumentCacheTest,
+                         RemoteDocumentCacheTest,
+                         testing::Values(PersistenceWithDocumentCacheFactory));
+
+TEST_F(LevelDbDocumentCacheTest, ServesRepeatedReads) {
+  Add(Doc("coll/a", 1, Map("value", 1)));
+
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+  EXPECT_EQ(1, cache_->document_cache_misses());
+  EXPECT_EQ(1, cache_->document_cache_hits());
+}
+
+TEST_F(LevelDbDocumentCacheTest, ReturnsCopies) {
+  Add(Doc("coll/a", 1, Map("value", 1)));
+
+  MutableDocument document = Get("coll/a");
+  document.mutable_data().Set(Field("value"), Value(2));
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+
+  Get("coll/a").mutable_data().Set(Field("value"), Value(3));
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+}
+
+TEST_F(LevelDbDocumentCacheTest, IsInvalidatedByWrites) {
+  Add(Doc("coll/a", 1, Map("value", 1)));
+  Get("coll/a");
+
+  Add(Doc("coll/a", 2, Map("value", 2)));
+  EXPECT_EQ(Doc("coll/a", 2, Map("value", 2)), Get("coll/a"));
+
+  persistence_->Run("Remove document", [&] { cache_->Remove(Key("coll/a")); });
+  EXPECT_FALSE(Get("coll/a").is_valid_document());
+}
+
+TEST_F(LevelDbDocumentCacheTest, DoesNotCacheUncommittedWrites) {
+  persistence_->Run("Add and read document", [&] {
+    cache_->Add(Doc("coll/a", 1, Map("value", 1)), Version(1));
+    EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), cache_->Get(Key("coll/a")));
+    EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), cache_->Get(Key("coll/a")));
+  });
+  EXPECT_EQ(0, cache_->document_cache_hits());
+
+  // Once committed, the document is cached on its next read.
+  Get("coll/a");
+  Get("coll/a");
+  EXPECT_EQ(1, cache_->document_cache_hits());
+}
+
+TEST_F(LevelDbDocumentCacheTest, EvictsDocumentsOverBudget) {
+  cache_->EnableDocumentCache(1);
+  Add(Doc("coll/a", 1, Map("value", 1)));
+
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+  EXPECT_EQ(Doc("coll/a", 1, Map("value", 1)), Get("coll/a"));
+  EXPECT_EQ(0, cache_->document_cache_hits());
+  EXPECT_EQ(2, cache_->document_cache_misses());
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
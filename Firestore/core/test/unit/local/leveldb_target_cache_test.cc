@@ -16,6 +16,9 @@
 
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 
+#include <stdexcept>
+#include <string>
+
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
@@ -153,6 +156,60 @@ TEST_F(LevelDbTargetCacheTest, SurvivesMissingTargetData) {
   });
 }
 
+TEST_F(LevelDbTargetCacheTest, WritesQueryTargetKeysOfBothForms) {
+  persistence_->Run("test_writes_query_target_keys_of_both_forms", [&]() {
+    TargetData target_data = MakeTargetData(query_rooms_);
+    const std::string& canonical_id =
+        target_data.target_or_pipeline().CanonicalId();
+    // Earlier versions of the SDK look targets up by the full canonical ID.
+    std::string full_key =
+        LevelDbQueryTargetKey::Key(canonical_id, target_data.target_id());
+    std::string hashed_key = LevelDbQueryTargetKey::Key(
+        LevelDbQueryTargetKey::CanonicalIdHash(canonical_id),
+        target_data.target_id());
+
+    LevelDbTransaction* transaction =
+        leveldb_persistence()->current_transaction();
+    std::string value;
+    cache_->AddTarget(target_data);
+    EXPECT_TRUE(transaction->Get(full_key, &value).ok());
+    EXPECT_TRUE(transaction->Get(hashed_key, &value).ok());
+
+    cache_->RemoveTarget(target_data);
+    EXPECT_TRUE(transaction->Get(full_key, &value).IsNotFound());
+    EXPECT_TRUE(transaction->Get(hashed_key, &value).IsNotFound());
+  });
+}
+
+TEST_F(LevelDbTargetCacheTest, ForgetsTargetsOfUncommittedTransactions) {
+  TargetData committed = MakeTargetData(query_rooms_);
+  persistence_->Run("add target", [&] { cache_->AddTarget(committed); });
+
+  TargetData updated = committed.WithResumeToken(
+      testutil::ResumeToken(1000), testutil::Version(1000));
+  EXPECT_ANY_THROW(persistence_->Run("abandoned update", [&] {
+    cache_->UpdateTarget(updated);
+    throw std::runtime_error("abandoned");
+  }));
+
+  Query query_halls = testutil::Query("halls");
+  EXPECT_ANY_THROW(persistence_->Run("abandoned add", [&] {
+    cache_->AddTarget(MakeTargetData(query_halls));
+    throw std::runtime_error("abandoned");
+  }));
+
+  persistence_->Run("lookup", [&] {
+    auto result =
+        cache_->GetTarget(core::TargetOrPipeline(query_rooms_.ToTarget()));
+    ASSERT_NE(result, absl::nullopt);
+    EXPECT_EQ(result->resume_token(), committed.resume_token());
+
+    EXPECT_EQ(
+        cache_->GetTarget(core::TargetOrPipeline(query_halls.ToTarget())),
+        absl::nullopt);
+  });
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
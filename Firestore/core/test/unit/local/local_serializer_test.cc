@@ -16,6 +16,9 @@
 
 #include "Firestore/core/src/local/local_serializer.h"
 
+#include <memory>
+#include <string>
+
 #include "Firestore/Protos/cpp/firestore/bundle.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/maybe_document.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/mutation.pb.h"
@@ -27,6 +30,7 @@
 #include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/field_mask.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/mutation.h"
@@ -276,6 +280,14 @@ class LocalSerializerTest : public ::testing::Test {
     auto actual_model = serializer.DecodeMaybeDocument(&reader, *message);
     EXPECT_OK(reader.status());
     EXPECT_EQ(model, actual_model);
+
+    // Documents decoded lazily from the same bytes are equal as well.
+    StringReader lazy_reader;
+    auto encoded =
+        std::make_shared<const std::string>(proto.SerializeAsString());
+    auto lazy_model = serializer.DecodeMaybeDocument(&lazy_reader, encoded);
+    EXPECT_OK(lazy_reader.status());
+    EXPECT_EQ(model, lazy_model);
   }
 
   ByteString EncodeMaybeDocument(local::LocalSerializer* localSerializer,
@@ -835,6 +847,36 @@ TEST_F(LocalSerializerTest, EncodesTargetDataWithPipeline) {
   ExpectRoundTrip(target_data, expected_proto);
 }
 
+TEST_F(LocalSerializerTest, EncodesIndexState) {
+  for (const model::IndexState& state :
+       {model::IndexState(),
+        model::IndexState(/* sequence_number= */ 7,
+                          SnapshotVersion(Timestamp(1234, 5678)),
+                          Key("coll/doc/sub/ü"), /* largest_batch_id= */ 42),
+        model::IndexState(/* sequence_number= */ -1,
+                          SnapshotVersion(Timestamp(-5, 0)),
+                          DocumentKey::Empty(),
+                          /* largest_batch_id= */ model::kBatchIdUnknown)}) {
+    std::string encoded = serializer.EncodeIndexState(state);
+    StringReader reader{encoded};
+    model::IndexState decoded = serializer.DecodeIndexState(&reader, encoded);
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    EXPECT_EQ(state, decoded);
+  }
+}
+
+TEST_F(LocalSerializerTest, FailsToDecodeInvalidIndexState) {
+  std::string encoded = serializer.EncodeIndexState(model::IndexState(
+      1, SnapshotVersion(Timestamp(1, 2)), Key("coll/doc"), 3));
+  for (const std::string& invalid :
+       {std::string{}, std::string{R"({"seconds": 1})"},
+        encoded.substr(0, encoded.size() - 1)}) {
+    StringReader reader{invalid};
+    serializer.DecodeIndexState(&reader, invalid);
+    EXPECT_FALSE(reader.ok());
+  }
+}
+
 }  // namespace
 }  // namespace local
 }  // namespace firestore
@@ -303,7 +303,7 @@ void LocalStoreTestBase::SetIndexAutoCreationEnabled(bool is_enabled) {
   query_engine_.SetIndexAutoCreationEnabled(is_enabled);
 }
 
-void LocalStoreTestBase::DeleteAllIndexes() const {
+void LocalStoreTestBase::DeleteAllIndexes() {
   local_store_.DeleteAllFieldIndexes();
 }
 
@@ -346,6 +346,35 @@ TEST_P(MutationQueueTest, AllMutationBatchesAffectingQuery) {
   });
 }
 
+TEST_P(MutationQueueTest, AllMutationBatchesAffectingQuerySkipsSubtrees) {
+  persistence_->Run("AllMutationBatchesAffectingQuerySkipsSubtrees", [&] {
+    std::vector<Mutation> mutations = {
+        testutil::SetMutation("foo/a/sub/x", Map("a", 1)),
+        testutil::SetMutation("foo/a", Map("a", 1)),
+        testutil::SetMutation("foo/a/sub/x/deeper/y", Map("a", 1)),
+        testutil::SetMutation("foo/b", Map("a", 1)),
+        testutil::SetMutation("foo/c/sub/z", Map("a", 1)),
+        testutil::SetMutation("foo/d", Map("a", 1)),
+        testutil::PatchMutation("foo/a", Map("b", 1),
+                                std::vector<model::FieldPath>{}),
+    };
+
+    std::vector<MutationBatch> batches;
+    for (const Mutation& mutation : mutations) {
+      MutationBatch batch =
+          mutation_queue_->AddMutationBatch(Timestamp::Now(), {}, {mutation});
+      batches.push_back(batch);
+    }
+
+    std::vector<MutationBatch> expected = {batches[1], batches[3], batches[5],
+                                           batches[6]};
+    std::vector<MutationBatch> matches =
+        mutation_queue_->AllMutationBatchesAffectingQuery(Query("foo"));
+
+    EXPECT_EQ(matches, expected);
+  });
+}
+
 TEST_P(MutationQueueTest, RemoveMutationBatches) {
   persistence_->Run("RemoveMutationBatches", [&] {
     std::vector<MutationBatch> batches = CreateBatches(10);
@@ -298,23 +298,23 @@ TEST_P(RemoteDocumentCacheTest, DoesNotApplyDocumentModificationsToCache) {
     MutableDocument document = SetTestDocument("coll/doc", Map("value", "old"));
     document = cache_->Get(Key("coll/doc"));
     EXPECT_EQ(document.value(), *Map("value", "old"));
-    document.data().Set(Field("value"), Value("new"));
+    document.mutable_data().Set(Field("value"), Value("new"));
 
     document = cache_->Get(Key("coll/doc"));
     EXPECT_EQ(document.value(), *Map("value", "old"));
-    document.data().Set(Field("value"), Value("new"));
+    document.mutable_data().Set(Field("value"), Value("new"));
 
     MutableDocumentMap documents =
         cache_->GetAll(DocumentKeySet{Key("coll/doc")});
     document = documents.find(Key("coll/doc"))->second;
     EXPECT_EQ(document.value(), *Map("value", "old"));
-    document.data().Set(Field("value"), Value("new"));
+    document.mutable_data().Set(Field("value"), Value("new"));
 
     documents = cache_->GetDocumentsMatchingQuery(
         core::QueryOrPipeline(Query("coll")), model::IndexOffset::None());
     document = documents.find(Key("coll/doc"))->second;
     EXPECT_EQ(document.value(), *Map("value", "old"));
-    document.data().Set(Field("value"), Value("new"));
+    document.mutable_data().Set(Field("value"), Value("new"));
 
     document = cache_->Get(Key("coll/doc"));
     EXPECT_EQ(document.value(), *Map("value", "old"));
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+// Keys of messages spread over 100 rooms, in random order.
+std::vector<DocumentKey> MakeKeys(int count) {
+  std::vector<DocumentKey> keys;
+  keys.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    keys.push_back(DocumentKey::FromSegments(
+        {"rooms", "room-" + std::to_string(i % 100), "messages",
+         "message-" + std::to_string(i)}));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{42});
+  return keys;
+}
+
+void BM_BuildDocumentKeySet(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    DocumentKeySet set;
+    for (const DocumentKey& key : keys) {
+      set = set.insert(key);
+    }
+    benchmark::DoNotOptimize(set);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildDocumentKeySet)->Arg(100)->Arg(1000)->Arg(10000);
+
+void BM_CopyDocumentKeys(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    std::vector<DocumentKey> copy = keys;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CopyDocumentKeys)->Arg(1000);
+
+// Matching a document against a collection query: the query's path must be
+// the immediate parent of the key's path.
+void BM_ParentPathMatching(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys(static_cast<int>(state.range(0)));
+  ResourcePath collection = ResourcePath::FromString("rooms/room-7/messages");
+
+  for (auto _ : state) {
+    int matches = 0;
+    for (const DocumentKey& key : keys) {
+      if (collection.IsImmediateParentOf(key.path())) {
+        ++matches;
+      }
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParentPathMatching)->Arg(1000);
+
+// Deriving the collection path of each key.
+void BM_PopLast(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    for (const DocumentKey& key : keys) {
+      ResourcePath parent = key.path().PopLast();
+      benchmark::DoNotOptimize(parent);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PopLast)->Arg(1000);
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/model/document_set.h"
 
+#include <string>
 #include <vector>
 
 #include "Firestore/core/src/model/document.h"
@@ -132,6 +133,56 @@ TEST_F(DocumentSetTest, Equality) {
   EXPECT_NE(set1, sorted_set1);
 }
 
+TEST_F(DocumentSetTest, FromDocuments) {
+  DocumentSet set = DocumentSet::FromDocuments(DocComparator("sort"),
+                                               {doc1_, doc2_, doc3_});
+  EXPECT_EQ(set, DocSet(comp_, {doc1_, doc2_, doc3_}));
+  ASSERT_THAT(set, ElementsAre(doc3_, doc1_, doc2_));
+  EXPECT_EQ(set.GetDocument(doc1_->key()), doc1_);
+
+  EXPECT_EQ(DocumentSet::FromDocuments(DocComparator("sort"), {}),
+            DocSet(comp_, {}));
+}
+
+TEST_F(DocumentSetTest, FromManyDocuments) {
+  // Enough documents that the sets are stored as trees.
+  std::vector<Document> docs;
+  DocumentSet expected{DocComparator("sort")};
+  for (int i = 0; i < 100; ++i) {
+    Document doc =
+        Doc("docs/" + std::to_string(i), 0, Map("sort", (i * 37) % 100));
+    docs.push_back(doc);
+    expected = expected.insert(doc);
+  }
+
+  DocumentSet set = DocumentSet::FromDocuments(DocComparator("sort"), docs);
+  EXPECT_EQ(set, expected);
+  for (const Document& doc : docs) {
+    EXPECT_EQ(set.GetDocument(doc->key()), doc);
+  }
+
+  // The set can still be modified.
+  set = set.erase(docs[0]->key()).insert(docs[0]);
+  EXPECT_EQ(set, expected);
+}
+
+TEST_F(DocumentSetTest, FromDocumentsInComparatorOrder) {
+  // Sorted by the comparator rather than by key, as views pass them.
+  std::vector<Document> docs;
+  DocumentSet expected{DocComparator("sort")};
+  for (int i = 0; i < 100; ++i) {
+    Document doc = Doc("docs/" + std::to_string(i), 0, Map("sort", 99 - i));
+    docs.insert(docs.begin(), doc);
+    expected = expected.insert(doc);
+  }
+
+  DocumentSet set = DocumentSet::FromDocuments(DocComparator("sort"), docs);
+  EXPECT_EQ(set, expected);
+  for (const Document& doc : docs) {
+    EXPECT_EQ(set.GetDocument(doc->key()), doc);
+  }
+}
+
 }  // namespace
 }  // namespace model
 }  // namespace firestore
@@ -84,6 +84,23 @@ TEST(DocumentTest, Equality) {
   EXPECT_NE(DeletedDoc("same/path", 1), UnknownDoc("same/path", 1));
 }
 
+TEST(DocumentTest, DocumentsWithoutDataShareEmptyValue) {
+  MutableDocument invalid = MutableDocument::InvalidDocument(Key("a/b"));
+  MutableDocument deleted = DeletedDoc("c/d", 1);
+  EXPECT_EQ(invalid.shared_data(), deleted.shared_data());
+  EXPECT_EQ(invalid.shared_data(), UnknownDoc("e/f", 1).shared_data());
+  EXPECT_EQ(invalid.shared_data(), invalid.Clone().shared_data());
+
+  // Writing to one of them gives it its own value.
+  MutableDocument copy = invalid;
+  invalid.mutable_data().Set(Field("a"), Value(1));
+  EXPECT_EQ(WrapObject("a", 1), invalid.data());
+  EXPECT_EQ(ObjectValue{}, copy.data());
+  EXPECT_EQ(ObjectValue{}, deleted.data());
+  EXPECT_EQ(ObjectValue{},
+            MutableDocument::InvalidDocument(Key("a/b")).data());
+}
+
 }  // namespace model
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/field_mask.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Counts calls to the global `operator new`, which is how documents allocate
+// their values.
+std::atomic<int64_t> allocations{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++allocations;
+  void* result = std::malloc(size == 0 ? 1 : size);
+  if (result == nullptr) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+constexpr int kDocumentCount = 1000;
+
+std::vector<DocumentKey> MakeKeys() {
+  std::vector<DocumentKey> keys;
+  for (int i = 0; i != kDocumentCount; ++i) {
+    keys.push_back(testutil::Key("rooms/room-" + std::to_string(i)));
+  }
+  return keys;
+}
+
+void ReportAllocations(benchmark::State& state, int64_t allocations_before) {
+  state.SetItemsProcessed(state.iterations() * kDocumentCount);
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(allocations - allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+// What `GetAll` does for every missing key.
+void BM_CreateInvalidDocuments(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys();
+  std::vector<MutableDocument> documents;
+  documents.reserve(kDocumentCount);
+
+  int64_t allocations_before = allocations;
+  for (auto _ : state) {
+    documents.clear();
+    for (const DocumentKey& key : keys) {
+      documents.push_back(MutableDocument::InvalidDocument(key));
+    }
+  }
+  ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_CreateInvalidDocuments);
+
+// Applying a patch that requires the document to exist to missing documents,
+// as the local documents view does for every overlay: the patch doesn't
+// apply, so the documents are never written to.
+void BM_ApplyPatchToMissingDocuments(benchmark::State& state) {
+  std::vector<DocumentKey> keys = MakeKeys();
+  std::vector<Mutation> patches;
+  for (const DocumentKey& key : keys) {
+    patches.push_back(testutil::PatchMutation(key.ToString(),
+                                              testutil::Map("count", 1)));
+  }
+
+  int64_t allocations_before = allocations;
+  for (auto _ : state) {
+    for (const Mutation& patch : patches) {
+      MutableDocument document = MutableDocument::InvalidDocument(patch.key());
+      patch.ApplyToLocalView(document, FieldMask(), Timestamp::Now());
+      benchmark::DoNotOptimize(document);
+    }
+  }
+  ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_ApplyPatchToMissingDocuments);
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -16,7 +16,12 @@
 
 #include "Firestore/core/src/model/object_value.h"
 
+#include <cmath>
+#include <memory>
+#include <string>
+
 #include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "gtest/gtest.h"
@@ -31,13 +36,25 @@ const char kBarString[] = "bar";
 namespace {
 
 using absl::nullopt;
+using nanopb::MakeStdString;
+using nanopb::Message;
 using testutil::DbId;
 using testutil::Field;
+using testutil::Key;
 using testutil::Map;
 using testutil::Value;
 using testutil::WrapObject;
 
 class ObjectValueTest : public ::testing::Test {
+ protected:
+  /** Returns an ObjectValue backed by `value` encoded as a Document. */
+  ObjectValue Encoded(const ObjectValue& value) const {
+    Message<google_firestore_v1_Document> document{
+        serializer.EncodeDocument(Key("coll/doc"), value)};
+    auto storage = std::make_shared<const std::string>(MakeStdString(document));
+    return ObjectValue::FromEncodedDocument(storage, *storage);
+  }
+
  private:
   remote::Serializer serializer{DbId()};
 };
@@ -335,6 +352,119 @@ TEST_F(ObjectValueTest, DoesNotRequireSortedInserts) {
   EXPECT_EQ(*Value(2), *object_value.Get(Field("nested.nested.c")));
 }
 
+TEST_F(ObjectValueTest, EqualObjectsHaveEqualFingerprints) {
+  ObjectValue lhs = WrapObject("a", 1, "b", Map("c", kFooString));
+  ObjectValue rhs = WrapObject("b", Map("c", kFooString), "a", 1);
+  EXPECT_EQ(lhs, rhs);
+  EXPECT_EQ(lhs.Fingerprint(), rhs.Fingerprint());
+  EXPECT_EQ(lhs.Hash(), rhs.Hash());
+
+  ObjectValue copy = lhs;
+  EXPECT_EQ(lhs.Fingerprint(), copy.Fingerprint());
+}
+
+TEST_F(ObjectValueTest, FingerprintMatchesNumericEquality) {
+  // Numbers nested in maps compare by numeric value.
+  EXPECT_EQ(WrapObject("a", 1), WrapObject("a", 1.0));
+  EXPECT_EQ(WrapObject("a", 1).Fingerprint(),
+            WrapObject("a", 1.0).Fingerprint());
+  EXPECT_EQ(WrapObject("a", NAN).Fingerprint(),
+            WrapObject("a", NAN).Fingerprint());
+  EXPECT_EQ(WrapObject("a", 0.0).Fingerprint(),
+            WrapObject("a", -0.0).Fingerprint());
+}
+
+TEST_F(ObjectValueTest, FingerprintChangesAfterMutation) {
+  ObjectValue object_value = WrapObject("a", Map("b", kFooString));
+  uint64_t original = object_value.Fingerprint();
+
+  object_value.Set(Field("a.b"), Value(kBarString));
+  EXPECT_NE(original, object_value.Fingerprint());
+  EXPECT_EQ(WrapObject("a", Map("b", kBarString)), object_value);
+  EXPECT_NE(WrapObject("a", Map("b", kFooString)), object_value);
+
+  object_value.Delete(Field("a.b"));
+  EXPECT_EQ(WrapObject("a", Map()).Fingerprint(), object_value.Fingerprint());
+
+  TransformMap data;
+  data[Field("a.b")] = Value(kFooString);
+  object_value.SetAll(std::move(data));
+  EXPECT_EQ(original, object_value.Fingerprint());
+  EXPECT_EQ(WrapObject("a", Map("b", kFooString)), object_value);
+}
+
+TEST_F(ObjectValueTest, ExtractsFieldsFromEncodedDocument) {
+  ObjectValue value =
+      Encoded(WrapObject("foo", Map("a", 1, "b", true), "bar", "string"));
+
+  EXPECT_EQ(*Value(1), *value.Get(Field("foo.a")));
+  EXPECT_EQ(*Value(true), *value.Get(Field("foo.b")));
+  EXPECT_EQ(*Value("string"), *value.Get("bar"));
+
+  EXPECT_EQ(nullopt, value.Get(Field("foo.c")));
+  EXPECT_EQ(nullopt, value.Get(Field("baz")));
+  EXPECT_EQ(nullopt, value.Get("baz"));
+
+  // Fields read before the whole document is decoded stay consistent with it.
+  EXPECT_EQ(WrapObject("foo", Map("a", 1, "b", true), "bar", "string"), value);
+  EXPECT_EQ(*Value(1), *value.Get(Field("foo.a")));
+}
+
+TEST_F(ObjectValueTest, EncodedDocumentEqualsDecodedDocument) {
+  ObjectValue decoded = WrapObject("b", Map("c", kFooString), "a", 1);
+  ObjectValue encoded = Encoded(decoded);
+
+  EXPECT_EQ(decoded.Fingerprint(), encoded.Fingerprint());
+  EXPECT_EQ(decoded.ToString(), encoded.ToString());
+  EXPECT_EQ(decoded.ToFieldMask(), encoded.ToFieldMask());
+  EXPECT_EQ(decoded, ObjectValue{encoded});
+  EXPECT_EQ(Encoded(ObjectValue{}), ObjectValue{});
+}
+
+TEST_F(ObjectValueTest, PrefetchesFieldsOfEncodedDocument) {
+  ObjectValue value =
+      Encoded(WrapObject("a", Map("b", kFooString), "c", 1, "d", true));
+
+  value.PrefetchFields({"a", "c", "missing"});
+  EXPECT_EQ(*Value(kFooString), *value.Get(Field("a.b")));
+  EXPECT_EQ(*Value(1), *value.Get("c"));
+  EXPECT_EQ(*Value(true), *value.Get("d"));
+  EXPECT_EQ(nullopt, value.Get("missing"));
+
+  EXPECT_EQ(WrapObject("a", Map("b", kFooString), "c", 1, "d", true), value);
+  value.PrefetchFields({"d", "e"});
+  EXPECT_EQ(*Value(true), *value.Get("d"));
+}
+
+TEST_F(ObjectValueTest, ModifiesEncodedDocument) {
+  ObjectValue value = Encoded(WrapObject("a", Map("b", kFooString), "c", 1));
+  EXPECT_EQ(*Value(kFooString), *value.Get(Field("a.b")));
+
+  value.Set(Field("a.b"), Value(kBarString));
+  value.Delete(Field("c"));
+
+  EXPECT_EQ(*Value(kBarString), *value.Get(Field("a.b")));
+  EXPECT_EQ(nullopt, value.Get(Field("c")));
+  EXPECT_EQ(WrapObject("a", Map("b", kBarString)), value);
+}
+
+TEST_F(ObjectValueTest, CopiesEncodedDocument) {
+  ObjectValue original = Encoded(WrapObject("a", 1, "b", kFooString));
+  ObjectValue copy{original};
+
+  // The copy decodes independently of the original.
+  copy.Set(Field("a"), Value(2));
+  EXPECT_EQ(*Value(1), *original.Get("a"));
+  EXPECT_EQ(*Value(2), *copy.Get("a"));
+  EXPECT_EQ(WrapObject("a", 1, "b", kFooString), original);
+  EXPECT_EQ(WrapObject("a", 2, "b", kFooString), copy);
+
+  // Copies of a decoded object are deep.
+  ObjectValue second_copy{original};
+  original.Delete(Field("b"));
+  EXPECT_EQ(WrapObject("a", 1, "b", kFooString), second_copy);
+}
+
 }  // namespace
 
 }  // namespace model
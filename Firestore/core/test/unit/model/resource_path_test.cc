@@ -70,6 +70,53 @@ TEST(ResourcePath, Comparison) {
   EXPECT_TRUE(a > empty);
   EXPECT_TRUE(b > a);
   EXPECT_TRUE(ab > a);
+
+  // Segments that differ in length order by their contents, not their sizes.
+  EXPECT_TRUE((ResourcePath{"a", "ab"}) < (ResourcePath{"a", "b"}));
+  EXPECT_TRUE((ResourcePath{"a", "ab"}) < (ResourcePath{"a", "abc"}));
+  const std::string long_segment(300, 'x');
+  EXPECT_TRUE((ResourcePath{"a", long_segment}) <
+              (ResourcePath{"a", long_segment + "x"}));
+  EXPECT_TRUE((ResourcePath{"a", long_segment}) < (ResourcePath{"a", "y"}));
+  EXPECT_TRUE((ResourcePath{"a", "xy"}) > (ResourcePath{"a", long_segment}));
+
+  // Numeric IDs sort before other segments, in numeric order.
+  EXPECT_TRUE((ResourcePath{"a", "__id9__"}) < (ResourcePath{"a", "__id10__"}));
+  EXPECT_TRUE((ResourcePath{"a", "__id10__"}) < (ResourcePath{"a", "0"}));
+
+  // Derived paths compare by their own segments.
+  const ResourcePath path{"rooms", "a", "rooms", "b"};
+  EXPECT_EQ(path.PopFirst(2), (ResourcePath{"rooms", "b"}));
+  EXPECT_TRUE(path.PopFirst(2) > path.PopLast().PopLast());
+  EXPECT_TRUE(path.PopFirst(2) > path);
+}
+
+TEST(ResourcePath, DerivedPaths) {
+  const ResourcePath path{"rooms", "Eros", "messages", "1"};
+  const ResourcePath parent = path.PopLast();
+  const ResourcePath tail = path.PopFirst(2);
+
+  EXPECT_EQ(parent, (ResourcePath{"rooms", "Eros", "messages"}));
+  EXPECT_EQ(parent.Hash(), (ResourcePath{"rooms", "Eros", "messages"}).Hash());
+  EXPECT_EQ(tail, (ResourcePath{"messages", "1"}));
+  EXPECT_EQ(tail.Hash(), (ResourcePath{"messages", "1"}).Hash());
+  EXPECT_EQ(path.PopFirst(4), ResourcePath{});
+  EXPECT_EQ(path.PopFirst(4).Hash(), ResourcePath{}.Hash());
+
+  EXPECT_TRUE(parent.IsPrefixOf(path));
+  EXPECT_TRUE(parent.IsImmediateParentOf(path));
+  EXPECT_FALSE(path.IsPrefixOf(parent));
+  EXPECT_FALSE(tail.IsPrefixOf(path));
+  EXPECT_TRUE(parent < path);
+  EXPECT_TRUE(path > parent);
+  EXPECT_TRUE(tail < path);
+
+  EXPECT_EQ(parent.Append("2"),
+            (ResourcePath{"rooms", "Eros", "messages", "2"}));
+  EXPECT_EQ(tail.Append(parent),
+            (ResourcePath{"messages", "1", "rooms", "Eros", "messages"}));
+  // Deriving paths leaves the original untouched.
+  EXPECT_EQ(path, (ResourcePath{"rooms", "Eros", "messages", "1"}));
 }
 
 TEST(ResourcePath, Parsing) {
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/nanopb/byte_string.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/json_reader.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/escaping.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using nanopb::ByteString;
+using nlohmann::json;
+using util::JsonReader;
+using util::Path;
+using util::StatusOr;
+
+const char* kDocumentsPath =
+    "projects/project-1/databases/database-1/documents/";
+
+/**
+ * Loads the golden test bloom filter that the backend built from `count`
+ * document paths, with a false positive rate of 1%.
+ */
+BloomFilter LoadGoldenBloomFilter(int64_t count) {
+  Path file_path = Path::FromUtf8(__FILE__).Dirname().AppendUtf8(
+      "bloom_filter_golden_test_data/Validation_BloomFilterTest_MD5_" +
+      std::to_string(count) + "_01_bloom_filter_proto.json");
+  std::ifstream stream(file_path.native_value());
+  HARD_ASSERT(stream.good(), "Failed to open %s", file_path.ToUtf8String());
+  json test_file = json::parse(stream);
+
+  JsonReader reader;
+  json bits = reader.OptionalObject("bits", test_file, {});
+  std::string bitmap = reader.OptionalString("bitmap", bits, "");
+  int padding = reader.OptionalInt("padding", bits, 0);
+  int hash_count = reader.OptionalInt("hashCount", test_file, 0);
+  std::string decoded;
+  absl::Base64Unescape(bitmap, &decoded);
+
+  StatusOr<BloomFilter> bloom_filter =
+      BloomFilter::Create(ByteString{decoded}, padding, hash_count);
+  HARD_ASSERT(bloom_filter.ok(), "Invalid bloom filter: %s",
+              bloom_filter.status().error_message());
+  return std::move(bloom_filter).ValueOrDie();
+}
+
+/**
+ * The keys checked by the golden test: the `count` documents in the filter,
+ * followed by as many that are not.
+ */
+std::vector<std::string> MakeKeyPaths(int64_t count) {
+  std::vector<std::string> key_paths;
+  for (int64_t i = 0; i < 2 * count; ++i) {
+    key_paths.push_back("coll/doc" + std::to_string(i));
+  }
+  return key_paths;
+}
+
+// Checks the keys one by one, as existence filter mismatches used to.
+void BM_MightContain(benchmark::State& state) {
+  BloomFilter bloom_filter = LoadGoldenBloomFilter(state.range(0));
+  std::vector<std::string> key_paths = MakeKeyPaths(state.range(0));
+
+  for (auto _ : state) {
+    int matches = 0;
+    for (const std::string& key_path : key_paths) {
+      if (bloom_filter.MightContain(kDocumentsPath + key_path)) ++matches;
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * key_paths.size());
+}
+BENCHMARK(BM_MightContain)->Arg(500)->Arg(5000)->Arg(50000);
+
+void BM_MightContainAll(benchmark::State& state) {
+  BloomFilter bloom_filter = LoadGoldenBloomFilter(state.range(0));
+  std::vector<std::string> key_paths = MakeKeyPaths(state.range(0));
+
+  for (auto _ : state) {
+    std::vector<bool> results =
+        bloom_filter.MightContainAll(kDocumentsPath, key_paths);
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * key_paths.size());
+}
+BENCHMARK(BM_MightContainAll)->Arg(500)->Arg(5000)->Arg(50000);
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -18,6 +18,8 @@
 
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "Firestore/core/src/util/filesystem.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -200,6 +202,20 @@ TEST(BloomFilterUnitTest, MightContainOnEmptyBloomFilterShouldReturnFalse) {
   EXPECT_FALSE(bloom_filter.MightContain("a"));
 }
 
+TEST(BloomFilterUnitTest, MightContainAllOnEmptyBloomFilterShouldReturnFalse) {
+  BloomFilter bloom_filter(ByteString{}, 0, 0);
+  EXPECT_EQ(bloom_filter.MightContainAll("", {"", "a"}),
+            (std::vector<bool>{false, false}));
+}
+
+TEST(BloomFilterTest, MightContainAllMatchesMightContain) {
+  // A non-empty BloomFilter object with 1 insertion : "ÀÒ∑"
+  BloomFilter bloom_filter(ByteString{237, 5}, 5, 8);
+  EXPECT_EQ(bloom_filter.MightContainAll("À", {"Ò∑", "∑Ò", ""}),
+            (std::vector<bool>{true, false, false}));
+  EXPECT_TRUE(bloom_filter.MightContainAll("", {}).empty());
+}
+
 TEST(BloomFilterUnitTest,
      MightContainWithEmptyStringMightReturnFalsePositiveResult) {
   {
@@ -218,12 +234,22 @@ class BloomFilterGoldenTest : public ::testing::Test {
     BloomFilter bloom_filter = LoadBloomFilter(test_file);
     std::string membership_result = LoadMembershipResult(test_file);
 
+    std::vector<std::string> suffixes;
     for (size_t i = 0; i < membership_result.length(); i++) {
       bool expectedResult = membership_result[i] == '1';
       bool mightContainResult =
           bloom_filter.MightContain(kGoldenDocumentPrefix + std::to_string(i));
 
       EXPECT_EQ(mightContainResult, expectedResult);
+      suffixes.push_back(std::to_string(i));
+    }
+
+    // The batched check must agree with the individual checks.
+    std::vector<bool> mightContainAllResult =
+        bloom_filter.MightContainAll(kGoldenDocumentPrefix, suffixes);
+    ASSERT_EQ(mightContainAllResult.size(), membership_result.length());
+    for (size_t i = 0; i < membership_result.length(); i++) {
+      EXPECT_EQ(mightContainAllResult[i], membership_result[i] == '1');
     }
   }
 
@@ -308,6 +308,68 @@ TEST_F(DatastoreTest, LookupDocumentsTwoSuccessfulReads) {
   EXPECT_TRUE(resulting_status.ok());
 }
 
+TEST_F(DatastoreTest, LookupDocumentsDeliversEachDocument) {
+  std::vector<std::string> delivered_keys;
+  int finish_count = 0;
+  Status resulting_status;
+  datastore->LookupDocuments(
+      {model::DocumentKey::FromPathString("foo/2"),
+       model::DocumentKey::FromPathString("foo/1")},
+      [&](Document doc) {
+        delivered_keys.push_back(doc->key().ToString());
+        return Status::OK();
+      },
+      [&](const Status& status) {
+        ++finish_count;
+        resulting_status = status;
+      });
+  // Make sure Auth has a chance to run.
+  worker_queue->EnqueueBlocking([] {});
+
+  ForceFinishAnyTypeOrder(
+      {{Type::Write, CompletionResult::Ok},
+       {Type::Read, MakeFakeDocument("foo/2")},
+       {Type::Read, MakeFakeDocument("foo/1")},
+       /*Read after last*/ {Type::Read, CompletionResult::Error}});
+  ForceFinish({{Type::Finish, grpc::Status::OK}});
+
+  // Documents are delivered in the order they arrive rather than sorted.
+  EXPECT_EQ(delivered_keys, (std::vector<std::string>{"foo/2", "foo/1"}));
+  EXPECT_EQ(finish_count, 1);
+  EXPECT_TRUE(resulting_status.ok());
+}
+
+TEST_F(DatastoreTest, LookupDocumentsStopsDeliveringAfterCallbackError) {
+  std::vector<std::string> delivered_keys;
+  int finish_count = 0;
+  Status resulting_status;
+  datastore->LookupDocuments(
+      {model::DocumentKey::FromPathString("foo/1"),
+       model::DocumentKey::FromPathString("foo/2")},
+      [&](Document doc) {
+        delivered_keys.push_back(doc->key().ToString());
+        // The call will be finished right away and block until it's
+        // completed, so asynchronously polling gRPC queue is necessary.
+        fake_grpc_queue.KeepPolling();
+        return Status{Error::kErrorAborted, "Rejected"};
+      },
+      [&](const Status& status) {
+        ++finish_count;
+        resulting_status = status;
+      });
+  // Make sure Auth has a chance to run.
+  worker_queue->EnqueueBlocking([] {});
+
+  // The second document is never read: the call doesn't wait for the server
+  // to finish.
+  ForceFinishAnyTypeOrder({{Type::Write, CompletionResult::Ok},
+                           {Type::Read, MakeFakeDocument("foo/1")}});
+
+  EXPECT_EQ(delivered_keys, std::vector<std::string>{"foo/1"});
+  EXPECT_EQ(finish_count, 1);
+  EXPECT_EQ(resulting_status.code(), Error::kErrorAborted);
+}
+
 // gRPC errors
 
 TEST_F(DatastoreTest, CommitMutationsError) {
@@ -0,0 +1,357 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Firestore/core/src/api/settings.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/grpc_connection.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/generic/async_generic_service.h"
+#include "grpcpp/security/server_credentials.h"
+#include "grpcpp/server.h"
+#include "grpcpp/server_builder.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using api::Settings;
+using core::DatabaseInfo;
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using model::DatabaseId;
+using model::Mutation;
+using util::AsyncQueue;
+using util::Status;
+
+/**
+ * A gRPC server on the loopback interface that accepts any call, reads the
+ * request, and replies with an empty message.
+ */
+class LoopbackServer {
+ public:
+  LoopbackServer() {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(),
+                             &port_);
+    builder.RegisterAsyncGenericService(&service_);
+    queue_ = builder.AddCompletionQueue();
+    server_ = builder.BuildAndStart();
+    HARD_ASSERT(server_ && port_ != 0, "Failed to start the loopback server");
+    thread_ = std::thread([this] { Serve(); });
+  }
+
+  ~LoopbackServer() {
+    server_->Shutdown();
+    queue_->Shutdown();
+    thread_.join();
+  }
+
+  int port() const {
+    return port_;
+  }
+
+ private:
+  void Serve() {
+    grpc::Slice empty{std::string{}};
+    grpc::ByteBuffer reply{&empty, 1};
+
+    while (true) {
+      grpc::GenericServerContext context;
+      grpc::GenericServerAsyncReaderWriter stream(&context);
+      service_.RequestCall(&context, &stream, queue_.get(), queue_.get(),
+                           this);
+      if (!Await()) {
+        break;
+      }
+
+      grpc::ByteBuffer request;
+      stream.Read(&request, this);
+      if (Await()) {
+        stream.WriteAndFinish(reply, grpc::WriteOptions{}, grpc::Status::OK,
+                              this);
+      } else {
+        stream.Finish(grpc::Status::CANCELLED, this);
+      }
+      Await();
+    }
+
+    // Drain the queue so that it can be destroyed.
+    void* tag = nullptr;
+    bool ok = false;
+    while (queue_->Next(&tag, &ok)) {
+    }
+  }
+
+  bool Await() {
+    void* tag = nullptr;
+    bool ok = false;
+    return queue_->Next(&tag, &ok) && ok;
+  }
+
+  int port_ = 0;
+  grpc::AsyncGenericService service_;
+  std::unique_ptr<grpc::ServerCompletionQueue> queue_;
+  std::unique_ptr<grpc::Server> server_;
+  std::thread thread_;
+};
+
+/**
+ * Relays TCP connections from its own loopback port to the given port,
+ * counting the bytes the client sends. These are the bytes on the wire:
+ * compressed messages plus HTTP/2 framing and headers.
+ */
+class CountingProxy {
+ public:
+  explicit CountingProxy(int target_port) : target_port_{target_port} {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = LoopbackAddress(0);
+    int bound = bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+                     sizeof(address));
+    HARD_ASSERT(bound == 0 && listen(listen_fd_, 8) == 0,
+                "Failed to start the proxy");
+
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    accept_thread_ = std::thread([this] { Accept(); });
+  }
+
+  ~CountingProxy() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      shutting_down_ = true;
+      for (int fd : fds_) {
+        shutdown(fd, SHUT_RDWR);
+      }
+    }
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+
+    // Connection threads are only started by the accepting thread.
+    accept_thread_.join();
+    for (std::thread& thread : connection_threads_) {
+      thread.join();
+    }
+    for (int fd : fds_) {
+      close(fd);
+    }
+  }
+
+  int port() const {
+    return port_;
+  }
+
+  int64_t bytes_sent() const {
+    return bytes_sent_;
+  }
+
+ private:
+  static sockaddr_in LoopbackAddress(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    return address;
+  }
+
+  void Accept() {
+    while (true) {
+      int client_fd = accept(listen_fd_, nullptr, nullptr);
+      if (client_fd < 0) {
+        return;
+      }
+
+      int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+      sockaddr_in address = LoopbackAddress(target_port_);
+      if (connect(server_fd, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) != 0) {
+        close(client_fd);
+        close(server_fd);
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock{mutex_};
+      fds_.push_back(client_fd);
+      fds_.push_back(server_fd);
+      if (shutting_down_) {
+        shutdown(client_fd, SHUT_RDWR);
+        shutdown(server_fd, SHUT_RDWR);
+      }
+      connection_threads_.emplace_back(
+          [this, client_fd, server_fd] { Pump(client_fd, server_fd, true); });
+      connection_threads_.emplace_back(
+          [this, client_fd, server_fd] { Pump(server_fd, client_fd, false); });
+    }
+  }
+
+  void Pump(int from_fd, int to_fd, bool count) {
+    char buffer[16 * 1024];
+    while (true) {
+      ssize_t received = read(from_fd, buffer, sizeof(buffer));
+      if (received <= 0) {
+        break;
+      }
+      if (count) {
+        bytes_sent_ += received;
+      }
+      for (ssize_t written = 0; written < received;) {
+        ssize_t n = write(to_fd, buffer + written, received - written);
+        if (n <= 0) {
+          shutdown(from_fd, SHUT_RDWR);
+          return;
+        }
+        written += n;
+      }
+    }
+    shutdown(to_fd, SHUT_WR);
+  }
+
+  int target_port_ = 0;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<int64_t> bytes_sent_{0};
+
+  std::mutex mutex_;
+  bool shutting_down_ = false;
+  std::vector<int> fds_;
+  std::thread accept_thread_;
+  std::vector<std::thread> connection_threads_;
+};
+
+/**
+ * A write of `size_bytes` of document data that compresses about as well as
+ * typical user data: the same few keys recur, and the values are text.
+ */
+std::vector<Mutation> MakeWrite(int64_t size_bytes) {
+  const std::string text =
+      "The quick brown fox jumps over the lazy dog while the dog sleeps. ";
+  std::vector<Mutation> mutations;
+  for (int64_t written = 0, i = 0; written < size_bytes; ++i) {
+    mutations.push_back(testutil::SetMutation(
+        "messages/message-" + std::to_string(i),
+        testutil::Map("author", "user-" + std::to_string(i % 7), "text", text,
+                      "likes", i % 100, "pinned", i % 2 == 0)));
+    written += static_cast<int64_t>(text.size()) + 64;
+  }
+  return mutations;
+}
+
+void BM_CommitOverLoopback(benchmark::State& state) {
+  auto compression = static_cast<Settings::MessageCompression>(state.range(0));
+  int64_t write_size = state.range(1);
+
+  LoopbackServer server;
+  CountingProxy proxy{server.port()};
+  std::string host = "127.0.0.1:" + std::to_string(proxy.port());
+  GrpcConnection::UseInsecureChannel(host);
+
+  DatabaseInfo database_info{DatabaseId{"p", "d"}, "", host, false};
+  std::shared_ptr<AsyncQueue> worker_queue = testutil::AsyncQueueForTesting();
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor =
+      CreateNoOpConnectivityMonitor();
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider =
+      CreateFirebaseMetadataProviderNoOp();
+  auto datastore = std::make_shared<Datastore>(
+      database_info, worker_queue,
+      std::make_shared<EmptyAuthCredentialsProvider>(),
+      std::make_shared<EmptyAppCheckCredentialsProvider>(),
+      connectivity_monitor.get(), firebase_metadata_provider.get());
+  datastore->EnableMessageCompression(
+      compression,
+      static_cast<size_t>(Settings::DefaultMessageCompressionThresholdBytes));
+  datastore->Start();
+
+  std::vector<Mutation> write = MakeWrite(write_size);
+
+  auto commit = [&] {
+    std::promise<Status> done;
+    worker_queue->Enqueue([&] {
+      datastore->CommitMutations(
+          write, [&](const Status& status) { done.set_value(status); });
+    });
+    Status status = done.get_future().get();
+    HARD_ASSERT(status.ok(), "Commit failed: %s", status.ToString());
+  };
+
+  // Establish the connection before measuring.
+  commit();
+  int64_t bytes_before = proxy.bytes_sent();
+
+  for (auto _ : state) {
+    commit();
+  }
+
+  state.SetBytesProcessed(state.iterations() * write_size);
+  state.counters["wire_bytes_per_commit"] = benchmark::Counter(
+      static_cast<double>(proxy.bytes_sent() - bytes_before),
+      benchmark::Counter::kAvgIterations);
+
+  worker_queue->EnqueueBlocking([&] { datastore->Shutdown(); });
+}
+
+// Each commit is measured uncompressed, with gzip and with deflate, for writes
+// below the compression threshold, of a typical size, and large.
+void CommitArguments(benchmark::internal::Benchmark* b) {
+  for (Settings::MessageCompression compression :
+       {Settings::MessageCompression::kNone,
+        Settings::MessageCompression::kGzip,
+        Settings::MessageCompression::kDeflate}) {
+    for (int64_t write_size : {512, 16 * 1024, 256 * 1024}) {
+      b->Args({static_cast<int64_t>(compression), write_size});
+    }
+  }
+}
+
+// Compression happens off the benchmark thread, so count the CPU time of the
+// whole process.
+BENCHMARK(BM_CommitOverLoopback)
+    ->Apply(CommitArguments)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -231,6 +231,20 @@ TEST_F(GrpcConnectionTest, ShutdownFastFinishesActiveCalls) {
   EXPECT_NO_THROW(baz.reset());
 }
 
+TEST_F(GrpcConnectionTest, SkipsCompressionOnlyForMessagesBelowThreshold) {
+  GrpcConnection* connection = tester.grpc_connection();
+  grpc::ByteBuffer small_message = MakeByteBuffer(std::string(99, 'a'));
+  grpc::ByteBuffer large_message = MakeByteBuffer(std::string(100, 'a'));
+
+  // Without compression, there is nothing to skip.
+  EXPECT_FALSE(connection->ShouldSkipCompression(small_message));
+  EXPECT_FALSE(connection->ShouldSkipCompression(large_message));
+
+  connection->EnableMessageCompression(GRPC_COMPRESS_GZIP, 100);
+  EXPECT_TRUE(connection->ShouldSkipCompression(small_message));
+  EXPECT_FALSE(connection->ShouldSkipCompression(large_message));
+}
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
@@ -16,6 +16,7 @@
 
 #include <initializer_list>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -177,6 +178,75 @@ TEST_F(GrpcStreamingReaderTest, TwoSuccessfulReads) {
   EXPECT_EQ(ByteBufferToString(responses[1]), std::string{"bar"});
 }
 
+TEST_F(GrpcStreamingReaderTest, DeliversEachMessageAsItIsRead) {
+  std::vector<std::string> messages;
+  bool responses_callback_fired = false;
+  worker_queue->EnqueueBlocking([&] {
+    reader->Start(
+        util::StatusOr<size_t>(2),
+        [&](const grpc::ByteBuffer& message) {
+          messages.push_back(ByteBufferToString(message));
+          return Status::OK();
+        },
+        [&](std::vector<ResponsesT> result) {
+          responses_callback_fired = true;
+          responses = std::move(result);
+        },
+        [&](const util::Status& st, bool) { status = st; });
+  });
+
+  ForceFinishAnyTypeOrder({
+      {Type::Write, CompletionResult::Ok},
+      {Type::Read, MakeByteBuffer("foo")},
+      {Type::Read, MakeByteBuffer("bar")},
+      /*Read after last*/ {Type::Read, CompletionResult::Error},
+  });
+  EXPECT_FALSE(status.has_value());
+  EXPECT_TRUE(responses_callback_fired);
+
+  ForceFinish({{Type::Finish, grpc::Status::OK}});
+
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status.value(), Status::OK());
+  EXPECT_EQ(messages, (std::vector<std::string>{"foo", "bar"}));
+  // Messages delivered one by one are not accumulated.
+  EXPECT_TRUE(responses.empty());
+}
+
+TEST_F(GrpcStreamingReaderTest, FinishesWhenMessageIsRejected) {
+  std::vector<std::string> messages;
+  bool responses_callback_fired = false;
+  bool close_callback_fired = false;
+  worker_queue->EnqueueBlocking([&] {
+    reader->Start(
+        util::StatusOr<size_t>(2),
+        [&](const grpc::ByteBuffer& message) {
+          messages.push_back(ByteBufferToString(message));
+          // The reader will issue a finish operation and block until it's
+          // completed, so asynchronously polling gRPC queue is necessary.
+          KeepPollingGrpcQueue();
+          return Status{Error::kErrorDataLoss, "Rejected"};
+        },
+        [&](std::vector<ResponsesT>) { responses_callback_fired = true; },
+        [&](const util::Status& st, bool callback_fired) {
+          close_callback_fired = true;
+          status = st;
+          EXPECT_FALSE(callback_fired);
+        });
+  });
+
+  ForceFinishAnyTypeOrder({
+      {Type::Write, CompletionResult::Ok},
+      {Type::Read, MakeByteBuffer("foo")},
+  });
+
+  EXPECT_TRUE(close_callback_fired);
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status.value().code(), Error::kErrorDataLoss);
+  EXPECT_EQ(messages, std::vector<std::string>{"foo"});
+  EXPECT_FALSE(responses_callback_fired);
+}
+
 TEST_F(GrpcStreamingReaderTest, FinishWhileReading) {
   StartReader(util::StatusOr<size_t>(1));
 
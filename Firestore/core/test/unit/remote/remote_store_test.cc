@@ -0,0 +1,383 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/remote_store.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/write_stream.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using core::DatabaseInfo;
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using credentials::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using model::BatchId;
+using model::DatabaseId;
+using model::DocumentKeySet;
+using model::Mutation;
+using model::MutationBatchResult;
+using model::MutationResult;
+using model::OnlineState;
+using model::TargetId;
+using testing::ElementsAre;
+using testutil::Map;
+using testutil::SetMutation;
+using util::AsyncQueue;
+using util::Status;
+
+/**
+ * A write stream that never touches the network. The stream opens on the next
+ * turn of the worker queue, the handshake completes immediately, and requests
+ * are only answered when the test says so.
+ */
+class FakeWriteStream : public WriteStream {
+ public:
+  FakeWriteStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  Serializer serializer,
+                  GrpcConnection* grpc_connection,
+                  WriteStreamCallback* callback)
+      : WriteStream{worker_queue,
+                    std::make_shared<EmptyAuthCredentialsProvider>(),
+                    std::make_shared<EmptyAppCheckCredentialsProvider>(),
+                    std::move(serializer),
+                    grpc_connection,
+                    callback},
+        worker_queue_{worker_queue},
+        callback_{callback} {
+  }
+
+  void Start() override {
+    started_ = true;
+    SetHandshakeComplete(false);
+    worker_queue_->EnqueueRelaxed([this] {
+      if (started_) {
+        open_ = true;
+        callback_->OnWriteStreamOpen();
+      }
+    });
+  }
+
+  void Stop() override {
+    started_ = false;
+    open_ = false;
+    SetHandshakeComplete(false);
+    CancelIdleCheck();
+  }
+
+  bool IsStarted() const override {
+    return started_;
+  }
+  bool IsOpen() const override {
+    return open_;
+  }
+
+  void WriteHandshake() override {
+    SetHandshakeComplete();
+    callback_->OnWriteStreamHandshakeComplete();
+  }
+
+  void WriteMutations(const std::vector<Mutation>& mutations) override {
+    requests_.push_back(mutations.size());
+  }
+
+  /**
+   * Acknowledges the oldest unanswered request with `result_count` results,
+   * whose versions count up from 1 second.
+   */
+  void Acknowledge(size_t result_count) {
+    std::vector<MutationResult> results;
+    for (size_t i = 0; i != result_count; ++i) {
+      results.emplace_back(
+          testutil::Version(static_cast<int64_t>(i) + 1, 0),
+          nanopb::Message<google_firestore_v1_ArrayValue>{});
+    }
+    callback_->OnWriteStreamMutationResult(testutil::Version(1, 0),
+                                           std::move(results));
+  }
+
+  /** Closes the stream with the given error, as the backend would. */
+  void Fail(const Status& status) {
+    started_ = false;
+    open_ = false;
+    callback_->OnWriteStreamClose(status);
+  }
+
+  /** The number of mutations in each request sent so far. */
+  const std::vector<size_t>& requests() const {
+    return requests_;
+  }
+
+ private:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  WriteStreamCallback* callback_ = nullptr;
+  bool started_ = false;
+  bool open_ = false;
+  std::vector<size_t> requests_;
+};
+
+class FakeDatastore : public Datastore {
+ public:
+  FakeDatastore(const DatabaseInfo& database_info,
+                const std::shared_ptr<AsyncQueue>& worker_queue,
+                ConnectivityMonitor* connectivity_monitor,
+                FirebaseMetadataProvider* firebase_metadata_provider)
+      : Datastore{database_info,
+                  worker_queue,
+                  std::make_shared<EmptyAuthCredentialsProvider>(),
+                  std::make_shared<EmptyAppCheckCredentialsProvider>(),
+                  connectivity_monitor,
+                  firebase_metadata_provider},
+        database_id_{database_info.database_id()},
+        worker_queue_{worker_queue} {
+  }
+
+  std::shared_ptr<WriteStream> CreateWriteStream(
+      WriteStreamCallback* callback) override {
+    write_stream_ = std::make_shared<FakeWriteStream>(
+        worker_queue_, Serializer{database_id_}, grpc_connection(), callback);
+    return write_stream_;
+  }
+
+  FakeWriteStream& write_stream() {
+    return *write_stream_;
+  }
+
+ private:
+  DatabaseId database_id_;
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::shared_ptr<FakeWriteStream> write_stream_;
+};
+
+/**
+ * Stands in for the `SyncEngine`: settles batches in the `LocalStore` and
+ * records how each of them was settled.
+ */
+class RecordingCallback : public RemoteStoreCallback {
+ public:
+  explicit RecordingCallback(LocalStore* local_store)
+      : local_store_{local_store} {
+  }
+
+  void ApplyRemoteEvent(const RemoteEvent&) override {
+  }
+  void HandleRejectedListen(TargetId, Status) override {
+  }
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+  DocumentKeySet GetRemoteKeys(TargetId) const override {
+    return {};
+  }
+
+  void HandleSuccessfulWrite(MutationBatchResult batch_result) override {
+    acknowledged_batches.push_back(batch_result.batch().batch_id());
+    std::vector<int64_t> versions;
+    for (const MutationResult& result : batch_result.mutation_results()) {
+      versions.push_back(result.version().timestamp().seconds());
+    }
+    result_versions.push_back(std::move(versions));
+    local_store_->AcknowledgeBatch(batch_result);
+  }
+
+  void HandleRejectedWrite(BatchId batch_id, Status) override {
+    rejected_batches.push_back(batch_id);
+    local_store_->RejectBatch(batch_id);
+  }
+
+  std::vector<BatchId> acknowledged_batches;
+  // For each acknowledged batch, the versions of the results it received.
+  std::vector<std::vector<int64_t>> result_versions;
+  std::vector<BatchId> rejected_batches;
+
+ private:
+  LocalStore* local_store_ = nullptr;
+};
+
+}  // namespace
+
+class RemoteStoreTest : public testing::Test {
+ public:
+  RemoteStoreTest()
+      : worker_queue_{testutil::AsyncQueueForTesting()},
+        persistence_{local::MemoryPersistenceWithEagerGcForTesting()},
+        local_store_{persistence_.get(), &query_engine_,
+                     User::Unauthenticated()},
+        connectivity_monitor_{CreateNoOpConnectivityMonitor()},
+        firebase_metadata_provider_{CreateFirebaseMetadataProviderNoOp()},
+        datastore_{std::make_shared<FakeDatastore>(
+            DatabaseInfo{DatabaseId{"p", "d"}, "", "localhost", false},
+            worker_queue_,
+            connectivity_monitor_.get(),
+            firebase_metadata_provider_.get())},
+        callback_{&local_store_} {
+    worker_queue_->EnqueueBlocking([&] {
+      local_store_.Start();
+      remote_store_ = absl::make_unique<RemoteStore>(
+          &local_store_, datastore_, worker_queue_,
+          connectivity_monitor_.get(), [](OnlineState) {});
+      remote_store_->set_sync_engine(&callback_);
+    });
+  }
+
+  ~RemoteStoreTest() override {
+    worker_queue_->EnqueueBlocking([&] {
+      remote_store_->Shutdown();
+      remote_store_.reset();
+    });
+  }
+
+ protected:
+  BatchId WriteLocally(std::vector<Mutation> mutations) {
+    BatchId batch_id = 0;
+    worker_queue_->EnqueueBlocking([&] {
+      batch_id = local_store_.WriteLocally(std::move(mutations)).batch_id();
+    });
+    return batch_id;
+  }
+
+  /** Starts the remote store and waits for the write stream to open. */
+  void Start() {
+    worker_queue_->EnqueueBlocking([&] { remote_store_->Start(); });
+    worker_queue_->EnqueueBlocking([] {});
+  }
+
+  void EnableWriteBatchCoalescing(size_t max_request_bytes) {
+    worker_queue_->EnqueueBlocking([&] {
+      remote_store_->EnableWriteBatchCoalescing(max_request_bytes);
+    });
+  }
+
+  FakeWriteStream& write_stream() {
+    return datastore_->write_stream();
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<Persistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider_;
+  std::shared_ptr<FakeDatastore> datastore_;
+  RecordingCallback callback_;
+  std::unique_ptr<RemoteStore> remote_store_;
+};
+
+TEST_F(RemoteStoreTest, SendsEachBatchInItsOwnRequestByDefault) {
+  WriteLocally({SetMutation("coll/a", Map("value", 1))});
+  WriteLocally({SetMutation("coll/b", Map("value", 2))});
+  WriteLocally({SetMutation("coll/c", Map("value", 3))});
+
+  Start();
+
+  EXPECT_THAT(write_stream().requests(), ElementsAre(1, 1, 1));
+}
+
+TEST_F(RemoteStoreTest, CoalescesBatchesUpToTheByteBudget) {
+  WriteLocally({SetMutation("coll/a", Map("value", 1))});
+  WriteLocally({SetMutation("coll/b", Map("value", 2))});
+  WriteLocally({SetMutation("coll/c", Map("value", 3))});
+
+  // All three batches encode to the same size, so only two fit.
+  size_t batch_bytes = write_stream().CalculateByteSize(
+      {SetMutation("coll/a", Map("value", 1))});
+  EnableWriteBatchCoalescing(2 * batch_bytes);
+  Start();
+
+  EXPECT_THAT(write_stream().requests(), ElementsAre(2, 1));
+}
+
+TEST_F(RemoteStoreTest, SplitsCoalescedResultsPerBatch) {
+  BatchId first = WriteLocally({SetMutation("coll/a", Map("value", 1))});
+  BatchId second = WriteLocally({SetMutation("coll/b", Map("value", 2)),
+                                 SetMutation("coll/c", Map("value", 3))});
+
+  EnableWriteBatchCoalescing(64 * 1024);
+  Start();
+  ASSERT_THAT(write_stream().requests(), ElementsAre(3));
+
+  worker_queue_->EnqueueBlocking([&] { write_stream().Acknowledge(3); });
+
+  EXPECT_THAT(callback_.acknowledged_batches, ElementsAre(first, second));
+  EXPECT_THAT(callback_.result_versions,
+              ElementsAre(ElementsAre(1), ElementsAre(2, 3)));
+  EXPECT_TRUE(callback_.rejected_batches.empty());
+}
+
+TEST_F(RemoteStoreTest, ResendsRejectedCoalescedBatchesOnePerRequest) {
+  BatchId first = WriteLocally({SetMutation("coll/a", Map("value", 1))});
+  BatchId second = WriteLocally({SetMutation("coll/b", Map("value", 2))});
+
+  EnableWriteBatchCoalescing(64 * 1024);
+  Start();
+  ASSERT_THAT(write_stream().requests(), ElementsAre(2));
+
+  // Nothing is rejected yet: the batch at fault is unknown.
+  Status rejection{Error::kErrorInvalidArgument, "Invalid write"};
+  worker_queue_->EnqueueBlocking([&] { write_stream().Fail(rejection); });
+  worker_queue_->EnqueueBlocking([] {});
+  EXPECT_TRUE(callback_.rejected_batches.empty());
+  ASSERT_THAT(write_stream().requests(), ElementsAre(2, 1, 1));
+
+  // Now only the first batch is rejected, and the second one is resent.
+  worker_queue_->EnqueueBlocking([&] { write_stream().Fail(rejection); });
+  worker_queue_->EnqueueBlocking([] {});
+  EXPECT_THAT(callback_.rejected_batches, ElementsAre(first));
+  ASSERT_THAT(write_stream().requests(), ElementsAre(2, 1, 1, 1));
+
+  worker_queue_->EnqueueBlocking([&] { write_stream().Acknowledge(1); });
+  EXPECT_THAT(callback_.acknowledged_batches, ElementsAre(second));
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/remote/stream.h"
 
+#include <future>
 #include <initializer_list>
 #include <memory>
 #include <string>
@@ -180,6 +181,12 @@ class StreamTest : public testing::Test {
     tester.KeepPollingGrpcQueue();
   }
 
+  void DecodeResponsesOffQueue() {
+    decode_queue = testutil::AsyncQueueForTesting();
+    worker_queue->EnqueueBlocking(
+        [&] { firestore_stream->DecodeResponsesOn(decode_queue); });
+  }
+
   void StartStream() {
     worker_queue->EnqueueBlocking([&] { firestore_stream->Start(); });
     worker_queue->EnqueueBlocking([] {});
@@ -196,6 +203,7 @@ class StreamTest : public testing::Test {
   }
 
   std::shared_ptr<AsyncQueue> worker_queue;
+  std::shared_ptr<AsyncQueue> decode_queue;
 
   std::unique_ptr<ConnectivityMonitor> connectivity_monitor;
   GrpcStreamTester tester;
@@ -543,6 +551,93 @@ TEST_F(StreamTest, ClientSideErrorOnRead) {
   });
 }
 
+// Decoding off the worker queue
+
+TEST_F(StreamTest, HandlesResponsesDecodedOffQueueInOrder) {
+  DecodeResponsesOffQueue();
+  StartStream();
+
+  ForceFinish({
+      {Type::Read, MakeByteBuffer("foo")},
+      {Type::Read, MakeByteBuffer("bar")},
+  });
+  decode_queue->EnqueueBlocking([] {});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_TRUE(firestore_stream->IsOpen());
+    EXPECT_EQ(observed_states(),
+              States({"NotifyStreamOpen", "NotifyStreamResponse(foo)",
+                      "NotifyStreamResponse(bar)"}));
+  });
+}
+
+TEST_F(StreamTest, DropsResponsesDecodedAfterStop) {
+  DecodeResponsesOffQueue();
+  StartStream();
+
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  decode_queue->Enqueue([unblocked] { unblocked.wait(); });
+
+  ForceFinish({{Type::Read, MakeByteBuffer("foo")}});
+  worker_queue->EnqueueBlocking([&] {
+    KeepPollingGrpcQueue();
+    firestore_stream->Stop();
+  });
+
+  unblock.set_value();
+  decode_queue->EnqueueBlocking([] {});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_EQ(observed_states(),
+              States({"NotifyStreamOpen", "NotifyStreamClose(Ok)"}));
+  });
+}
+
+TEST_F(StreamTest, HandlesResponsesDecodingWhenTheStreamFinishes) {
+  DecodeResponsesOffQueue();
+  StartStream();
+
+  ForceFinish({{Type::Read, MakeByteBuffer("foo")},
+               {Type::Read, CompletionResult::Error},
+               {Type::Finish, grpc::Status{grpc::UNAVAILABLE, ""}}});
+  decode_queue->EnqueueBlocking([] {});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_FALSE(firestore_stream->IsStarted());
+    EXPECT_EQ(observed_states(),
+              States({"NotifyStreamOpen", "NotifyStreamResponse(foo)",
+                      "NotifyStreamClose(Unavailable)"}));
+  });
+}
+
+TEST_F(StreamTest, StopWhileDecodingAfterTheStreamFinishesClosesOnce) {
+  DecodeResponsesOffQueue();
+  StartStream();
+
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  decode_queue->Enqueue([unblocked] { unblocked.wait(); });
+
+  ForceFinish({{Type::Read, MakeByteBuffer("foo")},
+               {Type::Read, CompletionResult::Error},
+               {Type::Finish, grpc::Status{grpc::UNAVAILABLE, ""}}});
+  worker_queue->EnqueueBlocking([&] {
+    // The finish waits for the response being decoded.
+    EXPECT_TRUE(firestore_stream->IsOpen());
+    KeepPollingGrpcQueue();
+    firestore_stream->Stop();
+  });
+
+  unblock.set_value();
+  decode_queue->EnqueueBlocking([] {});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_EQ(observed_states(),
+              States({"NotifyStreamOpen", "NotifyStreamClose(Ok)"}));
+  });
+}
+
 TEST_F(StreamTest, RefreshesTokenUponExpiration) {
   StartStream();
   ForceFinish({{Type::Read, CompletionResult::Error},
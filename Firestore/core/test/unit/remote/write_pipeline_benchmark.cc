@@ -0,0 +1,292 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/credentials/empty_credentials_provider.h"
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/write_stream.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using core::DatabaseInfo;
+using credentials::EmptyAppCheckCredentialsProvider;
+using credentials::EmptyAuthCredentialsProvider;
+using credentials::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using model::BatchId;
+using model::DatabaseId;
+using model::DocumentKeySet;
+using model::Mutation;
+using model::MutationBatchResult;
+using model::MutationResult;
+using model::OnlineState;
+using model::TargetId;
+using util::AsyncQueue;
+using util::Status;
+
+constexpr int kQueuedBatches = 10000;
+
+/**
+ * A write stream that never touches the network: the handshake completes
+ * immediately, and every request is acknowledged on the next turn of the
+ * worker queue.
+ */
+class FakeWriteStream : public WriteStream {
+ public:
+  FakeWriteStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  Serializer serializer,
+                  GrpcConnection* grpc_connection,
+                  WriteStreamCallback* callback)
+      : WriteStream{worker_queue,
+                    std::make_shared<EmptyAuthCredentialsProvider>(),
+                    std::make_shared<EmptyAppCheckCredentialsProvider>(),
+                    std::move(serializer),
+                    grpc_connection,
+                    callback},
+        worker_queue_{worker_queue},
+        callback_{callback} {
+  }
+
+  void Start() override {
+    open_ = true;
+    callback_->OnWriteStreamOpen();
+  }
+
+  void Stop() override {
+    open_ = false;
+    SetHandshakeComplete(false);
+  }
+
+  bool IsStarted() const override {
+    return open_;
+  }
+  bool IsOpen() const override {
+    return open_;
+  }
+
+  void WriteHandshake() override {
+    SetHandshakeComplete();
+    callback_->OnWriteStreamHandshakeComplete();
+  }
+
+  void WriteMutations(const std::vector<Mutation>& mutations) override {
+    ++requests_sent_;
+    size_t result_count = mutations.size();
+    worker_queue_->EnqueueRelaxed([this, result_count] {
+      if (!open_) {
+        return;
+      }
+
+      std::vector<MutationResult> results;
+      results.reserve(result_count);
+      for (size_t i = 0; i != result_count; ++i) {
+        results.emplace_back(
+            testutil::Version(1),
+            nanopb::Message<google_firestore_v1_ArrayValue>{});
+      }
+      callback_->OnWriteStreamMutationResult(testutil::Version(1),
+                                             std::move(results));
+    });
+  }
+
+  int requests_sent() const {
+    return requests_sent_;
+  }
+
+ private:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  WriteStreamCallback* callback_ = nullptr;
+  bool open_ = false;
+  int requests_sent_ = 0;
+};
+
+class FakeDatastore : public Datastore {
+ public:
+  FakeDatastore(const DatabaseInfo& database_info,
+                const std::shared_ptr<AsyncQueue>& worker_queue,
+                ConnectivityMonitor* connectivity_monitor,
+                FirebaseMetadataProvider* firebase_metadata_provider)
+      : Datastore{database_info,
+                  worker_queue,
+                  std::make_shared<EmptyAuthCredentialsProvider>(),
+                  std::make_shared<EmptyAppCheckCredentialsProvider>(),
+                  connectivity_monitor,
+                  firebase_metadata_provider},
+        database_id_{database_info.database_id()},
+        worker_queue_{worker_queue} {
+  }
+
+  std::shared_ptr<WriteStream> CreateWriteStream(
+      WriteStreamCallback* callback) override {
+    write_stream_ = std::make_shared<FakeWriteStream>(
+        worker_queue_, Serializer{database_id_}, grpc_connection(), callback);
+    return write_stream_;
+  }
+
+  const FakeWriteStream& write_stream() const {
+    return *write_stream_;
+  }
+
+ private:
+  DatabaseId database_id_;
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::shared_ptr<FakeWriteStream> write_stream_;
+};
+
+/**
+ * Stands in for the `SyncEngine`: acknowledges batches in the `LocalStore` and
+ * signals once all of them have been acknowledged.
+ */
+class AcknowledgingCallback : public RemoteStoreCallback {
+ public:
+  AcknowledgingCallback(LocalStore* local_store, int expected_batches)
+      : local_store_{local_store}, remaining_batches_{expected_batches} {
+  }
+
+  std::future<void> drained() {
+    return drained_.get_future();
+  }
+
+  void ApplyRemoteEvent(const RemoteEvent&) override {
+  }
+  void HandleRejectedListen(TargetId, Status) override {
+  }
+  void HandleRejectedWrite(BatchId, Status) override {
+  }
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+  DocumentKeySet GetRemoteKeys(TargetId) const override {
+    return {};
+  }
+
+  void HandleSuccessfulWrite(MutationBatchResult batch_result) override {
+    local_store_->AcknowledgeBatch(batch_result);
+    if (--remaining_batches_ == 0) {
+      drained_.set_value();
+    }
+  }
+
+ private:
+  LocalStore* local_store_ = nullptr;
+  int remaining_batches_ = 0;
+  std::promise<void> drained_;
+};
+
+void BM_DrainWritePipeline(benchmark::State& state) {
+  size_t max_coalesced_write_bytes = static_cast<size_t>(state.range(0));
+  DatabaseInfo database_info{DatabaseId{"p", "d"}, "", "localhost", false};
+  int64_t requests_sent = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::shared_ptr<AsyncQueue> worker_queue =
+        testutil::AsyncQueueForTesting();
+    std::unique_ptr<Persistence> persistence =
+        local::MemoryPersistenceWithEagerGcForTesting();
+    QueryEngine query_engine;
+    LocalStore local_store(persistence.get(), &query_engine,
+                           User::Unauthenticated());
+    std::unique_ptr<ConnectivityMonitor> connectivity_monitor =
+        CreateNoOpConnectivityMonitor();
+    std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider =
+        CreateFirebaseMetadataProviderNoOp();
+    auto datastore = std::make_shared<FakeDatastore>(
+        database_info, worker_queue, connectivity_monitor.get(),
+        firebase_metadata_provider.get());
+    AcknowledgingCallback callback(&local_store, kQueuedBatches);
+    std::future<void> drained = callback.drained();
+
+    std::unique_ptr<RemoteStore> remote_store;
+    worker_queue->EnqueueBlocking([&] {
+      local_store.Start();
+      for (int i = 0; i != kQueuedBatches; ++i) {
+        local_store.WriteLocally({testutil::SetMutation(
+            "coll/doc" + std::to_string(i), testutil::Map("value", i))});
+      }
+
+      remote_store = absl::make_unique<RemoteStore>(
+          &local_store, datastore, worker_queue, connectivity_monitor.get(),
+          [](OnlineState) {});
+      remote_store->set_sync_engine(&callback);
+      if (max_coalesced_write_bytes > 0) {
+        remote_store->EnableWriteBatchCoalescing(max_coalesced_write_bytes);
+      }
+    });
+    state.ResumeTiming();
+
+    worker_queue->EnqueueBlocking([&] { remote_store->Start(); });
+    drained.wait();
+
+    state.PauseTiming();
+    worker_queue->EnqueueBlocking([&] {
+      requests_sent += datastore->write_stream().requests_sent();
+      remote_store->Shutdown();
+      remote_store.reset();
+    });
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kQueuedBatches);
+  state.counters["requests"] = benchmark::Counter(
+      static_cast<double>(requests_sent), benchmark::Counter::kAvgIterations);
+}
+
+// Each write request carries one batch, or as many batches as fit in the
+// given number of bytes.
+BENCHMARK(BM_DrainWritePipeline)
+    ->Arg(0)
+    ->Arg(4 * 1024)
+    ->Arg(64 * 1024)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/write_pipeline_window.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using Clock = WritePipelineWindow::Clock;
+using std::chrono::milliseconds;
+
+/**
+ * Fills the window with single-batch requests and acknowledges all of them
+ * `rtt` later, as a backend with no queueing would.
+ */
+void RunRoundTrip(WritePipelineWindow* window,
+                  Clock::time_point* now,
+                  milliseconds rtt) {
+  size_t count = window->size();
+  for (size_t i = 0; i != count; ++i) {
+    window->OnRequestSent(1, *now);
+  }
+  *now += rtt;
+  for (size_t i = 0; i != count; ++i) {
+    window->OnResponseReceived(*now);
+  }
+}
+
+TEST(WritePipelineWindowTest, StartsAtMinimumSize) {
+  WritePipelineWindow window;
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize);
+}
+
+TEST(WritePipelineWindowTest, GrowsWhileRoundTripTimeIsStable) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 5; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(50));
+  }
+
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize + 5);
+}
+
+TEST(WritePipelineWindowTest, NeverExceedsMaximumSize) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 200; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(50));
+  }
+
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMaxSize);
+}
+
+TEST(WritePipelineWindowTest, ShrinksWhenRoundTripTimeInflates) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 20; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(50));
+  }
+  size_t grown_size = window.size();
+
+  // Doubling the round-trip time at the same window size means half of the
+  // window is queued somewhere.
+  for (int i = 0; i != 5; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(100));
+  }
+
+  EXPECT_EQ(window.size(), grown_size - 5);
+}
+
+TEST(WritePipelineWindowTest, DoesNotGrowWhenNotFull) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 5; ++i) {
+    window.OnRequestSent(1, now);
+    now += milliseconds(50);
+    window.OnResponseReceived(now);
+  }
+
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize);
+}
+
+TEST(WritePipelineWindowTest, IgnoresInstantResponses) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 5; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(0));
+  }
+
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize);
+}
+
+TEST(WritePipelineWindowTest, HalvesOnFailure) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  for (int i = 0; i != 30; ++i) {
+    RunRoundTrip(&window, &now, milliseconds(50));
+  }
+  ASSERT_EQ(window.size(), WritePipelineWindow::kMinSize + 30);
+
+  window.OnStreamClosed(/*failed=*/false);
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize + 30);
+
+  window.OnStreamClosed(/*failed=*/true);
+  EXPECT_EQ(window.size(), (WritePipelineWindow::kMinSize + 30) / 2);
+
+  window.OnStreamClosed(/*failed=*/true);
+  EXPECT_EQ(window.size(), WritePipelineWindow::kMinSize);
+}
+
+TEST(WritePipelineWindowTest, ReportsBatchCountsInRequestOrder) {
+  WritePipelineWindow window;
+  Clock::time_point now;
+
+  window.OnRequestSent(3, now);
+  window.OnRequestSent(1, now);
+  window.OnRequestSent(2, now);
+
+  EXPECT_EQ(window.next_response_batch_count(), 3u);
+  EXPECT_EQ(window.OnResponseReceived(now), 3u);
+  EXPECT_EQ(window.OnResponseReceived(now), 1u);
+  EXPECT_EQ(window.next_response_batch_count(), 2u);
+
+  window.OnStreamClosed(/*failed=*/false);
+  EXPECT_EQ(window.next_response_batch_count(), 1u);
+  EXPECT_EQ(window.OnResponseReceived(now), 1u);
+}
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -15,9 +15,11 @@
  */
 #include "Firestore/core/test/unit/testutil/bundle_builder.h"
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
+#include "Firestore/core/src/bundle/bundle_reader.h"
 #include "absl/strings/str_replace.h"
 
 namespace firebase {
@@ -192,6 +194,16 @@ std::vector<std::string> BundleTemplate() {
           document_1, document_metadata2, document_2};
 }
 
+void AppendLengthPrefixed(std::string* out, absl::string_view element) {
+  uint64_t size = element.size();
+  while (size >= 0x80) {
+    out->push_back(static_cast<char>((size & 0x7F) | 0x80));
+    size >>= 7;
+  }
+  out->push_back(static_cast<char>(size));
+  out->append(element.data(), element.size());
+}
+
 }  // namespace
 
 std::string CreateBundle(const std::string& project_id,
@@ -212,6 +224,18 @@ std::string CreateBundle(const std::string& project_id,
   return std::to_string(metadata.size()) + metadata + bundle;
 }
 
+void BinaryBundleWriter::AddElement(absl::string_view element) {
+  AppendLengthPrefixed(&body_, element);
+}
+
+std::string BinaryBundleWriter::Build(absl::string_view metadata) const {
+  std::string bundle(bundle::kBinaryBundleMagic,
+                     bundle::kBinaryBundleMagicSize);
+  AppendLengthPrefixed(&bundle, metadata);
+  bundle.append(body_);
+  return bundle;
+}
+
 }  // namespace testutil
 }  // namespace firestore
 }  // namespace firebase
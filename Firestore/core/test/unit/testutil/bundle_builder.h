@@ -16,8 +16,11 @@
 #ifndef FIRESTORE_CORE_TEST_UNIT_TESTUTIL_BUNDLE_BUILDER_H_
 #define FIRESTORE_CORE_TEST_UNIT_TESTUTIL_BUNDLE_BUILDER_H_
 
+#include <cstddef>
 #include <string>
 
+#include "absl/strings/string_view.h"
+
 namespace firebase {
 namespace firestore {
 namespace testutil {
@@ -25,6 +28,37 @@ namespace testutil {
 std::string CreateBundle(const std::string& project_id,
                          const std::string& database_id);
 
+/**
+ * Writes bundles in the binary format understood by `bundle::BundleReader`:
+ * the binary bundle header, followed by varint length-prefixed serialized
+ * `firestore.BundleElement` protos.
+ *
+ * The metadata element is only given to `Build()`, once all other elements
+ * have been added, so that its `total_bytes` can be set from `body_size()`.
+ */
+class BinaryBundleWriter {
+ public:
+  /** Appends a serialized `firestore.BundleElement` to the bundle. */
+  void AddElement(absl::string_view element);
+
+  /**
+   * Returns the number of bytes of all elements added so far, which is what
+   * the bundle metadata reports as `total_bytes`.
+   */
+  size_t body_size() const {
+    return body_.size();
+  }
+
+  /**
+   * Returns the complete bundle, starting with the given serialized metadata
+   * `firestore.BundleElement`.
+   */
+  std::string Build(absl::string_view metadata) const;
+
+ private:
+  std::string body_;
+};
+
 }  // namespace testutil
 }  // namespace firestore
 }  // namespace firebase
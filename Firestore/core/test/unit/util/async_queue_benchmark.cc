@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/executor.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kOperationsPerThread = 1000;
+
+/**
+ * Enqueues operations from `state.range(0)` threads at once, the way user
+ * calls and callbacks reach the queue, and reports the average time between
+ * enqueuing an operation and running it.
+ */
+void MeasureLatency(
+    benchmark::State& state,
+    const std::function<void(std::function<void()>)>& enqueue,
+    const std::function<void()>& await_all) {
+  auto thread_count = static_cast<int>(state.range(0));
+
+  // Only updated by the enqueued operations, which run one at a time.
+  Clock::duration total_latency{};
+  int64_t operations = 0;
+
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < kOperationsPerThread; ++i) {
+          Clock::time_point enqueued = Clock::now();
+          enqueue([&total_latency, &operations, enqueued] {
+            total_latency += Clock::now() - enqueued;
+            ++operations;
+          });
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    await_all();
+  }
+
+  state.SetItemsProcessed(operations);
+  state.counters["latency_us"] =
+      std::chrono::duration<double, std::micro>(total_latency).count() /
+      static_cast<double>(operations);
+}
+
+void BM_AsyncQueueEnqueue(benchmark::State& state) {
+  std::shared_ptr<AsyncQueue> queue = AsyncQueue::Create(
+      Executor::CreateSerial("com.google.firebase.firestore.benchmark"));
+
+  MeasureLatency(
+      state,
+      [&](std::function<void()> operation) {
+        queue->Enqueue(std::move(operation));
+      },
+      [&] { queue->EnqueueBlocking([] {}); });
+}
+BENCHMARK(BM_AsyncQueueEnqueue)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+// The same, going through the executor directly, as `AsyncQueue` used to.
+void BM_ExecutorExecute(benchmark::State& state) {
+  std::unique_ptr<Executor> executor =
+      Executor::CreateSerial("com.google.firebase.firestore.benchmark");
+
+  MeasureLatency(
+      state,
+      [&](std::function<void()> operation) {
+        executor->Execute(std::move(operation));
+      },
+      [&] { executor->ExecuteBlocking([] {}); });
+}
+BENCHMARK(BM_ExecutorExecute)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+}  // namespace
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -16,9 +16,13 @@
 
 #include "Firestore/core/test/unit/util/async_queue_test.h"
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <future>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Firestore/core/src/util/executor.h"
 #include "absl/memory/memory.h"
@@ -44,6 +48,69 @@ TEST_P(AsyncQueueTest, Enqueue) {
   Await(ran);
 }
 
+TEST_P(AsyncQueueTest, EnqueueFromManyThreadsKeepsTheOrderOfEachThread) {
+  constexpr int kThreads = 4;
+  constexpr int kOperationsPerThread = 1000;
+
+  std::vector<int> next(kThreads, 0);
+  bool in_order = true;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreads; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (int i = 0; i < kOperationsPerThread; ++i) {
+        queue->Enqueue([&, thread, i] {
+          in_order = in_order && next[thread] == i;
+          ++next[thread];
+        });
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  queue->EnqueueBlocking([] {});
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(next, std::vector<int>(kThreads, kOperationsPerThread));
+}
+
+TEST_P(AsyncQueueTest, DelayedOperationsRunWhileOperationsKeepArriving) {
+  Expectation done;
+  std::atomic<bool> delayed_ran{false};
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+  // Every operation enqueues another one, so there is always an operation
+  // pending until the delayed operation gets its turn.
+  std::function<void()> keep_busy = [&] {
+    if (!delayed_ran && std::chrono::steady_clock::now() < deadline) {
+      queue->EnqueueRelaxed(keep_busy);
+    } else {
+      done.Fulfill();
+    }
+  };
+  queue->EnqueueBlocking([&] {
+    queue->EnqueueAfterDelay(AsyncQueue::Milliseconds(10000), kTimerId1,
+                             [&] { delayed_ran = true; });
+    queue->EnqueueRelaxed(keep_busy);
+  });
+
+  // Bring the delayed operation due now; it has to run in between the
+  // operations rather than after they stop arriving.
+  queue->RunScheduledOperationsUntil(kTimerId1);
+  EXPECT_LT(std::chrono::steady_clock::now(), deadline);
+
+  Await(done);
+  EXPECT_TRUE(delayed_ran);
+}
+
+TEST_P(AsyncQueueTest, EnqueueBlockingRunsAfterEarlierOperations) {
+  std::vector<int> order;
+  queue->Enqueue([&] { order.push_back(1); });
+  queue->Enqueue([&] { order.push_back(2); });
+  queue->EnqueueBlocking([&] { order.push_back(3); });
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
 TEST_P(AsyncQueueTest, EnqueueDisallowsNesting) {
   Expectation ran;
   // clang-format off
@@ -278,6 +345,64 @@ TEST_P(AsyncQueueTest, DisposeDoesNotBlockEnqueueWhileWaiting) {
   Await(dispose_complete);
 }
 
+TEST_P(AsyncQueueTest, DisposeEndsEnqueueBlockingWaits) {
+  Expectation blocking_started;
+  Expectation blocking_complete;
+  queue->Enqueue([&] {
+    blocking_started.Fulfill();
+    Await(blocking_complete);
+  });
+  Await(blocking_started);
+
+  // Wait on an operation that is stuck behind the blocking one.
+  std::atomic<bool> ran{false};
+  Expectation wait_ended;
+  Async([&] {
+    queue->EnqueueBlocking([&] { ran = true; });
+    wait_ended.Fulfill();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // Dispose while the wait is in progress, and let the blocking operation
+  // finish only once the queue is disposed.
+  Expectation dispose_complete;
+  Async([&] {
+    queue->Dispose();
+    dispose_complete.Fulfill();
+  });
+  while (queue->is_running()) {
+    std::this_thread::yield();
+  }
+  blocking_complete.Fulfill();
+
+  Await(dispose_complete);
+  Await(wait_ended);
+  EXPECT_FALSE(ran);
+}
+
+TEST_P(AsyncQueueTest, DisposeFromOperationEndsEnqueueBlockingWaits) {
+  Expectation blocking_started;
+  Expectation dispose;
+  queue->Enqueue([&] {
+    blocking_started.Fulfill();
+    Await(dispose);
+    queue->Dispose();
+  });
+  Await(blocking_started);
+
+  std::atomic<bool> ran{false};
+  Expectation wait_ended;
+  Async([&] {
+    queue->EnqueueBlocking([&] { ran = true; });
+    wait_ended.Fulfill();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  dispose.Fulfill();
+
+  Await(wait_ended);
+  EXPECT_FALSE(ran);
+}
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
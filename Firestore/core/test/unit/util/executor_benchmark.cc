@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "Firestore/core/src/util/background_queue.h"
+#include "Firestore/core/src/util/executor.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+std::unique_ptr<Executor> CreateExecutor() {
+  auto hw_concurrency = std::thread::hardware_concurrency();
+  if (hw_concurrency == 0) {
+    hw_concurrency = 4;
+  }
+  return Executor::CreateConcurrent("com.google.firebase.firestore.benchmark",
+                                    static_cast<int>(hw_concurrency));
+}
+
+// A task about as small as decoding a tiny document.
+void TinyTask(std::atomic<int64_t>* sum, size_t i) {
+  int64_t value = static_cast<int64_t>(i);
+  for (int j = 0; j < 100; ++j) {
+    value = value * 31 + j;
+  }
+  sum->fetch_add(value, std::memory_order_relaxed);
+}
+
+// Submits every task on its own, as parallel decoding used to.
+void BM_ExecuteEach(benchmark::State& state) {
+  std::unique_ptr<Executor> executor = CreateExecutor();
+  auto count = static_cast<size_t>(state.range(0));
+  std::atomic<int64_t> sum{0};
+
+  for (auto _ : state) {
+    BackgroundQueue tasks(executor.get());
+    for (size_t i = 0; i < count; ++i) {
+      tasks.Execute([&sum, i] { TinyTask(&sum, i); });
+    }
+    tasks.AwaitAll();
+  }
+  benchmark::DoNotOptimize(sum.load());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExecuteEach)->Arg(100)->Arg(1000)->Arg(10000)->UseRealTime();
+
+void BM_ExecuteAll(benchmark::State& state) {
+  std::unique_ptr<Executor> executor = CreateExecutor();
+  auto count = static_cast<size_t>(state.range(0));
+  std::atomic<int64_t> sum{0};
+
+  for (auto _ : state) {
+    executor->ExecuteAll(count, [&sum](size_t i) { TinyTask(&sum, i); });
+  }
+  benchmark::DoNotOptimize(sum.load());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExecuteAll)->Arg(100)->Arg(1000)->Arg(10000)->UseRealTime();
+
+}  // namespace
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -18,11 +18,13 @@
 
 #include <cstdlib>  // NOLINT(build/include_order)
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <future>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/task.h"
@@ -58,6 +60,46 @@ TEST_P(ExecutorTest, ExecuteBlocking) {
   EXPECT_TRUE(finished);
 }
 
+TEST_P(ExecutorTest, ExecuteAll) {
+  executor = GetParam()(/*threads=*/4);
+
+  std::vector<std::atomic<int>> runs(1000);
+  for (std::atomic<int>& run : runs) {
+    run = 0;
+  }
+  executor->ExecuteAll(runs.size(), [&](size_t i) { ++runs[i]; });
+
+  for (size_t i = 0; i < runs.size(); ++i) {
+    EXPECT_EQ(runs[i], 1) << "index " << i;
+  }
+}
+
+TEST_P(ExecutorTest, ExecuteAllWithNoOperations) {
+  bool ran = false;
+  executor->ExecuteAll(0, [&](size_t) { ran = true; });
+  EXPECT_FALSE(ran);
+}
+
+TEST_P(ExecutorTest, ExecuteAllFromAnOperation) {
+  // The executor is serial, so the calling operation has to take part.
+  Expectation ran;
+  std::atomic<int> sum{0};
+  executor->Execute([&] {
+    executor->ExecuteAll(100, [&](size_t i) { sum += static_cast<int>(i); });
+    ran.Fulfill();
+  });
+  Await(ran);
+  EXPECT_EQ(sum, 4950);
+}
+
+TEST_P(ExecutorTest, ExecuteAllAfterDispose) {
+  executor->Dispose();
+
+  int runs = 0;
+  executor->ExecuteAll(10, [&](size_t) { ++runs; });
+  EXPECT_EQ(runs, 10);
+}
+
 TEST_P(ExecutorTest, DestructorDoesNotBlockIfThereArePendingTasks) {
   const auto future = Async([&] {
     auto another_executor = GetParam()(/*threads=*/1);
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/lru_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+TEST(LruCacheTest, GetReturnsNullForMissingKeys) {
+  LruCache<std::string, int> cache(2);
+  EXPECT_EQ(nullptr, cache.get("a"));
+  EXPECT_TRUE(cache.empty());
+}
+
+TEST(LruCacheTest, PutReplacesExistingValues) {
+  LruCache<std::string, int> cache(2);
+  cache.put("a", 1);
+  cache.put("a", 2);
+  EXPECT_EQ(1u, cache.size());
+  ASSERT_NE(nullptr, cache.get("a"));
+  EXPECT_EQ(2, *cache.get("a"));
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsedEntry) {
+  LruCache<std::string, int> cache(2);
+  cache.put("a", 1);
+  cache.put("b", 2);
+
+  // Touch "a" so that "b" becomes the least recently used entry.
+  ASSERT_NE(nullptr, cache.get("a"));
+  cache.put("c", 3);
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_NE(nullptr, cache.get("a"));
+  EXPECT_EQ(nullptr, cache.get("b"));
+  EXPECT_NE(nullptr, cache.get("c"));
+}
+
+TEST(LruCacheTest, RemovesEntries) {
+  LruCache<int, int> cache(10);
+  for (int i = 0; i < 5; ++i) {
+    cache.put(i, i * 10);
+  }
+
+  EXPECT_TRUE(cache.remove(0));
+  EXPECT_FALSE(cache.remove(0));
+  cache.remove_if([](int, int value) { return value >= 30; });
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_NE(nullptr, cache.get(1));
+  EXPECT_NE(nullptr, cache.get(2));
+
+  cache.clear();
+  EXPECT_TRUE(cache.empty());
+}
+
+TEST(LruCacheTest, EvictsByCost) {
+  LruCache<std::string, int> cache(10);
+  cache.put("a", 1, 4);
+  cache.put("b", 2, 4);
+  EXPECT_EQ(8u, cache.total_cost());
+
+  // Evicts "a" to make room.
+  cache.put("c", 3, 4);
+  EXPECT_EQ(nullptr, cache.get("a"));
+  EXPECT_NE(nullptr, cache.get("b"));
+  EXPECT_NE(nullptr, cache.get("c"));
+  EXPECT_EQ(8u, cache.total_cost());
+
+  // Replacing an entry updates its cost.
+  cache.put("b", 2, 1);
+  EXPECT_EQ(5u, cache.total_cost());
+  EXPECT_TRUE(cache.remove("c"));
+  EXPECT_EQ(1u, cache.total_cost());
+
+  // An entry larger than the whole cache is not retained, and doesn't evict
+  // the others.
+  cache.put("d", 4, 11);
+  EXPECT_EQ(nullptr, cache.get("d"));
+  EXPECT_NE(nullptr, cache.get("b"));
+  EXPECT_EQ(1u, cache.total_cost());
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
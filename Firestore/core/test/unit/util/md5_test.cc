@@ -15,6 +15,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/util/md5.h"
 #include "Firestore/core/test/unit/testutil/md5_testing.h"
@@ -23,6 +24,7 @@
 
 using firebase::firestore::testutil::md5::Uint8ArrayFromHexDigest;
 using firebase::firestore::util::CalculateMd5Digest;
+using firebase::firestore::util::CalculateMd5Digests;
 
 namespace {
 
@@ -92,4 +94,42 @@ TEST(CalculateMd5DigestTest, ShouldReturnMd5DigestOfLongStringWithAllChars) {
             Uint8ArrayFromHexDigest("6556112372898c69e1de0bf689d8db26"));
 }
 
+TEST(CalculateMd5DigestsTest, ShouldReturnNoDigestsForNoSuffixes) {
+  EXPECT_TRUE(CalculateMd5Digests("prefix", {}).empty());
+}
+
+TEST(CalculateMd5DigestsTest, ShouldReturnMd5DigestsOfPrefixedSuffixes) {
+  EXPECT_EQ(
+      CalculateMd5Digests("abc", {"", "defghijklmnopqrstuvwxyz"}),
+      (std::vector<std::array<uint8_t, 16>>{
+          Uint8ArrayFromHexDigest("900150983cd24fb0d6963f7d28e17f72"),
+          Uint8ArrayFromHexDigest("c3fcd3d76192e4007dfb496cca67e13b")}));
+}
+
+TEST(CalculateMd5DigestsTest, ShouldMatchCalculateMd5Digest) {
+  // Prefixes and suffixes of lengths around the 64-byte block size and the
+  // 56-byte padding boundary, more suffixes than are hashed together, and
+  // suffixes that need different numbers of blocks.
+  std::vector<std::string> suffixes;
+  for (int length : {0, 1, 7, 55, 56, 57, 63, 64, 65, 119, 120, 200, 3, 60}) {
+    std::string suffix;
+    for (int i = 0; i < length; ++i) {
+      suffix += static_cast<char>(length * 31 + i);
+    }
+    suffixes.push_back(suffix);
+  }
+
+  for (int prefix_length : {0, 5, 55, 56, 63, 64, 65, 128, 130}) {
+    std::string prefix(prefix_length, 'p');
+    std::vector<std::array<uint8_t, 16>> digests =
+        CalculateMd5Digests(prefix, suffixes);
+
+    ASSERT_EQ(digests.size(), suffixes.size());
+    for (size_t i = 0; i < suffixes.size(); ++i) {
+      EXPECT_EQ(digests[i], CalculateMd5Digest(prefix + suffixes[i]))
+          << "prefix length " << prefix_length << ", suffix " << i;
+    }
+  }
+}
+
 }  // namespace
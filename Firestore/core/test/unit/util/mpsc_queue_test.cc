@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/mpsc_queue.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+TEST(MpscQueueTest, PopsNothingWhenEmpty) {
+  MpscQueue<int> queue;
+  int value = 0;
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+  MpscQueue<std::string> queue;
+  queue.Push("a");
+  queue.Push("b");
+
+  std::string value;
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, "a");
+
+  queue.Push("c");
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, "b");
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, "c");
+  EXPECT_FALSE(queue.TryPop(&value));
+
+  // The queue keeps working once it has been emptied.
+  queue.Push("d");
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, "d");
+}
+
+TEST(MpscQueueTest, DestroysValuesThatWereNotPopped) {
+  auto value = std::make_shared<int>(42);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.Push(value);
+    queue.Push(value);
+    EXPECT_EQ(value.use_count(), 3);
+  }
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(MpscQueueTest, KeepsTheOrderOfEachProducer) {
+  constexpr int kProducers = 4;
+  constexpr int kValuesPerProducer = 10000;
+
+  MpscQueue<std::pair<int, int>> queue;
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducers; ++producer) {
+    producers.emplace_back([&queue, producer] {
+      for (int i = 0; i < kValuesPerProducer; ++i) {
+        queue.Push({producer, i});
+      }
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  int popped = 0;
+  while (popped < kProducers * kValuesPerProducer) {
+    std::pair<int, int> value;
+    if (!queue.TryPop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value.second, next[value.first]);
+    ++next[value.first];
+    ++popped;
+  }
+
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  std::pair<int, int> value;
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase